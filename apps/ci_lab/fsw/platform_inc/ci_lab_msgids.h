@@ -26,6 +26,7 @@
 #define CI_LAB_CMD_MID     0x1884
 #define CI_LAB_SEND_HK_MID 0x1885
 
-#define CI_LAB_HK_TLM_MID 0x0884
+#define CI_LAB_HK_TLM_MID        0x0884
+#define CI_LAB_CMD_STATS_TLM_MID 0x0885
 
 #endif
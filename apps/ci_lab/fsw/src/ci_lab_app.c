@@ -43,7 +43,8 @@ typedef struct
     osal_id_t       SocketID;
     OS_SockAddr_t   SocketAddress;
 
-    CI_LAB_HkTlm_t HkTlm;
+    CI_LAB_HkTlm_t      HkTlm;
+    MRLIB_CmdStatsTlm_t CmdStatsTlm;
 
     CFE_SB_Buffer_t *NextIngestBufPtr;
 
@@ -60,10 +61,44 @@ CI_LAB_GlobalData_t CI_LAB_Global;
  */
 int32 CI_LAB_Noop(const CI_LAB_NoopCmd_t *data);
 int32 CI_LAB_ResetCounters(const CI_LAB_ResetCountersCmd_t *data);
+int32 CI_LAB_SendCmdStats(const CI_LAB_SendCmdStatsCmd_t *data);
 
 /* Housekeeping message handler */
 int32 CI_LAB_ReportHousekeeping(const CFE_MSG_CommandHeader_t *data);
 
+/*
+ * Table entries, each handing the packet to its handler as its command type
+ */
+MRLIB_HANDLER_ADAPTER(CI_LAB_Noop, CI_LAB_NoopCmd_t)
+MRLIB_HANDLER_ADAPTER(CI_LAB_ResetCounters, CI_LAB_ResetCountersCmd_t)
+MRLIB_HANDLER_ADAPTER(CI_LAB_SendCmdStats, CI_LAB_SendCmdStatsCmd_t)
+MRLIB_HANDLER_ADAPTER(CI_LAB_ReportHousekeeping, CFE_MSG_CommandHeader_t)
+
+/*
+ * Command dispatch tables, indexed by function code
+ */
+static const MRLIB_Cmd_t CI_LAB_GroundCmds[] = {
+    [CI_LAB_NOOP_CC]           = {CI_LAB_Noop_Handler, sizeof(CI_LAB_NoopCmd_t)},
+    [CI_LAB_RESET_COUNTERS_CC] = {CI_LAB_ResetCounters_Handler, sizeof(CI_LAB_ResetCountersCmd_t)},
+    [CI_LAB_SEND_CMD_STATS_CC] = {CI_LAB_SendCmdStats_Handler, sizeof(CI_LAB_SendCmdStatsCmd_t)},
+};
+
+static const MRLIB_Cmd_t CI_LAB_SendHkCmds[] = {
+    {CI_LAB_ReportHousekeeping_Handler, sizeof(CFE_MSG_CommandHeader_t)},
+};
+
+static MRLIB_CmdStats_t CI_LAB_GroundStats[MRLIB_COUNT(CI_LAB_GroundCmds)];
+static MRLIB_CmdStats_t CI_LAB_SendHkStats[MRLIB_COUNT(CI_LAB_SendHkCmds)];
+
+static const MRLIB_Route_t CI_LAB_Routes[] = {
+    {CI_LAB_CMD_MID, MRLIB_COUNT(CI_LAB_GroundCmds), CI_LAB_GroundCmds, CI_LAB_GroundStats},
+    {CI_LAB_SEND_HK_MID, 0, CI_LAB_SendHkCmds, CI_LAB_SendHkStats},
+};
+
+static const MRLIB_Dispatch_t CI_LAB_Dispatch = {
+    CI_LAB_Routes, MRLIB_COUNT(CI_LAB_Routes), CI_LAB_COMMAND_ERR_EID, CI_LAB_COMMAND_ERR_EID, CI_LAB_LEN_ERR_EID,
+};
+
 /** * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 /*                                                                            */
 /* Application entry point and main process loop                              */
@@ -176,6 +211,8 @@ void CI_LAB_TaskInit(void)
 
     CFE_MSG_Init(CFE_MSG_PTR(CI_LAB_Global.HkTlm.TelemetryHeader), CFE_SB_ValueToMsgId(CI_LAB_HK_TLM_MID),
                  sizeof(CI_LAB_Global.HkTlm));
+    CFE_MSG_Init(CFE_MSG_PTR(CI_LAB_Global.CmdStatsTlm.TelemetryHeader), CFE_SB_ValueToMsgId(CI_LAB_CMD_STATS_TLM_MID),
+                 sizeof(CI_LAB_Global.CmdStatsTlm));
 
     CFE_EVS_SendEvent(CI_LAB_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "CI Lab Initialized.%s",
                       CI_LAB_VERSION_STRING);
@@ -189,65 +226,15 @@ void CI_LAB_TaskInit(void)
 /*                                                                            */
 /*        1. NOOP command (from ground)                                       */
 /*        2. Request to reset telemetry counters (from ground)                */
-/*        3. Request for housekeeping telemetry packet (from HS task)         */
+/*        3. Request for the command statistics packet (from ground)          */
+/*        4. Request for housekeeping telemetry packet (from HS task)         */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
 void CI_LAB_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr)
 {
-    CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
-
-    CFE_MSG_GetMsgId(&SBBufPtr->Msg, &MsgId);
-
-    switch (CFE_SB_MsgIdToValue(MsgId))
-    {
-        case CI_LAB_CMD_MID:
-            CI_LAB_ProcessGroundCommand(SBBufPtr);
-            break;
-
-        case CI_LAB_SEND_HK_MID:
-            CI_LAB_ReportHousekeeping((const CFE_MSG_CommandHeader_t *)SBBufPtr);
-            break;
-
-        default:
-            CI_LAB_Global.HkTlm.Payload.CommandErrorCounter++;
-            CFE_EVS_SendEvent(CI_LAB_COMMAND_ERR_EID, CFE_EVS_EventType_ERROR, "CI: invalid command packet,MID = 0x%x",
-                              (unsigned int)CFE_SB_MsgIdToValue(MsgId));
-            break;
-    }
-}
-
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-/*                                                                            */
-/* CI ground commands                                                         */
-/*                                                                            */
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-
-void CI_LAB_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr)
-{
-    CFE_MSG_FcnCode_t CommandCode = 0;
-
-    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &CommandCode);
-
-    /* Process "known" CI task ground commands */
-    switch (CommandCode)
+    if (MRLIB_Dispatch(&CI_LAB_Dispatch, SBBufPtr) != CFE_SUCCESS)
     {
-        case CI_LAB_NOOP_CC:
-            if (CI_LAB_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CI_LAB_NoopCmd_t)))
-            {
-                CI_LAB_Noop((const CI_LAB_NoopCmd_t *)SBBufPtr);
-            }
-            break;
-
-        case CI_LAB_RESET_COUNTERS_CC:
-            if (CI_LAB_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CI_LAB_ResetCountersCmd_t)))
-            {
-                CI_LAB_ResetCounters((const CI_LAB_ResetCountersCmd_t *)SBBufPtr);
-            }
-            break;
-
-        /* default case already found during FC vs length test */
-        default:
-            break;
+        CI_LAB_Global.HkTlm.Payload.CommandErrorCounter++;
     }
 }
 
@@ -280,6 +267,19 @@ int32 CI_LAB_ResetCounters(const CI_LAB_ResetCountersCmd_t *data)
     return CFE_SUCCESS;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                             */
+/*  Purpose:                                                                   */
+/*     Handle SendCmdStats command packets                                     */
+/*                                                                             */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+int32 CI_LAB_SendCmdStats(const CI_LAB_SendCmdStatsCmd_t *data)
+{
+    CI_LAB_Global.HkTlm.Payload.CommandCounter++;
+    MRLIB_SendCmdStats(&CI_LAB_Dispatch, &CI_LAB_Global.CmdStatsTlm);
+    return CFE_SUCCESS;
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
 /*  Purpose:                                                                  */
@@ -309,6 +309,7 @@ void CI_LAB_ResetCounters_Internal(void)
     /* Status of commands processed by CI task */
     CI_LAB_Global.HkTlm.Payload.CommandCounter      = 0;
     CI_LAB_Global.HkTlm.Payload.CommandErrorCounter = 0;
+    MRLIB_ResetCmdStats(&CI_LAB_Dispatch);
 
     /* Status of packets ingested by CI task */
     CI_LAB_Global.HkTlm.Payload.IngestPackets = 0;
@@ -375,36 +376,3 @@ void CI_LAB_ReadUpLink(void)
         }
     }
 }
-
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-/*                                                                            */
-/* Verify command packet length                                               */
-/*                                                                            */
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-bool CI_LAB_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength)
-{
-    bool              result       = true;
-    size_t            ActualLength = 0;
-    CFE_MSG_FcnCode_t FcnCode      = 0;
-    CFE_SB_MsgId_t    MsgId        = CFE_SB_INVALID_MSG_ID;
-
-    CFE_MSG_GetSize(MsgPtr, &ActualLength);
-
-    /*
-    ** Verify the command packet length...
-    */
-    if (ExpectedLength != ActualLength)
-    {
-        CFE_MSG_GetMsgId(MsgPtr, &MsgId);
-        CFE_MSG_GetFcnCode(MsgPtr, &FcnCode);
-
-        CFE_EVS_SendEvent(CI_LAB_LEN_ERR_EID, CFE_EVS_EventType_ERROR,
-                          "Invalid msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u",
-                          (unsigned int)CFE_SB_MsgIdToValue(MsgId), (unsigned int)FcnCode, (unsigned int)ActualLength,
-                          (unsigned int)ExpectedLength);
-        result = false;
-        CI_LAB_Global.HkTlm.Payload.CommandErrorCounter++;
-    }
-
-    return result;
-}
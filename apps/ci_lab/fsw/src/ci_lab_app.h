@@ -31,6 +31,8 @@
 
 #include "osapi.h"
 
+#include "mrlib.h"
+
 #include <string.h>
 #include <errno.h>
 #include <unistd.h>
@@ -55,10 +57,7 @@
 void CI_Lab_AppMain(void);
 void CI_LAB_TaskInit(void);
 void CI_LAB_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr);
-void CI_LAB_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr);
 void CI_LAB_ResetCounters_Internal(void);
 void CI_LAB_ReadUpLink(void);
 
-bool CI_LAB_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength);
-
 #endif
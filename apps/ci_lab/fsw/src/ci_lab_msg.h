@@ -28,6 +28,7 @@
 */
 #define CI_LAB_NOOP_CC           0
 #define CI_LAB_RESET_COUNTERS_CC 1
+#define CI_LAB_SEND_CMD_STATS_CC 2
 
 /*************************************************************************/
 /*
@@ -40,7 +41,7 @@ typedef struct
 } CI_LAB_NoArgsCmd_t;
 
 /*
- * Neither the Noop nor ResetCounters command
+ * Neither the Noop, ResetCounters nor SendCmdStats command
  * have any payload, but should still "reserve" a unique
  * structure type to employ a consistent handler pattern.
  *
@@ -48,6 +49,7 @@ typedef struct
  */
 typedef CI_LAB_NoArgsCmd_t CI_LAB_NoopCmd_t;
 typedef CI_LAB_NoArgsCmd_t CI_LAB_ResetCountersCmd_t;
+typedef CI_LAB_NoArgsCmd_t CI_LAB_SendCmdStatsCmd_t;
 
 /*************************************************************************/
 /*
@@ -33,6 +33,8 @@
 #define DDFK_APP_SEND_HK_MID 0x1899
 #define DDFK_APP_WAKEUP_MID  0x18A0
 /* V1 Telemetry Message IDs must be 0x08xx */
-#define DDFK_APP_HK_TLM_MID 0x0898
+#define DDFK_APP_HK_TLM_MID        0x0898
+#define DDFK_APP_POSE_TLM_MID      0x0899
+#define DDFK_APP_CMD_STATS_TLM_MID 0x089A
 
 #endif /* DDFK_APP_MSGIDS_H */
@@ -25,13 +25,62 @@
 #ifndef DDFK_APP_TABLE_H
 #define DDFK_APP_TABLE_H
 
+#include "mrlib_rt.h"
+
+/*
+** Bounds on the robot geometry, well beyond any Romi sized base
+*/
+#define DDFK_APP_WHEEL_RADIUS_MAX 0.5 /* m */
+#define DDFK_APP_TRACK_WIDTH_MAX  2.0 /* m */
+
+/*
+** Bounds on the drive command limits and goal tolerances
+*/
+#define DDFK_APP_SPEED_MAX                  2.0  /* m/s */
+#define DDFK_APP_TURN_RATE_MAX              20.0 /* rad/s */
+#define DDFK_APP_GOAL_TOLERANCE_MAX         0.5  /* m */
+#define DDFK_APP_GOAL_HEADING_TOLERANCE_MAX 1.0  /* rad */
+
+/*
+** Pose integrators, see ddfk_app_fix.h
+*/
+#define DDFK_APP_INTEGRATOR_DOUBLE 0 /* Double precision with libm sin and cos */
+#define DDFK_APP_INTEGRATOR_FIXED  1 /* Fixed point, the same pose to the bit on every target */
+
 /*
 ** Table structure
+**
+** One geometry for every Romi base ROMIMOT drives.  Taken at the next
+** housekeeping request, and used for the state samples that follow.  The
+** drive limits and goal controller gains apply to every base DDFK drives.
+** The goal gains must keep the controller stable: GoalGainDistance > 0,
+** GoalGainBearing > GoalGainDistance and GoalGainHeading < 0.
 */
 typedef struct
 {
-    uint16 Int1;
-    uint16 Int2;
+    double WheelRadius;     /* m, 0 < WheelRadius <= DDFK_APP_WHEEL_RADIUS_MAX */
+    double TrackWidth;      /* m between the wheel contact points, 0 < TrackWidth <= DDFK_APP_TRACK_WIDTH_MAX */
+    double CountsPerRev;    /* Encoder counts per wheel revolution, > 0 */
+    uint16 Integrator;      /* DDFK_APP_INTEGRATOR_DOUBLE or DDFK_APP_INTEGRATOR_FIXED */
+    uint16 StreamTimeoutMs; /* ROMIMOT stops a base whose setpoints stop this long, 1..ROMIMOT_STREAM_TIMEOUT_MAX_MS */
+    uint16 Spare[2];
+
+    double MaxSpeed;             /* m/s, 0 < MaxSpeed <= DDFK_APP_SPEED_MAX */
+    double MaxTurnRate;          /* rad/s, 0 < MaxTurnRate <= DDFK_APP_TURN_RATE_MAX */
+    double MaxAccel;             /* m/s^2, > 0 */
+    double MaxTurnAccel;         /* rad/s^2, > 0 */
+    double GoalGainDistance;     /* 1/s */
+    double GoalGainBearing;      /* 1/s */
+    double GoalGainHeading;      /* 1/s */
+    double GoalTolerance;        /* m, 0 < GoalTolerance <= DDFK_APP_GOAL_TOLERANCE_MAX */
+    double GoalHeadingTolerance; /* rad, 0 < GoalHeadingTolerance <= DDFK_APP_GOAL_HEADING_TOLERANCE_MAX */
+
+    /*
+    ** Real-time profile of the app's task, taken when the app starts.  A
+    ** driven base gets its next setpoint only once DDFK has handled its
+    ** state packet.
+    */
+    MRLIB_RtProfile_t RtProfile;
 } DDFK_APP_Table_t;
 
 #endif /* DDFK_APP_TABLE_H */
@@ -29,6 +29,8 @@
 #include "ddfk_app.h"
 #include "ddfk_app_table.h"
 
+#include <math.h>
+#include <stddef.h>
 #include <string.h>
 
 /*
@@ -36,6 +38,66 @@
 */
 DDFK_APP_Data_t DDFK_APP_Data;
 
+/*
+** Table entries, each handing the packet to its handler as its command type
+*/
+MRLIB_HANDLER_ADAPTER(DDFK_APP_Noop, DDFK_APP_NoopCmd_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_ResetCounters, DDFK_APP_ResetCountersCmd_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_Process, DDFK_APP_ProcessCmd_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_SetPose, DDFK_APP_SetPoseCmd_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_SetTwist, DDFK_APP_SetTwistCmd_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_GotoPose, DDFK_APP_GotoPoseCmd_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_Stop, DDFK_APP_StopCmd_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_SendCmdStats, DDFK_APP_SendCmdStatsCmd_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_ReportHousekeeping, CFE_MSG_CommandHeader_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_Wakeup, CFE_MSG_CommandHeader_t)
+MRLIB_HANDLER_ADAPTER(DDFK_APP_ProcessState, ROMIMOT_StateBatchTlm_t)
+
+/*
+** Command dispatch tables, indexed by function code
+*/
+static const MRLIB_Cmd_t DDFK_APP_GroundCmds[] = {
+    [DDFK_APP_NOOP_CC]           = {DDFK_APP_Noop_Handler, sizeof(DDFK_APP_NoopCmd_t)},
+    [DDFK_APP_RESET_COUNTERS_CC] = {DDFK_APP_ResetCounters_Handler, sizeof(DDFK_APP_ResetCountersCmd_t)},
+    [DDFK_APP_PROCESS_CC]        = {DDFK_APP_Process_Handler, sizeof(DDFK_APP_ProcessCmd_t)},
+    [DDFK_APP_SET_POSE_CC]       = {DDFK_APP_SetPose_Handler, sizeof(DDFK_APP_SetPoseCmd_t)},
+    [DDFK_APP_SET_TWIST_CC]      = {DDFK_APP_SetTwist_Handler, sizeof(DDFK_APP_SetTwistCmd_t)},
+    [DDFK_APP_GOTO_POSE_CC]      = {DDFK_APP_GotoPose_Handler, sizeof(DDFK_APP_GotoPoseCmd_t)},
+    [DDFK_APP_STOP_CC]           = {DDFK_APP_Stop_Handler, sizeof(DDFK_APP_StopCmd_t)},
+    [DDFK_APP_SEND_CMD_STATS_CC] = {DDFK_APP_SendCmdStats_Handler, sizeof(DDFK_APP_SendCmdStatsCmd_t)},
+};
+
+static const MRLIB_Cmd_t DDFK_APP_SendHkCmds[] = {
+    {DDFK_APP_ReportHousekeeping_Handler, sizeof(CFE_MSG_CommandHeader_t)},
+};
+
+static const MRLIB_Cmd_t DDFK_APP_WakeupCmds[] = {
+    {DDFK_APP_Wakeup_Handler, sizeof(CFE_MSG_CommandHeader_t)},
+};
+
+/* A state packet only carries SampleCount samples, its handler checks the length */
+static const MRLIB_Cmd_t DDFK_APP_StateCmds[] = {
+    {DDFK_APP_ProcessState_Handler, 0},
+};
+
+static MRLIB_CmdStats_t DDFK_APP_GroundStats[MRLIB_COUNT(DDFK_APP_GroundCmds)];
+static MRLIB_CmdStats_t DDFK_APP_SendHkStats[MRLIB_COUNT(DDFK_APP_SendHkCmds)];
+static MRLIB_CmdStats_t DDFK_APP_WakeupStats[MRLIB_COUNT(DDFK_APP_WakeupCmds)];
+static MRLIB_CmdStats_t DDFK_APP_StateStats[MRLIB_COUNT(DDFK_APP_StateCmds)];
+
+/* State packets are the busiest, then the wakeup */
+static const MRLIB_Route_t DDFK_APP_Routes[] = {
+    {ROMIMOT_STATE_TLM_MID, 0, DDFK_APP_StateCmds, DDFK_APP_StateStats},
+    {DDFK_APP_WAKEUP_MID, 0, DDFK_APP_WakeupCmds, DDFK_APP_WakeupStats},
+    {DDFK_APP_CMD_MID, MRLIB_COUNT(DDFK_APP_GroundCmds), DDFK_APP_GroundCmds, DDFK_APP_GroundStats},
+    {DDFK_APP_SEND_HK_MID, 0, DDFK_APP_SendHkCmds, DDFK_APP_SendHkStats},
+};
+
+const MRLIB_Dispatch_t DDFK_APP_Dispatch = {
+    DDFK_APP_Routes, MRLIB_COUNT(DDFK_APP_Routes), DDFK_APP_INVALID_MSGID_ERR_EID, DDFK_APP_COMMAND_ERR_EID,
+    DDFK_APP_LEN_ERR_EID,
+};
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  * *  * * * * **/
 /*                                                                            */
 /* Application entry point and main process loop                              */
@@ -108,7 +170,10 @@ void DDFK_APP_Main(void)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 int32 DDFK_APP_Init(void)
 {
-    int32 status;
+    int32              status;
+    int                i;
+    DDFK_APP_Table_t * TblPtr;
+    MRLIB_RtProfile_t  RtProfile;
 
     DDFK_APP_Data.RunStatus = CFE_ES_RunStatus_APP_RUN;
 
@@ -127,9 +192,13 @@ int32 DDFK_APP_Init(void)
     DDFK_APP_Data.PipeName[sizeof(DDFK_APP_Data.PipeName) - 1] = 0;
 
     /*
-    ** Register the events
+    ** Register the events.  A bad state packet stops being reported after
+    ** the first eight until the counters are reset.
     */
-    status = CFE_EVS_Register(NULL, 0, CFE_EVS_EventFilter_BINARY);
+    DDFK_APP_Data.EventFilters[0].EventID = DDFK_APP_STATE_ERR_EID;
+    DDFK_APP_Data.EventFilters[0].Mask    = CFE_EVS_FIRST_8_STOP;
+
+    status = CFE_EVS_Register(DDFK_APP_Data.EventFilters, DDFK_APP_EVENT_FILTERS, CFE_EVS_EventFilter_BINARY);
     if (status != CFE_SUCCESS)
     {
         CFE_ES_WriteToSysLog("Differential Drive Forward Kinematics App: Error Registering Events, RC = 0x%08lX\n",
@@ -138,10 +207,34 @@ int32 DDFK_APP_Init(void)
     }
 
     /*
-    ** Initialize housekeeping packet (clear user data area).
+    ** Initialize the housekeeping and dispatch statistics packets (clear user data area).
     */
     CFE_MSG_Init(CFE_MSG_PTR(DDFK_APP_Data.HkTlm.TelemetryHeader), CFE_SB_ValueToMsgId(DDFK_APP_HK_TLM_MID),
                  sizeof(DDFK_APP_Data.HkTlm));
+    CFE_MSG_Init(CFE_MSG_PTR(DDFK_APP_Data.CmdStatsTlm.TelemetryHeader),
+                 CFE_SB_ValueToMsgId(DDFK_APP_CMD_STATS_TLM_MID), sizeof(DDFK_APP_Data.CmdStatsTlm));
+
+    /*
+    ** Initialize the pose packets and the ROMIMOT velocity setpoints, no
+    ** base has been heard from yet
+    */
+    memset(DDFK_APP_Data.Robot, 0, sizeof(DDFK_APP_Data.Robot));
+    DDFK_APP_Data.StatePackets = 0;
+    DDFK_APP_Data.StateErrors  = 0;
+    for (i = 0; i < DDFK_APP_MAX_ROBOTS; i++)
+    {
+        CFE_MSG_Init(CFE_MSG_PTR(DDFK_APP_Data.Robot[i].PoseTlm.TelemetryHeader),
+                     CFE_SB_ValueToMsgId(DDFK_APP_POSE_TLM_MID), sizeof(DDFK_APP_Data.Robot[i].PoseTlm));
+        DDFK_APP_Data.Robot[i].PoseTlm.Payload.Instance = (uint8)i;
+
+        CFE_MSG_Init(CFE_MSG_PTR(DDFK_APP_Data.Robot[i].VelocityCmd.CmdHeader),
+                     CFE_SB_ValueToMsgId(ROMIMOT_CMD_MID), sizeof(DDFK_APP_Data.Robot[i].VelocityCmd));
+        CFE_MSG_SetFcnCode(CFE_MSG_PTR(DDFK_APP_Data.Robot[i].VelocityCmd.CmdHeader), ROMIMOT_SET_VELOCITY_CC);
+        DDFK_APP_Data.Robot[i].VelocityCmd.Device = (uint8)i;
+
+        /* A restarted DDFK integrates from a new origin */
+        MRLIB_PoseClear(i);
+    }
 
     /*
     ** Create Software Bus message pipe.
@@ -178,6 +271,31 @@ int32 DDFK_APP_Init(void)
         return status;
     }
 
+    /*
+    ** Subscribe to the scheduler wakeup, the pose telemetry rate
+    */
+    status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(DDFK_APP_WAKEUP_MID), DDFK_APP_Data.CommandPipe);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("Differential Drive Forward Kinematics App: Error Subscribing to Wakeup, RC = 0x%08lX\n",
+                             (unsigned long)status);
+
+        return status;
+    }
+
+    /*
+    ** Subscribe to the ROMIMOT wheel state, every sample is integrated
+    */
+    status = CFE_SB_SubscribeEx(CFE_SB_ValueToMsgId(ROMIMOT_STATE_TLM_MID), DDFK_APP_Data.CommandPipe,
+                                CFE_SB_DEFAULT_QOS, DDFK_APP_PIPE_DEPTH);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("Differential Drive Forward Kinematics App: Error Subscribing to State, RC = 0x%08lX\n",
+                             (unsigned long)status);
+
+        return status;
+    }
+
     /*
     ** Register Table(s)
     */
@@ -195,6 +313,20 @@ int32 DDFK_APP_Init(void)
         status = CFE_TBL_Load(DDFK_APP_Data.TblHandles[0], CFE_TBL_SRC_FILE, DDFK_APP_TABLE_FILE);
     }
 
+    /*
+    ** Real-time profile of the app's task.  Without a table it stays as
+    ** OSAL created it.
+    */
+    memset(&RtProfile, 0, sizeof(RtProfile));
+    if (CFE_TBL_GetAddress((void *)&TblPtr, DDFK_APP_Data.TblHandles[0]) >= CFE_SUCCESS)
+    {
+        RtProfile = TblPtr->RtProfile;
+        CFE_TBL_ReleaseAddress(DDFK_APP_Data.TblHandles[0]);
+    }
+    DDFK_APP_ApplyRtProfile(&RtProfile);
+
+    DDFK_APP_ApplyTableConfig();
+
     CFE_EVS_SendEvent(DDFK_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "DDFK_APP Initialized.%s",
                       DDFK_APP_VERSION_STRING);
 
@@ -203,79 +335,41 @@ int32 DDFK_APP_Init(void)
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
-/*  Purpose:                                                                  */
-/*     This routine will process any packet that is received on the DDFK_APP */
-/*     command pipe.                                                          */
+/* Apply a real-time profile to the app's task and report what it got        */
 /*                                                                            */
-/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
-void DDFK_APP_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr)
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_ApplyRtProfile(const MRLIB_RtProfile_t *Profile)
 {
-    CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
-
-    CFE_MSG_GetMsgId(&SBBufPtr->Msg, &MsgId);
+    MRLIB_RtStatus_t *Status = &DDFK_APP_Data.RtStatus;
 
-    switch (CFE_SB_MsgIdToValue(MsgId))
+    if (MRLIB_RtApply(Profile, Status) != CFE_SUCCESS)
     {
-        case DDFK_APP_CMD_MID:
-            DDFK_APP_ProcessGroundCommand(SBBufPtr);
-            break;
-
-        case DDFK_APP_SEND_HK_MID:
-            DDFK_APP_ReportHousekeeping((CFE_MSG_CommandHeader_t *)SBBufPtr);
-            break;
-
-        default:
-            CFE_EVS_SendEvent(DDFK_APP_INVALID_MSGID_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "DDFK_APP: invalid command packet,MID = 0x%x", (unsigned int)CFE_SB_MsgIdToValue(MsgId));
-            break;
+        CFE_EVS_SendEvent(DDFK_APP_RT_PROFILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "DDFK_APP: RT profile incomplete, errors 0x%02X, policy %u priority %u CPUs 0x%X",
+                          (unsigned int)Status->Errors, (unsigned int)Status->Policy, (unsigned int)Status->Priority,
+                          (unsigned int)Status->CpuMask);
+    }
+    else if (Profile->Enabled)
+    {
+        CFE_EVS_SendEvent(DDFK_APP_RT_PROFILE_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "DDFK_APP: RT profile applied, policy %u priority %u CPUs 0x%X, %u kB locked",
+                          (unsigned int)Status->Policy, (unsigned int)Status->Priority,
+                          (unsigned int)Status->CpuMask, (unsigned int)Status->LockedKb);
     }
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
-/* DDFK_APP ground commands                                                 */
+/*  Purpose:                                                                  */
+/*     This routine will process any packet that is received on the DDFK_APP */
+/*     command pipe.                                                          */
 /*                                                                            */
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-void DDFK_APP_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr)
+/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
+void DDFK_APP_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr)
 {
-    CFE_MSG_FcnCode_t CommandCode = 0;
-
-    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &CommandCode);
-
-    /*
-    ** Process "known" DDFK_APP ground commands
-    */
-    switch (CommandCode)
+    if (MRLIB_Dispatch(&DDFK_APP_Dispatch, SBBufPtr) != CFE_SUCCESS)
     {
-        case DDFK_APP_NOOP_CC:
-            if (DDFK_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(DDFK_APP_NoopCmd_t)))
-            {
-                DDFK_APP_Noop((DDFK_APP_NoopCmd_t *)SBBufPtr);
-            }
-
-            break;
-
-        case DDFK_APP_RESET_COUNTERS_CC:
-            if (DDFK_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(DDFK_APP_ResetCountersCmd_t)))
-            {
-                DDFK_APP_ResetCounters((DDFK_APP_ResetCountersCmd_t *)SBBufPtr);
-            }
-
-            break;
-
-        case DDFK_APP_PROCESS_CC:
-            if (DDFK_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(DDFK_APP_ProcessCmd_t)))
-            {
-                DDFK_APP_Process((DDFK_APP_ProcessCmd_t *)SBBufPtr);
-            }
-
-            break;
-
-        /* default case already found during FC vs length test */
-        default:
-            CFE_EVS_SendEvent(DDFK_APP_COMMAND_ERR_EID, CFE_EVS_EventType_ERROR, "Invalid ground command code: CC = %d",
-                              CommandCode);
-            break;
+        DDFK_APP_Data.ErrCounter++;
     }
 }
 
@@ -296,6 +390,10 @@ int32 DDFK_APP_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
     */
     DDFK_APP_Data.HkTlm.Payload.CommandErrorCounter = DDFK_APP_Data.ErrCounter;
     DDFK_APP_Data.HkTlm.Payload.CommandCounter      = DDFK_APP_Data.CmdCounter;
+    DDFK_APP_Data.HkTlm.Payload.Integrator          = (uint8)DDFK_APP_Data.Integrator;
+    DDFK_APP_Data.HkTlm.Payload.StatePackets        = DDFK_APP_Data.StatePackets;
+    DDFK_APP_Data.HkTlm.Payload.StateErrors         = DDFK_APP_Data.StateErrors;
+    DDFK_APP_Data.HkTlm.Payload.Rt                  = DDFK_APP_Data.RtStatus;
 
     /*
     ** Send housekeeping telemetry packet...
@@ -311,6 +409,8 @@ int32 DDFK_APP_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
         CFE_TBL_Manage(DDFK_APP_Data.TblHandles[i]);
     }
 
+    DDFK_APP_ApplyTableConfig();
+
     return CFE_SUCCESS;
 }
 
@@ -341,11 +441,29 @@ int32 DDFK_APP_ResetCounters(const DDFK_APP_ResetCountersCmd_t *Msg)
     DDFK_APP_Data.CmdCounter = 0;
     DDFK_APP_Data.ErrCounter = 0;
 
+    DDFK_APP_Data.StatePackets = 0;
+    DDFK_APP_Data.StateErrors  = 0;
+    MRLIB_ResetCmdStats(&DDFK_APP_Dispatch);
+
     CFE_EVS_SendEvent(DDFK_APP_COMMANDRST_INF_EID, CFE_EVS_EventType_INFORMATION, "DDFK_APP: RESET command");
 
     return CFE_SUCCESS;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Send the run counts and times of every command the app dispatches          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 DDFK_APP_SendCmdStats(const DDFK_APP_SendCmdStatsCmd_t *Msg)
+{
+    DDFK_APP_Data.CmdCounter++;
+
+    MRLIB_SendCmdStats(&DDFK_APP_Dispatch, &DDFK_APP_Data.CmdStatsTlm);
+
+    return CFE_SUCCESS;
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
 /*  Purpose:                                                                  */
@@ -369,8 +487,9 @@ int32 DDFK_APP_Process(const DDFK_APP_ProcessCmd_t *Msg)
         return status;
     }
 
-    CFE_ES_WriteToSysLog("Differential Drive Forward Kinematics App: Table Value 1: %d  Value 2: %d", TblPtr->Int1,
-                         TblPtr->Int2);
+    CFE_ES_WriteToSysLog(
+        "Differential Drive Forward Kinematics App: Wheel radius %.4f m, track %.4f m, %.2f counts/rev",
+        TblPtr->WheelRadius, TblPtr->TrackWidth, TblPtr->CountsPerRev);
 
     DDFK_APP_GetCrc(TableName);
 
@@ -387,37 +506,487 @@ int32 DDFK_APP_Process(const DDFK_APP_ProcessCmd_t *Msg)
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
-/* Verify command packet length                                               */
+/* Set the pose of one Romi base, the odometry integrates on from there       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 DDFK_APP_SetPose(const DDFK_APP_SetPoseCmd_t *Msg)
+{
+    DDFK_APP_Robot_t *Robot;
+
+    if (Msg->Device >= DDFK_APP_MAX_ROBOTS)
+    {
+        DDFK_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(DDFK_APP_POSE_ERR_EID, CFE_EVS_EventType_ERROR, "DDFK_APP: No Romi base %u",
+                          (unsigned int)Msg->Device);
+        return CFE_SUCCESS;
+    }
+
+    Robot = &DDFK_APP_Data.Robot[Msg->Device];
+
+    /* Both poses are set, so either integrator carries on from here */
+    DDFK_APP_FixSetPose(&Robot->FixPose, Msg->X, Msg->Y, Msg->Heading);
+    DDFK_APP_FixToPose(&Robot->FixPose, &Robot->Pose);
+    Robot->Samples            = 0;
+    Robot->LostCycles         = 0;
+    Robot->VelocityMismatches = 0;
+
+    /* Interpolating across the jump would make up poses the base never had */
+    MRLIB_PoseClear(Msg->Device);
+
+    DDFK_APP_Data.CmdCounter++;
+
+    CFE_EVS_SendEvent(DDFK_APP_POSE_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "DDFK_APP: Romi base %u pose set to %ld mm, %ld mm, %ld mrad", (unsigned int)Msg->Device,
+                      (long)Msg->X, (long)Msg->Y, (long)Msg->Heading);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Look up the Romi base a drive command names, NULL if DDFK cannot drive it  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static DDFK_APP_Robot_t *DDFK_APP_DriveRobot(uint8 Device)
+{
+    const char *Reason = NULL;
+
+    /* The drive steps at the base's state packets, with the table's geometry and limits */
+    if (Device >= DDFK_APP_MAX_ROBOTS)
+    {
+        Reason = "does not exist";
+    }
+    else if (!DDFK_APP_Data.Robot[Device].Valid)
+    {
+        Reason = "has sent no state";
+    }
+    else if (DDFK_APP_Data.TrackWidth <= 0 || DDFK_APP_Data.StreamTimeoutMs == 0)
+    {
+        Reason = "has no table";
+    }
+
+    if (Reason != NULL)
+    {
+        DDFK_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(DDFK_APP_DRIVE_ERR_EID, CFE_EVS_EventType_ERROR, "DDFK_APP: Romi base %u %s",
+                          (unsigned int)Device, Reason);
+        return NULL;
+    }
+
+    return &DDFK_APP_Data.Robot[Device];
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Drive a Romi base at a body velocity.  Teleop sends these at its own       */
+/* rate, so they raise only a debug event.                                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 DDFK_APP_SetTwist(const DDFK_APP_SetTwistCmd_t *Msg)
+{
+    DDFK_APP_Robot_t *Robot = DDFK_APP_DriveRobot(Msg->Device);
+
+    if (Robot == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    Robot->DriveTwist.Speed    = Msg->Speed / 1000.0;
+    Robot->DriveTwist.TurnRate = Msg->TurnRate / 1000.0;
+    Robot->DriveTimeLeft       = Msg->DurationMs != 0 ? Msg->DurationMs / 1000.0 : INFINITY;
+    Robot->DriveMode           = DDFK_APP_DRIVE_TWIST;
+
+    DDFK_APP_Data.CmdCounter++;
+
+    CFE_EVS_SendEvent(DDFK_APP_DRIVE_INF_EID, CFE_EVS_EventType_DEBUG,
+                      "DDFK_APP: Romi base %u twist %d mm/s, %d mrad/s for %u ms", (unsigned int)Msg->Device,
+                      Msg->Speed, Msg->TurnRate, (unsigned int)Msg->DurationMs);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Drive a Romi base to a pose                                                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 DDFK_APP_GotoPose(const DDFK_APP_GotoPoseCmd_t *Msg)
+{
+    DDFK_APP_Robot_t *Robot = DDFK_APP_DriveRobot(Msg->Device);
+
+    if (Robot == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    Robot->DriveGoal.X       = Msg->X / 1000.0;
+    Robot->DriveGoal.Y       = Msg->Y / 1000.0;
+    Robot->DriveGoal.Heading = DDFK_APP_FkWrap(Msg->Heading / 1000.0);
+    Robot->DriveMode         = DDFK_APP_DRIVE_GOAL;
+
+    DDFK_APP_Data.CmdCounter++;
+
+    CFE_EVS_SendEvent(DDFK_APP_DRIVE_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "DDFK_APP: Romi base %u driving to %ld mm, %ld mm, %ld mrad", (unsigned int)Msg->Device,
+                      (long)Msg->X, (long)Msg->Y, (long)Msg->Heading);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Bring a Romi base to a stop within the acceleration limits                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 DDFK_APP_Stop(const DDFK_APP_StopCmd_t *Msg)
+{
+    DDFK_APP_Robot_t *Robot;
+
+    if (Msg->Device >= DDFK_APP_MAX_ROBOTS)
+    {
+        DDFK_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(DDFK_APP_DRIVE_ERR_EID, CFE_EVS_EventType_ERROR, "DDFK_APP: Romi base %u does not exist",
+                          (unsigned int)Msg->Device);
+        return CFE_SUCCESS;
+    }
+
+    /* Always taken, a base DDFK is not driving is already stopped as far as DDFK goes */
+    Robot = &DDFK_APP_Data.Robot[Msg->Device];
+    if (Robot->DriveMode != DDFK_APP_DRIVE_IDLE)
+    {
+        Robot->DriveMode = DDFK_APP_DRIVE_STOP;
+    }
+
+    DDFK_APP_Data.CmdCounter++;
+
+    CFE_EVS_SendEvent(DDFK_APP_DRIVE_INF_EID, CFE_EVS_EventType_INFORMATION, "DDFK_APP: Romi base %u stopping",
+                      (unsigned int)Msg->Device);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Integrate one ROMIMOT state packet into the odometry of its Romi base      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 DDFK_APP_ProcessState(const ROMIMOT_StateBatchTlm_t *Msg)
+{
+    const ROMIMOT_StateBatchPayload_t *Batch = &Msg->Payload;
+    DDFK_APP_Robot_t *                 Robot;
+    size_t                             ActualLength = 0;
+    CFE_TIME_SysTime_t                 PacketTime;
+    CFE_TIME_SysTime_t                 Offset;
+    CFE_TIME_SysTime_t                 Time;
+    MRLIB_Pose_t                       Pose;
+    bool                               Clocked;
+    uint32                             Micros;
+    double                             Dt = 0;
+    uint8                              i;
+
+    /*
+    ** The header must be there before SampleCount can be read, then the
+    ** packet must hold exactly the samples it claims
+    */
+    CFE_MSG_GetSize(CFE_MSG_PTR(Msg->TelemetryHeader), &ActualLength);
+    if (ActualLength < offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) || Batch->SampleCount == 0 ||
+        Batch->SampleCount > ROMIMOT_STATE_BATCH_MAX ||
+        ActualLength != offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) +
+                            Batch->SampleCount * sizeof(ROMIMOT_StateSample_t) ||
+        Batch->Instance >= DDFK_APP_MAX_ROBOTS)
+    {
+        DDFK_APP_Data.StateErrors++;
+        CFE_EVS_SendEvent(DDFK_APP_STATE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "DDFK_APP: Bad ROMIMOT state packet, length %u", (unsigned int)ActualLength);
+        return CFE_SUCCESS;
+    }
+
+    CFE_MSG_GetMsgTime(CFE_MSG_PTR(Msg->TelemetryHeader), &PacketTime);
+    Robot   = &DDFK_APP_Data.Robot[Batch->Instance];
+    Clocked = Robot->Valid;
+    Micros  = Robot->LastRomiMicros;
+
+    for (i = 0; i < Batch->SampleCount; i++)
+    {
+        Offset.Seconds    = Batch->Samples[i].TimeOffsetUs / 1000000;
+        Offset.Subseconds = CFE_TIME_Micro2SubSecs(Batch->Samples[i].TimeOffsetUs % 1000000);
+        Time              = CFE_TIME_Add(PacketTime, Offset);
+
+        DDFK_APP_IntegrateSample(Robot, &Batch->Samples[i], Batch->FirstCycle + i, Time);
+
+        /* Every sample's pose goes into the history other apps look up */
+        Pose.X       = Robot->Pose.X;
+        Pose.Y       = Robot->Pose.Y;
+        Pose.Heading = Robot->Pose.Heading;
+        MRLIB_PoseRecord(Batch->Instance, Time, &Pose);
+    }
+
+    DDFK_APP_Data.StatePackets++;
+
+    /* The drive runs on the Romi clock, at the rate the pose it steers by moves */
+    if (Robot->DriveMode != DDFK_APP_DRIVE_IDLE)
+    {
+        if (Clocked)
+        {
+            Dt = (Robot->LastRomiMicros - Micros) / 1.0e6;
+        }
+        DDFK_APP_DriveStep(Batch->Instance, Dt < DDFK_APP_DRIVE_DT_MAX ? Dt : DDFK_APP_DRIVE_DT_MAX);
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Whether a wheel's odometer travel over Dt is what its velocity makes of it */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-bool DDFK_APP_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength)
+static bool DDFK_APP_VelocityAgrees(int32 Counts, int16 Velocity, double Dt)
 {
-    bool              result       = true;
-    size_t            ActualLength = 0;
-    CFE_SB_MsgId_t    MsgId        = CFE_SB_INVALID_MSG_ID;
-    CFE_MSG_FcnCode_t FcnCode      = 0;
+    double Travel = Velocity * Dt;
 
-    CFE_MSG_GetSize(MsgPtr, &ActualLength);
+    return fabs(Counts - Travel) <= DDFK_APP_VELOCITY_SLACK_COUNTS + DDFK_APP_VELOCITY_SLACK_SHARE * fabs(Travel);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Move a Romi base's pose by the wheel travel since its last sample          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_IntegrateSample(DDFK_APP_Robot_t *Robot, const ROMIMOT_StateSample_t *Sample, uint32 Cycle,
+                              CFE_TIME_SysTime_t Time)
+{
+    int32  LeftCounts;
+    int32  RightCounts;
+    double Left;
+    double Right;
+    double Dt;
 
     /*
-    ** Verify the command packet length.
+    ** A cycle that does not move forward is a restarted ROMIMOT, and a
+    ** table that never loaded leaves no geometry, either way the sample
+    ** only becomes the new baseline
     */
-    if (ExpectedLength != ActualLength)
+    if (Robot->Valid && (int32)(Cycle - Robot->LastCycle) > 0 && DDFK_APP_Data.TrackWidth > 0)
     {
-        CFE_MSG_GetMsgId(MsgPtr, &MsgId);
-        CFE_MSG_GetFcnCode(MsgPtr, &FcnCode);
+        /*
+        ** The odometers are totals, so their difference spans any samples
+        ** lost in between, which are bridged as one arc.  The encoder
+        ** deltas would drop the travel of a lost packet.
+        */
+        Robot->LostCycles += Cycle - Robot->LastCycle - 1;
 
-        CFE_EVS_SendEvent(DDFK_APP_LEN_ERR_EID, CFE_EVS_EventType_ERROR,
-                          "Invalid Msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u",
-                          (unsigned int)CFE_SB_MsgIdToValue(MsgId), (unsigned int)FcnCode, (unsigned int)ActualLength,
-                          (unsigned int)ExpectedLength);
+        /* Unsigned differences stay right across an odometer wrap */
+        LeftCounts  = (int32)((uint32)Sample->LeftMotorOdometer - (uint32)Robot->LastLeftOdo);
+        RightCounts = (int32)((uint32)Sample->RightMotorOdometer - (uint32)Robot->LastRightOdo);
 
-        result = false;
+        if (DDFK_APP_Data.Integrator == DDFK_APP_INTEGRATOR_FIXED)
+        {
+            DDFK_APP_FixArc(&Robot->FixPose, LeftCounts, RightCounts, &DDFK_APP_Data.FixGeometry);
+            DDFK_APP_FixToPose(&Robot->FixPose, &Robot->Pose);
+        }
+        else
+        {
+            Left  = LeftCounts * DDFK_APP_Data.MetersPerCount;
+            Right = RightCounts * DDFK_APP_Data.MetersPerCount;
 
-        DDFK_APP_Data.ErrCounter++;
+            DDFK_APP_FkArc(&Robot->Pose, Left, Right, DDFK_APP_Data.TrackWidth);
+        }
+
+        /*
+        ** The rates are the firmware's own wheel velocities, not the
+        ** odometer travel over Dt, which moves in whole counts and
+        ** averages over any lost cycles
+        */
+        Robot->Speed    = 0.5 * (Sample->LeftVelocity + Sample->RightVelocity) * DDFK_APP_Data.MetersPerCount;
+        Robot->TurnRate = (Sample->RightVelocity - Sample->LeftVelocity) * DDFK_APP_Data.MetersPerCount /
+                          DDFK_APP_Data.TrackWidth;
+
+        /* Over a single cycle the odometers check the velocities */
+        Dt = (Sample->RomiMicros - Robot->LastRomiMicros) / 1.0e6;
+        if (Cycle - Robot->LastCycle == 1 && Dt > 0 &&
+            (!DDFK_APP_VelocityAgrees(LeftCounts, Sample->LeftVelocity, Dt) ||
+             !DDFK_APP_VelocityAgrees(RightCounts, Sample->RightVelocity, Dt)))
+        {
+            Robot->VelocityMismatches++;
+        }
+
+        Robot->Samples++;
+    }
+
+    Robot->Valid          = true;
+    Robot->LastCycle      = Cycle;
+    Robot->LastLeftOdo    = Sample->LeftMotorOdometer;
+    Robot->LastRightOdo   = Sample->RightMotorOdometer;
+    Robot->LastRomiMicros = Sample->RomiMicros;
+    Robot->Time           = Time;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Wheel speed in the counts/s ROMIMOT takes                                  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int16 DDFK_APP_WheelCounts(double Speed)
+{
+    double Counts = round(Speed / DDFK_APP_Data.MetersPerCount);
+
+    if (Counts > ROMIMOT_STREAM_SPEED_MAX)
+    {
+        return ROMIMOT_STREAM_SPEED_MAX;
+    }
+    if (Counts < -ROMIMOT_STREAM_SPEED_MAX)
+    {
+        return -ROMIMOT_STREAM_SPEED_MAX;
     }
 
-    return result;
+    return (int16)Counts;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Send a Romi base the wheel speeds for its drive command, Dt after the last */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_DriveStep(uint8 Instance, double Dt)
+{
+    DDFK_APP_Robot_t *Robot = &DDFK_APP_Data.Robot[Instance];
+    DDFK_APP_Twist_t  Twist = {0, 0};
+    double            Left;
+    double            Right;
+
+    if (Robot->DriveMode == DDFK_APP_DRIVE_TWIST)
+    {
+        Robot->DriveTimeLeft -= Dt;
+        if (Robot->DriveTimeLeft > 0)
+        {
+            Twist = Robot->DriveTwist;
+        }
+        else
+        {
+            Robot->DriveMode = DDFK_APP_DRIVE_STOP;
+        }
+    }
+    else if (Robot->DriveMode == DDFK_APP_DRIVE_GOAL &&
+             DDFK_APP_IkGoal(&Robot->Pose, &Robot->DriveGoal, &DDFK_APP_Data.GoalGains, &Twist))
+    {
+        Robot->DriveMode = DDFK_APP_DRIVE_STOP;
+        CFE_EVS_SendEvent(DDFK_APP_DRIVE_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "DDFK_APP: Romi base %u reached its goal", (unsigned int)Instance);
+    }
+
+    DDFK_APP_IkLimit(&Twist, &Robot->DriveSent, &DDFK_APP_Data.DriveLimits, DDFK_APP_Data.TrackWidth, Dt);
+    Robot->DriveSent = Twist;
+
+    DDFK_APP_IkWheels(&Twist, DDFK_APP_Data.TrackWidth, &Left, &Right);
+    Robot->VelocityCmd.SpeedLeft  = DDFK_APP_WheelCounts(Left);
+    Robot->VelocityCmd.SpeedRight = DDFK_APP_WheelCounts(Right);
+    Robot->VelocityCmd.TimeoutMs  = DDFK_APP_Data.StreamTimeoutMs;
+
+    CFE_SB_TransmitMsg(CFE_MSG_PTR(Robot->VelocityCmd.CmdHeader), true);
+
+    /* A stop is over once the zero setpoint that ends the stream has gone */
+    if (Robot->DriveMode == DDFK_APP_DRIVE_STOP && Robot->VelocityCmd.SpeedLeft == 0 &&
+        Robot->VelocityCmd.SpeedRight == 0)
+    {
+        Robot->DriveMode          = DDFK_APP_DRIVE_IDLE;
+        Robot->DriveSent.Speed    = 0;
+        Robot->DriveSent.TurnRate = 0;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Send the pose of every Romi base heard from                                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 DDFK_APP_Wakeup(const CFE_MSG_CommandHeader_t *Msg)
+{
+    DDFK_APP_Robot_t *Robot;
+    int               i;
+
+    for (i = 0; i < DDFK_APP_MAX_ROBOTS; i++)
+    {
+        Robot = &DDFK_APP_Data.Robot[i];
+        if (!Robot->Valid)
+        {
+            continue;
+        }
+
+        Robot->PoseTlm.Payload.DriveMode          = Robot->DriveMode;
+        Robot->PoseTlm.Payload.Samples            = Robot->Samples;
+        Robot->PoseTlm.Payload.LostCycles         = Robot->LostCycles;
+        Robot->PoseTlm.Payload.X                  = Robot->Pose.X;
+        Robot->PoseTlm.Payload.Y                  = Robot->Pose.Y;
+        Robot->PoseTlm.Payload.Heading            = Robot->Pose.Heading;
+        Robot->PoseTlm.Payload.Speed              = (float)Robot->Speed;
+        Robot->PoseTlm.Payload.TurnRate           = (float)Robot->TurnRate;
+        Robot->PoseTlm.Payload.VelocityMismatches = Robot->VelocityMismatches;
+
+        CFE_MSG_SetMsgTime(CFE_MSG_PTR(Robot->PoseTlm.TelemetryHeader), Robot->Time);
+        CFE_SB_TransmitMsg(CFE_MSG_PTR(Robot->PoseTlm.TelemetryHeader), true);
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Take the robot geometry and integrator from the table                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_ApplyTableConfig(void)
+{
+    DDFK_APP_Table_t *TblPtr;
+    int32             Status;
+    uint16            Integrator;
+    int               i;
+
+    Status = CFE_TBL_GetAddress((void *)&TblPtr, DDFK_APP_Data.TblHandles[0]);
+    if (Status < CFE_SUCCESS)
+    {
+        return;
+    }
+
+    DDFK_APP_Data.MetersPerCount = 2.0 * DDFK_APP_PI * TblPtr->WheelRadius / TblPtr->CountsPerRev;
+    DDFK_APP_Data.TrackWidth     = TblPtr->TrackWidth;
+    Integrator                   = TblPtr->Integrator;
+
+    DDFK_APP_Data.DriveLimits.MaxSpeed      = TblPtr->MaxSpeed;
+    DDFK_APP_Data.DriveLimits.MaxTurnRate   = TblPtr->MaxTurnRate;
+    DDFK_APP_Data.DriveLimits.MaxAccel      = TblPtr->MaxAccel;
+    DDFK_APP_Data.DriveLimits.MaxTurnAccel  = TblPtr->MaxTurnAccel;
+    DDFK_APP_Data.DriveLimits.MaxWheelSpeed = ROMIMOT_STREAM_SPEED_MAX * DDFK_APP_Data.MetersPerCount;
+
+    DDFK_APP_Data.GoalGains.GainDistance     = TblPtr->GoalGainDistance;
+    DDFK_APP_Data.GoalGains.GainBearing      = TblPtr->GoalGainBearing;
+    DDFK_APP_Data.GoalGains.GainHeading      = TblPtr->GoalGainHeading;
+    DDFK_APP_Data.GoalGains.Tolerance        = TblPtr->GoalTolerance;
+    DDFK_APP_Data.GoalGains.HeadingTolerance = TblPtr->GoalHeadingTolerance;
+    DDFK_APP_Data.StreamTimeoutMs            = TblPtr->StreamTimeoutMs;
+
+    CFE_TBL_ReleaseAddress(DDFK_APP_Data.TblHandles[0]);
+
+    /* Validation has already checked the geometry fits, fall back rather than trust it */
+    if (Integrator == DDFK_APP_INTEGRATOR_FIXED &&
+        !DDFK_APP_FixSetGeometry(&DDFK_APP_Data.FixGeometry, DDFK_APP_Data.MetersPerCount, DDFK_APP_Data.TrackWidth))
+    {
+        Integrator = DDFK_APP_INTEGRATOR_DOUBLE;
+    }
+
+    /*
+    ** The fixed-point integrator keeps Pose up to date as it goes, so only a
+    ** switch to it has a pose to carry over
+    */
+    if (Integrator == DDFK_APP_INTEGRATOR_FIXED && DDFK_APP_Data.Integrator != DDFK_APP_INTEGRATOR_FIXED)
+    {
+        for (i = 0; i < DDFK_APP_MAX_ROBOTS; i++)
+        {
+            DDFK_APP_FixFromPose(&DDFK_APP_Data.Robot[i].Pose, &DDFK_APP_Data.Robot[i].FixPose);
+        }
+    }
+
+    DDFK_APP_Data.Integrator = Integrator;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
@@ -427,15 +996,50 @@ bool DDFK_APP_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 int32 DDFK_APP_TblValidationFunc(void *TblData)
 {
-    int32             ReturnCode = CFE_SUCCESS;
-    DDFK_APP_Table_t *TblDataPtr = (DDFK_APP_Table_t *)TblData;
+    int32                  ReturnCode = CFE_SUCCESS;
+    DDFK_APP_Table_t *     TblDataPtr = (DDFK_APP_Table_t *)TblData;
+    DDFK_APP_FixGeometry_t FixGeometry;
 
     /*
-    ** Differential Drive Forward Kinematics Table Validation
+    ** Differential Drive Forward Kinematics Table Validation.
+    ** Written so a NaN fails every check
     */
-    if (TblDataPtr->Int1 > DDFK_APP_TBL_ELEMENT_1_MAX)
+    if (!(TblDataPtr->WheelRadius > 0 && TblDataPtr->WheelRadius <= DDFK_APP_WHEEL_RADIUS_MAX) ||
+        !(TblDataPtr->TrackWidth > 0 && TblDataPtr->TrackWidth <= DDFK_APP_TRACK_WIDTH_MAX) ||
+        !(TblDataPtr->CountsPerRev > 0 && TblDataPtr->CountsPerRev < INFINITY) ||
+        TblDataPtr->Integrator > DDFK_APP_INTEGRATOR_FIXED)
+    {
+        ReturnCode = DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (!MRLIB_RtValidate(&TblDataPtr->RtProfile))
+    {
+        ReturnCode = DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (TblDataPtr->StreamTimeoutMs < 1 || TblDataPtr->StreamTimeoutMs > ROMIMOT_STREAM_TIMEOUT_MAX_MS ||
+             !(TblDataPtr->MaxSpeed > 0 && TblDataPtr->MaxSpeed <= DDFK_APP_SPEED_MAX) ||
+             !(TblDataPtr->MaxTurnRate > 0 && TblDataPtr->MaxTurnRate <= DDFK_APP_TURN_RATE_MAX) ||
+             !(TblDataPtr->MaxAccel > 0 && TblDataPtr->MaxAccel < INFINITY) ||
+             !(TblDataPtr->MaxTurnAccel > 0 && TblDataPtr->MaxTurnAccel < INFINITY) ||
+             !(TblDataPtr->GoalTolerance > 0 && TblDataPtr->GoalTolerance <= DDFK_APP_GOAL_TOLERANCE_MAX) ||
+             !(TblDataPtr->GoalHeadingTolerance > 0 &&
+               TblDataPtr->GoalHeadingTolerance <= DDFK_APP_GOAL_HEADING_TOLERANCE_MAX))
+    {
+        ReturnCode = DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (!(TblDataPtr->GoalGainDistance > 0 && TblDataPtr->GoalGainDistance < INFINITY) ||
+             !(TblDataPtr->GoalGainBearing > TblDataPtr->GoalGainDistance &&
+               TblDataPtr->GoalGainBearing < INFINITY) ||
+             !(TblDataPtr->GoalGainHeading < 0 && TblDataPtr->GoalGainHeading > -INFINITY))
+    {
+        /* Outside these the goal controller is not stable */
+        ReturnCode = DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (TblDataPtr->Integrator == DDFK_APP_INTEGRATOR_FIXED &&
+             !DDFK_APP_FixSetGeometry(&FixGeometry,
+                                      2.0 * DDFK_APP_PI * TblDataPtr->WheelRadius / TblDataPtr->CountsPerRev,
+                                      TblDataPtr->TrackWidth))
     {
-        /* First element is out of range, return an appropriate error code */
+        /* The fixed-point step needs a count of Right - Left to turn less than half a turn */
         ReturnCode = DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
     }
 
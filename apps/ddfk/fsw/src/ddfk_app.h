@@ -37,22 +37,88 @@
 #include "ddfk_app_perfids.h"
 #include "ddfk_app_msgids.h"
 #include "ddfk_app_msg.h"
+#include "ddfk_app_fk.h"
+#include "ddfk_app_fix.h"
+#include "ddfk_app_ik.h"
+
+#include "romimot_msgids.h"
+#include "romimot_table.h"
+#include "romimot_state_msg.h"
+#include "romimot_drive_msg.h"
+
+#include "mrlib.h"
 
 /***********************************************************************/
 #define DDFK_APP_PIPE_DEPTH 32 /* Depth of the Command Pipe for Application */
 
 #define DDFK_APP_NUMBER_OF_TABLES 1 /* Number of Table(s) */
 
+#define DDFK_APP_EVENT_FILTERS 1 /* Number of filtered event IDs */
+
+#define DDFK_APP_MAX_ROBOTS ROMIMOT_MAX_DEVICES /* One pose per Romi base ROMIMOT can drive */
+
+#if DDFK_APP_MAX_ROBOTS > MRLIB_POSE_MAX_ROBOTS
+#error "MRLIB_POSE_MAX_ROBOTS must cover every Romi base DDFK integrates"
+#endif
+
+/*
+** Longest gap between state packets one drive step spans, so a stalled or
+** restarted ROMIMOT cannot make the acceleration limits allow a jump
+*/
+#define DDFK_APP_DRIVE_DT_MAX 0.1 /* s */
+
+/*
+** Room the odometer travel of a control cycle has around the travel the
+** firmware velocities make of it, before the two count as disagreeing: the
+** odometers move in whole counts, and the firmware measures over its own
+** window, which lags the odometers while the wheels speed up or slow down
+*/
+#define DDFK_APP_VELOCITY_SLACK_COUNTS 2    /* counts */
+#define DDFK_APP_VELOCITY_SLACK_SHARE  0.25 /* of the travel the velocity makes */
+
 /* Define filenames of default data images for tables */
 #define DDFK_APP_TABLE_FILE "/cf/ddfk_app_tbl.tbl"
 
 #define DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE -1
-
-#define DDFK_APP_TBL_ELEMENT_1_MAX 10
 /************************************************************************
 ** Type Definitions
 *************************************************************************/
 
+/*
+** Odometry of one Romi base, integrated from its ROMIMOT state samples
+*/
+typedef struct
+{
+    bool Valid; /* A state sample has been seen, the Last* fields are set */
+
+    uint32 LastCycle; /* ROMIMOT control cycle of the last sample */
+    int32  LastLeftOdo;
+    int32  LastRightOdo;
+    uint32 LastRomiMicros;
+
+    DDFK_APP_Pose_t    Pose;
+    DDFK_APP_FixPose_t FixPose;            /* The pose itself under DDFK_APP_INTEGRATOR_FIXED, Pose follows it */
+    double             Speed;              /* m/s, from the firmware wheel velocities */
+    double             TurnRate;           /* rad/s, from the firmware wheel velocities */
+    CFE_TIME_SysTime_t Time;               /* Of the last sample */
+    uint32             Samples;
+    uint32             LostCycles;
+    uint32             VelocityMismatches; /* Cycles the odometers and wheel velocities disagreed over */
+
+    /*
+    ** Drive command, stepped at each state packet and streamed to ROMIMOT
+    ** as wheel speeds
+    */
+    uint8                    DriveMode;     /* DDFK_APP_DRIVE_* */
+    DDFK_APP_Twist_t         DriveTwist;    /* Under DDFK_APP_DRIVE_TWIST */
+    double                   DriveTimeLeft; /* s the twist is held for, INFINITY until the next command */
+    DDFK_APP_Pose_t          DriveGoal;     /* Under DDFK_APP_DRIVE_GOAL */
+    DDFK_APP_Twist_t         DriveSent;     /* Last sent, within the limits */
+    ROMIMOT_SetVelocityCmd_t VelocityCmd;
+
+    DDFK_APP_PoseTlm_t PoseTlm;
+} DDFK_APP_Robot_t;
+
 /*
 ** Global Data
 */
@@ -69,6 +135,43 @@ typedef struct
     */
     DDFK_APP_HkTlm_t HkTlm;
 
+    /*
+    ** Dispatch statistics packet, sent on DDFK_APP_SEND_CMD_STATS_CC
+    */
+    MRLIB_CmdStatsTlm_t CmdStatsTlm;
+
+    /*
+    ** Robot geometry from the table
+    */
+    double                 MetersPerCount;
+    double                 TrackWidth;
+    DDFK_APP_FixGeometry_t FixGeometry;
+    uint16                 Integrator;
+
+    /*
+    ** Drive limits and goal controller from the table
+    */
+    DDFK_APP_IkLimits_t    DriveLimits;
+    DDFK_APP_IkGoalGains_t GoalGains;
+    uint16                 StreamTimeoutMs;
+
+    /*
+    ** Odometry, indexed by ROMIMOT instance
+    */
+    DDFK_APP_Robot_t Robot[DDFK_APP_MAX_ROBOTS];
+    uint32           StatePackets;
+    uint32           StateErrors;
+
+    /*
+    ** What the task got from the table's real-time profile
+    */
+    MRLIB_RtStatus_t RtStatus;
+
+    /*
+    ** Event filters, a bad state packet arrives at the state telemetry rate
+    */
+    CFE_EVS_BinFilter_t EventFilters[DDFK_APP_EVENT_FILTERS];
+
     /*
     ** Run Status variable used in the main processing loop
     */
@@ -97,16 +200,27 @@ typedef struct
 */
 void  DDFK_APP_Main(void);
 int32 DDFK_APP_Init(void);
+void  DDFK_APP_ApplyRtProfile(const MRLIB_RtProfile_t *Profile);
 void  DDFK_APP_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr);
-void  DDFK_APP_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr);
 int32 DDFK_APP_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg);
 int32 DDFK_APP_ResetCounters(const DDFK_APP_ResetCountersCmd_t *Msg);
 int32 DDFK_APP_Process(const DDFK_APP_ProcessCmd_t *Msg);
 int32 DDFK_APP_Noop(const DDFK_APP_NoopCmd_t *Msg);
+int32 DDFK_APP_SetPose(const DDFK_APP_SetPoseCmd_t *Msg);
+int32 DDFK_APP_SetTwist(const DDFK_APP_SetTwistCmd_t *Msg);
+int32 DDFK_APP_GotoPose(const DDFK_APP_GotoPoseCmd_t *Msg);
+int32 DDFK_APP_Stop(const DDFK_APP_StopCmd_t *Msg);
+int32 DDFK_APP_SendCmdStats(const DDFK_APP_SendCmdStatsCmd_t *Msg);
+void  DDFK_APP_DriveStep(uint8 Instance, double Dt);
+int32 DDFK_APP_ProcessState(const ROMIMOT_StateBatchTlm_t *Msg);
+void  DDFK_APP_IntegrateSample(DDFK_APP_Robot_t *Robot, const ROMIMOT_StateSample_t *Sample, uint32 Cycle,
+                               CFE_TIME_SysTime_t Time);
+int32 DDFK_APP_Wakeup(const CFE_MSG_CommandHeader_t *Msg);
+void  DDFK_APP_ApplyTableConfig(void);
 void  DDFK_APP_GetCrc(const char *TableName);
 
 int32 DDFK_APP_TblValidationFunc(void *TblData);
 
-bool DDFK_APP_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength);
+extern const MRLIB_Dispatch_t DDFK_APP_Dispatch;
 
 #endif /* DDFK_APP_H */
@@ -0,0 +1,303 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   Batch differential drive forward kinematics.
+ */
+
+/*
+** Include Files:
+*/
+#include "ddfk_app_batch.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifdef __GNUC__
+
+#define DDFK_APP_BATCH_LANES 4   /* Samples per vector, one AVX register or two SSE or NEON ones */
+#define DDFK_APP_BATCH_BLOCK 128 /* Samples per pass, so a block's passes stay in the L1 cache */
+
+/*
+** GCC and clang vectors, which the compiler lowers to whichever of SSE,
+** AVX or NEON the target has
+*/
+typedef double DDFK_APP_BatchVec_t __attribute__((vector_size(DDFK_APP_BATCH_LANES * sizeof(double))));
+typedef uint64 DDFK_APP_BatchBits_t __attribute__((vector_size(DDFK_APP_BATCH_LANES * sizeof(uint64))));
+typedef int32  DDFK_APP_BatchCounts_t __attribute__((vector_size(DDFK_APP_BATCH_LANES * sizeof(int32))));
+
+/*
+** Adding 1.5 * 2^52 rounds a double to the nearest integer, which is then
+** the low bits of the sum
+*/
+#define DDFK_APP_BATCH_ROUNDER     6755399441055744.0
+#define DDFK_APP_BATCH_TWO_OVER_PI 0.63661977236758134308
+#define DDFK_APP_BATCH_ONE_OVER_2PI 0.15915494309189533577
+#define DDFK_APP_BATCH_SIGN        0x8000000000000000u
+
+/*
+** pi/2 in three parts of 33 bits, so that a whole number of quarter turns
+** times each part is exact (the Cody-Waite split of fdlibm)
+*/
+#define DDFK_APP_BATCH_PIO2_1 1.57079632673412561417e+00
+#define DDFK_APP_BATCH_PIO2_2 6.07710050630396597660e-11
+#define DDFK_APP_BATCH_PIO2_3 2.02226624871116645580e-21
+
+/*
+** Minimax sine and cosine on -pi/4..pi/4, from fdlibm's __kernel_sin and
+** __kernel_cos, good to within an ulp
+*/
+#define DDFK_APP_BATCH_S1 -1.66666666666666324348e-01
+#define DDFK_APP_BATCH_S2 8.33333333332248946124e-03
+#define DDFK_APP_BATCH_S3 -1.98412698298579493134e-04
+#define DDFK_APP_BATCH_S4 2.75573137070700676789e-06
+#define DDFK_APP_BATCH_S5 -2.50507602534068634195e-08
+#define DDFK_APP_BATCH_S6 1.58969099521155010221e-10
+#define DDFK_APP_BATCH_C1 4.16666666666666019037e-02
+#define DDFK_APP_BATCH_C2 -1.38888888888741095749e-03
+#define DDFK_APP_BATCH_C3 2.48015872894767294178e-05
+#define DDFK_APP_BATCH_C4 -2.75573143513906633035e-07
+#define DDFK_APP_BATCH_C5 2.08757232129817482790e-09
+#define DDFK_APP_BATCH_C6 -1.13596475577881948265e-11
+
+/*
+** Below this half turn sin(x)/x comes from its series, as in DDFK_APP_FkArc()
+*/
+#define DDFK_APP_BATCH_SINC_SERIES 1.0e-4
+
+/*
+** Per lane, A where Mask is set and B elsewhere.  The helpers below take
+** vectors by pointer or as macros, as passing one by value changes with
+** the instruction set enabled.
+*/
+#define DDFK_APP_BATCH_SELECT(Mask, A, B) \
+    ((DDFK_APP_BatchVec_t)(((DDFK_APP_BatchBits_t)(A) & (Mask)) | ((DDFK_APP_BatchBits_t)(B) & ~(Mask))))
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Sine and cosine of every lane, without a branch                            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void DDFK_APP_BatchSinCos(const DDFK_APP_BatchVec_t *Angle, DDFK_APP_BatchVec_t *Sin,
+                                 DDFK_APP_BatchVec_t *Cos)
+{
+    DDFK_APP_BatchVec_t  Shifted  = *Angle * DDFK_APP_BATCH_TWO_OVER_PI + DDFK_APP_BATCH_ROUNDER;
+    DDFK_APP_BatchVec_t  Quarters = Shifted - DDFK_APP_BATCH_ROUNDER;
+    DDFK_APP_BatchBits_t Quadrant = (DDFK_APP_BatchBits_t)Shifted;
+    DDFK_APP_BatchBits_t Odd;
+    DDFK_APP_BatchVec_t  R;
+    DDFK_APP_BatchVec_t  Z;
+    DDFK_APP_BatchVec_t  Hz;
+    DDFK_APP_BatchVec_t  W;
+    DDFK_APP_BatchVec_t  S;
+    DDFK_APP_BatchVec_t  C;
+
+    /* Reduce to -pi/4..pi/4 and the quarter turn it lies in */
+    R = *Angle - Quarters * DDFK_APP_BATCH_PIO2_1;
+    R = R - Quarters * DDFK_APP_BATCH_PIO2_2;
+    R = R - Quarters * DDFK_APP_BATCH_PIO2_3;
+    Z = R * R;
+
+    S = R + R * Z *
+                (DDFK_APP_BATCH_S1 +
+                 Z * (DDFK_APP_BATCH_S2 +
+                      Z * (DDFK_APP_BATCH_S3 + Z * (DDFK_APP_BATCH_S4 + Z * (DDFK_APP_BATCH_S5 + Z * DDFK_APP_BATCH_S6)))));
+
+    Hz = 0.5 * Z;
+    W  = 1.0 - Hz;
+    C  = W + (((1.0 - W) - Hz) +
+             Z * Z *
+                 (DDFK_APP_BATCH_C1 +
+                  Z * (DDFK_APP_BATCH_C2 +
+                       Z * (DDFK_APP_BATCH_C3 + Z * (DDFK_APP_BATCH_C4 + Z * (DDFK_APP_BATCH_C5 + Z * DDFK_APP_BATCH_C6))))));
+
+    /*
+    ** Each quarter turn swaps sine and cosine, and the sign bits follow
+    ** the quadrant: sin is negative in the 3rd and 4th, cos in the 2nd and 3rd
+    */
+    Odd  = -(Quadrant & 1);
+    *Sin = DDFK_APP_BATCH_SELECT(Odd, C, S);
+    *Cos = DDFK_APP_BATCH_SELECT(Odd, S, C);
+    *Sin = (DDFK_APP_BatchVec_t)((DDFK_APP_BatchBits_t)*Sin ^ ((Quadrant & 2) << 62));
+    *Cos = (DDFK_APP_BatchVec_t)((DDFK_APP_BatchBits_t)*Cos ^ (((Quadrant + 1) & 2) << 62));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Wrap every lane into -pi..pi                                               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void DDFK_APP_BatchWrap(DDFK_APP_BatchVec_t *Angle)
+{
+    DDFK_APP_BatchVec_t Turns =
+        (*Angle * DDFK_APP_BATCH_ONE_OVER_2PI + DDFK_APP_BATCH_ROUNDER) - DDFK_APP_BATCH_ROUNDER;
+
+    *Angle = *Angle - Turns * (4 * DDFK_APP_BATCH_PIO2_1);
+    *Angle = *Angle - Turns * (4 * DDFK_APP_BATCH_PIO2_2);
+    *Angle = *Angle - Turns * (4 * DDFK_APP_BATCH_PIO2_3);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Integrate a run of samples, a block at a time                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_FkBatch(DDFK_APP_Pose_t *Pose, const DDFK_APP_Batch_t *Batch, double MetersPerCount, double TrackWidth)
+{
+    int32                  LeftBuf[DDFK_APP_BATCH_BLOCK];
+    int32                  RightBuf[DDFK_APP_BATCH_BLOCK];
+    double                 HalfBuf[DDFK_APP_BATCH_BLOCK];
+    double                 ChordBuf[DDFK_APP_BATCH_BLOCK];
+    double                 MidBuf[DDFK_APP_BATCH_BLOCK];
+    double                 HeadingBuf[DDFK_APP_BATCH_BLOCK];
+    double                 DxBuf[DDFK_APP_BATCH_BLOCK];
+    double                 DyBuf[DDFK_APP_BATCH_BLOCK];
+    DDFK_APP_BatchCounts_t Counts;
+    DDFK_APP_BatchVec_t    Left;
+    DDFK_APP_BatchVec_t    Right;
+    DDFK_APP_BatchVec_t    Distance;
+    DDFK_APP_BatchVec_t    Half;
+    DDFK_APP_BatchVec_t    Mid;
+    DDFK_APP_BatchVec_t    Sin;
+    DDFK_APP_BatchVec_t    Cos;
+    DDFK_APP_BatchBits_t   Series;
+    double                 X       = Pose->X;
+    double                 Y       = Pose->Y;
+    double                 Heading = Pose->Heading;
+    uint32                 Done;
+    uint32                 Size;
+    uint32                 Padded;
+    uint32                 i;
+
+    for (Done = 0; Done < Batch->Count; Done += Size)
+    {
+        Size   = Batch->Count - Done < DDFK_APP_BATCH_BLOCK ? Batch->Count - Done : DDFK_APP_BATCH_BLOCK;
+        Padded = (Size + DDFK_APP_BATCH_LANES - 1) / DDFK_APP_BATCH_LANES * DDFK_APP_BATCH_LANES;
+
+        /* The lanes past the last sample roll nothing */
+        memcpy(LeftBuf, &Batch->LeftCounts[Done], Size * sizeof(LeftBuf[0]));
+        memcpy(RightBuf, &Batch->RightCounts[Done], Size * sizeof(RightBuf[0]));
+        for (i = Size; i < Padded; i++)
+        {
+            LeftBuf[i]  = 0;
+            RightBuf[i] = 0;
+        }
+
+        /*
+        ** Each sample's turn and chord, which depend on its counts alone
+        */
+        for (i = 0; i < Padded; i += DDFK_APP_BATCH_LANES)
+        {
+            memcpy(&Counts, &LeftBuf[i], sizeof(Counts));
+            Left = __builtin_convertvector(Counts, DDFK_APP_BatchVec_t) * MetersPerCount;
+            memcpy(&Counts, &RightBuf[i], sizeof(Counts));
+            Right = __builtin_convertvector(Counts, DDFK_APP_BatchVec_t) * MetersPerCount;
+
+            Distance = 0.5 * (Left + Right);
+            Half     = 0.5 * (Right - Left) / TrackWidth;
+
+            DDFK_APP_BatchSinCos(&Half, &Sin, &Cos);
+            Series = (DDFK_APP_BatchBits_t)((DDFK_APP_BatchVec_t)((DDFK_APP_BatchBits_t)Half & ~DDFK_APP_BATCH_SIGN) <
+                                            DDFK_APP_BATCH_SINC_SERIES);
+
+            memcpy(&HalfBuf[i], &Half, sizeof(Half));
+            Half = DDFK_APP_BATCH_SELECT(Series, Distance * (1.0 - Half * Half / 6.0), Distance * Sin / Half);
+            memcpy(&ChordBuf[i], &Half, sizeof(Half));
+        }
+
+        /*
+        ** The heading prefix sum, in the order DDFK_APP_FkArc() adds, with
+        ** each sample's chord pointing halfway through its turn
+        */
+        for (i = 0; i < Size; i++)
+        {
+            MidBuf[i] = Heading + HalfBuf[i];
+            Heading += 2.0 * HalfBuf[i];
+            HeadingBuf[i] = Heading;
+        }
+        for (; i < Padded; i++)
+        {
+            MidBuf[i]     = 0;
+            HeadingBuf[i] = 0;
+        }
+
+        /*
+        ** Every sample's step, now its heading is known
+        */
+        for (i = 0; i < Padded; i += DDFK_APP_BATCH_LANES)
+        {
+            memcpy(&Mid, &MidBuf[i], sizeof(Mid));
+            memcpy(&Distance, &ChordBuf[i], sizeof(Distance));
+            DDFK_APP_BatchSinCos(&Mid, &Sin, &Cos);
+
+            Cos = Distance * Cos;
+            Sin = Distance * Sin;
+            memcpy(&DxBuf[i], &Cos, sizeof(Cos));
+            memcpy(&DyBuf[i], &Sin, sizeof(Sin));
+
+            memcpy(&Mid, &HeadingBuf[i], sizeof(Mid));
+            DDFK_APP_BatchWrap(&Mid);
+            memcpy(&HeadingBuf[i], &Mid, sizeof(Mid));
+        }
+
+        /*
+        ** The position prefix sums
+        */
+        for (i = 0; i < Size; i++)
+        {
+            X += DxBuf[i];
+            Y += DyBuf[i];
+
+            Batch->X[Done + i]       = X;
+            Batch->Y[Done + i]       = Y;
+            Batch->Heading[Done + i] = HeadingBuf[i];
+        }
+
+        /* Each block starts from a wrapped heading, so the reduction stays exact */
+        Heading = DDFK_APP_FkWrap(Heading);
+    }
+
+    Pose->X       = X;
+    Pose->Y       = Y;
+    Pose->Heading = Heading;
+}
+
+#else
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Integrate a run of samples one at a time, without compiler vectors         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_FkBatch(DDFK_APP_Pose_t *Pose, const DDFK_APP_Batch_t *Batch, double MetersPerCount, double TrackWidth)
+{
+    uint32 i;
+
+    for (i = 0; i < Batch->Count; i++)
+    {
+        DDFK_APP_FkArc(Pose, Batch->LeftCounts[i] * MetersPerCount, Batch->RightCounts[i] * MetersPerCount,
+                       TrackWidth);
+
+        Batch->X[i]       = Pose->X;
+        Batch->Y[i]       = Pose->Y;
+        Batch->Heading[i] = Pose->Heading;
+    }
+}
+
+#endif /* __GNUC__ */
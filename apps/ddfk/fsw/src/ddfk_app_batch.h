@@ -0,0 +1,62 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Batch differential drive forward kinematics, for reprocessing recorded
+ * encoder counts on the ground
+ *
+ * The same arcs as DDFK_APP_FkArc(), taken as two prefix sums: the heading
+ * before each sample is the start heading plus the turns of the samples
+ * before it, after which every sample's step along its arc is independent
+ * of the others, and the positions are the running sum of those steps.
+ * The independent parts run several samples at a time in the compiler's
+ * vector registers, SSE or AVX on x86 and NEON on the Pi, with sine and
+ * cosine from a polynomial rather than libm.
+ */
+
+#ifndef DDFK_APP_BATCH_H
+#define DDFK_APP_BATCH_H
+
+#include "common_types.h"
+
+#include "ddfk_app_fk.h"
+
+/*
+** Encoder counts in, one pose per sample out, all arrays Count long
+*/
+typedef struct
+{
+    const int32 *LeftCounts;  /* Counts the left wheel rolled in each sample */
+    const int32 *RightCounts; /* Counts the right wheel rolled in each sample */
+    double *     X;           /* m, pose after each sample */
+    double *     Y;           /* m */
+    double *     Heading;     /* rad, -pi..pi */
+    uint32       Count;
+} DDFK_APP_Batch_t;
+
+/**
+ * Integrate a run of samples from Pose, leaving Pose at the end of it.
+ *
+ * Agrees with DDFK_APP_FkArc() applied sample by sample to within a few
+ * ulp of each sine and cosine, not to the bit.  Uses about 7 kB of stack.
+ */
+void DDFK_APP_FkBatch(DDFK_APP_Pose_t *Pose, const DDFK_APP_Batch_t *Batch, double MetersPerCount, double TrackWidth);
+
+#endif /* DDFK_APP_BATCH_H */
@@ -33,5 +33,12 @@
 #define DDFK_APP_INVALID_MSGID_ERR_EID 5
 #define DDFK_APP_LEN_ERR_EID           6
 #define DDFK_APP_PIPE_ERR_EID          7
+#define DDFK_APP_POSE_INF_EID          8
+#define DDFK_APP_POSE_ERR_EID          9
+#define DDFK_APP_STATE_ERR_EID         10
+#define DDFK_APP_DRIVE_INF_EID         11
+#define DDFK_APP_DRIVE_ERR_EID         12
+#define DDFK_APP_RT_PROFILE_INF_EID    13
+#define DDFK_APP_RT_PROFILE_ERR_EID    14
 
 #endif /* DDFK_APP_EVENTS_H */
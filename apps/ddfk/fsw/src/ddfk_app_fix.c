@@ -0,0 +1,295 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   Fixed-point differential drive forward kinematics.
+ */
+
+/*
+** Include Files:
+*/
+#include "ddfk_app_fix.h"
+
+#include <math.h>
+
+#define DDFK_APP_FIX_CORDIC_STEPS 30
+
+/*
+** CORDIC gain over DDFK_APP_FIX_CORDIC_STEPS rotations, 0.60725293500888,
+** as the start vector so no scaling is needed after.  The rotation runs in
+** Q40, the 10 bits below the Q30 result absorb the truncation of each step.
+*/
+#define DDFK_APP_FIX_CORDIC_GAIN  667681663043
+#define DDFK_APP_FIX_CORDIC_GUARD 10
+
+#define DDFK_APP_FIX_HALF_PI_Q30 1686629713 /* Binary angle to Q30 radians */
+
+/*
+** Below 0.125 rad, as a binary angle, sin(x)/x comes from its series, which
+** is past the last bit of Q30 there and avoids dividing two small numbers
+*/
+#define DDFK_APP_FIX_SINC_SERIES 85445659
+
+#define DDFK_APP_FIX_SIXTH        178956971               /* 1/3! in Q30 */
+#define DDFK_APP_FIX_ONE_120TH    8947849                 /* 1/5! in Q30 */
+#define DDFK_APP_FIX_ONE_5040TH   213044                  /* 1/7! in Q30 */
+#define DDFK_APP_FIX_MRAD_TO_TURN 2935890503282002u       /* 2^64 / 2000 pi */
+#define DDFK_APP_FIX_GEOMETRY_MAX 4611686018427387904.0   /* 2^62, bound on a converted constant */
+
+/*
+** atan(2^-i) in 2^-48 turns, round(atan(2^-i) * 2^48 / 2 pi), fixed at
+** compile time so no target computes it with its own libm.  The 16 bits
+** below a binary angle keep the rounding of the table out of the result.
+*/
+static const int64 DDFK_APP_FixAtan[DDFK_APP_FIX_CORDIC_STEPS] = {
+    35184372088832, 20770547670515, 10974586953444, 5570871696862, 2796246208089, 1399486241028,
+    699913886760,   349978300884,   174991820497,   87496244017,   43748163730,   21874087080,
+    10937044192,    5468522177,     2734261099,     1367130551,    683565276,     341782638,
+    170891319,      85445659,       42722830,       21361415,      10680707,      5340354,
+    2670177,        1335088,        667544,         333772,        166886,        83443,
+};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Arithmetic shift right, which C leaves to the compiler for a negative      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int64 DDFK_APP_FixAsr(int64 Value, int Shift)
+{
+    if (Value < 0)
+    {
+        return ~(~Value >> Shift);
+    }
+
+    return Value >> Shift;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Multiply and shift through a 128 bit product built from 32 bit halves      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int64 DDFK_APP_FixMul(int64 A, int64 B, uint8 Shift)
+{
+    bool   Negative = (A < 0) != (B < 0);
+    uint64 MagA     = A < 0 ? -(uint64)A : (uint64)A;
+    uint64 MagB     = B < 0 ? -(uint64)B : (uint64)B;
+    uint64 LoLo     = (MagA & 0xFFFFFFFFu) * (MagB & 0xFFFFFFFFu);
+    uint64 LoHi     = (MagA & 0xFFFFFFFFu) * (MagB >> 32);
+    uint64 HiLo     = (MagA >> 32) * (MagB & 0xFFFFFFFFu);
+    uint64 HiHi     = (MagA >> 32) * (MagB >> 32);
+    uint64 Mid      = (LoLo >> 32) + (LoHi & 0xFFFFFFFFu) + (HiLo & 0xFFFFFFFFu);
+    uint64 Lo       = (LoLo & 0xFFFFFFFFu) | (Mid << 32);
+    uint64 Hi       = HiHi + (LoHi >> 32) + (HiLo >> 32) + (Mid >> 32);
+    uint64 Round    = (uint64)1 << (Shift - 1);
+    uint64 Result;
+
+    Lo += Round;
+    if (Lo < Round)
+    {
+        Hi++;
+    }
+
+    Result = (Lo >> Shift) | (Hi << (64 - Shift));
+
+    return Negative ? -(int64)Result : (int64)Result;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Sine and cosine by CORDIC rotation                                         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_FixSinCos(uint32 Angle, int32 *Sin, int32 *Cos)
+{
+    int64 X = DDFK_APP_FIX_CORDIC_GAIN;
+    int64 Y = 0;
+    int64 Z;
+    int64 NextX;
+    bool  Flip;
+    int   i;
+
+    /*
+    ** CORDIC only converges within about 100 degrees of +X, so an angle in
+    ** the left half plane is turned by pi and the result negated
+    */
+    Flip = ((Angle + 0x40000000u) & DDFK_APP_FIX_HALF_TURN) != 0;
+    if (Flip)
+    {
+        Angle += DDFK_APP_FIX_HALF_TURN;
+    }
+
+    /* -pi/2..pi/2 as signed, in 2^-48 turns */
+    Z = Angle < DDFK_APP_FIX_HALF_TURN ? (int64)Angle : (int64)Angle - 4294967296;
+    Z *= 65536;
+
+    for (i = 0; i < DDFK_APP_FIX_CORDIC_STEPS; i++)
+    {
+        if (Z >= 0)
+        {
+            NextX = X - DDFK_APP_FixAsr(Y, i);
+            Y     = Y + DDFK_APP_FixAsr(X, i);
+            Z -= DDFK_APP_FixAtan[i];
+        }
+        else
+        {
+            NextX = X + DDFK_APP_FixAsr(Y, i);
+            Y     = Y - DDFK_APP_FixAsr(X, i);
+            Z += DDFK_APP_FixAtan[i];
+        }
+        X = NextX;
+    }
+
+    Y = DDFK_APP_FixAsr(Y + (1 << (DDFK_APP_FIX_CORDIC_GUARD - 1)), DDFK_APP_FIX_CORDIC_GUARD);
+    X = DDFK_APP_FixAsr(X + (1 << (DDFK_APP_FIX_CORDIC_GUARD - 1)), DDFK_APP_FIX_CORDIC_GUARD);
+
+    *Sin = (int32)(Flip ? -Y : Y);
+    *Cos = (int32)(Flip ? -X : X);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Move a fixed-point pose along one constant-curvature arc                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_FixArc(DDFK_APP_FixPose_t *Pose, int32 LeftCounts, int32 RightCounts,
+                     const DDFK_APP_FixGeometry_t *Geometry)
+{
+    int64  Distance;
+    int64  Half;
+    int64  HalfRad;
+    int64  HalfSq;
+    int64  Sinc;
+    int64  Chord;
+    uint64 HalfTurn;
+    int32  Sin;
+    int32  Cos;
+
+    /*
+    ** Half the turn twice over: wrapped and exact for the heading, where
+    ** overflowing the multiply only drops whole turns, and as an unwrapped
+    ** binary angle for sin(Half) / Half
+    */
+    HalfTurn = (uint64)((int64)RightCounts - LeftCounts) * (uint64)Geometry->HalfAnglePerCount;
+    Half     = DDFK_APP_FixMul((int64)RightCounts - LeftCounts, Geometry->HalfAnglePerCount, 32);
+    HalfRad  = DDFK_APP_FixMul(Half, DDFK_APP_FIX_HALF_PI_Q30, 30);
+    Distance = DDFK_APP_FixMul((int64)LeftCounts + RightCounts, Geometry->HalfMetersPerCount, 16);
+
+    /*
+    ** The same chord as DDFK_APP_FkArc(), Distance * sin(Half) / Half along
+    ** the heading halfway through the turn
+    */
+    if (Half > -DDFK_APP_FIX_SINC_SERIES && Half < DDFK_APP_FIX_SINC_SERIES)
+    {
+        HalfSq = DDFK_APP_FixMul(HalfRad, HalfRad, 30);
+        Sinc   = DDFK_APP_FixMul(HalfSq, DDFK_APP_FIX_ONE_5040TH, 30);
+        Sinc   = DDFK_APP_FixMul(HalfSq, DDFK_APP_FIX_ONE_120TH - Sinc, 30);
+        Sinc   = DDFK_APP_FIX_TRIG_ONE - DDFK_APP_FixMul(HalfSq, DDFK_APP_FIX_SIXTH - Sinc, 30);
+    }
+    else
+    {
+        DDFK_APP_FixSinCos((uint32)Half, &Sin, &Cos);
+        Sinc = (int64)Sin * DDFK_APP_FIX_TRIG_ONE / HalfRad;
+    }
+    Chord = DDFK_APP_FixMul(Distance, Sinc, 30);
+
+    DDFK_APP_FixSinCos((uint32)((Pose->Heading + HalfTurn + 0x80000000u) >> 32), &Sin, &Cos);
+
+    Pose->X += DDFK_APP_FixMul(Chord, Cos, 30);
+    Pose->Y += DDFK_APP_FixMul(Chord, Sin, 30);
+    Pose->Heading += 2u * HalfTurn;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Convert the robot geometry to the fixed-point step's constants             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool DDFK_APP_FixSetGeometry(DDFK_APP_FixGeometry_t *Geometry, double MetersPerCount, double TrackWidth)
+{
+    double HalfMeters = ldexp(MetersPerCount / 2, 48);
+    double HalfAngle  = ldexp(MetersPerCount / (4 * DDFK_APP_PI * TrackWidth), 64);
+
+    /* Written so a NaN fails */
+    if (!(HalfMeters >= 0 && HalfMeters < DDFK_APP_FIX_GEOMETRY_MAX) ||
+        !(HalfAngle >= 0 && HalfAngle < DDFK_APP_FIX_GEOMETRY_MAX))
+    {
+        return false;
+    }
+
+    Geometry->HalfMetersPerCount = llround(HalfMeters);
+    Geometry->HalfAnglePerCount  = llround(HalfAngle);
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Metres from mm, rounded to the nearest Q32 step                            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int64 DDFK_APP_FixFromMm(int32 Mm)
+{
+    int64 Rest = (int64)(Mm % 1000) * DDFK_APP_FIX_POS_ONE;
+
+    return (int64)(Mm / 1000) * DDFK_APP_FIX_POS_ONE + (Rest + (Rest < 0 ? -500 : 500)) / 1000;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Set a fixed-point pose from a ground command                               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_FixSetPose(DDFK_APP_FixPose_t *Pose, int32 XMm, int32 YMm, int32 HeadingMrad)
+{
+    Pose->X       = DDFK_APP_FixFromMm(XMm);
+    Pose->Y       = DDFK_APP_FixFromMm(YMm);
+    Pose->Heading = (uint64)HeadingMrad * DDFK_APP_FIX_MRAD_TO_TURN; /* wraps to within the turn */
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Fixed-point pose to floating point, for telemetry                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_FixToPose(const DDFK_APP_FixPose_t *Fix, DDFK_APP_Pose_t *Pose)
+{
+    double Heading = (double)Fix->Heading;
+
+    if (Fix->Heading >= (uint64)1 << 63)
+    {
+        Heading -= 18446744073709551616.0;
+    }
+
+    Pose->X       = ldexp((double)Fix->X, -32);
+    Pose->Y       = ldexp((double)Fix->Y, -32);
+    Pose->Heading = ldexp(Heading, -63) * DDFK_APP_PI;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Floating-point pose to fixed point, when the integrator changes            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_FixFromPose(const DDFK_APP_Pose_t *Pose, DDFK_APP_FixPose_t *Fix)
+{
+    Fix->X       = llround(ldexp(Pose->X, 32));
+    Fix->Y       = llround(ldexp(Pose->Y, 32));
+    Fix->Heading = (uint64)llround(ldexp(Pose->Heading / (2 * DDFK_APP_PI), 63)) * 2u;
+}
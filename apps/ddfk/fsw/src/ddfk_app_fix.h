@@ -0,0 +1,105 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Fixed-point differential drive forward kinematics
+ *
+ * The pose is integer state: position in Q32 metres and heading as a
+ * binary angle, 2^64 to the turn, which wraps by itself.  A step takes the
+ * encoder counts each wheel rolled and uses only integer adds, multiplies,
+ * shifts and one division, with sin and cos from a CORDIC over a constant
+ * arctangent table.  Given the same geometry constants and counts, every
+ * target computes the same pose to the bit, where libm and the x87 FPU of
+ * the i686 builds each round their own way, and no floating point is left
+ * in the step for cores without an FPU.
+ *
+ * Only DDFK_APP_FixSetGeometry() and the conversions to and from
+ * DDFK_APP_Pose_t use floating point.
+ */
+
+#ifndef DDFK_APP_FIX_H
+#define DDFK_APP_FIX_H
+
+#include "cfe.h"
+
+#include "ddfk_app_fk.h"
+
+#define DDFK_APP_FIX_POS_ONE   ((int64)1 << 32) /* 1 m in a DDFK_APP_FixPose_t position */
+#define DDFK_APP_FIX_TRIG_ONE  ((int32)1 << 30) /* 1.0 from DDFK_APP_FixSinCos() */
+#define DDFK_APP_FIX_HALF_TURN 0x80000000u      /* pi as a 32 bit binary angle */
+
+/*
+** Body pose in the odometry frame, in fixed point
+*/
+typedef struct
+{
+    int64  X;       /* m, Q32 */
+    int64  Y;       /* m, Q32 */
+    uint64 Heading; /* 2^64 per turn, counterclockwise from +X */
+} DDFK_APP_FixPose_t;
+
+/*
+** Robot geometry as the fixed-point step uses it
+*/
+typedef struct
+{
+    int64 HalfMetersPerCount; /* Q48, forward travel per count summed over both wheels */
+    int64 HalfAnglePerCount;  /* Half the turn per count of Right - Left, 2^64 per turn */
+} DDFK_APP_FixGeometry_t;
+
+/**
+ * Convert the geometry, false if it does not fit the fixed-point formats.
+ */
+bool DDFK_APP_FixSetGeometry(DDFK_APP_FixGeometry_t *Geometry, double MetersPerCount, double TrackWidth);
+
+/**
+ * Move a pose along the arc traced by the wheels, LeftCounts and
+ * RightCounts being the encoder counts each wheel rolled.
+ *
+ * The same arc as DDFK_APP_FkArc(), exact for any step up to about 2^31
+ * counts of travel.
+ */
+void DDFK_APP_FixArc(DDFK_APP_FixPose_t *Pose, int32 LeftCounts, int32 RightCounts,
+                     const DDFK_APP_FixGeometry_t *Geometry);
+
+/**
+ * Sine and cosine of a binary angle in Q30, within a few LSB.
+ */
+void DDFK_APP_FixSinCos(uint32 Angle, int32 *Sin, int32 *Cos);
+
+/**
+ * (A * B) >> Shift, rounded half away from zero, without overflowing in
+ * between.  Shift is 1..63.
+ */
+int64 DDFK_APP_FixMul(int64 A, int64 B, uint8 Shift);
+
+/**
+ * Set a fixed-point pose from a ground command's mm and mrad, in integers
+ * only so the same command gives the same pose everywhere.
+ */
+void DDFK_APP_FixSetPose(DDFK_APP_FixPose_t *Pose, int32 XMm, int32 YMm, int32 HeadingMrad);
+
+/**
+ * Convert between the fixed-point and floating-point poses.
+ */
+void DDFK_APP_FixToPose(const DDFK_APP_FixPose_t *Fix, DDFK_APP_Pose_t *Pose);
+void DDFK_APP_FixFromPose(const DDFK_APP_Pose_t *Pose, DDFK_APP_FixPose_t *Fix);
+
+#endif /* DDFK_APP_FIX_H */
@@ -0,0 +1,75 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   Differential drive forward kinematics, wheel travel to body pose.
+ */
+
+/*
+** Include Files:
+*/
+#include "ddfk_app_fk.h"
+
+#include <math.h>
+
+/*
+** Below this half turn, sin(x)/x is taken from its series, good to the last
+** bit of a double and free of the 0/0 of a straight step
+*/
+#define DDFK_APP_FK_SINC_SERIES 1.0e-4
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Move a pose along one constant-curvature arc                               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_FkArc(DDFK_APP_Pose_t *Pose, double Left, double Right, double TrackWidth)
+{
+    double Distance = 0.5 * (Left + Right);
+    double Half     = 0.5 * (Right - Left) / TrackWidth;
+    double Chord;
+
+    /*
+    ** The arc's chord is Distance * sin(Half) / Half long and points along
+    ** the heading halfway through the turn, which covers straight steps
+    ** and turns in place with the same expression
+    */
+    if (fabs(Half) < DDFK_APP_FK_SINC_SERIES)
+    {
+        Chord = Distance * (1.0 - Half * Half / 6.0);
+    }
+    else
+    {
+        Chord = Distance * sin(Half) / Half;
+    }
+
+    Pose->X += Chord * cos(Pose->Heading + Half);
+    Pose->Y += Chord * sin(Pose->Heading + Half);
+    Pose->Heading = DDFK_APP_FkWrap(Pose->Heading + 2.0 * Half);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Wrap an angle into -pi..pi                                                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+double DDFK_APP_FkWrap(double Angle)
+{
+    return remainder(Angle, 2.0 * DDFK_APP_PI);
+}
@@ -0,0 +1,57 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Differential drive forward kinematics, wheel travel to body pose
+ */
+
+#ifndef DDFK_APP_FK_H
+#define DDFK_APP_FK_H
+
+#include "common_types.h"
+
+#define DDFK_APP_PI 3.14159265358979323846
+
+/*
+** Body pose in the odometry frame
+*/
+typedef struct
+{
+    double X;       /* m */
+    double Y;       /* m */
+    double Heading; /* rad, -pi..pi, counterclockwise from +X */
+} DDFK_APP_Pose_t;
+
+/**
+ * Move a pose along the arc traced by the wheels.
+ *
+ * Left and Right are the distances each wheel rolled, in m.  The step is
+ * integrated as one arc of constant curvature, exact whenever the wheel
+ * speed ratio held over the step, rather than as a straight line along
+ * the old heading.
+ */
+void DDFK_APP_FkArc(DDFK_APP_Pose_t *Pose, double Left, double Right, double TrackWidth);
+
+/**
+ * Wrap an angle into -pi..pi.
+ */
+double DDFK_APP_FkWrap(double Angle);
+
+#endif /* DDFK_APP_FK_H */
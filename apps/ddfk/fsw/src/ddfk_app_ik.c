@@ -0,0 +1,144 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   Differential drive inverse kinematics, body velocity to wheel speeds.
+ */
+
+/*
+** Include Files:
+*/
+#include "ddfk_app_ik.h"
+
+#include <math.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Wheel speeds for a body velocity                                           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_IkWheels(const DDFK_APP_Twist_t *Twist, double TrackWidth, double *Left, double *Right)
+{
+    double Turn = 0.5 * TrackWidth * Twist->TurnRate;
+
+    *Left  = Twist->Speed - Turn;
+    *Right = Twist->Speed + Turn;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Body velocity toward a pose goal                                           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool DDFK_APP_IkGoal(const DDFK_APP_Pose_t *Pose, const DDFK_APP_Pose_t *Goal, const DDFK_APP_IkGoalGains_t *Gains,
+                     DDFK_APP_Twist_t *Twist)
+{
+    double Dx        = Goal->X - Pose->X;
+    double Dy        = Goal->Y - Pose->Y;
+    double Distance  = hypot(Dx, Dy);
+    double Direction = 1.0;
+    double Bearing;
+    double Heading;
+
+    if (Distance < Gains->Tolerance)
+    {
+        Heading      = DDFK_APP_FkWrap(Goal->Heading - Pose->Heading);
+        Twist->Speed = 0;
+        if (fabs(Heading) < Gains->HeadingTolerance)
+        {
+            Twist->TurnRate = 0;
+            return true;
+        }
+
+        Twist->TurnRate = Gains->GainBearing * Heading;
+        return false;
+    }
+
+    /*
+    ** A goal behind the base is driven to in reverse, steering as a base
+    ** facing the other way would forward
+    */
+    Bearing = DDFK_APP_FkWrap(atan2(Dy, Dx) - Pose->Heading);
+    if (fabs(Bearing) > 0.5 * DDFK_APP_PI)
+    {
+        Bearing   = DDFK_APP_FkWrap(Bearing + DDFK_APP_PI);
+        Direction = -1.0;
+    }
+
+    /* The heading the base still has to turn through once it is on the line */
+    Heading = DDFK_APP_FkWrap(Goal->Heading - Pose->Heading - Bearing);
+
+    Twist->Speed    = Direction * Gains->GainDistance * Distance;
+    Twist->TurnRate = Gains->GainBearing * Bearing + Gains->GainHeading * Heading;
+
+    return false;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Hold a value within Previous +/- Step                                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static double DDFK_APP_IkSlew(double Value, double Previous, double Step)
+{
+    if (Value > Previous + Step)
+    {
+        return Previous + Step;
+    }
+    if (Value < Previous - Step)
+    {
+        return Previous - Step;
+    }
+
+    return Value;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Bring a twist within the speed and acceleration limits                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void DDFK_APP_IkLimit(DDFK_APP_Twist_t *Twist, const DDFK_APP_Twist_t *Previous, const DDFK_APP_IkLimits_t *Limits,
+                      double TrackWidth, double Dt)
+{
+    double Scale = 1.0;
+    double Wheel;
+
+    if (fabs(Twist->Speed) > Limits->MaxSpeed)
+    {
+        Scale = Limits->MaxSpeed / fabs(Twist->Speed);
+    }
+    if (fabs(Twist->TurnRate) * Scale > Limits->MaxTurnRate)
+    {
+        Scale = Limits->MaxTurnRate / fabs(Twist->TurnRate);
+    }
+    Twist->Speed *= Scale;
+    Twist->TurnRate *= Scale;
+
+    Twist->Speed    = DDFK_APP_IkSlew(Twist->Speed, Previous->Speed, Limits->MaxAccel * Dt);
+    Twist->TurnRate = DDFK_APP_IkSlew(Twist->TurnRate, Previous->TurnRate, Limits->MaxTurnAccel * Dt);
+
+    Wheel = fabs(Twist->Speed) + 0.5 * TrackWidth * fabs(Twist->TurnRate);
+    if (Wheel > Limits->MaxWheelSpeed)
+    {
+        Scale = Limits->MaxWheelSpeed / Wheel;
+        Twist->Speed *= Scale;
+        Twist->TurnRate *= Scale;
+    }
+}
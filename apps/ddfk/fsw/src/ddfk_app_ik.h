@@ -0,0 +1,95 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Differential drive inverse kinematics, body velocity to wheel speeds,
+ * and the pose goal controller that chooses the body velocity
+ */
+
+#ifndef DDFK_APP_IK_H
+#define DDFK_APP_IK_H
+
+#include "common_types.h"
+
+#include "ddfk_app_fk.h"
+
+/*
+** Body velocity, a twist in the plane
+*/
+typedef struct
+{
+    double Speed;    /* m/s, forward */
+    double TurnRate; /* rad/s, counterclockwise */
+} DDFK_APP_Twist_t;
+
+/*
+** What the base may be asked to do
+*/
+typedef struct
+{
+    double MaxSpeed;      /* m/s */
+    double MaxTurnRate;   /* rad/s */
+    double MaxAccel;      /* m/s^2 */
+    double MaxTurnAccel;  /* rad/s^2 */
+    double MaxWheelSpeed; /* m/s at either wheel */
+} DDFK_APP_IkLimits_t;
+
+/*
+** Pose goal controller gains and when it has arrived
+*/
+typedef struct
+{
+    double GainDistance;     /* 1/s, speed per m to go */
+    double GainBearing;      /* 1/s, turn rate per rad off the line to the goal */
+    double GainHeading;      /* 1/s, turn rate per rad of final heading still to turn, < 0 */
+    double Tolerance;        /* m */
+    double HeadingTolerance; /* rad */
+} DDFK_APP_IkGoalGains_t;
+
+/**
+ * Wheel speeds, in m/s, that drive the body at Twist.
+ */
+void DDFK_APP_IkWheels(const DDFK_APP_Twist_t *Twist, double TrackWidth, double *Left, double *Right);
+
+/**
+ * Body velocity that takes the base from Pose to Goal.
+ *
+ * The polar controller of Astolfi: the speed follows the distance to go,
+ * and the turn rate the bearing of the goal and the heading to finish on,
+ * which brings the base in along a smooth curve that ends on the goal
+ * heading.  A goal behind the base is reversed onto.  Within Tolerance of
+ * the goal the base turns in place onto the heading.  Returns true, with a
+ * zero twist, once it is there.
+ */
+bool DDFK_APP_IkGoal(const DDFK_APP_Pose_t *Pose, const DDFK_APP_Pose_t *Goal, const DDFK_APP_IkGoalGains_t *Gains,
+                     DDFK_APP_Twist_t *Twist);
+
+/**
+ * Bring a wanted twist within the limits, Dt after Previous was sent.
+ *
+ * The speed and turn rate limits scale the twist as a whole, so the base
+ * keeps to the curve asked for.  The acceleration limits then move each
+ * part no further from Previous than Dt allows, and last the wheel speed
+ * limit scales the result, outranking the acceleration limits.
+ */
+void DDFK_APP_IkLimit(DDFK_APP_Twist_t *Twist, const DDFK_APP_Twist_t *Previous, const DDFK_APP_IkLimits_t *Limits,
+                      double TrackWidth, double Dt);
+
+#endif /* DDFK_APP_IK_H */
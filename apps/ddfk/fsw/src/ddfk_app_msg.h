@@ -25,12 +25,27 @@
 #ifndef DDFK_APP_MSG_H
 #define DDFK_APP_MSG_H
 
+#include "mrlib_rt.h"
+
 /*
 ** DDFK_APP command codes
 */
 #define DDFK_APP_NOOP_CC           0
 #define DDFK_APP_RESET_COUNTERS_CC 1
 #define DDFK_APP_PROCESS_CC        2
+#define DDFK_APP_SET_POSE_CC       3 // uses DDFK_APP_SetPoseCmd_t
+#define DDFK_APP_SET_TWIST_CC      4 // uses DDFK_APP_SetTwistCmd_t
+#define DDFK_APP_GOTO_POSE_CC      5 // uses DDFK_APP_GotoPoseCmd_t
+#define DDFK_APP_STOP_CC           6 // uses DDFK_APP_StopCmd_t
+#define DDFK_APP_SEND_CMD_STATS_CC 7
+
+/*
+** What DDFK is driving a Romi base toward
+*/
+#define DDFK_APP_DRIVE_IDLE  0 /* Nothing, ROMIMOT's own commands have the wheels */
+#define DDFK_APP_DRIVE_TWIST 1 /* A body velocity, DDFK_APP_SET_TWIST_CC */
+#define DDFK_APP_DRIVE_GOAL  2 /* A pose, DDFK_APP_GOTO_POSE_CC */
+#define DDFK_APP_DRIVE_STOP  3 /* Slowing to a stop */
 
 /*************************************************************************/
 
@@ -42,6 +57,45 @@ typedef struct
     CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
 } DDFK_APP_NoArgsCmd_t;
 
+/*
+** Type definition (a pose of one Romi base, to take or to drive to)
+*/
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
+    uint8                   Device;    /**< \brief ROMIMOT instance, index in its table's Devices */
+    uint8                   Spare[3];
+    int32                   X;         /**< \brief mm */
+    int32                   Y;         /**< \brief mm */
+    int32                   Heading;   /**< \brief mrad, counterclockwise from +X */
+} DDFK_APP_PoseCmd_t;
+
+/*
+** Type definition (drive one Romi base at a body velocity)
+**
+** The base holds the twist for DurationMs, or until the next drive command
+** when it is 0, then slows to a stop.
+*/
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader;  /**< \brief Command header */
+    uint8                   Device;     /**< \brief ROMIMOT instance, index in its table's Devices */
+    uint8                   Spare;
+    int16                   Speed;      /**< \brief mm/s, forward */
+    int16                   TurnRate;   /**< \brief mrad/s, counterclockwise */
+    uint16                  DurationMs; /**< \brief 0 to hold until the next drive command */
+} DDFK_APP_SetTwistCmd_t;
+
+/*
+** Type definition (commands to one Romi base and no other arguments)
+*/
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
+    uint8                   Device;    /**< \brief ROMIMOT instance, index in its table's Devices */
+    uint8                   Spare;
+} DDFK_APP_DeviceCmd_t;
+
 /*
 ** The following commands all share the "NoArgs" format
 **
@@ -52,6 +106,12 @@ typedef struct
 typedef DDFK_APP_NoArgsCmd_t DDFK_APP_NoopCmd_t;
 typedef DDFK_APP_NoArgsCmd_t DDFK_APP_ResetCountersCmd_t;
 typedef DDFK_APP_NoArgsCmd_t DDFK_APP_ProcessCmd_t;
+typedef DDFK_APP_NoArgsCmd_t DDFK_APP_SendCmdStatsCmd_t;
+
+typedef DDFK_APP_PoseCmd_t DDFK_APP_SetPoseCmd_t;
+typedef DDFK_APP_PoseCmd_t DDFK_APP_GotoPoseCmd_t;
+
+typedef DDFK_APP_DeviceCmd_t DDFK_APP_StopCmd_t;
 
 /*************************************************************************/
 /*
@@ -60,9 +120,15 @@ typedef DDFK_APP_NoArgsCmd_t DDFK_APP_ProcessCmd_t;
 
 typedef struct
 {
-    uint8 CommandErrorCounter;
-    uint8 CommandCounter;
-    uint8 spare[2];
+    uint8  CommandErrorCounter;
+    uint8  CommandCounter;
+    uint8  Integrator; /* DDFK_APP_INTEGRATOR_DOUBLE or DDFK_APP_INTEGRATOR_FIXED */
+    uint8  spare;
+    uint32 StatePackets; /* ROMIMOT state packets integrated */
+    uint32 StateErrors;  /* ROMIMOT state packets rejected */
+
+    /* Real-time profile as the kernel applied it at startup */
+    MRLIB_RtStatus_t Rt;
 } DDFK_APP_HkTlm_Payload_t;
 
 typedef struct
@@ -71,4 +137,33 @@ typedef struct
     DDFK_APP_HkTlm_Payload_t  Payload;         /**< \brief Telemetry payload */
 } DDFK_APP_HkTlm_t;
 
+/*
+** Type definition (Differential Drive Forward Kinematics App pose)
+**
+** One packet per Romi base at each wakeup, once its state has been seen,
+** told apart by Instance.  The packet time is that of the last state
+** sample integrated.  The pose is in the frame the base was in when DDFK
+** first heard from it, or the one DDFK_APP_SET_POSE_CC put it in.
+*/
+typedef struct __attribute__((__packed__))
+{
+    uint8  Instance;           /* ROMIMOT instance, index in its table's Devices */
+    uint8  DriveMode;          /* DDFK_APP_DRIVE_* */
+    uint8  Spare[2];
+    uint32 Samples;            /* State samples integrated since the pose was set */
+    uint32 LostCycles;         /* Control cycles missing from the state packets, bridged as one arc */
+    double X;                  /* m */
+    double Y;                  /* m */
+    double Heading;            /* rad, -pi..pi, counterclockwise from +X */
+    float  Speed;              /* m/s, as the firmware measured it at the last sample */
+    float  TurnRate;           /* rad/s, as the firmware measured it at the last sample */
+    uint32 VelocityMismatches; /* Cycles the odometer travel and the wheel velocities disagreed over */
+} DDFK_APP_PoseTlm_Payload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t  TelemetryHeader; /**< \brief Telemetry header */
+    DDFK_APP_PoseTlm_Payload_t Payload;         /**< \brief Telemetry payload */
+} DDFK_APP_PoseTlm_t;
+
 #endif /* DDFK_APP_MSG_H */
@@ -23,7 +23,33 @@
 ** The following is an example of the declaration statement that defines the desired
 ** contents of the table image.
 */
-DDFK_APP_Table_t DDFKAppTable = {1, 2};
+DDFK_APP_Table_t DDFKAppTable = {
+    /* Pololu Romi: 70 mm wheels 141 mm apart, 12 CPR encoders on 119.76:1 gearmotors */
+    .WheelRadius  = 0.035,
+    .TrackWidth   = 0.141,
+    .CountsPerRev = 1437.09,
+    .Integrator   = DDFK_APP_INTEGRATOR_FIXED,
+
+    /* A few setpoints lost at the 40 Hz default state packet rate ride through, a stalled DDFK does not */
+    .StreamTimeoutMs = 200,
+
+    /* Well inside the 0.6 m/s the firmware's 4000 counts/s allows at each wheel */
+    .MaxSpeed     = 0.4,
+    .MaxTurnRate  = 4.0,
+    .MaxAccel     = 1.0,
+    .MaxTurnAccel = 10.0,
+
+    /* Gains meeting Astolfi's strong stability condition, kAlpha + 5/3 kBeta - 2/pi kRho > 0 */
+    .GoalGainDistance     = 1.0,
+    .GoalGainBearing      = 3.0,
+    .GoalGainHeading      = -1.0,
+    .GoalTolerance        = 0.01,
+    .GoalHeadingTolerance = 0.05,
+
+    /* Ahead of everything but the ROMIMOT I/O task that waits for its
+       setpoints, and on core 2 so it never takes the I/O task's core 3 */
+    .RtProfile = {.Enabled = 1, .Priority = 70, .LockMemory = 1, .CpuMask = 0x4, .PrefaultBytes = 8192},
+};
 
 /*
 ** This is alternate table contents:
@@ -38,6 +38,17 @@
 
 #include "ddfk_app_coveragetest_common.h"
 #include "ut_ddfk_app.h"
+#include "ddfk_app_batch.h"
+
+#include <math.h>
+#include <stddef.h>
+
+/*
+ * The fixed-point pose is 64 bit, compared exactly
+ */
+#define UT_FIX_EQ(Actual, Expected)                                                                          \
+    UtAssert_True((Actual) == (Expected), "%s (%lld) == %s (%lld)", #Actual, (long long)(Actual), #Expected, \
+                  (long long)(Expected))
 
 /*
  * Unit test check event hook information
@@ -267,66 +278,144 @@ void Test_DDFK_APP_Init(void)
     UtAssert_INT32_EQ(DDFK_APP_Init(), CFE_SB_BAD_ARGUMENT);
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 4);
 
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_Subscribe), 3, CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(DDFK_APP_Init(), CFE_SB_BAD_ARGUMENT);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 5);
+
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_SubscribeEx), 1, CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(DDFK_APP_Init(), CFE_SB_BAD_ARGUMENT);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 6);
+
     UT_SetDeferredRetcode(UT_KEY(CFE_TBL_Register), 1, CFE_TBL_ERR_INVALID_OPTIONS);
     UtAssert_INT32_EQ(DDFK_APP_Init(), CFE_TBL_ERR_INVALID_OPTIONS);
-    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 5);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 7);
+
+    /* every pose packet knows its base, and the geometry came from the table */
+    UtAssert_INT32_EQ(DDFK_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.Robot[DDFK_APP_MAX_ROBOTS - 1].PoseTlm.Payload.Instance,
+                       DDFK_APP_MAX_ROBOTS - 1);
+    UtAssert_BOOL_FALSE(DDFK_APP_Data.Robot[0].Valid);
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.MetersPerCount, 2 * DDFK_APP_PI * 0.035 / 1437.09, 1e-12, "MetersPerCount");
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.TrackWidth, 0.141, 1e-12, "TrackWidth");
 }
 
-void Test_DDFK_APP_ProcessCommandPacket(void)
+void Test_DDFK_APP_RtProfile(void)
 {
     /*
      * Test Case For:
-     * void DDFK_APP_ProcessCommandPacket
+     * void DDFK_APP_ApplyRtProfile( const MRLIB_RtProfile_t *Profile )
      */
-    /* a buffer large enough for any command message */
-    union
-    {
-        CFE_SB_Buffer_t    SBBuf;
-        DDFK_APP_NoopCmd_t Noop;
-    } TestMsg;
-    CFE_SB_MsgId_t    TestMsgId;
-    CFE_MSG_FcnCode_t FcnCode;
-    size_t            MsgSize;
+    DDFK_APP_Table_t  TestTblData;
+    DDFK_APP_Table_t *TblPtr = &TestTblData;
+    MRLIB_RtProfile_t Profile;
+    MRLIB_RtStatus_t  Got = {.Policy = MRLIB_RT_POLICY_FIFO, .Priority = 70, .CpuMask = 0x2, .LockedKb = 512};
     UT_CheckEvent_t   EventTest;
 
-    memset(&TestMsg, 0, sizeof(TestMsg));
-    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_INVALID_MSGID_ERR_EID, "DDFK_APP: invalid command packet,MID = 0x%x");
+    /* a disabled profile is only read back, without an event */
+    memset(&Profile, 0, sizeof(Profile));
+    UT_SetDataBuffer(UT_KEY(MRLIB_RtApply), &Got, sizeof(Got), false);
+    DDFK_APP_ApplyRtProfile(&Profile);
+    UtAssert_STUB_COUNT(MRLIB_RtApply, 1);
+    UtAssert_STUB_COUNT(CFE_EVS_SendEvent, 0);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.RtStatus.CpuMask, 0x2);
+
+    /* an applied profile is reported with what the task got */
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_RT_PROFILE_INF_EID, NULL);
+    Profile.Enabled       = 1;
+    Profile.Priority      = 70;
+    Profile.CpuMask       = 0x2;
+    Profile.PrefaultBytes = 4096;
+    DDFK_APP_ApplyRtProfile(&Profile);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 
-    /*
-     * The CFE_MSG_GetMsgId() stub uses a data buffer to hold the
-     * message ID values to return.
-     */
-    TestMsgId = CFE_SB_ValueToMsgId(DDFK_APP_CMD_MID);
-    FcnCode   = DDFK_APP_NOOP_CC;
-    MsgSize   = sizeof(TestMsg.Noop);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &MsgSize, sizeof(MsgSize), false);
-    DDFK_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+    /* a step the kernel refused is reported as an error */
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_RT_PROFILE_ERR_EID, NULL);
+    UT_SetDeferredRetcode(UT_KEY(MRLIB_RtApply), 1, CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    DDFK_APP_ApplyRtProfile(&Profile);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 
-    TestMsgId = CFE_SB_ValueToMsgId(DDFK_APP_SEND_HK_MID);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
-    DDFK_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+    /* Init takes the profile from the table, and housekeeping reports it */
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_RT_PROFILE_INF_EID, NULL);
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.RtProfile = Profile;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UT_SetDataBuffer(UT_KEY(MRLIB_RtApply), &Got, sizeof(Got), false);
+    UtAssert_INT32_EQ(DDFK_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_INT32_EQ(DDFK_APP_ReportHousekeeping(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.HkTlm.Payload.Rt.Policy, MRLIB_RT_POLICY_FIFO);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.HkTlm.Payload.Rt.CpuMask, 0x2);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.HkTlm.Payload.Rt.Errors, 0);
 
-    /* invalid message id */
-    TestMsgId = CFE_SB_INVALID_MSG_ID;
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
-    DDFK_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+    /* without a table the task stays as OSAL made it */
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+    UtAssert_INT32_EQ(DDFK_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+}
 
+void Test_DDFK_APP_ProcessCommandPacket(void)
+{
     /*
-     * Confirm that the event was generated only _once_
+     * Test Case For:
+     * void DDFK_APP_ProcessCommandPacket
      */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    CFE_SB_Buffer_t TestMsg;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    DDFK_APP_Data.ErrCounter = 0;
+
+    /* a packet the table takes is counted by its handler */
+    DDFK_APP_ProcessCommandPacket(&TestMsg);
+    UtAssert_STUB_COUNT(MRLIB_Dispatch, 1);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.ErrCounter, 0);
+
+    /* MRLIB sends the event for a rejected packet, the app only counts it */
+    UT_SetDeferredRetcode(UT_KEY(MRLIB_Dispatch), 1, CFE_STATUS_WRONG_MSG_LENGTH);
+    DDFK_APP_ProcessCommandPacket(&TestMsg);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.ErrCounter, 1);
+    UtAssert_STUB_COUNT(CFE_EVS_SendEvent, 0);
 }
 
-void Test_DDFK_APP_ProcessGroundCommand(void)
+/*
+ * The command DDFK_APP_Dispatch holds for a message ID and function code,
+ * found the way MRLIB_Dispatch() finds it, NULL if there is none.  MRLIB
+ * is stubbed, so the tests call the table's handlers through this.
+ */
+static const MRLIB_Cmd_t *UT_FindCmd(CFE_SB_MsgId_Atom_t MsgId, CFE_MSG_FcnCode_t FcnCode)
+{
+    const MRLIB_Route_t *Route;
+    uint16               i;
+
+    for (i = 0; i < DDFK_APP_Dispatch.RouteCount; i++)
+    {
+        Route = &DDFK_APP_Dispatch.Routes[i];
+        if (Route->MsgId != MsgId)
+        {
+            continue;
+        }
+        if (Route->FcnCodes == 0)
+        {
+            return &Route->Cmds[0];
+        }
+        if (FcnCode < Route->FcnCodes && Route->Cmds[FcnCode].Handler != NULL)
+        {
+            return &Route->Cmds[FcnCode];
+        }
+        break;
+    }
+
+    return NULL;
+}
+
+void Test_DDFK_APP_DispatchTable(void)
 {
     /*
      * Test Case For:
-     * void DDFK_APP_ProcessGroundCommand
+     * const MRLIB_Dispatch_t DDFK_APP_Dispatch
      */
-    CFE_MSG_FcnCode_t FcnCode;
-    size_t            Size;
+    const MRLIB_Cmd_t *Cmd;
+    CFE_MSG_FcnCode_t  FcnCode;
+    size_t             Size;
 
     /* a buffer large enough for any command message */
     union
@@ -335,63 +424,64 @@ void Test_DDFK_APP_ProcessGroundCommand(void)
         DDFK_APP_NoopCmd_t          Noop;
         DDFK_APP_ResetCountersCmd_t Reset;
         DDFK_APP_ProcessCmd_t       Process;
+        ROMIMOT_StateBatchTlm_t     State;
     } TestMsg;
     UT_CheckEvent_t EventTest;
 
     memset(&TestMsg, 0, sizeof(TestMsg));
 
-    /*
-     * call with each of the supported command codes
-     * The CFE_MSG_GetFcnCode stub allows the code to be
-     * set to whatever is needed.  There is no return
-     * value here and the actual implementation of these
-     * commands have separate test cases, so this just
-     * needs to exercise the "switch" statement.
-     */
-
-    /* test dispatch of NOOP */
-    FcnCode = DDFK_APP_NOOP_CC;
-    Size    = sizeof(TestMsg.Noop);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
-    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_COMMANDNOP_INF_EID, NULL);
+    /* rejected packets are reported with the app's own events */
+    UtAssert_UINT32_EQ(DDFK_APP_Dispatch.MsgIdErrEventId, DDFK_APP_INVALID_MSGID_ERR_EID);
+    UtAssert_UINT32_EQ(DDFK_APP_Dispatch.FcnCodeErrEventId, DDFK_APP_COMMAND_ERR_EID);
+    UtAssert_UINT32_EQ(DDFK_APP_Dispatch.LengthErrEventId, DDFK_APP_LEN_ERR_EID);
 
-    DDFK_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+    /* every ground command has a handler, and none lies past the last */
+    for (FcnCode = 0; FcnCode <= DDFK_APP_SEND_CMD_STATS_CC; FcnCode++)
+    {
+        UtAssert_True(UT_FindCmd(DDFK_APP_CMD_MID, FcnCode) != NULL, "Command code %u has a handler",
+                      (unsigned int)FcnCode);
+    }
+    UtAssert_NULL(UT_FindCmd(DDFK_APP_CMD_MID, DDFK_APP_SEND_CMD_STATS_CC + 1));
+    UtAssert_NULL(UT_FindCmd(DDFK_APP_CMD_MID, 1000));
 
+    /* NOOP */
+    Cmd = UT_FindCmd(DDFK_APP_CMD_MID, DDFK_APP_NOOP_CC);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(TestMsg.Noop));
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_COMMANDNOP_INF_EID, NULL);
+    UtAssert_INT32_EQ(Cmd->Handler(&TestMsg.SBBuf), CFE_SUCCESS);
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 
-    /* test dispatch of RESET */
-    FcnCode = DDFK_APP_RESET_COUNTERS_CC;
-    Size    = sizeof(TestMsg.Reset);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    /* RESET, which also clears the dispatch statistics */
+    Cmd = UT_FindCmd(DDFK_APP_CMD_MID, DDFK_APP_RESET_COUNTERS_CC);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(TestMsg.Reset));
     UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_COMMANDRST_INF_EID, NULL);
-
-    DDFK_APP_ProcessGroundCommand(&TestMsg.SBBuf);
-
+    UtAssert_INT32_EQ(Cmd->Handler(&TestMsg.SBBuf), CFE_SUCCESS);
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_STUB_COUNT(MRLIB_ResetCmdStats, 1);
 
-    /* test dispatch of PROCESS */
-    /* note this will end up calling DDFK_APP_Process(), and as such it needs to
-     * avoid dereferencing a table which does not exist. */
-    FcnCode = DDFK_APP_PROCESS_CC;
-    Size    = sizeof(TestMsg.Process);
+    /* PROCESS, whose missing table is the handler's error for MRLIB to count */
+    Cmd = UT_FindCmd(DDFK_APP_CMD_MID, DDFK_APP_PROCESS_CC);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(TestMsg.Process));
     UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+    UtAssert_True(Cmd->Handler(&TestMsg.SBBuf) != CFE_SUCCESS, "PROCESS without a table fails");
+
+    /* a state packet of any length reaches its handler, which rejects an empty one */
+    DDFK_APP_Data.StateErrors = 0;
+    Cmd                       = UT_FindCmd(ROMIMOT_STATE_TLM_MID, 0);
+    UtAssert_NOT_NULL(Cmd);
+    UtAssert_UINT32_EQ(Cmd->Length, 0);
+    Size = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
-
-    DDFK_APP_ProcessGroundCommand(&TestMsg.SBBuf);
-
-    /* test an invalid CC */
-    FcnCode = 1000;
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_COMMAND_ERR_EID, "Invalid ground command code: CC = %d");
-    DDFK_APP_ProcessGroundCommand(&TestMsg.SBBuf);
-
-    /*
-     * Confirm that the event was generated only _once_
-     */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    Cmd->Handler(&TestMsg.SBBuf);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.StateErrors, 1);
+
+    /* the housekeeping request and the wakeup take any function code */
+    Cmd = UT_FindCmd(DDFK_APP_SEND_HK_MID, 1000);
+    UtAssert_NOT_NULL(Cmd);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(CFE_MSG_CommandHeader_t));
+    Cmd = UT_FindCmd(DDFK_APP_WAKEUP_MID, 1000);
+    UtAssert_NOT_NULL(Cmd);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(CFE_MSG_CommandHeader_t));
 }
 
 void Test_DDFK_APP_ReportHousekeeping(void)
@@ -402,10 +492,6 @@ void Test_DDFK_APP_ReportHousekeeping(void)
      */
     CFE_MSG_Message_t *MsgSend;
     CFE_MSG_Message_t *MsgTimestamp;
-    CFE_SB_MsgId_t     MsgId = CFE_SB_ValueToMsgId(DDFK_APP_SEND_HK_MID);
-
-    /* Set message id to return so DDFK_APP_Housekeeping will be called */
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
 
     /* Set up to capture send message address */
     UT_SetDataBuffer(UT_KEY(CFE_SB_TransmitMsg), &MsgSend, sizeof(MsgSend), false);
@@ -413,12 +499,15 @@ void Test_DDFK_APP_ReportHousekeeping(void)
     /* Set up to capture timestamp message address */
     UT_SetDataBuffer(UT_KEY(CFE_SB_TimeStampMsg), &MsgTimestamp, sizeof(MsgTimestamp), false);
 
+    DDFK_APP_Data.Integrator = DDFK_APP_INTEGRATOR_FIXED;
+
     /* Call unit under test, NULL pointer confirms command access is through APIs */
-    DDFK_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    DDFK_APP_ReportHousekeeping(NULL);
 
     /* Confirm message sent*/
     UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 1);
     UtAssert_ADDRESS_EQ(MsgSend, &DDFK_APP_Data.HkTlm);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.HkTlm.Payload.Integrator, DDFK_APP_INTEGRATOR_FIXED);
 
     /* Confirm timestamp msg address */
     UtAssert_STUB_COUNT(CFE_SB_TimeStampMsg, 1);
@@ -473,6 +562,23 @@ void Test_DDFK_APP_ResetCounters(void)
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 }
 
+void Test_DDFK_APP_SendCmdStats(void)
+{
+    /*
+     * Test Case For:
+     * int32 DDFK_APP_SendCmdStats( const DDFK_APP_SendCmdStatsCmd_t *Msg )
+     */
+    DDFK_APP_SendCmdStatsCmd_t TestMsg;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    DDFK_APP_Data.CmdCounter = 0;
+
+    /* MRLIB fills in and sends the packet */
+    UtAssert_INT32_EQ(DDFK_APP_SendCmdStats(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.CmdCounter, 1);
+    UtAssert_STUB_COUNT(MRLIB_SendCmdStats, 1);
+}
+
 void Test_DDFK_APP_ProcessCC(void)
 {
     /*
@@ -487,8 +593,9 @@ void Test_DDFK_APP_ProcessCC(void)
     memset(&TestMsg, 0, sizeof(TestMsg));
 
     /* Provide some table data for the DDFK_APP_Process() function to use */
-    TestTblData.Int1 = 40;
-    TestTblData.Int2 = 50;
+    TestTblData.WheelRadius  = 0.035;
+    TestTblData.TrackWidth   = 0.141;
+    TestTblData.CountsPerRev = 1437.09;
     UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
     UtAssert_INT32_EQ(DDFK_APP_Process(&TestMsg), CFE_SUCCESS);
 
@@ -505,61 +612,108 @@ void Test_DDFK_APP_ProcessCC(void)
     UtAssert_INT32_EQ(DDFK_APP_Process(&TestMsg), CFE_TBL_ERR_UNREGISTERED);
 }
 
-void Test_DDFK_APP_VerifyCmdLength(void)
+void Test_DDFK_APP_TblValidationFunc(void)
 {
     /*
      * Test Case For:
-     * bool DDFK_APP_VerifyCmdLength
+     * int32 DDFK_APP_TblValidationFunc( void *TblData )
      */
-    UT_CheckEvent_t   EventTest;
-    size_t            size    = 1;
-    CFE_MSG_FcnCode_t fcncode = 2;
-    CFE_SB_MsgId_t    msgid   = CFE_SB_ValueToMsgId(3);
+    DDFK_APP_Table_t TestTblData = {.WheelRadius          = 0.035,
+                                    .TrackWidth           = 0.141,
+                                    .CountsPerRev         = 1437.09,
+                                    .Integrator           = DDFK_APP_INTEGRATOR_FIXED,
+                                    .StreamTimeoutMs      = 200,
+                                    .MaxSpeed             = 0.4,
+                                    .MaxTurnRate          = 4.0,
+                                    .MaxAccel             = 1.0,
+                                    .MaxTurnAccel         = 10.0,
+                                    .GoalGainDistance     = 1.0,
+                                    .GoalGainBearing      = 3.0,
+                                    .GoalGainHeading      = -1.0,
+                                    .GoalTolerance        = 0.01,
+                                    .GoalHeadingTolerance = 0.05};
+
+    /* nominal case should succeed */
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-    /*
-     * test a match case
-     */
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &size, sizeof(size), false);
-    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_LEN_ERR_EID,
-                        "Invalid Msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u");
+    /* error cases should return DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE */
+    TestTblData.WheelRadius = 0;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.WheelRadius = DDFK_APP_WHEEL_RADIUS_MAX * 2;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.WheelRadius = DDFK_APP_WHEEL_RADIUS_MAX;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-    DDFK_APP_VerifyCmdLength(NULL, size);
+    TestTblData.TrackWidth = NAN;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.TrackWidth = -0.141;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.TrackWidth = DDFK_APP_TRACK_WIDTH_MAX;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-    /*
-     * Confirm that the event was NOT generated
-     */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 0);
+    TestTblData.CountsPerRev = INFINITY;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.CountsPerRev = 0;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
 
-    /*
-     * test a mismatch case
-     */
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &size, sizeof(size), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &msgid, sizeof(msgid), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &fcncode, sizeof(fcncode), false);
-    DDFK_APP_VerifyCmdLength(NULL, size + 1);
+    TestTblData.CountsPerRev = 1437.09;
+    TestTblData.Integrator   = DDFK_APP_INTEGRATOR_FIXED + 1;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
 
-    /*
-     * Confirm that the event WAS generated
-     */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
-}
+    /* a count turning the base more than the fixed-point step holds is only an error for it */
+    TestTblData.WheelRadius  = DDFK_APP_WHEEL_RADIUS_MAX;
+    TestTblData.TrackWidth   = 0.141;
+    TestTblData.CountsPerRev = 1;
+    TestTblData.Integrator   = DDFK_APP_INTEGRATOR_FIXED;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.Integrator = DDFK_APP_INTEGRATOR_DOUBLE;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-void Test_DDFK_APP_TblValidationFunc(void)
-{
-    /*
-     * Test Case For:
-     * int32 DDFK_APP_TblValidationFunc( void *TblData )
-     */
-    DDFK_APP_Table_t TestTblData;
+    /* the drive limits */
+    TestTblData.StreamTimeoutMs = 0;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.StreamTimeoutMs = ROMIMOT_STREAM_TIMEOUT_MAX_MS + 1;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.StreamTimeoutMs = ROMIMOT_STREAM_TIMEOUT_MAX_MS;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.MaxSpeed = DDFK_APP_SPEED_MAX * 2;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.MaxSpeed    = 0.4;
+    TestTblData.MaxTurnRate = NAN;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.MaxTurnRate = 4.0;
+    TestTblData.MaxAccel    = INFINITY;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.MaxAccel     = 1.0;
+    TestTblData.MaxTurnAccel = 0;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.MaxTurnAccel  = 10.0;
+    TestTblData.GoalTolerance = 0;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.GoalTolerance        = 0.01;
+    TestTblData.GoalHeadingTolerance = DDFK_APP_GOAL_HEADING_TOLERANCE_MAX * 2;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.GoalHeadingTolerance = 0.05;
 
-    /* nominal case (0) should succeed */
+    /* goal gains the controller is not stable with */
+    TestTblData.GoalGainDistance = 0;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.GoalGainDistance = 1.0;
+    TestTblData.GoalGainBearing  = 1.0;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.GoalGainBearing = 3.0;
+    TestTblData.GoalGainHeading = 0;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.GoalGainHeading = NAN;
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.GoalGainHeading = -1.0;
     UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-    /* error case should return DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE */
-    TestTblData.Int1 = 1 + DDFK_APP_TBL_ELEMENT_1_MAX;
+    /* a real-time profile MRLIB rejects */
+    UT_SetDeferredRetcode(UT_KEY(MRLIB_RtValidate), 1, false);
     UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), DDFK_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    UtAssert_INT32_EQ(DDFK_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 }
 
 void Test_DDFK_APP_GetCrc(void)
@@ -587,12 +741,990 @@ void Test_DDFK_APP_GetCrc(void)
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 2);
 }
 
+void Test_DDFK_APP_FkArc(void)
+{
+    /*
+     * Test Case For:
+     * void DDFK_APP_FkArc(DDFK_APP_Pose_t *Pose, double Left, double Right, double TrackWidth)
+     */
+    DDFK_APP_Pose_t Pose;
+    double          Track = 0.14;
+    double          Radius;
+
+    /* straight along the heading */
+    memset(&Pose, 0, sizeof(Pose));
+    Pose.Heading = DDFK_APP_PI / 2;
+    DDFK_APP_FkArc(&Pose, 0.5, 0.5, Track);
+    UtAssert_DoubleCmpAbs(Pose.X, 0, 1e-12, "straight X");
+    UtAssert_DoubleCmpAbs(Pose.Y, 0.5, 1e-12, "straight Y");
+    UtAssert_DoubleCmpAbs(Pose.Heading, DDFK_APP_PI / 2, 1e-12, "straight Heading");
+
+    /* a quarter circle to the left ends a radius along each axis */
+    memset(&Pose, 0, sizeof(Pose));
+    Radius = 0.3;
+    DDFK_APP_FkArc(&Pose, (Radius - Track / 2) * DDFK_APP_PI / 2, (Radius + Track / 2) * DDFK_APP_PI / 2, Track);
+    UtAssert_DoubleCmpAbs(Pose.X, Radius, 1e-12, "arc X");
+    UtAssert_DoubleCmpAbs(Pose.Y, Radius, 1e-12, "arc Y");
+    UtAssert_DoubleCmpAbs(Pose.Heading, DDFK_APP_PI / 2, 1e-12, "arc Heading");
+
+    /* a gentle arc, where sin(x)/x comes from its series, matches the circle */
+    memset(&Pose, 0, sizeof(Pose));
+    Radius = 2000.0;
+    DDFK_APP_FkArc(&Pose, (Radius - Track / 2) * 1e-5, (Radius + Track / 2) * 1e-5, Track);
+    UtAssert_DoubleCmpAbs(Pose.X, Radius * sin(1e-5), 1e-15, "series X");
+    UtAssert_DoubleCmpAbs(Pose.Y, 2 * Radius * sin(0.5e-5) * sin(0.5e-5), 1e-15, "series Y");
+
+    /* turning in place does not move the base */
+    memset(&Pose, 0, sizeof(Pose));
+    DDFK_APP_FkArc(&Pose, -Track / 2 * DDFK_APP_PI / 4, Track / 2 * DDFK_APP_PI / 4, Track);
+    UtAssert_DoubleCmpAbs(Pose.X, 0, 1e-12, "spin X");
+    UtAssert_DoubleCmpAbs(Pose.Y, 0, 1e-12, "spin Y");
+    UtAssert_DoubleCmpAbs(Pose.Heading, DDFK_APP_PI / 4, 1e-12, "spin Heading");
+
+    /* the heading wraps past pi */
+    Pose.Heading = 3 * DDFK_APP_PI / 4;
+    DDFK_APP_FkArc(&Pose, -Track / 2 * DDFK_APP_PI / 2, Track / 2 * DDFK_APP_PI / 2, Track);
+    UtAssert_DoubleCmpAbs(Pose.Heading, -3 * DDFK_APP_PI / 4, 1e-12, "wrapped Heading");
+    UtAssert_DoubleCmpAbs(DDFK_APP_FkWrap(-5 * DDFK_APP_PI / 2), -DDFK_APP_PI / 2, 1e-12, "FkWrap");
+}
+
+void Test_DDFK_APP_FkBatch(void)
+{
+    /*
+     * Test Case For:
+     * void DDFK_APP_FkBatch(DDFK_APP_Pose_t *Pose, const DDFK_APP_Batch_t *Batch, double MetersPerCount,
+     *                       double TrackWidth)
+     */
+    enum
+    {
+        UT_BATCH_COUNT = 1003 /* Several blocks and a partial vector */
+    };
+    static int32     Left[UT_BATCH_COUNT];
+    static int32     Right[UT_BATCH_COUNT];
+    static double    X[UT_BATCH_COUNT];
+    static double    Y[UT_BATCH_COUNT];
+    static double    Heading[UT_BATCH_COUNT];
+    DDFK_APP_Batch_t Batch          = {Left, Right, X, Y, Heading, UT_BATCH_COUNT};
+    DDFK_APP_Pose_t  Pose           = {-1.0, 2.0, 3.0};
+    DDFK_APP_Pose_t  Expected       = Pose;
+    double           MetersPerCount = 2.0 * DDFK_APP_PI * 0.035 / 1437.09;
+    double           Error          = 0;
+    uint32           Seed           = 1;
+    uint32           i;
+
+    /* straight runs, gentle arcs on the series and spins in place, either way */
+    for (i = 0; i < UT_BATCH_COUNT; i++)
+    {
+        Seed     = Seed * 1664525u + 1013904223u;
+        Left[i]  = (int32)(Seed >> 20 & 0x1FF) - 128;
+        Right[i] = (i % 7 == 0) ? Left[i] : (i % 11 == 0) ? -Left[i] : Left[i] + (int32)(Seed >> 8 & 3) - 1;
+    }
+
+    DDFK_APP_FkBatch(&Pose, &Batch, MetersPerCount, 0.141);
+
+    /* every pose along the way tracks the scalar step */
+    for (i = 0; i < UT_BATCH_COUNT; i++)
+    {
+        DDFK_APP_FkArc(&Expected, Left[i] * MetersPerCount, Right[i] * MetersPerCount, 0.141);
+        Error = fmax(Error, fabs(X[i] - Expected.X) + fabs(Y[i] - Expected.Y));
+        Error = fmax(Error, fabs(DDFK_APP_FkWrap(Heading[i] - Expected.Heading)));
+        UtAssert_True(Heading[i] >= -DDFK_APP_PI && Heading[i] <= DDFK_APP_PI, "Heading[%lu] wrapped",
+                      (unsigned long)i);
+    }
+    UtAssert_DoubleCmpAbs(Error, 0, 1e-9, "Largest error");
+    UtAssert_DoubleCmpAbs(Pose.X, Expected.X, 1e-9, "Final X");
+    UtAssert_DoubleCmpAbs(Pose.Y, Expected.Y, 1e-9, "Final Y");
+    UtAssert_DoubleCmpAbs(Pose.Heading, Expected.Heading, 1e-9, "Final Heading");
+
+    /* an empty batch leaves the pose alone */
+    Batch.Count = 0;
+    Expected    = Pose;
+    DDFK_APP_FkBatch(&Pose, &Batch, MetersPerCount, 0.141);
+    UtAssert_DoubleCmpAbs(Pose.X, Expected.X, 1e-12, "Empty X");
+    UtAssert_DoubleCmpAbs(Pose.Y, Expected.Y, 1e-12, "Empty Y");
+    UtAssert_DoubleCmpAbs(Pose.Heading, Expected.Heading, 1e-12, "Empty Heading");
+}
+
+/*
+ * Robot and pose of the last MRLIB_PoseRecord() call
+ */
+static uint16       UT_PoseRobot;
+static MRLIB_Pose_t UT_Pose;
+
+static void UT_Handler_MRLIB_PoseRecord(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    UT_PoseRobot = UT_Hook_GetArgValueByName(Context, "Robot", uint16);
+    UT_Pose      = *UT_Hook_GetArgValueByName(Context, "Pose", const MRLIB_Pose_t *);
+}
+
+void Test_DDFK_APP_ProcessState(void)
+{
+    /*
+     * Test Case For:
+     * int32 DDFK_APP_ProcessState(const ROMIMOT_StateBatchTlm_t *Msg)
+     */
+    ROMIMOT_StateBatchTlm_t TestMsg;
+    DDFK_APP_Robot_t *      Robot = &DDFK_APP_Data.Robot[1];
+    size_t                  Size;
+    UT_CheckEvent_t         EventTest;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    memset(DDFK_APP_Data.Robot, 0, sizeof(DDFK_APP_Data.Robot));
+    UT_SetHandlerFunction(UT_KEY(MRLIB_PoseRecord), UT_Handler_MRLIB_PoseRecord, NULL);
+    DDFK_APP_Data.StatePackets   = 0;
+    DDFK_APP_Data.StateErrors    = 0;
+    DDFK_APP_Data.MetersPerCount = 0.001;
+    DDFK_APP_Data.TrackWidth     = 0.1;
+    DDFK_APP_Data.Integrator     = DDFK_APP_INTEGRATOR_DOUBLE;
+
+    /* the first sample only sets the baseline, the second drives 100 counts in 10 ms at 10000 counts/s */
+    TestMsg.Payload.FirstCycle                    = 100;
+    TestMsg.Payload.SampleCount                   = 2;
+    TestMsg.Payload.Instance                      = 1;
+    TestMsg.Payload.Samples[0].LeftMotorOdometer  = 500;
+    TestMsg.Payload.Samples[0].RightMotorOdometer = 500;
+    TestMsg.Payload.Samples[0].RomiMicros         = 1000;
+    TestMsg.Payload.Samples[1].TimeOffsetUs       = 10000;
+    TestMsg.Payload.Samples[1].LeftMotorOdometer  = 600;
+    TestMsg.Payload.Samples[1].RightMotorOdometer = 600;
+    TestMsg.Payload.Samples[1].RomiMicros         = 11000;
+    TestMsg.Payload.Samples[1].LeftVelocity       = 10000;
+    TestMsg.Payload.Samples[1].RightVelocity      = 10000;
+
+    Size = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) + 2 * sizeof(ROMIMOT_StateSample_t);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(Robot->Valid);
+    UtAssert_BOOL_FALSE(DDFK_APP_Data.Robot[0].Valid);
+    UtAssert_UINT32_EQ(Robot->Samples, 1);
+    UtAssert_UINT32_EQ(Robot->LostCycles, 0);
+    UtAssert_UINT32_EQ(Robot->LastCycle, 101);
+    UtAssert_DoubleCmpAbs(Robot->Pose.X, 0.1, 1e-12, "X");
+    UtAssert_DoubleCmpAbs(Robot->Speed, 10.0, 1e-9, "Speed");
+    UtAssert_UINT32_EQ(Robot->VelocityMismatches, 0);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.StatePackets, 1);
+    UtAssert_STUB_COUNT(CFE_TIME_Add, 2);
+
+    /* the pose of every sample goes into the history */
+    UtAssert_STUB_COUNT(MRLIB_PoseRecord, 2);
+    UtAssert_UINT32_EQ(UT_PoseRobot, 1);
+    UtAssert_DoubleCmpAbs(UT_Pose.X, 0.1, 1e-12, "history X");
+
+    /*
+     * a lost packet is bridged by the odometers, here a turn in place of
+     * 1 rad, and the rates are the velocities of the last cycle, which
+     * the odometers do not check across the gap
+     */
+    TestMsg.Payload.FirstCycle                    = 105;
+    TestMsg.Payload.SampleCount                   = 1;
+    TestMsg.Payload.Samples[0].LeftMotorOdometer  = 550;
+    TestMsg.Payload.Samples[0].RightMotorOdometer = 650;
+    TestMsg.Payload.Samples[0].RomiMicros         = 21000;
+    TestMsg.Payload.Samples[0].LeftVelocity       = -5000;
+    TestMsg.Payload.Samples[0].RightVelocity      = 5000;
+
+    Size = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) + sizeof(ROMIMOT_StateSample_t);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->Samples, 2);
+    UtAssert_UINT32_EQ(Robot->LostCycles, 3);
+    UtAssert_DoubleCmpAbs(Robot->Pose.X, 0.1, 1e-12, "X");
+    UtAssert_DoubleCmpAbs(Robot->Pose.Heading, 1.0, 1e-12, "Heading");
+    UtAssert_DoubleCmpAbs(Robot->Speed, 0, 1e-12, "Speed");
+    UtAssert_DoubleCmpAbs(Robot->TurnRate, 100.0, 1e-9, "TurnRate");
+    UtAssert_UINT32_EQ(Robot->VelocityMismatches, 0);
+
+    /* the odometers wrap */
+    Robot->LastLeftOdo                            = INT32_MAX - 49;
+    Robot->LastRightOdo                           = INT32_MAX - 49;
+    TestMsg.Payload.FirstCycle                    = 106;
+    TestMsg.Payload.Samples[0].LeftMotorOdometer  = INT32_MIN + 50;
+    TestMsg.Payload.Samples[0].RightMotorOdometer = INT32_MIN + 50;
+    TestMsg.Payload.Samples[0].RomiMicros         = 31000;
+    TestMsg.Payload.Samples[0].LeftVelocity       = 10000;
+    TestMsg.Payload.Samples[0].RightVelocity      = 10000;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+    UtAssert_DoubleCmpAbs(Robot->Pose.X, 0.1 + 0.1 * cos(1.0), 1e-12, "wrapped X");
+    UtAssert_DoubleCmpAbs(Robot->Pose.Y, 0.1 * sin(1.0), 1e-12, "wrapped Y");
+    UtAssert_UINT32_EQ(Robot->VelocityMismatches, 0);
+
+    /* a restarted ROMIMOT counts its cycles from the start, the pose stays */
+    TestMsg.Payload.FirstCycle                    = 1;
+    TestMsg.Payload.Samples[0].LeftMotorOdometer  = 0;
+    TestMsg.Payload.Samples[0].RightMotorOdometer = 0;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->Samples, 3);
+    UtAssert_UINT32_EQ(Robot->LastCycle, 1);
+    UtAssert_DoubleCmpAbs(Robot->Pose.X, 0.1 + 0.1 * cos(1.0), 1e-12, "restart X");
+    UtAssert_UINT32_EQ(DDFK_APP_Data.StatePackets, 4);
+
+    /* bad packets are counted and dropped */
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_STATE_ERR_EID, NULL);
+
+    Size = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) - 1;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+
+    Size = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) + 2 * sizeof(ROMIMOT_StateSample_t);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+
+    TestMsg.Payload.SampleCount = ROMIMOT_STATE_BATCH_MAX + 1;
+    Size                        = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) +
+           (ROMIMOT_STATE_BATCH_MAX + 1) * sizeof(ROMIMOT_StateSample_t);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+
+    TestMsg.Payload.SampleCount = 0;
+    Size                        = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+
+    TestMsg.Payload.SampleCount = 1;
+    TestMsg.Payload.Instance    = DDFK_APP_MAX_ROBOTS;
+    Size                        = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) + sizeof(ROMIMOT_StateSample_t);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 5);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.StateErrors, 5);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.StatePackets, 4);
+    UtAssert_UINT32_EQ(Robot->Samples, 3);
+
+    /* without a geometry from the table a sample only moves the baseline */
+    DDFK_APP_Data.TrackWidth                      = 0;
+    TestMsg.Payload.Instance                      = 1;
+    TestMsg.Payload.FirstCycle                    = 2;
+    TestMsg.Payload.Samples[0].LeftMotorOdometer  = 1000;
+    TestMsg.Payload.Samples[0].RightMotorOdometer = 1000;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->Samples, 3);
+    UtAssert_INT32_EQ(Robot->LastLeftOdo, 1000);
+
+    /* the fixed-point integrator moves FixPose, and Pose with it */
+    DDFK_APP_Data.TrackWidth = 0.1;
+    DDFK_APP_Data.Integrator = DDFK_APP_INTEGRATOR_FIXED;
+    DDFK_APP_FixSetGeometry(&DDFK_APP_Data.FixGeometry, DDFK_APP_Data.MetersPerCount, DDFK_APP_Data.TrackWidth);
+    DDFK_APP_FixSetPose(&Robot->FixPose, 0, 0, 0);
+    TestMsg.Payload.FirstCycle                    = 3;
+    TestMsg.Payload.Samples[0].LeftMotorOdometer  = 1200;
+    TestMsg.Payload.Samples[0].RightMotorOdometer = 1200;
+    TestMsg.Payload.Samples[0].RomiMicros         = 41000;
+    TestMsg.Payload.Samples[0].LeftVelocity       = 20000;
+    TestMsg.Payload.Samples[0].RightVelocity      = 20000;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->Samples, 4);
+    UtAssert_DoubleCmpAbs(Robot->Pose.X, 0.2, 1e-9, "fixed X");
+    UtAssert_DoubleCmpAbs(Robot->Pose.Y, 0, 1e-9, "fixed Y");
+    UtAssert_DoubleCmpAbs(Robot->Speed, 20.0, 1e-9, "fixed Speed");
+    UtAssert_UINT32_EQ(Robot->VelocityMismatches, 0);
+
+    /*
+     * odometers that fall short of the velocities are counted, while the
+     * pose still follows the odometers and the rates the velocities
+     */
+    TestMsg.Payload.FirstCycle                    = 4;
+    TestMsg.Payload.Samples[0].LeftMotorOdometer  = 1300;
+    TestMsg.Payload.Samples[0].RightMotorOdometer = 1300;
+    TestMsg.Payload.Samples[0].RomiMicros         = 51000;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+    UtAssert_DoubleCmpAbs(Robot->Pose.X, 0.3, 1e-9, "short X");
+    UtAssert_DoubleCmpAbs(Robot->Speed, 20.0, 1e-9, "short Speed");
+    UtAssert_UINT32_EQ(Robot->VelocityMismatches, 1);
+
+    /* within the slack they agree */
+    TestMsg.Payload.FirstCycle                    = 5;
+    TestMsg.Payload.Samples[0].LeftMotorOdometer  = 1498;
+    TestMsg.Payload.Samples[0].RightMotorOdometer = 1502;
+    TestMsg.Payload.Samples[0].RomiMicros         = 61000;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->VelocityMismatches, 1);
+}
+
+void Test_DDFK_APP_Wakeup(void)
+{
+    /*
+     * Test Case For:
+     * int32 DDFK_APP_Wakeup(const CFE_MSG_CommandHeader_t *Msg)
+     */
+    CFE_MSG_CommandHeader_t TestMsg;
+    CFE_MSG_Message_t *     MsgSend;
+    DDFK_APP_Robot_t *      Robot = &DDFK_APP_Data.Robot[1];
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    memset(DDFK_APP_Data.Robot, 0, sizeof(DDFK_APP_Data.Robot));
+
+    /* nothing is sent for a base not yet heard from */
+    UtAssert_INT32_EQ(DDFK_APP_Wakeup(&TestMsg), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 0);
+
+    Robot->Valid        = true;
+    Robot->Pose.X       = 1.25;
+    Robot->Pose.Heading = -0.5;
+    Robot->Speed        = 0.2;
+    Robot->Samples      = 42;
+    Robot->LostCycles   = 3;
+    Robot->DriveMode    = DDFK_APP_DRIVE_GOAL;
+
+    Robot->VelocityMismatches = 7;
+    UT_SetDataBuffer(UT_KEY(CFE_SB_TransmitMsg), &MsgSend, sizeof(MsgSend), false);
+
+    UtAssert_INT32_EQ(DDFK_APP_Wakeup(&TestMsg), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 1);
+    UtAssert_STUB_COUNT(CFE_MSG_SetMsgTime, 1);
+    UtAssert_ADDRESS_EQ(MsgSend, &Robot->PoseTlm);
+    UtAssert_UINT32_EQ(Robot->PoseTlm.Payload.Samples, 42);
+    UtAssert_UINT32_EQ(Robot->PoseTlm.Payload.LostCycles, 3);
+    UtAssert_UINT32_EQ(Robot->PoseTlm.Payload.VelocityMismatches, 7);
+    UtAssert_UINT32_EQ(Robot->PoseTlm.Payload.DriveMode, DDFK_APP_DRIVE_GOAL);
+    UtAssert_DoubleCmpAbs(Robot->PoseTlm.Payload.X, 1.25, 1e-12, "X");
+    UtAssert_DoubleCmpAbs(Robot->PoseTlm.Payload.Heading, -0.5, 1e-12, "Heading");
+    UtAssert_DoubleCmpAbs(Robot->PoseTlm.Payload.Speed, 0.2, 1e-6, "Speed");
+}
+
+void Test_DDFK_APP_SetPose(void)
+{
+    /*
+     * Test Case For:
+     * int32 DDFK_APP_SetPose(const DDFK_APP_SetPoseCmd_t *Msg)
+     */
+    DDFK_APP_SetPoseCmd_t TestMsg;
+    DDFK_APP_Robot_t *    Robot = &DDFK_APP_Data.Robot[2];
+    UT_CheckEvent_t       EventTest;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    memset(DDFK_APP_Data.Robot, 0, sizeof(DDFK_APP_Data.Robot));
+    DDFK_APP_Data.CmdCounter = 0;
+    DDFK_APP_Data.ErrCounter = 0;
+
+    /* no such base */
+    TestMsg.Device = DDFK_APP_MAX_ROBOTS;
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_POSE_ERR_EID, NULL);
+    UtAssert_INT32_EQ(DDFK_APP_SetPose(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.ErrCounter, 1);
+
+    /* the heading is wrapped and the sample counts start again */
+    Robot->Samples            = 10;
+    Robot->LostCycles         = 2;
+    Robot->VelocityMismatches = 4;
+    TestMsg.Device            = 2;
+    TestMsg.X                 = 1500;
+    TestMsg.Y                 = -250;
+    TestMsg.Heading           = 4000;
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_POSE_INF_EID, NULL);
+    UtAssert_INT32_EQ(DDFK_APP_SetPose(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.CmdCounter, 1);
+    UtAssert_DoubleCmpAbs(Robot->Pose.X, 1.5, 1e-12, "X");
+    UtAssert_DoubleCmpAbs(Robot->Pose.Y, -0.25, 1e-12, "Y");
+    UtAssert_DoubleCmpAbs(Robot->Pose.Heading, 4.0 - 2 * DDFK_APP_PI, 1e-12, "Heading");
+    UT_FIX_EQ(Robot->FixPose.X, 3 * DDFK_APP_FIX_POS_ONE / 2);
+    UT_FIX_EQ(Robot->FixPose.Y, -DDFK_APP_FIX_POS_ONE / 4);
+    UtAssert_UINT32_EQ(Robot->Samples, 0);
+    UtAssert_UINT32_EQ(Robot->LostCycles, 0);
+    UtAssert_UINT32_EQ(Robot->VelocityMismatches, 0);
+
+    /* the history before the jump is dropped, not that of a base that does not exist */
+    UtAssert_STUB_COUNT(MRLIB_PoseClear, 1);
+}
+
+void Test_DDFK_APP_ApplyTableConfig(void)
+{
+    /*
+     * Test Case For:
+     * void DDFK_APP_ApplyTableConfig(void)
+     */
+    DDFK_APP_Table_t  TestTblData = {.WheelRadius          = 0.05,
+                                     .TrackWidth           = 0.2,
+                                     .CountsPerRev         = 1000,
+                                     .Integrator           = DDFK_APP_INTEGRATOR_DOUBLE,
+                                     .StreamTimeoutMs      = 150,
+                                     .MaxSpeed             = 0.3,
+                                     .MaxTurnRate          = 2.0,
+                                     .MaxAccel             = 0.5,
+                                     .MaxTurnAccel         = 5.0,
+                                     .GoalGainDistance     = 0.5,
+                                     .GoalGainBearing      = 2.0,
+                                     .GoalGainHeading      = -0.5,
+                                     .GoalTolerance        = 0.02,
+                                     .GoalHeadingTolerance = 0.1};
+    void *            TblPtr      = &TestTblData;
+    DDFK_APP_Robot_t *Robot       = &DDFK_APP_Data.Robot[0];
+
+    memset(DDFK_APP_Data.Robot, 0, sizeof(DDFK_APP_Data.Robot));
+    DDFK_APP_Data.Integrator = DDFK_APP_INTEGRATOR_DOUBLE;
+
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    DDFK_APP_ApplyTableConfig();
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.MetersPerCount, 2 * DDFK_APP_PI * 0.05 / 1000, 1e-15, "MetersPerCount");
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.TrackWidth, 0.2, 1e-15, "TrackWidth");
+    UtAssert_UINT32_EQ(DDFK_APP_Data.Integrator, DDFK_APP_INTEGRATOR_DOUBLE);
+    UtAssert_STUB_COUNT(CFE_TBL_ReleaseAddress, 1);
+
+    /* the drive limits, the wheel speed one being what ROMIMOT takes */
+    UtAssert_UINT32_EQ(DDFK_APP_Data.StreamTimeoutMs, 150);
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.DriveLimits.MaxSpeed, 0.3, 1e-15, "MaxSpeed");
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.DriveLimits.MaxTurnAccel, 5.0, 1e-15, "MaxTurnAccel");
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.DriveLimits.MaxWheelSpeed,
+                          ROMIMOT_STREAM_SPEED_MAX * 2 * DDFK_APP_PI * 0.05 / 1000, 1e-12, "MaxWheelSpeed");
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.GoalGains.GainHeading, -0.5, 1e-15, "GainHeading");
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.GoalGains.HeadingTolerance, 0.1, 1e-15, "HeadingTolerance");
+
+    /* switching to the fixed-point integrator carries the pose over */
+    Robot->Pose.X          = -2.5;
+    Robot->Pose.Y          = 0.75;
+    Robot->Pose.Heading    = -DDFK_APP_PI / 2;
+    TestTblData.Integrator = DDFK_APP_INTEGRATOR_FIXED;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    DDFK_APP_ApplyTableConfig();
+    UtAssert_UINT32_EQ(DDFK_APP_Data.Integrator, DDFK_APP_INTEGRATOR_FIXED);
+    UT_FIX_EQ(Robot->FixPose.X, -5 * DDFK_APP_FIX_POS_ONE / 2);
+    UT_FIX_EQ(Robot->FixPose.Y, 3 * DDFK_APP_FIX_POS_ONE / 4);
+    UT_FIX_EQ(Robot->FixPose.Heading, (uint64)3 << 62);
+    UT_FIX_EQ(DDFK_APP_Data.FixGeometry.HalfMetersPerCount, llround(ldexp(DDFK_APP_PI * 0.05 / 1000, 48)));
+
+    /* staying on it leaves the fixed-point pose alone */
+    Robot->Pose.X = 0;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    DDFK_APP_ApplyTableConfig();
+    UT_FIX_EQ(Robot->FixPose.X, -5 * DDFK_APP_FIX_POS_ONE / 2);
+
+    /* a geometry the fixed-point step cannot hold falls back to double */
+    TestTblData.CountsPerRev = 0.01;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    DDFK_APP_ApplyTableConfig();
+    UtAssert_UINT32_EQ(DDFK_APP_Data.Integrator, DDFK_APP_INTEGRATOR_DOUBLE);
+    UtAssert_STUB_COUNT(CFE_TBL_ReleaseAddress, 4);
+
+    /* without a table the geometry stays */
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+    DDFK_APP_ApplyTableConfig();
+    UtAssert_DoubleCmpAbs(DDFK_APP_Data.TrackWidth, 0.2, 1e-15, "TrackWidth");
+    UtAssert_STUB_COUNT(CFE_TBL_ReleaseAddress, 4);
+}
+
+void Test_DDFK_APP_FixMul(void)
+{
+    /*
+     * Test Case For:
+     * int64 DDFK_APP_FixMul(int64 A, int64 B, uint8 Shift)
+     */
+
+    /* halves round away from zero, either sign */
+    UT_FIX_EQ(DDFK_APP_FixMul(3, 1, 1), 2);
+    UT_FIX_EQ(DDFK_APP_FixMul(-3, 1, 1), -2);
+    UT_FIX_EQ(DDFK_APP_FixMul(3, -1, 1), -2);
+    UT_FIX_EQ(DDFK_APP_FixMul(-3, -5, 1), 8);
+    UT_FIX_EQ(DDFK_APP_FixMul(5, 1, 2), 1);
+
+    /* 1.0 * 1.0 in Q30, and the full 128 bit product */
+    UT_FIX_EQ(DDFK_APP_FixMul(DDFK_APP_FIX_TRIG_ONE, DDFK_APP_FIX_TRIG_ONE, 30), DDFK_APP_FIX_TRIG_ONE);
+    UT_FIX_EQ(DDFK_APP_FixMul(INT64_MAX, INT64_MAX, 63), INT64_MAX - 1);
+    UT_FIX_EQ(DDFK_APP_FixMul(-INT64_MAX, INT64_MAX, 63), -(INT64_MAX - 1));
+    UT_FIX_EQ(DDFK_APP_FixMul((int64)1 << 40, (int64)3 << 40, 32), (int64)3 << 48);
+}
+
+void Test_DDFK_APP_FixSinCos(void)
+{
+    /*
+     * Test Case For:
+     * void DDFK_APP_FixSinCos(uint32 Angle, int32 *Sin, int32 *Cos)
+     */
+    int32  Sin;
+    int32  Cos;
+    uint32 Angle;
+    double Radians;
+    double Error;
+    double MaxError = 0;
+    uint32 i;
+
+    /* a sweep of the whole turn against libm, 4 Q30 LSB is 3.7e-9 */
+    for (i = 0; i < 65536; i++)
+    {
+        Angle   = i * 65537u;
+        Radians = Angle * (2 * DDFK_APP_PI / 4294967296.0);
+        DDFK_APP_FixSinCos(Angle, &Sin, &Cos);
+
+        Error = fmax(fabs((double)Sin / DDFK_APP_FIX_TRIG_ONE - sin(Radians)),
+                     fabs((double)Cos / DDFK_APP_FIX_TRIG_ONE - cos(Radians)));
+        if (Error > MaxError)
+        {
+            MaxError = Error;
+        }
+    }
+    UtAssert_DoubleCmpAbs(MaxError, 0, 4.0 / DDFK_APP_FIX_TRIG_ONE, "sweep error");
+
+    /* the quadrant edges, either side of where the angle is flipped by pi */
+    for (i = 0; i < 4; i++)
+    {
+        DDFK_APP_FixSinCos(i << 30, &Sin, &Cos);
+        UtAssert_DoubleCmpAbs((double)Sin / DDFK_APP_FIX_TRIG_ONE, (i == 1) - (i == 3), 4.0 / DDFK_APP_FIX_TRIG_ONE,
+                              "quadrant %u sin", (unsigned int)i);
+        UtAssert_DoubleCmpAbs((double)Cos / DDFK_APP_FIX_TRIG_ONE, (i == 0) - (i == 2), 4.0 / DDFK_APP_FIX_TRIG_ONE,
+                              "quadrant %u cos", (unsigned int)i);
+    }
+}
+
+void Test_DDFK_APP_FixArc(void)
+{
+    /*
+     * Test Case For:
+     * void DDFK_APP_FixArc(DDFK_APP_FixPose_t *Pose, int32 LeftCounts, int32 RightCounts,
+     *                      const DDFK_APP_FixGeometry_t *Geometry)
+     */
+    static const int32     Steps[][2] = {{1000, 1000}, {1000, 1010}, {-300, 900}, {-1000, 1000}, {25000, -20000}};
+    DDFK_APP_FixGeometry_t Geometry;
+    DDFK_APP_FixPose_t     Fix;
+    DDFK_APP_Pose_t        Pose;
+    DDFK_APP_Pose_t        Reference;
+    double                 MetersPerCount = 2 * DDFK_APP_PI * 0.035 / 1437.09;
+    double                 Track          = 0.141;
+    uint32                 Seed           = 1;
+    int32                  Left;
+    int32                  Right;
+    int                    i;
+
+    UtAssert_BOOL_TRUE(DDFK_APP_FixSetGeometry(&Geometry, MetersPerCount, Track));
+
+    /* straight, a gentle arc, a sharp arc, a spin and a long step, each against the double-precision step */
+    for (i = 0; i < (int)(sizeof(Steps) / sizeof(Steps[0])); i++)
+    {
+        DDFK_APP_FixSetPose(&Fix, 250, -750, 2500);
+        DDFK_APP_FixToPose(&Fix, &Reference);
+        DDFK_APP_FixArc(&Fix, Steps[i][0], Steps[i][1], &Geometry);
+        DDFK_APP_FkArc(&Reference, Steps[i][0] * MetersPerCount, Steps[i][1] * MetersPerCount, Track);
+        DDFK_APP_FixToPose(&Fix, &Pose);
+
+        UtAssert_DoubleCmpAbs(Pose.X, Reference.X, 1e-8, "step %d X", i);
+        UtAssert_DoubleCmpAbs(Pose.Y, Reference.Y, 1e-8, "step %d Y", i);
+        UtAssert_DoubleCmpAbs(DDFK_APP_FkWrap(Pose.Heading - Reference.Heading), 0, 1e-12, "step %d Heading", i);
+    }
+
+    /*
+     * A long random drive with a hard turn every 500 steps stays with the
+     * double-precision reference, and lands on the same bits on every
+     * target.  The expected pose is what this step computes, any change to
+     * the arithmetic shows here first.
+     */
+    DDFK_APP_FixSetPose(&Fix, 0, 0, 0);
+    memset(&Reference, 0, sizeof(Reference));
+    for (i = 0; i < 20000; i++)
+    {
+        Seed  = Seed * 1664525u + 1013904223u;
+        Left  = (int32)(Seed >> 24) - 100;
+        Right = (int32)((Seed >> 16) & 0xFF) - 100;
+        if (i % 500 == 0)
+        {
+            Left *= 40;
+            Right *= -25;
+        }
+
+        DDFK_APP_FixArc(&Fix, Left, Right, &Geometry);
+        DDFK_APP_FkArc(&Reference, Left * MetersPerCount, Right * MetersPerCount, Track);
+    }
+
+    DDFK_APP_FixToPose(&Fix, &Pose);
+    UtAssert_DoubleCmpAbs(Pose.X, Reference.X, 1e-6, "drive X");
+    UtAssert_DoubleCmpAbs(Pose.Y, Reference.Y, 1e-6, "drive Y");
+    UtAssert_DoubleCmpAbs(DDFK_APP_FkWrap(Pose.Heading - Reference.Heading), 0, 1e-8, "drive Heading");
+
+    UT_FIX_EQ(Fix.X, -746448643);
+    UT_FIX_EQ(Fix.Y, -58247851178);
+    UT_FIX_EQ(Fix.Heading, 14286083367594965376u);
+}
+
+void Test_DDFK_APP_FixSetGeometry(void)
+{
+    /*
+     * Test Case For:
+     * bool DDFK_APP_FixSetGeometry(DDFK_APP_FixGeometry_t *Geometry, double MetersPerCount, double TrackWidth)
+     */
+    DDFK_APP_FixGeometry_t Geometry;
+
+    UtAssert_BOOL_TRUE(DDFK_APP_FixSetGeometry(&Geometry, 2 * DDFK_APP_PI * 0.035 / 1437.09, 0.141));
+    UT_FIX_EQ(Geometry.HalfMetersPerCount, 21536431375);
+    UT_FIX_EQ(Geometry.HalfAnglePerCount, 1593142748675761);
+
+    /* a count of Right - Left may not turn half a turn, nor a NaN get through */
+    UtAssert_BOOL_FALSE(DDFK_APP_FixSetGeometry(&Geometry, DDFK_APP_PI * 0.2, 0.2));
+    UtAssert_BOOL_FALSE(DDFK_APP_FixSetGeometry(&Geometry, NAN, 0.141));
+    UtAssert_BOOL_FALSE(DDFK_APP_FixSetGeometry(&Geometry, 0.001, 0));
+}
+
+void Test_DDFK_APP_FixPose(void)
+{
+    /*
+     * Test Case For:
+     * void DDFK_APP_FixSetPose(DDFK_APP_FixPose_t *Pose, int32 XMm, int32 YMm, int32 HeadingMrad)
+     * void DDFK_APP_FixToPose(const DDFK_APP_FixPose_t *Fix, DDFK_APP_Pose_t *Pose)
+     * void DDFK_APP_FixFromPose(const DDFK_APP_Pose_t *Pose, DDFK_APP_FixPose_t *Fix)
+     */
+    DDFK_APP_FixPose_t Fix;
+    DDFK_APP_FixPose_t Back;
+    DDFK_APP_Pose_t    Pose;
+
+    /* mm round to the nearest Q32 step, either sign */
+    DDFK_APP_FixSetPose(&Fix, -1, 1001, 0);
+    UT_FIX_EQ(Fix.X, -4294967);
+    UT_FIX_EQ(Fix.Y, DDFK_APP_FIX_POS_ONE + 4294967);
+    UT_FIX_EQ(Fix.Heading, 0);
+
+    /* the heading wraps into -pi..pi */
+    DDFK_APP_FixSetPose(&Fix, -1500, 250, -4000);
+    DDFK_APP_FixToPose(&Fix, &Pose);
+    UtAssert_DoubleCmpAbs(Pose.X, -1.5, 1e-12, "X");
+    UtAssert_DoubleCmpAbs(Pose.Y, 0.25, 1e-12, "Y");
+    UtAssert_DoubleCmpAbs(Pose.Heading, 2 * DDFK_APP_PI - 4.0, 1e-12, "Heading");
+
+    /* and back again within a step of the heading's last bit */
+    DDFK_APP_FixFromPose(&Pose, &Back);
+    UT_FIX_EQ(Back.X, Fix.X);
+    UT_FIX_EQ(Back.Y, Fix.Y);
+    UtAssert_DoubleCmpAbs((double)(int64)(Back.Heading - Fix.Heading), 0, 4096, "Heading round trip");
+}
+
+void Test_DDFK_APP_IkWheels(void)
+{
+    /*
+     * Test Case For:
+     * void DDFK_APP_IkWheels(const DDFK_APP_Twist_t *Twist, double TrackWidth, double *Left, double *Right)
+     */
+    DDFK_APP_Twist_t Twist = {0.2, 1.0};
+    double           Left;
+    double           Right;
+
+    DDFK_APP_IkWheels(&Twist, 0.1, &Left, &Right);
+    UtAssert_DoubleCmpAbs(Left, 0.15, 1e-12, "Left");
+    UtAssert_DoubleCmpAbs(Right, 0.25, 1e-12, "Right");
+
+    /* the inverse of the forward kinematics */
+    Twist.Speed    = -0.1;
+    Twist.TurnRate = -2.0;
+    DDFK_APP_IkWheels(&Twist, 0.1, &Left, &Right);
+    UtAssert_DoubleCmpAbs(0.5 * (Left + Right), -0.1, 1e-12, "Speed");
+    UtAssert_DoubleCmpAbs((Right - Left) / 0.1, -2.0, 1e-12, "TurnRate");
+}
+
+void Test_DDFK_APP_IkGoal(void)
+{
+    /*
+     * Test Case For:
+     * bool DDFK_APP_IkGoal(const DDFK_APP_Pose_t *Pose, const DDFK_APP_Pose_t *Goal,
+     *                      const DDFK_APP_IkGoalGains_t *Gains, DDFK_APP_Twist_t *Twist)
+     */
+    DDFK_APP_IkGoalGains_t Gains = {1.0, 3.0, -1.0, 0.01, 0.05};
+    DDFK_APP_Pose_t        Pose  = {0, 0, 0};
+    DDFK_APP_Pose_t        Goal  = {1.0, 0, 0};
+    DDFK_APP_Twist_t       Twist;
+    DDFK_APP_Pose_t        Start;
+    int                    i;
+
+    /* straight ahead */
+    UtAssert_BOOL_FALSE(DDFK_APP_IkGoal(&Pose, &Goal, &Gains, &Twist));
+    UtAssert_DoubleCmpAbs(Twist.Speed, 1.0, 1e-12, "ahead Speed");
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, 0, 1e-12, "ahead TurnRate");
+
+    /* off to the left, to finish facing +X */
+    Goal.Y = 1.0;
+    UtAssert_BOOL_FALSE(DDFK_APP_IkGoal(&Pose, &Goal, &Gains, &Twist));
+    UtAssert_DoubleCmpAbs(Twist.Speed, sqrt(2.0), 1e-12, "left Speed");
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, DDFK_APP_PI, 1e-12, "left TurnRate");
+
+    /* behind is reversed onto */
+    Goal.X = -1.0;
+    Goal.Y = 0;
+    UtAssert_BOOL_FALSE(DDFK_APP_IkGoal(&Pose, &Goal, &Gains, &Twist));
+    UtAssert_DoubleCmpAbs(Twist.Speed, -1.0, 1e-12, "behind Speed");
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, 0, 1e-12, "behind TurnRate");
+
+    /* on the goal the base turns in place, then arrives */
+    Goal.X       = 0.005;
+    Goal.Heading = 0.5;
+    UtAssert_BOOL_FALSE(DDFK_APP_IkGoal(&Pose, &Goal, &Gains, &Twist));
+    UtAssert_DoubleCmpAbs(Twist.Speed, 0, 1e-12, "turn Speed");
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, 1.5, 1e-12, "turn TurnRate");
+    Goal.Heading = 0.04;
+    UtAssert_BOOL_TRUE(DDFK_APP_IkGoal(&Pose, &Goal, &Gains, &Twist));
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, 0, 1e-12, "arrived TurnRate");
+
+    /* followed through the forward kinematics it gets there from anywhere */
+    Goal.X        = 0.5;
+    Goal.Y        = 0.3;
+    Goal.Heading  = DDFK_APP_PI / 2;
+    Start.X       = -0.4;
+    Start.Y       = 0.2;
+    Start.Heading = -2.5;
+    Pose          = Start;
+    for (i = 0; i < 10000 && !DDFK_APP_IkGoal(&Pose, &Goal, &Gains, &Twist); i++)
+    {
+        DDFK_APP_FkArc(&Pose, 0.01 * (Twist.Speed - 0.05 * Twist.TurnRate),
+                       0.01 * (Twist.Speed + 0.05 * Twist.TurnRate), 0.1);
+    }
+    UtAssert_True(i < 10000, "goal reached in %d steps", i);
+    UtAssert_DoubleCmpAbs(Pose.X, Goal.X, Gains.Tolerance, "goal X");
+    UtAssert_DoubleCmpAbs(Pose.Y, Goal.Y, Gains.Tolerance, "goal Y");
+    UtAssert_DoubleCmpAbs(Pose.Heading, Goal.Heading, Gains.HeadingTolerance, "goal Heading");
+}
+
+void Test_DDFK_APP_IkLimit(void)
+{
+    /*
+     * Test Case For:
+     * void DDFK_APP_IkLimit(DDFK_APP_Twist_t *Twist, const DDFK_APP_Twist_t *Previous,
+     *                       const DDFK_APP_IkLimits_t *Limits, double TrackWidth, double Dt)
+     */
+    DDFK_APP_IkLimits_t Limits   = {0.4, 4.0, 1.0, 10.0, 0.5};
+    DDFK_APP_Twist_t    Previous = {0.4, 1.0};
+    DDFK_APP_Twist_t    Twist    = {0.8, 2.0};
+
+    /* the speed limit scales the whole twist, keeping the curve */
+    DDFK_APP_IkLimit(&Twist, &Previous, &Limits, 0.1, 1.0);
+    UtAssert_DoubleCmpAbs(Twist.Speed, 0.4, 1e-12, "Speed");
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, 1.0, 1e-12, "TurnRate");
+
+    /* and so does the turn rate limit */
+    Twist.Speed    = 0.1;
+    Twist.TurnRate = -8.0;
+    DDFK_APP_IkLimit(&Twist, &Previous, &Limits, 0.1, 1.0);
+    UtAssert_DoubleCmpAbs(Twist.Speed, 0.05, 1e-12, "Speed");
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, -4.0, 1e-12, "TurnRate");
+
+    /* the acceleration limits hold each part near the last */
+    Previous.Speed    = 0;
+    Previous.TurnRate = 0;
+    Twist.Speed       = 0.4;
+    Twist.TurnRate    = -4.0;
+    DDFK_APP_IkLimit(&Twist, &Previous, &Limits, 0.1, 0.1);
+    UtAssert_DoubleCmpAbs(Twist.Speed, 0.1, 1e-12, "Speed");
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, -1.0, 1e-12, "TurnRate");
+
+    /* the wheel speed limit outranks them */
+    Limits.MaxWheelSpeed = 0.2;
+    Previous.Speed       = 0.3;
+    Previous.TurnRate    = 2.0;
+    Twist                = Previous;
+    DDFK_APP_IkLimit(&Twist, &Previous, &Limits, 0.1, 1.0);
+    UtAssert_DoubleCmpAbs(Twist.Speed, 0.15, 1e-12, "Speed");
+    UtAssert_DoubleCmpAbs(Twist.TurnRate, 1.0, 1e-12, "TurnRate");
+}
+
+/*
+ * Send Romi base 1 a state packet with one sample, Micros on the Romi clock
+ * and its odometers where they were
+ */
+static void UT_DriveState(uint32 Cycle, uint32 Micros)
+{
+    ROMIMOT_StateBatchTlm_t TestMsg;
+    size_t                  Size = offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) + sizeof(ROMIMOT_StateSample_t);
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    TestMsg.Payload.FirstCycle            = Cycle;
+    TestMsg.Payload.SampleCount           = 1;
+    TestMsg.Payload.Instance              = 1;
+    TestMsg.Payload.Samples[0].RomiMicros = Micros;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+
+    UtAssert_INT32_EQ(DDFK_APP_ProcessState(&TestMsg), CFE_SUCCESS);
+}
+
+void Test_DDFK_APP_Drive(void)
+{
+    /*
+     * Test Case For:
+     * int32 DDFK_APP_SetTwist(const DDFK_APP_SetTwistCmd_t *Msg)
+     * int32 DDFK_APP_GotoPose(const DDFK_APP_GotoPoseCmd_t *Msg)
+     * int32 DDFK_APP_Stop(const DDFK_APP_StopCmd_t *Msg)
+     * void DDFK_APP_DriveStep(uint8 Instance, double Dt)
+     */
+    DDFK_APP_SetTwistCmd_t Twist;
+    DDFK_APP_GotoPoseCmd_t Goto;
+    DDFK_APP_StopCmd_t     Stop;
+    DDFK_APP_Robot_t *     Robot = &DDFK_APP_Data.Robot[1];
+    CFE_MSG_Message_t *    MsgSend;
+    UT_CheckEvent_t        EventTest;
+
+    memset(&Twist, 0, sizeof(Twist));
+    memset(&Goto, 0, sizeof(Goto));
+    memset(&Stop, 0, sizeof(Stop));
+    memset(DDFK_APP_Data.Robot, 0, sizeof(DDFK_APP_Data.Robot));
+    DDFK_APP_Data.CmdCounter      = 0;
+    DDFK_APP_Data.ErrCounter      = 0;
+    DDFK_APP_Data.MetersPerCount  = 0.001;
+    DDFK_APP_Data.TrackWidth      = 0.1;
+    DDFK_APP_Data.Integrator      = DDFK_APP_INTEGRATOR_DOUBLE;
+    DDFK_APP_Data.StreamTimeoutMs = 0;
+
+    DDFK_APP_Data.DriveLimits.MaxSpeed      = 0.4;
+    DDFK_APP_Data.DriveLimits.MaxTurnRate   = 4.0;
+    DDFK_APP_Data.DriveLimits.MaxAccel      = 1.0;
+    DDFK_APP_Data.DriveLimits.MaxTurnAccel  = 10.0;
+    DDFK_APP_Data.DriveLimits.MaxWheelSpeed = ROMIMOT_STREAM_SPEED_MAX * 0.001;
+
+    DDFK_APP_Data.GoalGains.GainDistance     = 1.0;
+    DDFK_APP_Data.GoalGains.GainBearing      = 3.0;
+    DDFK_APP_Data.GoalGains.GainHeading      = -1.0;
+    DDFK_APP_Data.GoalGains.Tolerance        = 0.01;
+    DDFK_APP_Data.GoalGains.HeadingTolerance = 0.05;
+
+    /* no such base, a base not heard from, and no table */
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_DRIVE_ERR_EID, NULL);
+    Twist.Device = DDFK_APP_MAX_ROBOTS;
+    UtAssert_INT32_EQ(DDFK_APP_SetTwist(&Twist), CFE_SUCCESS);
+    Goto.Device = 1;
+    UtAssert_INT32_EQ(DDFK_APP_GotoPose(&Goto), CFE_SUCCESS);
+    UT_DriveState(100, 1000);
+    UtAssert_INT32_EQ(DDFK_APP_GotoPose(&Goto), CFE_SUCCESS);
+    Stop.Device = DDFK_APP_MAX_ROBOTS;
+    UtAssert_INT32_EQ(DDFK_APP_Stop(&Stop), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 4);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.ErrCounter, 4);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_IDLE);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 0);
+
+    /* stopping a base that is not driving leaves it idle */
+    Stop.Device = 1;
+    UtAssert_INT32_EQ(DDFK_APP_Stop(&Stop), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_IDLE);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.CmdCounter, 1);
+
+    /* a twist is streamed at each state packet, within the acceleration limits */
+    DDFK_APP_Data.StreamTimeoutMs = 200;
+    Twist.Device                  = 1;
+    Twist.Speed                   = 200;
+    Twist.TurnRate                = 1000;
+    Twist.DurationMs              = 1000;
+    UtAssert_INT32_EQ(DDFK_APP_SetTwist(&Twist), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_TWIST);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.CmdCounter, 2);
+    UtAssert_DoubleCmpAbs(Robot->DriveTimeLeft, 1.0, 1e-12, "DriveTimeLeft");
+
+    UT_SetDataBuffer(UT_KEY(CFE_SB_TransmitMsg), &MsgSend, sizeof(MsgSend), false);
+    UT_DriveState(101, 21000);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 1);
+    UtAssert_ADDRESS_EQ(MsgSend, &Robot->VelocityCmd);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedLeft, 10);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedRight, 30);
+    UtAssert_UINT32_EQ(Robot->VelocityCmd.TimeoutMs, 200);
+    UtAssert_DoubleCmpAbs(Robot->DriveTimeLeft, 0.98, 1e-12, "DriveTimeLeft");
+
+    /* the time it was held for runs out and the base slows to a stop */
+    Robot->DriveTimeLeft = 0.001;
+    UT_DriveState(102, 31000);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_STOP);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedLeft, 5);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedRight, 15);
+
+    UT_DriveState(103, 41000);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_IDLE);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedLeft, 0);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedRight, 0);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 3);
+
+    /* an idle base is sent nothing */
+    UT_DriveState(104, 51000);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 3);
+
+    /* a goal is driven to, a long gap between packets spanned as DDFK_APP_DRIVE_DT_MAX */
+    Goto.X       = 1000;
+    Goto.Heading = 7000;
+    UtAssert_INT32_EQ(DDFK_APP_GotoPose(&Goto), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_GOAL);
+    UtAssert_DoubleCmpAbs(Robot->DriveGoal.X, 1.0, 1e-12, "Goal X");
+    UtAssert_DoubleCmpAbs(Robot->DriveGoal.Heading, 7.0 - 2 * DDFK_APP_PI, 1e-12, "Goal Heading");
+
+    Robot->DriveGoal.Heading = 0;
+    UT_DriveState(105, 1051000);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedLeft, 100);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedRight, 100);
+
+    /* there, it stops */
+    UT_CHECKEVENT_SETUP(&EventTest, DDFK_APP_DRIVE_INF_EID, "DDFK_APP: Romi base %u reached its goal");
+    Robot->Pose.X = 1.0;
+    UT_DriveState(106, 1151000);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_IDLE);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedLeft, 0);
+
+    /* a stop ends a drive */
+    UtAssert_INT32_EQ(DDFK_APP_GotoPose(&Goto), CFE_SUCCESS);
+    UtAssert_INT32_EQ(DDFK_APP_Stop(&Stop), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_STOP);
+    UT_DriveState(107, 1161000);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_IDLE);
+
+    /* the wheel speeds are clamped to what ROMIMOT takes */
+    DDFK_APP_Data.DriveLimits.MaxSpeed = DDFK_APP_SPEED_MAX;
+    DDFK_APP_Data.DriveLimits.MaxAccel = 100.0;
+    DDFK_APP_Data.MetersPerCount       = 0.0001;
+    Twist.Speed                        = 2000;
+    Twist.TurnRate                     = 0;
+    Twist.DurationMs                   = 0;
+    UtAssert_INT32_EQ(DDFK_APP_SetTwist(&Twist), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(isinf(Robot->DriveTimeLeft));
+    UT_DriveState(108, 1171000);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedLeft, ROMIMOT_STREAM_SPEED_MAX);
+    Twist.Speed = -2000;
+    UtAssert_INT32_EQ(DDFK_APP_SetTwist(&Twist), CFE_SUCCESS);
+    UT_DriveState(109, 1271000);
+    UtAssert_INT32_EQ(Robot->VelocityCmd.SpeedRight, -ROMIMOT_STREAM_SPEED_MAX);
+    UtAssert_UINT32_EQ(Robot->DriveMode, DDFK_APP_DRIVE_TWIST);
+    UtAssert_UINT32_EQ(DDFK_APP_Data.ErrCounter, 4);
+}
+
+/*
+ * Table image handed out by CFE_TBL_GetAddress() when a test case did not
+ * supply its own with UT_SetDataBuffer()
+ */
+static DDFK_APP_Table_t UT_DefaultTbl = {.WheelRadius          = 0.035,
+                                         .TrackWidth           = 0.141,
+                                         .CountsPerRev         = 1437.09,
+                                         .Integrator           = DDFK_APP_INTEGRATOR_DOUBLE,
+                                         .StreamTimeoutMs      = 200,
+                                         .MaxSpeed             = 0.4,
+                                         .MaxTurnRate          = 4.0,
+                                         .MaxAccel             = 1.0,
+                                         .MaxTurnAccel         = 10.0,
+                                         .GoalGainDistance     = 1.0,
+                                         .GoalGainBearing      = 3.0,
+                                         .GoalGainHeading      = -1.0,
+                                         .GoalTolerance        = 0.01,
+                                         .GoalHeadingTolerance = 0.05};
+
+static void UT_Handler_CFE_TBL_GetAddress(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    void **TblPtr = UT_Hook_GetArgValueByName(Context, "TblPtr", void **);
+    int32  status;
+    void * ptr;
+
+    UT_Stub_GetInt32StatusCode(Context, &status);
+    if (status >= 0)
+    {
+        if (UT_Stub_CopyToLocal(FuncKey, &ptr, sizeof(ptr)) < sizeof(ptr))
+        {
+            ptr = &UT_DefaultTbl;
+        }
+        *TblPtr = ptr;
+    }
+}
+
 /*
  * Setup function prior to every test
  */
 void DDFK_UT_Setup(void)
 {
     UT_ResetState(0);
+    UT_SetHandlerFunction(UT_KEY(CFE_TBL_GetAddress), UT_Handler_CFE_TBL_GetAddress, NULL);
 }
 
 /*
@@ -607,13 +1739,29 @@ void UtTest_Setup(void)
 {
     ADD_TEST(DDFK_APP_Main);
     ADD_TEST(DDFK_APP_Init);
+    ADD_TEST(DDFK_APP_RtProfile);
     ADD_TEST(DDFK_APP_ProcessCommandPacket);
-    ADD_TEST(DDFK_APP_ProcessGroundCommand);
+    ADD_TEST(DDFK_APP_DispatchTable);
     ADD_TEST(DDFK_APP_ReportHousekeeping);
     ADD_TEST(DDFK_APP_NoopCmd);
     ADD_TEST(DDFK_APP_ResetCounters);
+    ADD_TEST(DDFK_APP_SendCmdStats);
     ADD_TEST(DDFK_APP_ProcessCC);
-    ADD_TEST(DDFK_APP_VerifyCmdLength);
     ADD_TEST(DDFK_APP_TblValidationFunc);
     ADD_TEST(DDFK_APP_GetCrc);
+    ADD_TEST(DDFK_APP_FkArc);
+    ADD_TEST(DDFK_APP_FkBatch);
+    ADD_TEST(DDFK_APP_ProcessState);
+    ADD_TEST(DDFK_APP_Wakeup);
+    ADD_TEST(DDFK_APP_SetPose);
+    ADD_TEST(DDFK_APP_ApplyTableConfig);
+    ADD_TEST(DDFK_APP_FixMul);
+    ADD_TEST(DDFK_APP_FixSinCos);
+    ADD_TEST(DDFK_APP_FixArc);
+    ADD_TEST(DDFK_APP_FixSetGeometry);
+    ADD_TEST(DDFK_APP_FixPose);
+    ADD_TEST(DDFK_APP_IkWheels);
+    ADD_TEST(DDFK_APP_IkGoal);
+    ADD_TEST(DDFK_APP_IkLimit);
+    ADD_TEST(DDFK_APP_Drive);
 }
@@ -0,0 +1,21 @@
+/**
+ * @file
+ *
+ * MoonRobot shared library, code common to the MoonRobot apps.
+ */
+
+#ifndef MRLIB_H
+#define MRLIB_H
+
+#include "cfe.h"
+
+#include "mrlib_dispatch.h"
+#include "mrlib_pose.h"
+#include "mrlib_rt.h"
+
+/**
+ * Library entry point, named in the ES startup script.
+ */
+int32 MRLIB_Init(void);
+
+#endif /* MRLIB_H */
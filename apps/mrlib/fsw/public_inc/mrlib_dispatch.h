@@ -0,0 +1,152 @@
+/**
+ * @file
+ *
+ * Table-driven command dispatch shared by the MoonRobot apps.
+ *
+ * Each app describes the messages on its command pipe with a constant table:
+ * one MRLIB_Route_t per message ID it subscribes to, each pointing at an
+ * array of MRLIB_Cmd_t indexed by function code.  MRLIB_Dispatch() finds the
+ * route, indexes the command, checks the packet length and calls the handler,
+ * so every app rejects bad packets the same way and none of them formats an
+ * event for a command that was accepted.
+ *
+ * The route search is bounded by the few message IDs an app subscribes to;
+ * the function code is a direct index.  Execution counts and handler run
+ * times are kept per command in an MRLIB_CmdStats_t array the app owns, one
+ * entry per MRLIB_Cmd_t.  The app sends them to the ground with
+ * MRLIB_SendCmdStats() when asked, and resets them with its other counters.
+ */
+
+#ifndef MRLIB_DISPATCH_H
+#define MRLIB_DISPATCH_H
+
+#include "cfe.h"
+
+/*
+** Command handler, called with the packet as it came off the pipe
+*/
+typedef int32 (*MRLIB_Handler_t)(const CFE_SB_Buffer_t *SBBufPtr);
+
+/*
+** Defines Fn##_Handler, a static MRLIB_Handler_t that passes the packet on to
+** a handler of the usual "int32 Fn(const MsgType *Msg)" shape, so the table
+** calls every handler through its own type.  Used at file scope, without a
+** trailing semicolon.
+*/
+#define MRLIB_HANDLER_ADAPTER(Fn, MsgType)                     \
+    static int32 Fn##_Handler(const CFE_SB_Buffer_t *SBBufPtr) \
+    {                                                          \
+        return Fn((const MsgType *)SBBufPtr);                  \
+    }
+
+/*
+** One command.  A NULL Handler leaves a hole in the function code range,
+** which is rejected like an unknown function code.
+*/
+typedef struct
+{
+    MRLIB_Handler_t Handler;
+    size_t          Length; /* Expected total packet size, 0 accepts any */
+} MRLIB_Cmd_t;
+
+typedef struct
+{
+    uint32 Count;         /* Handler calls */
+    uint32 HandlerErrors; /* Calls that returned other than CFE_SUCCESS */
+    uint32 LengthErrors;  /* Packets rejected for their length */
+    uint32 LastUs;        /* Handler run time, last call */
+    uint32 MaxUs;         /* Handler run time, worst call */
+    uint64 TotalUs;       /* Handler run time, all calls */
+} MRLIB_CmdStats_t;
+
+/*
+** One message ID.  With FcnCodes set to 0 the function code is not looked at
+** and Cmds[0] handles every packet, for housekeeping requests and wakeups.
+** A NULL Stats keeps no statistics for the route.
+*/
+typedef struct
+{
+    CFE_SB_MsgId_Atom_t MsgId;
+    uint16              FcnCodes; /* Entries in Cmds and Stats, 0 for one entry that ignores the code */
+    const MRLIB_Cmd_t * Cmds;
+    MRLIB_CmdStats_t *  Stats;
+} MRLIB_Route_t;
+
+typedef struct
+{
+    const MRLIB_Route_t *Routes;
+    uint16               RouteCount;
+
+    /* Error events sent on the app's behalf */
+    uint16 MsgIdErrEventId;
+    uint16 FcnCodeErrEventId;
+    uint16 LengthErrEventId;
+} MRLIB_Dispatch_t;
+
+/*
+** Number of entries in a constant table, for filling in FcnCodes and
+** RouteCount
+*/
+#define MRLIB_COUNT(Table) (sizeof(Table) / sizeof((Table)[0]))
+
+/*
+** Command statistics packet.  One entry per command with statistics, in the
+** order of the dispatch table, with the run times in microseconds.  Each app
+** sends it on its own message ID when the ground asks for it.
+*/
+#define MRLIB_CMD_STATS_MAX 24 /* Entries one packet carries */
+
+typedef struct __attribute__((__packed__))
+{
+    uint16 MsgId;
+    uint16 FcnCode; /* 0 on a route that ignores the code */
+    uint32 Count;
+    uint32 HandlerErrors;
+    uint32 LengthErrors;
+    uint32 LastUs;
+    uint32 MaxUs;
+    uint32 MeanUs;
+} MRLIB_CmdStatsEntry_Payload_t;
+
+typedef struct __attribute__((__packed__))
+{
+    uint8                         EntryCount; /* Entries filled in */
+    uint8                         Commands;   /* In the table, more than EntryCount if they did not all fit */
+    uint8                         Spare[2];
+    MRLIB_CmdStatsEntry_Payload_t Entries[MRLIB_CMD_STATS_MAX];
+} MRLIB_CmdStatsTlm_Payload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t   TelemetryHeader; /**< \brief Telemetry header */
+    MRLIB_CmdStatsTlm_Payload_t Payload;         /**< \brief Telemetry payload */
+} MRLIB_CmdStatsTlm_t;
+
+/**
+ * Route one packet from an app's command pipe to its handler.
+ *
+ * Returns CFE_SUCCESS once a handler has run, whatever the handler returned,
+ * or CFE_STATUS_UNKNOWN_MSG_ID, CFE_STATUS_BAD_COMMAND_CODE or
+ * CFE_STATUS_WRONG_MSG_LENGTH after sending the matching error event.  The
+ * app counts the rejection in its own error counter.
+ */
+int32 MRLIB_Dispatch(const MRLIB_Dispatch_t *Dispatch, const CFE_SB_Buffer_t *SBBufPtr);
+
+/**
+ * Statistics for one command, NULL if the table has no such entry.
+ */
+const MRLIB_CmdStats_t *MRLIB_GetCmdStats(const MRLIB_Dispatch_t *Dispatch, CFE_SB_MsgId_Atom_t MsgId,
+                                          CFE_MSG_FcnCode_t FcnCode);
+
+/**
+ * Clear the statistics of every command in the table.
+ */
+void MRLIB_ResetCmdStats(const MRLIB_Dispatch_t *Dispatch);
+
+/**
+ * Fill in a statistics packet from the table and send it.  The app
+ * initializes Tlm with its own message ID and sizeof(MRLIB_CmdStatsTlm_t).
+ */
+void MRLIB_SendCmdStats(const MRLIB_Dispatch_t *Dispatch, MRLIB_CmdStatsTlm_t *Tlm);
+
+#endif /* MRLIB_DISPATCH_H */
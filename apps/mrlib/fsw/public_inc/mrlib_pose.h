@@ -0,0 +1,69 @@
+/**
+ * @file
+ *
+ * Pose history of the Romi bases, for asking where a base was at a given
+ * time.
+ *
+ * DDFK records the pose of every state sample it integrates, stamped with
+ * the sample's CFE time, into a fixed ring per base.  Any app can then look
+ * up the pose at the time it captured a camera frame or a sensor sample by
+ * calling MRLIB_PoseAt() directly, without a request and reply over SB.
+ * The lookup is a binary search over the ring and interpolates between the
+ * two poses either side of the time.
+ *
+ * DDFK is the only writer.  Readers never block it and take no lock: the
+ * ring is published with atomics, and a reader that was held off long
+ * enough for the writer to lap it finds out and searches again.
+ */
+
+#ifndef MRLIB_POSE_H
+#define MRLIB_POSE_H
+
+#include "cfe.h"
+
+#define MRLIB_POSE_MAX_ROBOTS 4 /* Romi bases with a history, at least ROMIMOT_MAX_DEVICES */
+
+/*
+** Poses kept per base, a power of two.  4 s at the top ROMIMOT control
+** rate of 500 Hz, 20 s at 100 Hz.
+*/
+#define MRLIB_POSE_HISTORY_DEPTH 2048
+
+/*
+** Body pose in the odometry frame, as DDFK integrates it
+*/
+typedef struct
+{
+    double X;       /* m */
+    double Y;       /* m */
+    double Heading; /* rad, -pi..pi, counterclockwise from +X */
+} MRLIB_Pose_t;
+
+/**
+ * Append the pose of a base at Time.  Called by DDFK only.
+ *
+ * Times must increase.  A time at or before the newest one recorded, from
+ * a restarted ROMIMOT or a CFE time that was set back, starts the history
+ * over from this pose.
+ */
+void MRLIB_PoseRecord(uint16 Robot, CFE_TIME_SysTime_t Time, const MRLIB_Pose_t *Pose);
+
+/**
+ * Forget the history of a base, whose pose has jumped.  Called by DDFK
+ * only.
+ */
+void MRLIB_PoseClear(uint16 Robot);
+
+/**
+ * Pose of a base at Time.
+ *
+ * Between two recorded poses the position is interpolated linearly and the
+ * heading along the shorter way round, which is SLERP for a rotation in
+ * the plane.  Returns CFE_SUCCESS with the pose, CFE_STATUS_RANGE_ERROR
+ * with the oldest or newest pose when Time is outside the history,
+ * CFE_STATUS_INCORRECT_STATE when the base has no history, or
+ * CFE_ES_BAD_ARGUMENT for a base out of range.
+ */
+int32 MRLIB_PoseAt(uint16 Robot, CFE_TIME_SysTime_t Time, MRLIB_Pose_t *Pose);
+
+#endif /* MRLIB_POSE_H */
@@ -0,0 +1,83 @@
+/**
+ * @file
+ *
+ * Real-time scheduling profiles for the MoonRobot tasks.
+ *
+ * On Linux OSAL only uses the ES startup script priorities when the process
+ * may run SCHED_FIFO, and even then leaves every task free to run on any
+ * core and take page faults.  A task applies a profile to itself when it
+ * starts: it moves to SCHED_FIFO at a Linux priority, restricts itself to a
+ * set of CPUs, locks the process memory and touches its own stack, so the
+ * pages its loop uses are resident before the loop runs.
+ *
+ * The kernel may refuse any step (no CAP_SYS_NICE, a low RLIMIT_MEMLOCK, an
+ * offline CPU).  Every step is tried regardless, and MRLIB_RtApply() reads
+ * back what the task actually got so the app can report it in telemetry.
+ * Memory locking is process wide, all cFS apps share the one process.
+ */
+
+#ifndef MRLIB_RT_H
+#define MRLIB_RT_H
+
+#include "cfe.h"
+
+#define MRLIB_RT_PRIORITY_MAX 99          /* Highest SCHED_FIFO priority on Linux */
+#define MRLIB_RT_PREFAULT_MAX (64 * 1024) /* Bound on PrefaultBytes */
+
+/*
+** Values for MRLIB_RtStatus_t Policy
+*/
+#define MRLIB_RT_POLICY_OTHER 0 /* Time shared, as OSAL leaves it without privileges */
+#define MRLIB_RT_POLICY_FIFO  1
+#define MRLIB_RT_POLICY_RR    2
+
+/*
+** Bits in MRLIB_RtStatus_t Errors, one per step the kernel refused
+*/
+#define MRLIB_RT_ERR_PRIORITY    0x01
+#define MRLIB_RT_ERR_AFFINITY    0x02
+#define MRLIB_RT_ERR_MEMLOCK     0x04
+#define MRLIB_RT_ERR_READBACK    0x08
+#define MRLIB_RT_ERR_UNSUPPORTED 0x80 /* Not a Linux build, nothing was changed */
+
+/*
+** Profile, as it appears in an app's table
+*/
+typedef struct
+{
+    uint8  Enabled;       /* 0 leaves the task as OSAL created it */
+    uint8  Priority;      /* SCHED_FIFO priority 1..MRLIB_RT_PRIORITY_MAX, 0 keeps the OSAL policy */
+    uint8  LockMemory;    /* Lock the process's current and future pages */
+    uint8  Spare;
+    uint32 CpuMask;       /* Bit n allows CPU n, 0 keeps the CPUs the task inherited */
+    uint32 PrefaultBytes; /* Stack touched before the task starts work, 0..MRLIB_RT_PREFAULT_MAX */
+} MRLIB_RtProfile_t;
+
+/*
+** What the task got, read back from the kernel after applying the profile
+*/
+typedef struct
+{
+    uint8  Policy;   /* MRLIB_RT_POLICY_* */
+    uint8  Priority; /* Linux priority, 0 for MRLIB_RT_POLICY_OTHER */
+    uint8  Errors;   /* MRLIB_RT_ERR_* */
+    uint8  Spare;
+    uint32 CpuMask;  /* CPUs 0..31 the task may run on */
+    uint32 LockedKb; /* Process memory locked, VmLck */
+} MRLIB_RtStatus_t;
+
+/**
+ * Check a profile from a table, true if MRLIB_RtApply() can take it.
+ */
+bool MRLIB_RtValidate(const MRLIB_RtProfile_t *Profile);
+
+/**
+ * Apply a profile to the calling task and read back the result into Status.
+ *
+ * A disabled profile changes nothing and only reads back.  Returns
+ * CFE_SUCCESS when every step of the profile took, otherwise
+ * CFE_STATUS_EXTERNAL_RESOURCE_FAIL with the failed steps in Status->Errors.
+ */
+int32 MRLIB_RtApply(const MRLIB_RtProfile_t *Profile, MRLIB_RtStatus_t *Status);
+
+#endif /* MRLIB_RT_H */
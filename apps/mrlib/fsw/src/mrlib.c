@@ -0,0 +1,22 @@
+/**
+ * \file
+ *   This file contains the entry point of the MoonRobot shared library.
+ */
+
+/*
+** Include Files:
+*/
+#include "mrlib.h"
+#include "mrlib_version.h"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Library initialization, called once by ES before any app starts            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 MRLIB_Init(void)
+{
+    OS_printf("MRLIB Initialized.%s\n", MRLIB_VERSION_STRING);
+
+    return CFE_SUCCESS;
+}
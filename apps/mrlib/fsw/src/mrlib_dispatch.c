@@ -0,0 +1,236 @@
+/**
+ * \file
+ *   Table-driven command dispatch shared by the MoonRobot apps.
+ */
+
+/*
+** Include Files:
+*/
+#include "mrlib_dispatch.h"
+
+#include <string.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Local time in microseconds, for handler timing only                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int64 MRLIB_GetTimeUs(void)
+{
+    OS_time_t Now;
+
+    OS_GetLocalTime(&Now);
+
+    return OS_TimeGetTotalMicroseconds(Now);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Find the route for a message ID, NULL if the app does not handle it        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static const MRLIB_Route_t *MRLIB_FindRoute(const MRLIB_Dispatch_t *Dispatch, CFE_SB_MsgId_Atom_t MsgId)
+{
+    uint16 i;
+
+    for (i = 0; i < Dispatch->RouteCount; i++)
+    {
+        if (Dispatch->Routes[i].MsgId == MsgId)
+        {
+            return &Dispatch->Routes[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Route one command pipe packet to its handler                               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 MRLIB_Dispatch(const MRLIB_Dispatch_t *Dispatch, const CFE_SB_Buffer_t *SBBufPtr)
+{
+    CFE_SB_MsgId_t       MsgId        = CFE_SB_INVALID_MSG_ID;
+    CFE_MSG_FcnCode_t    FcnCode      = 0;
+    size_t               ActualLength = 0;
+    uint16               Index        = 0;
+    const MRLIB_Route_t *Route;
+    const MRLIB_Cmd_t *  Cmd;
+    MRLIB_CmdStats_t *   Stats;
+    int64                StartUs;
+    uint32               ElapsedUs;
+    int32                Status;
+
+    CFE_MSG_GetMsgId(&SBBufPtr->Msg, &MsgId);
+    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &FcnCode);
+
+    Route = MRLIB_FindRoute(Dispatch, CFE_SB_MsgIdToValue(MsgId));
+    if (Route == NULL)
+    {
+        CFE_EVS_SendEvent(Dispatch->MsgIdErrEventId, CFE_EVS_EventType_ERROR, "Invalid command packet, MID = 0x%x",
+                          (unsigned int)CFE_SB_MsgIdToValue(MsgId));
+        return CFE_STATUS_UNKNOWN_MSG_ID;
+    }
+
+    /*
+    ** A route without function codes always runs its first entry
+    */
+    if (Route->FcnCodes != 0)
+    {
+        Index = FcnCode;
+    }
+
+    if ((Route->FcnCodes != 0 && Index >= Route->FcnCodes) || Route->Cmds[Index].Handler == NULL)
+    {
+        CFE_EVS_SendEvent(Dispatch->FcnCodeErrEventId, CFE_EVS_EventType_ERROR,
+                          "Invalid ground command code: ID = 0x%X, CC = %u", (unsigned int)CFE_SB_MsgIdToValue(MsgId),
+                          (unsigned int)FcnCode);
+        return CFE_STATUS_BAD_COMMAND_CODE;
+    }
+
+    Cmd   = &Route->Cmds[Index];
+    Stats = Route->Stats != NULL ? &Route->Stats[Index] : NULL;
+
+    /*
+    ** Verify the command packet length.
+    */
+    CFE_MSG_GetSize(&SBBufPtr->Msg, &ActualLength);
+    if (Cmd->Length != 0 && ActualLength != Cmd->Length)
+    {
+        if (Stats != NULL)
+        {
+            Stats->LengthErrors++;
+        }
+
+        CFE_EVS_SendEvent(Dispatch->LengthErrEventId, CFE_EVS_EventType_ERROR,
+                          "Invalid Msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u",
+                          (unsigned int)CFE_SB_MsgIdToValue(MsgId), (unsigned int)FcnCode, (unsigned int)ActualLength,
+                          (unsigned int)Cmd->Length);
+        return CFE_STATUS_WRONG_MSG_LENGTH;
+    }
+
+    if (Stats == NULL)
+    {
+        Cmd->Handler(SBBufPtr);
+        return CFE_SUCCESS;
+    }
+
+    StartUs   = MRLIB_GetTimeUs();
+    Status    = Cmd->Handler(SBBufPtr);
+    ElapsedUs = (uint32)(MRLIB_GetTimeUs() - StartUs);
+
+    Stats->Count++;
+    if (Status != CFE_SUCCESS)
+    {
+        Stats->HandlerErrors++;
+    }
+    Stats->LastUs = ElapsedUs;
+    Stats->TotalUs += ElapsedUs;
+    if (ElapsedUs > Stats->MaxUs)
+    {
+        Stats->MaxUs = ElapsedUs;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Statistics for one command                                                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+const MRLIB_CmdStats_t *MRLIB_GetCmdStats(const MRLIB_Dispatch_t *Dispatch, CFE_SB_MsgId_Atom_t MsgId,
+                                          CFE_MSG_FcnCode_t FcnCode)
+{
+    const MRLIB_Route_t *Route = MRLIB_FindRoute(Dispatch, MsgId);
+
+    if (Route == NULL || Route->Stats == NULL)
+    {
+        return NULL;
+    }
+
+    if (Route->FcnCodes == 0)
+    {
+        return &Route->Stats[0];
+    }
+
+    if (FcnCode >= Route->FcnCodes)
+    {
+        return NULL;
+    }
+
+    return &Route->Stats[FcnCode];
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Clear the statistics of every command in the table                         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void MRLIB_ResetCmdStats(const MRLIB_Dispatch_t *Dispatch)
+{
+    uint16 i;
+
+    for (i = 0; i < Dispatch->RouteCount; i++)
+    {
+        if (Dispatch->Routes[i].Stats != NULL)
+        {
+            memset(Dispatch->Routes[i].Stats, 0,
+                   sizeof(MRLIB_CmdStats_t) * (Dispatch->Routes[i].FcnCodes == 0 ? 1 : Dispatch->Routes[i].FcnCodes));
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Send the statistics of every command in the table                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void MRLIB_SendCmdStats(const MRLIB_Dispatch_t *Dispatch, MRLIB_CmdStatsTlm_t *Tlm)
+{
+    MRLIB_CmdStatsTlm_Payload_t *  Payload = &Tlm->Payload;
+    MRLIB_CmdStatsEntry_Payload_t *Entry;
+    const MRLIB_Route_t *          Route;
+    const MRLIB_CmdStats_t *       Stats;
+    uint16                         Entries;
+    uint16                         i;
+    uint16                         j;
+
+    memset(Payload, 0, sizeof(*Payload));
+
+    for (i = 0; i < Dispatch->RouteCount; i++)
+    {
+        Route   = &Dispatch->Routes[i];
+        Entries = Route->FcnCodes == 0 ? 1 : Route->FcnCodes;
+
+        for (j = 0; j < Entries && Route->Stats != NULL; j++)
+        {
+            if (Route->Cmds[j].Handler == NULL)
+            {
+                continue;
+            }
+
+            Payload->Commands++;
+            if (Payload->EntryCount == MRLIB_CMD_STATS_MAX)
+            {
+                continue;
+            }
+
+            Stats = &Route->Stats[j];
+            Entry = &Payload->Entries[Payload->EntryCount++];
+
+            Entry->MsgId         = (uint16)Route->MsgId;
+            Entry->FcnCode       = j;
+            Entry->Count         = Stats->Count;
+            Entry->HandlerErrors = Stats->HandlerErrors;
+            Entry->LengthErrors  = Stats->LengthErrors;
+            Entry->LastUs        = Stats->LastUs;
+            Entry->MaxUs         = Stats->MaxUs;
+            Entry->MeanUs        = Stats->Count != 0 ? (uint32)(Stats->TotalUs / Stats->Count) : 0;
+        }
+    }
+
+    CFE_SB_TimeStampMsg(CFE_MSG_PTR(Tlm->TelemetryHeader));
+    CFE_SB_TransmitMsg(CFE_MSG_PTR(Tlm->TelemetryHeader), true);
+}
@@ -0,0 +1,253 @@
+/**
+ * \file
+ *   Pose history of the Romi bases.
+ */
+
+/*
+** Include Files:
+*/
+#include "mrlib_pose.h"
+
+#define MRLIB_POSE_MASK       (MRLIB_POSE_HISTORY_DEPTH - 1)
+#define MRLIB_POSE_READ_TRIES 4 /* Searches before a reader the writer keeps lapping gives up */
+#define MRLIB_POSE_PI         3.14159265358979323846
+
+/*
+** One recorded pose, with its CFE time as a single 64 bit number so the
+** search compares integers
+*/
+typedef struct
+{
+    uint64       Key; /* Seconds in the upper 32 bits, subseconds in the lower */
+    MRLIB_Pose_t Pose;
+} MRLIB_PoseStamp_t;
+
+/*
+** History of one base.  Head and Tail only count up, Stamps[Tail & MASK]
+** up to Stamps[(Head - 1) & MASK] are the poses in time order, and the
+** writer keeps at most DEPTH - 1 of them so the slot it is filling is
+** never one a reader may search.
+*/
+typedef struct
+{
+    uint32            Head; /* Poses ever recorded */
+    uint32            Tail; /* Oldest pose kept */
+    MRLIB_PoseStamp_t Stamps[MRLIB_POSE_HISTORY_DEPTH];
+} MRLIB_PoseHistory_t;
+
+static MRLIB_PoseHistory_t MRLIB_PoseHistory[MRLIB_POSE_MAX_ROBOTS];
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* CFE time as a search key                                                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static uint64 MRLIB_PoseKey(CFE_TIME_SysTime_t Time)
+{
+    return ((uint64)Time.Seconds << 32) | Time.Subseconds;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Wrap an angle within one turn of -pi..pi back into it                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static double MRLIB_PoseWrap(double Angle)
+{
+    if (Angle > MRLIB_POSE_PI)
+    {
+        Angle -= 2.0 * MRLIB_POSE_PI;
+    }
+    else if (Angle < -MRLIB_POSE_PI)
+    {
+        Angle += 2.0 * MRLIB_POSE_PI;
+    }
+
+    return Angle;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Append a pose, called by DDFK only                                         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void MRLIB_PoseRecord(uint16 Robot, CFE_TIME_SysTime_t Time, const MRLIB_Pose_t *Pose)
+{
+    MRLIB_PoseHistory_t *History;
+    MRLIB_PoseStamp_t *  Stamp;
+    uint32               Head;
+    uint32               Tail;
+    uint64               Key = MRLIB_PoseKey(Time);
+
+    if (Robot >= MRLIB_POSE_MAX_ROBOTS)
+    {
+        return;
+    }
+
+    History = &MRLIB_PoseHistory[Robot];
+    Head    = History->Head;
+    Tail    = History->Tail;
+
+    /* Keep the history in time order for the search, and one slot clear of it */
+    if (Head != Tail && Key <= History->Stamps[(Head - 1) & MRLIB_POSE_MASK].Key)
+    {
+        __atomic_store_n(&History->Tail, Head, __ATOMIC_RELEASE);
+    }
+    else if (Head - Tail == MRLIB_POSE_HISTORY_DEPTH - 1)
+    {
+        __atomic_store_n(&History->Tail, Tail + 1, __ATOMIC_RELEASE);
+    }
+
+    /*
+    ** A reader that sees any of the new slot also sees Head and Tail as they
+    ** were before it, and so knows the pose it held is gone
+    */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    Stamp       = &History->Stamps[Head & MRLIB_POSE_MASK];
+    Stamp->Key  = Key;
+    Stamp->Pose = *Pose;
+
+    __atomic_store_n(&History->Head, Head + 1, __ATOMIC_RELEASE);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Forget the history of a base, called by DDFK only                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void MRLIB_PoseClear(uint16 Robot)
+{
+    if (Robot < MRLIB_POSE_MAX_ROBOTS)
+    {
+        __atomic_store_n(&MRLIB_PoseHistory[Robot].Tail, MRLIB_PoseHistory[Robot].Head, __ATOMIC_RELEASE);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Search Count poses from Tail for Key, setting Oldest to the lowest one     */
+/* read so the caller can check none of them changed underneath it            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int32 MRLIB_PoseSearch(const MRLIB_PoseHistory_t *History, uint32 Tail, uint32 Count, uint64 Key,
+                              MRLIB_Pose_t *Pose, uint32 *Oldest)
+{
+    MRLIB_PoseStamp_t Before;
+    MRLIB_PoseStamp_t After;
+    uint32            Lo     = 0;
+    uint32            Hi     = Count;
+    uint32            Lowest = Count - 1; /* Offsets from Tail, which the counts may wrap past */
+    uint32            Mid;
+    double            Fraction;
+    int32             Status = CFE_SUCCESS;
+
+    /*
+    ** The first pose at or after Key.  The search itself reads the pose
+    ** before it whenever there is one, so Lowest covers the poses used below.
+    */
+    while (Lo < Hi)
+    {
+        Mid = Lo + (Hi - Lo) / 2;
+        if (Mid < Lowest)
+        {
+            Lowest = Mid;
+        }
+
+        if (History->Stamps[(Tail + Mid) & MRLIB_POSE_MASK].Key < Key)
+        {
+            Lo = Mid + 1;
+        }
+        else
+        {
+            Hi = Mid;
+        }
+    }
+
+    if (Lo == Count)
+    {
+        *Pose  = History->Stamps[(Tail + Count - 1) & MRLIB_POSE_MASK].Pose;
+        Status = CFE_STATUS_RANGE_ERROR;
+    }
+    else
+    {
+        After = History->Stamps[(Tail + Lo) & MRLIB_POSE_MASK];
+        if (After.Key == Key)
+        {
+            *Pose = After.Pose;
+        }
+        else if (Lo == 0)
+        {
+            *Pose  = After.Pose;
+            Status = CFE_STATUS_RANGE_ERROR;
+        }
+        else
+        {
+            Before = History->Stamps[(Tail + Lo - 1) & MRLIB_POSE_MASK];
+
+            Fraction      = (double)(Key - Before.Key) / (double)(After.Key - Before.Key);
+            Pose->X       = Before.Pose.X + Fraction * (After.Pose.X - Before.Pose.X);
+            Pose->Y       = Before.Pose.Y + Fraction * (After.Pose.Y - Before.Pose.Y);
+            Pose->Heading = MRLIB_PoseWrap(Before.Pose.Heading +
+                                           Fraction * MRLIB_PoseWrap(After.Pose.Heading - Before.Pose.Heading));
+        }
+    }
+
+    *Oldest = Tail + Lowest;
+
+    return Status;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Pose of a base at a time, interpolated between the poses either side       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 MRLIB_PoseAt(uint16 Robot, CFE_TIME_SysTime_t Time, MRLIB_Pose_t *Pose)
+{
+    MRLIB_PoseHistory_t *History;
+    uint32               Head;
+    uint32               Tail;
+    uint32               Oldest;
+    int32                Status;
+    int                  Try;
+
+    if (Robot >= MRLIB_POSE_MAX_ROBOTS || Pose == NULL)
+    {
+        return CFE_ES_BAD_ARGUMENT;
+    }
+
+    History = &MRLIB_PoseHistory[Robot];
+
+    for (Try = 0; Try < MRLIB_POSE_READ_TRIES; Try++)
+    {
+        Tail = __atomic_load_n(&History->Tail, __ATOMIC_ACQUIRE);
+        Head = __atomic_load_n(&History->Head, __ATOMIC_ACQUIRE);
+        if (Head == Tail)
+        {
+            return CFE_STATUS_INCORRECT_STATE;
+        }
+
+        /* Lapped between the two loads */
+        if (Head - Tail > MRLIB_POSE_HISTORY_DEPTH - 1)
+        {
+            continue;
+        }
+
+        Status = MRLIB_PoseSearch(History, Tail, Head - Tail, MRLIB_PoseKey(Time), Pose, &Oldest);
+
+        /*
+        ** The answer stands if the writer has not since dropped or started
+        ** to overwrite any pose the search read
+        */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        Head = __atomic_load_n(&History->Head, __ATOMIC_RELAXED);
+        Tail = __atomic_load_n(&History->Tail, __ATOMIC_RELAXED);
+        if (Head - Oldest < MRLIB_POSE_HISTORY_DEPTH && (int32)(Oldest - Tail) >= 0)
+        {
+            return Status;
+        }
+    }
+
+    return CFE_STATUS_INCORRECT_STATE;
+}
@@ -0,0 +1,235 @@
+/**
+ * \file
+ *   Real-time scheduling profiles for the MoonRobot tasks.
+ */
+
+/*
+** CPU affinity and the thread attributes of a running task are GNU
+** extensions, and must be asked for before any system header
+*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/*
+** Include Files:
+*/
+#include "mrlib_rt.h"
+
+#include <string.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define MRLIB_RT_MASK_CPUS 32 /* CPUs covered by CpuMask */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Stack the calling task may prefault, at most half of what it has so the    */
+/* touch cannot run off the end                                               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static size_t MRLIB_RtStackBudget(size_t Bytes)
+{
+    pthread_attr_t Attr;
+    size_t         StackSize = 0;
+
+    if (pthread_getattr_np(pthread_self(), &Attr) == 0)
+    {
+        pthread_attr_getstacksize(&Attr, &StackSize);
+        pthread_attr_destroy(&Attr);
+    }
+
+    if (Bytes > StackSize / 2)
+    {
+        Bytes = StackSize / 2;
+    }
+
+    return Bytes;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Write one byte in every page of a stack frame Bytes long                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void MRLIB_RtTouchStack(size_t Bytes)
+{
+    uint8           Frame[Bytes];
+    volatile uint8 *Touch = Frame; /* keeps the writes to a dead frame */
+    size_t          Page  = (size_t)sysconf(_SC_PAGESIZE);
+    size_t          i;
+
+    for (i = 0; i < Bytes; i += Page)
+    {
+        Touch[i] = 0;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Process memory locked by mlockall, from /proc, in kB                       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static uint32 MRLIB_RtLockedKb(void)
+{
+    FILE *        File;
+    char          Line[128];
+    unsigned long Kb = 0;
+
+    File = fopen("/proc/self/status", "r");
+    if (File == NULL)
+    {
+        return 0;
+    }
+
+    while (fgets(Line, sizeof(Line), File) != NULL)
+    {
+        if (sscanf(Line, "VmLck: %lu", &Kb) == 1)
+        {
+            break;
+        }
+    }
+    fclose(File);
+
+    return (uint32)Kb;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Read back the calling task's policy, priority and CPUs                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void MRLIB_RtReadBack(MRLIB_RtStatus_t *Status)
+{
+    struct sched_param Param;
+    cpu_set_t          Cpus;
+    int                Policy;
+    int                i;
+
+    if (pthread_getschedparam(pthread_self(), &Policy, &Param) == 0)
+    {
+        if (Policy == SCHED_FIFO)
+        {
+            Status->Policy = MRLIB_RT_POLICY_FIFO;
+        }
+        else if (Policy == SCHED_RR)
+        {
+            Status->Policy = MRLIB_RT_POLICY_RR;
+        }
+        Status->Priority = (uint8)Param.sched_priority;
+    }
+    else
+    {
+        Status->Errors |= MRLIB_RT_ERR_READBACK;
+    }
+
+    if (pthread_getaffinity_np(pthread_self(), sizeof(Cpus), &Cpus) == 0)
+    {
+        for (i = 0; i < MRLIB_RT_MASK_CPUS; i++)
+        {
+            if (CPU_ISSET(i, &Cpus))
+            {
+                Status->CpuMask |= (uint32)1 << i;
+            }
+        }
+    }
+    else
+    {
+        Status->Errors |= MRLIB_RT_ERR_READBACK;
+    }
+
+    Status->LockedKb = MRLIB_RtLockedKb();
+}
+#endif /* __linux__ */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Check a profile from a table                                               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool MRLIB_RtValidate(const MRLIB_RtProfile_t *Profile)
+{
+    return Profile->Enabled <= 1 && Profile->LockMemory <= 1 && Profile->Priority <= MRLIB_RT_PRIORITY_MAX &&
+           Profile->PrefaultBytes <= MRLIB_RT_PREFAULT_MAX;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Apply a profile to the calling task and read back what it got              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 MRLIB_RtApply(const MRLIB_RtProfile_t *Profile, MRLIB_RtStatus_t *Status)
+{
+#ifdef __linux__
+    struct sched_param Param;
+    cpu_set_t          Cpus;
+    size_t             Prefault;
+    int                i;
+#endif
+
+    memset(Status, 0, sizeof(*Status));
+
+#ifdef __linux__
+    if (Profile->Enabled)
+    {
+        if (Profile->Priority != 0)
+        {
+            memset(&Param, 0, sizeof(Param));
+            Param.sched_priority = Profile->Priority;
+            if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &Param) != 0)
+            {
+                Status->Errors |= MRLIB_RT_ERR_PRIORITY;
+            }
+        }
+
+        if (Profile->CpuMask != 0)
+        {
+            CPU_ZERO(&Cpus);
+            for (i = 0; i < MRLIB_RT_MASK_CPUS; i++)
+            {
+                if (Profile->CpuMask & ((uint32)1 << i))
+                {
+                    CPU_SET(i, &Cpus);
+                }
+            }
+            if (pthread_setaffinity_np(pthread_self(), sizeof(Cpus), &Cpus) != 0)
+            {
+                Status->Errors |= MRLIB_RT_ERR_AFFINITY;
+            }
+        }
+
+        /*
+        ** Lock before touching the stack, so the pages it faults in stay
+        */
+        if (Profile->LockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            Status->Errors |= MRLIB_RT_ERR_MEMLOCK;
+        }
+
+        Prefault = MRLIB_RtStackBudget(Profile->PrefaultBytes);
+        if (Prefault != 0)
+        {
+            MRLIB_RtTouchStack(Prefault);
+        }
+    }
+
+    MRLIB_RtReadBack(Status);
+#else
+    if (Profile->Enabled)
+    {
+        Status->Errors = MRLIB_RT_ERR_UNSUPPORTED;
+    }
+#endif
+
+    if (Status->Errors != 0)
+    {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    return CFE_SUCCESS;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file
+ *
+ *  The MoonRobot shared library header file containing version information
+ */
+
+#ifndef MRLIB_VERSION_H
+#define MRLIB_VERSION_H
+
+/* Development Build Macro Definitions */
+
+#define MRLIB_BUILD_NUMBER 0 /*!< Development Build: Number of commits since baseline */
+#define MRLIB_BUILD_BASELINE                                                              \
+    "v1.0.0" /*!< Development Build: git tag that is the base for the current development \
+              */
+
+/*
+ * Version Macros, see \ref cfsversions for definitions.
+ */
+#define MRLIB_MAJOR_VERSION 1 /*!< @brief Major version number. */
+#define MRLIB_MINOR_VERSION 0 /*!< @brief Minor version number. */
+#define MRLIB_REVISION      0 /*!< @brief Revision version number. */
+
+/*!
+ * @brief Mission revision.
+ *
+ * Reserved for mission use to denote patches/customizations as needed.
+ * Values 1-254 are reserved for mission use to denote patches/customizations as needed. NOTE: Reserving 0 and 0xFF for
+ * cFS open-source development use (pending resolution of nasa/cFS#440)
+ */
+#define MRLIB_MISSION_REV 0xFF
+
+/*! @brief Development Build Version Number.
+ * @details Baseline git tag + Number of commits since baseline. @n
+ * See @ref cfsversions for format differences between development and release versions.
+ */
+#define MRLIB_VERSION MRLIB_BUILD_BASELINE
+
+/*! @brief Development Build Version String.
+ * @details Reports the current development build's baseline, number, and name. Also includes a note about the latest
+ * official version. @n See @ref cfsversions for format differences between development and release versions.
+ */
+#define MRLIB_VERSION_STRING " MoonRobot Lib " MRLIB_VERSION
+
+#endif /* MRLIB_VERSION_H */
@@ -0,0 +1,430 @@
+/*
+** File: coveragetest_mrlib.c
+**
+** Purpose:
+** Coverage Unit Test cases for the MoonRobot shared library
+**
+** Notes:
+** The dispatch tests build a small command table of their own, with a
+** function-coded route, a hole in its function codes, a route that ignores
+** the function code and one without statistics, so they do not depend on
+** any app's table.
+*/
+
+/*
+ * Includes
+ */
+
+#include "mrlib_coveragetest_common.h"
+
+#include <math.h>
+
+#define UT_CMD_MID    0x1880
+#define UT_WAKEUP_MID 0x1881
+#define UT_TICK_MID   0x1882
+
+#define UT_MSGID_ERR_EID  1
+#define UT_FNCODE_ERR_EID 2
+#define UT_LENGTH_ERR_EID 3
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader;
+    uint32                  Arg;
+} UT_ArgCmd_t;
+
+static uint32 UT_HandlerCalls;
+static int32  UT_HandlerStatus;
+
+static int32 UT_Handler(const CFE_SB_Buffer_t *SBBufPtr)
+{
+    UT_HandlerCalls++;
+    return UT_HandlerStatus;
+}
+
+static const MRLIB_Cmd_t UT_Cmds[] = {
+    [0] = {UT_Handler, sizeof(CFE_MSG_CommandHeader_t)},
+    [2] = {UT_Handler, sizeof(UT_ArgCmd_t)},
+};
+
+static const MRLIB_Cmd_t UT_WakeupCmds[] = {
+    {UT_Handler, 0},
+};
+
+static MRLIB_CmdStats_t UT_CmdStats[MRLIB_COUNT(UT_Cmds)];
+static MRLIB_CmdStats_t UT_WakeupStats[MRLIB_COUNT(UT_WakeupCmds)];
+
+static const MRLIB_Route_t UT_Routes[] = {
+    {UT_WAKEUP_MID, 0, UT_WakeupCmds, UT_WakeupStats},
+    {UT_CMD_MID, MRLIB_COUNT(UT_Cmds), UT_Cmds, UT_CmdStats},
+    {UT_TICK_MID, 0, UT_WakeupCmds, NULL},
+};
+
+static const MRLIB_Dispatch_t UT_Dispatch = {UT_Routes, MRLIB_COUNT(UT_Routes), UT_MSGID_ERR_EID, UT_FNCODE_ERR_EID,
+                                             UT_LENGTH_ERR_EID};
+
+/*
+ * Records the last event sent on the library's behalf
+ */
+static uint16 UT_LastEventId;
+
+static int32 UT_LastEvent_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context,
+                               va_list va)
+{
+    UT_LastEventId = UT_Hook_GetArgValueByName(Context, "EventID", uint16);
+    return 0;
+}
+
+/*
+ * Sets up the stubs for one packet and dispatches it
+ */
+static int32 UT_DispatchPacket(CFE_SB_MsgId_Atom_t MidValue, CFE_MSG_FcnCode_t FcnCode, size_t Size)
+{
+    CFE_SB_Buffer_t SBBuf;
+    CFE_SB_MsgId_t  MsgId = CFE_SB_ValueToMsgId(MidValue);
+
+    memset(&SBBuf, 0, sizeof(SBBuf));
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), true);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), true);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), true);
+
+    return MRLIB_Dispatch(&UT_Dispatch, &SBBuf);
+}
+
+/*
+**********************************************************************************
+**          TEST CASE FUNCTIONS
+**********************************************************************************
+*/
+
+void Test_MRLIB_Init(void)
+{
+    /*
+     * Test Case For:
+     * int32 MRLIB_Init( void )
+     */
+    UtAssert_INT32_EQ(MRLIB_Init(), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OS_printf, 1);
+}
+
+void Test_MRLIB_Dispatch(void)
+{
+    /*
+     * Test Case For:
+     * int32 MRLIB_Dispatch( const MRLIB_Dispatch_t *Dispatch, const CFE_SB_Buffer_t *SBBufPtr )
+     */
+    const MRLIB_CmdStats_t *Stats;
+    OS_time_t               Times[2];
+
+    MRLIB_ResetCmdStats(&UT_Dispatch);
+    UT_HandlerCalls  = 0;
+    UT_HandlerStatus = CFE_SUCCESS;
+    UT_SetVaHookFunction(UT_KEY(CFE_EVS_SendEvent), UT_LastEvent_Hook, NULL);
+
+    /* nominal, with the handler run time taken from two clock reads */
+    Times[0] = OS_TimeAssembleFromMicroseconds(1, 1000);
+    Times[1] = OS_TimeAssembleFromMicroseconds(1, 1250);
+    UT_SetDataBuffer(UT_KEY(OS_GetLocalTime), Times, sizeof(Times), false);
+    UtAssert_INT32_EQ(UT_DispatchPacket(UT_CMD_MID, 2, sizeof(UT_ArgCmd_t)), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(UT_HandlerCalls, 1);
+    UtAssert_STUB_COUNT(CFE_EVS_SendEvent, 0);
+
+    Stats = MRLIB_GetCmdStats(&UT_Dispatch, UT_CMD_MID, 2);
+    UtAssert_NOT_NULL(Stats);
+    UtAssert_UINT32_EQ(Stats->Count, 1);
+    UtAssert_UINT32_EQ(Stats->LastUs, 250);
+    UtAssert_UINT32_EQ(Stats->MaxUs, 250);
+    UtAssert_UINT32_EQ(Stats->TotalUs, 250);
+
+    /* a failing handler is still a dispatched command */
+    UT_HandlerStatus = CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    UtAssert_INT32_EQ(UT_DispatchPacket(UT_CMD_MID, 0, sizeof(CFE_MSG_CommandHeader_t)), CFE_SUCCESS);
+    Stats = MRLIB_GetCmdStats(&UT_Dispatch, UT_CMD_MID, 0);
+    UtAssert_UINT32_EQ(Stats->Count, 1);
+    UtAssert_UINT32_EQ(Stats->HandlerErrors, 1);
+
+    /* the wakeup route ignores the function code and the length */
+    UtAssert_INT32_EQ(UT_DispatchPacket(UT_WAKEUP_MID, 77, 1), CFE_SUCCESS);
+    Stats = MRLIB_GetCmdStats(&UT_Dispatch, UT_WAKEUP_MID, 5);
+    UtAssert_NOT_NULL(Stats);
+    UtAssert_UINT32_EQ(Stats->Count, 1);
+    UtAssert_UINT32_EQ(UT_HandlerCalls, 3);
+
+    /* unknown message ID */
+    UtAssert_INT32_EQ(UT_DispatchPacket(0x1999, 0, sizeof(CFE_MSG_CommandHeader_t)), CFE_STATUS_UNKNOWN_MSG_ID);
+    UtAssert_UINT32_EQ(UT_LastEventId, UT_MSGID_ERR_EID);
+
+    /* function code past the table, and in the hole */
+    UtAssert_INT32_EQ(UT_DispatchPacket(UT_CMD_MID, 3, sizeof(CFE_MSG_CommandHeader_t)), CFE_STATUS_BAD_COMMAND_CODE);
+    UtAssert_UINT32_EQ(UT_LastEventId, UT_FNCODE_ERR_EID);
+    UT_LastEventId = 0;
+    UtAssert_INT32_EQ(UT_DispatchPacket(UT_CMD_MID, 1, sizeof(CFE_MSG_CommandHeader_t)), CFE_STATUS_BAD_COMMAND_CODE);
+    UtAssert_UINT32_EQ(UT_LastEventId, UT_FNCODE_ERR_EID);
+
+    /* wrong length */
+    UtAssert_INT32_EQ(UT_DispatchPacket(UT_CMD_MID, 2, sizeof(CFE_MSG_CommandHeader_t)), CFE_STATUS_WRONG_MSG_LENGTH);
+    UtAssert_UINT32_EQ(UT_LastEventId, UT_LENGTH_ERR_EID);
+    Stats = MRLIB_GetCmdStats(&UT_Dispatch, UT_CMD_MID, 2);
+    UtAssert_UINT32_EQ(Stats->LengthErrors, 1);
+    UtAssert_UINT32_EQ(Stats->Count, 1);
+
+    UtAssert_STUB_COUNT(CFE_EVS_SendEvent, 4);
+    UtAssert_UINT32_EQ(UT_HandlerCalls, 3);
+}
+
+void Test_MRLIB_CmdStats(void)
+{
+    /*
+     * Test Case For:
+     * const MRLIB_CmdStats_t *MRLIB_GetCmdStats( ... )
+     * void MRLIB_ResetCmdStats( const MRLIB_Dispatch_t *Dispatch )
+     */
+    UtAssert_ADDRESS_EQ(MRLIB_GetCmdStats(&UT_Dispatch, 0x1999, 0), NULL);
+    UtAssert_ADDRESS_EQ(MRLIB_GetCmdStats(&UT_Dispatch, UT_CMD_MID, 3), NULL);
+
+    UT_DispatchPacket(UT_CMD_MID, 0, sizeof(CFE_MSG_CommandHeader_t));
+    UT_DispatchPacket(UT_WAKEUP_MID, 0, 0);
+    UtAssert_UINT32_EQ(MRLIB_GetCmdStats(&UT_Dispatch, UT_CMD_MID, 0)->Count, 1);
+    UtAssert_UINT32_EQ(MRLIB_GetCmdStats(&UT_Dispatch, UT_WAKEUP_MID, 0)->Count, 1);
+
+    MRLIB_ResetCmdStats(&UT_Dispatch);
+    UtAssert_UINT32_EQ(MRLIB_GetCmdStats(&UT_Dispatch, UT_CMD_MID, 0)->Count, 0);
+    UtAssert_UINT32_EQ(MRLIB_GetCmdStats(&UT_Dispatch, UT_WAKEUP_MID, 0)->Count, 0);
+
+    /* a route without statistics still dispatches, and only that is skipped */
+    UT_HandlerCalls = 0;
+    UtAssert_INT32_EQ(UT_DispatchPacket(UT_TICK_MID, 0, 0), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(UT_HandlerCalls, 1);
+    UtAssert_ADDRESS_EQ(MRLIB_GetCmdStats(&UT_Dispatch, UT_TICK_MID, 0), NULL);
+    UtAssert_STUB_COUNT(OS_GetLocalTime, 4);
+}
+
+void Test_MRLIB_SendCmdStats(void)
+{
+    /*
+     * Test Case For:
+     * void MRLIB_SendCmdStats( const MRLIB_Dispatch_t *Dispatch, MRLIB_CmdStatsTlm_t *Tlm )
+     */
+    MRLIB_CmdStatsTlm_t            Tlm;
+    MRLIB_CmdStatsEntry_Payload_t *Entry;
+    OS_time_t                      Times[4];
+
+    MRLIB_ResetCmdStats(&UT_Dispatch);
+    UT_HandlerStatus = CFE_SUCCESS;
+
+    /* two calls of function code 2, 100 and 300 us, and one bad length */
+    Times[0] = OS_TimeAssembleFromMicroseconds(1, 0);
+    Times[1] = OS_TimeAssembleFromMicroseconds(1, 100);
+    Times[2] = OS_TimeAssembleFromMicroseconds(2, 0);
+    Times[3] = OS_TimeAssembleFromMicroseconds(2, 300);
+    UT_SetDataBuffer(UT_KEY(OS_GetLocalTime), Times, sizeof(Times), false);
+    UT_DispatchPacket(UT_CMD_MID, 2, sizeof(UT_ArgCmd_t));
+    UT_DispatchPacket(UT_CMD_MID, 2, sizeof(UT_ArgCmd_t));
+    UT_DispatchPacket(UT_CMD_MID, 2, 1);
+
+    memset(&Tlm, 0xAA, sizeof(Tlm));
+    MRLIB_SendCmdStats(&UT_Dispatch, &Tlm);
+    UtAssert_STUB_COUNT(CFE_SB_TimeStampMsg, 1);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 1);
+
+    /* the wakeup, then function codes 0 and 2, but not the hole or the route without statistics */
+    UtAssert_UINT32_EQ(Tlm.Payload.EntryCount, 3);
+    UtAssert_UINT32_EQ(Tlm.Payload.Commands, 3);
+    UtAssert_UINT32_EQ(Tlm.Payload.Entries[0].MsgId, UT_WAKEUP_MID);
+    UtAssert_UINT32_EQ(Tlm.Payload.Entries[0].Count, 0);
+    UtAssert_UINT32_EQ(Tlm.Payload.Entries[0].MeanUs, 0);
+    UtAssert_UINT32_EQ(Tlm.Payload.Entries[1].MsgId, UT_CMD_MID);
+    UtAssert_UINT32_EQ(Tlm.Payload.Entries[1].FcnCode, 0);
+
+    Entry = &Tlm.Payload.Entries[2];
+    UtAssert_UINT32_EQ(Entry->MsgId, UT_CMD_MID);
+    UtAssert_UINT32_EQ(Entry->FcnCode, 2);
+    UtAssert_UINT32_EQ(Entry->Count, 2);
+    UtAssert_UINT32_EQ(Entry->HandlerErrors, 0);
+    UtAssert_UINT32_EQ(Entry->LengthErrors, 1);
+    UtAssert_UINT32_EQ(Entry->LastUs, 300);
+    UtAssert_UINT32_EQ(Entry->MaxUs, 300);
+    UtAssert_UINT32_EQ(Entry->MeanUs, 200);
+    UtAssert_UINT32_EQ(Tlm.Payload.Entries[3].Count, 0);
+}
+
+void Test_MRLIB_RtValidate(void)
+{
+    /*
+     * Test Case For:
+     * bool MRLIB_RtValidate( const MRLIB_RtProfile_t *Profile )
+     */
+    MRLIB_RtProfile_t Profile = {1, MRLIB_RT_PRIORITY_MAX, 1, 0, 0x8, MRLIB_RT_PREFAULT_MAX};
+
+    UtAssert_BOOL_TRUE(MRLIB_RtValidate(&Profile));
+
+    Profile.Enabled = 2;
+    UtAssert_BOOL_FALSE(MRLIB_RtValidate(&Profile));
+    Profile.Enabled    = 1;
+    Profile.LockMemory = 2;
+    UtAssert_BOOL_FALSE(MRLIB_RtValidate(&Profile));
+    Profile.LockMemory = 0;
+    Profile.Priority   = MRLIB_RT_PRIORITY_MAX + 1;
+    UtAssert_BOOL_FALSE(MRLIB_RtValidate(&Profile));
+    Profile.Priority      = 0;
+    Profile.PrefaultBytes = MRLIB_RT_PREFAULT_MAX + 1;
+    UtAssert_BOOL_FALSE(MRLIB_RtValidate(&Profile));
+}
+
+void Test_MRLIB_RtApply(void)
+{
+    /*
+     * Test Case For:
+     * int32 MRLIB_RtApply( const MRLIB_RtProfile_t *Profile, MRLIB_RtStatus_t *Status )
+     *
+     * Only steps an unprivileged test host can take: the test does not know
+     * whether it may use SCHED_FIFO or lock memory.
+     */
+    MRLIB_RtProfile_t Profile;
+    MRLIB_RtStatus_t  Status;
+    uint32            CpuMask;
+
+    /* disabled, read back only */
+    memset(&Profile, 0, sizeof(Profile));
+    memset(&Status, 0xFF, sizeof(Status));
+    UtAssert_INT32_EQ(MRLIB_RtApply(&Profile, &Status), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Status.Errors, 0);
+    UtAssert_UINT32_EQ(Status.Policy, MRLIB_RT_POLICY_OTHER);
+    UtAssert_True(Status.CpuMask != 0, "CpuMask = 0x%x", (unsigned int)Status.CpuMask);
+    CpuMask = Status.CpuMask;
+
+    /* pinned to the CPUs the task already has, with the stack prefaulted */
+    Profile.Enabled       = 1;
+    Profile.CpuMask       = CpuMask;
+    Profile.PrefaultBytes = 8192;
+    UtAssert_INT32_EQ(MRLIB_RtApply(&Profile, &Status), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Status.Errors, 0);
+    UtAssert_UINT32_EQ(Status.CpuMask, CpuMask);
+
+    /* more stack than the task has is cut down, not run off the end */
+    Profile.PrefaultBytes = 0xFFFFFFFF;
+    UtAssert_INT32_EQ(MRLIB_RtApply(&Profile, &Status), CFE_SUCCESS);
+}
+
+void Test_MRLIB_PoseAt(void)
+{
+    /*
+     * Test Case For:
+     * void MRLIB_PoseRecord(uint16 Robot, CFE_TIME_SysTime_t Time, const MRLIB_Pose_t *Pose)
+     * void MRLIB_PoseClear(uint16 Robot)
+     * int32 MRLIB_PoseAt(uint16 Robot, CFE_TIME_SysTime_t Time, MRLIB_Pose_t *Pose)
+     */
+    CFE_TIME_SysTime_t Time;
+    MRLIB_Pose_t       Pose;
+    MRLIB_Pose_t       Got;
+    uint32             i;
+
+    MRLIB_PoseClear(1);
+
+    /* nothing recorded, or no such base */
+    Time.Seconds    = 10;
+    Time.Subseconds = 0;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_STATUS_INCORRECT_STATE);
+    UtAssert_INT32_EQ(MRLIB_PoseAt(MRLIB_POSE_MAX_ROBOTS, Time, &Got), CFE_ES_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, NULL), CFE_ES_BAD_ARGUMENT);
+    MRLIB_PoseRecord(MRLIB_POSE_MAX_ROBOTS, Time, &Pose);
+    MRLIB_PoseClear(MRLIB_POSE_MAX_ROBOTS);
+
+    /* 10 s, 10.5 s and 11 s, turning through pi between the last two */
+    Pose.X       = 1.0;
+    Pose.Y       = 2.0;
+    Pose.Heading = 0.5;
+    MRLIB_PoseRecord(1, Time, &Pose);
+    Time.Subseconds = 0x80000000;
+    Pose.X          = 2.0;
+    Pose.Heading    = 3.0;
+    MRLIB_PoseRecord(1, Time, &Pose);
+    Time.Seconds    = 11;
+    Time.Subseconds = 0;
+    Pose.Y          = 4.0;
+    Pose.Heading    = -3.0;
+    MRLIB_PoseRecord(1, Time, &Pose);
+
+    /* a recorded time gives its pose */
+    Time.Seconds    = 10;
+    Time.Subseconds = 0x80000000;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_SUCCESS);
+    UtAssert_DoubleCmpAbs(Got.X, 2.0, 1e-12, "exact X");
+    UtAssert_DoubleCmpAbs(Got.Heading, 3.0, 1e-12, "exact Heading");
+
+    /* a quarter of the way to the next pose */
+    Time.Subseconds = 0x40000000;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_SUCCESS);
+    UtAssert_DoubleCmpAbs(Got.X, 1.5, 1e-12, "X");
+    UtAssert_DoubleCmpAbs(Got.Y, 2.0, 1e-12, "Y");
+    UtAssert_DoubleCmpAbs(Got.Heading, 1.75, 1e-12, "Heading");
+
+    /* the heading turns the short way, through pi rather than 0 */
+    Time.Subseconds = 0xC0000000;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_SUCCESS);
+    UtAssert_DoubleCmpAbs(Got.Y, 3.0, 1e-12, "Y");
+    UtAssert_DoubleCmpAbs(fabs(Got.Heading), 3.14159265358979323846, 1e-12, "wrapped Heading");
+
+    /* either side of the history, the nearest end */
+    Time.Seconds = 9;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_STATUS_RANGE_ERROR);
+    UtAssert_DoubleCmpAbs(Got.X, 1.0, 1e-12, "oldest X");
+    Time.Seconds = 11;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_STATUS_RANGE_ERROR);
+    UtAssert_DoubleCmpAbs(Got.Y, 4.0, 1e-12, "newest Y");
+
+    /* a time that goes back starts the history over */
+    Time.Seconds    = 5;
+    Time.Subseconds = 0;
+    Pose.X          = -1.0;
+    MRLIB_PoseRecord(1, Time, &Pose);
+    Time.Seconds = 10;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_STATUS_RANGE_ERROR);
+    UtAssert_DoubleCmpAbs(Got.X, -1.0, 1e-12, "restarted X");
+
+    /* a full ring keeps the newest DEPTH - 1 poses */
+    for (i = 0; i < MRLIB_POSE_HISTORY_DEPTH + 10; i++)
+    {
+        Time.Seconds = 100 + i;
+        Pose.X       = i;
+        MRLIB_PoseRecord(1, Time, &Pose);
+    }
+    Time.Seconds = 100;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_STATUS_RANGE_ERROR);
+    UtAssert_DoubleCmpAbs(Got.X, 11, 1e-12, "oldest kept X");
+    Time.Seconds    = 100 + MRLIB_POSE_HISTORY_DEPTH;
+    Time.Subseconds = 0x80000000;
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_SUCCESS);
+    UtAssert_DoubleCmpAbs(Got.X, MRLIB_POSE_HISTORY_DEPTH + 0.5, 1e-9, "full X");
+
+    /* cleared, as after a pose jump */
+    MRLIB_PoseClear(1);
+    UtAssert_INT32_EQ(MRLIB_PoseAt(1, Time, &Got), CFE_STATUS_INCORRECT_STATE);
+}
+
+/*
+ * Setup function prior to every test
+ */
+void MRLIB_UT_Setup(void)
+{
+    UT_ResetState(0);
+}
+
+/*
+ * Teardown function after every test
+ */
+void MRLIB_UT_TearDown(void) {}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(MRLIB_Init);
+    ADD_TEST(MRLIB_Dispatch);
+    ADD_TEST(MRLIB_CmdStats);
+    ADD_TEST(MRLIB_SendCmdStats);
+    ADD_TEST(MRLIB_RtValidate);
+    ADD_TEST(MRLIB_RtApply);
+    ADD_TEST(MRLIB_PoseAt);
+}
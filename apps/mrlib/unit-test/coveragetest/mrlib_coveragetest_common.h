@@ -0,0 +1,36 @@
+/**
+ * @file
+ *
+ * Common definitions for all mrlib coverage tests
+ */
+
+#ifndef MRLIB_COVERAGETEST_COMMON_H
+#define MRLIB_COVERAGETEST_COMMON_H
+
+/*
+ * Includes
+ */
+
+#include "utassert.h"
+#include "uttest.h"
+#include "utstubs.h"
+
+#include "cfe.h"
+#include "mrlib.h"
+
+/*
+ * Macro to add a test case to the list of tests to execute
+ */
+#define ADD_TEST(test) UtTest_Add((Test_##test), MRLIB_UT_Setup, MRLIB_UT_TearDown, #test)
+
+/*
+ * Setup function prior to every test
+ */
+void MRLIB_UT_Setup(void);
+
+/*
+ * Teardown function after every test
+ */
+void MRLIB_UT_TearDown(void);
+
+#endif /* MRLIB_COVERAGETEST_COMMON_H */
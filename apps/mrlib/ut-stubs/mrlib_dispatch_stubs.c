@@ -0,0 +1,71 @@
+/**
+ * @file
+ *
+ * Stub implementations for the functions defined in the mrlib_dispatch header
+ */
+
+#include "mrlib_dispatch.h"
+#include "utgenstub.h"
+
+void UT_DefaultHandler_MRLIB_GetCmdStats(void *, UT_EntryKey_t, const UT_StubContext_t *);
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_Dispatch()
+ * ----------------------------------------------------
+ */
+int32 MRLIB_Dispatch(const MRLIB_Dispatch_t *Dispatch, const CFE_SB_Buffer_t *SBBufPtr)
+{
+    UT_GenStub_SetupReturnBuffer(MRLIB_Dispatch, int32);
+
+    UT_GenStub_AddParam(MRLIB_Dispatch, const MRLIB_Dispatch_t *, Dispatch);
+    UT_GenStub_AddParam(MRLIB_Dispatch, const CFE_SB_Buffer_t *, SBBufPtr);
+
+    UT_GenStub_Execute(MRLIB_Dispatch, Basic, NULL);
+
+    return UT_GenStub_GetReturnValue(MRLIB_Dispatch, int32);
+}
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_GetCmdStats()
+ * ----------------------------------------------------
+ */
+const MRLIB_CmdStats_t *MRLIB_GetCmdStats(const MRLIB_Dispatch_t *Dispatch, CFE_SB_MsgId_Atom_t MsgId,
+                                          CFE_MSG_FcnCode_t FcnCode)
+{
+    UT_GenStub_SetupReturnBuffer(MRLIB_GetCmdStats, const MRLIB_CmdStats_t *);
+
+    UT_GenStub_AddParam(MRLIB_GetCmdStats, const MRLIB_Dispatch_t *, Dispatch);
+    UT_GenStub_AddParam(MRLIB_GetCmdStats, CFE_SB_MsgId_Atom_t, MsgId);
+    UT_GenStub_AddParam(MRLIB_GetCmdStats, CFE_MSG_FcnCode_t, FcnCode);
+
+    UT_GenStub_Execute(MRLIB_GetCmdStats, Basic, UT_DefaultHandler_MRLIB_GetCmdStats);
+
+    return UT_GenStub_GetReturnValue(MRLIB_GetCmdStats, const MRLIB_CmdStats_t *);
+}
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_ResetCmdStats()
+ * ----------------------------------------------------
+ */
+void MRLIB_ResetCmdStats(const MRLIB_Dispatch_t *Dispatch)
+{
+    UT_GenStub_AddParam(MRLIB_ResetCmdStats, const MRLIB_Dispatch_t *, Dispatch);
+
+    UT_GenStub_Execute(MRLIB_ResetCmdStats, Basic, NULL);
+}
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_SendCmdStats()
+ * ----------------------------------------------------
+ */
+void MRLIB_SendCmdStats(const MRLIB_Dispatch_t *Dispatch, MRLIB_CmdStatsTlm_t *Tlm)
+{
+    UT_GenStub_AddParam(MRLIB_SendCmdStats, const MRLIB_Dispatch_t *, Dispatch);
+    UT_GenStub_AddParam(MRLIB_SendCmdStats, MRLIB_CmdStatsTlm_t *, Tlm);
+
+    UT_GenStub_Execute(MRLIB_SendCmdStats, Basic, NULL);
+}
@@ -0,0 +1,83 @@
+/**
+ * @file
+ *
+ * Default handlers for the mrlib stubs that hand something back to the
+ * caller.  A test sets what they return with UT_SetDataBuffer() and
+ * UT_SetDeferredRetcode() on the function's key.
+ */
+
+#include <string.h>
+
+#include "mrlib.h"
+#include "utstubs.h"
+
+/*------------------------------------------------------------
+ *
+ * Default handler for MRLIB_GetCmdStats coverage stub function
+ *
+ * Returns the statistics pointer in the data buffer, NULL without one
+ *
+ *------------------------------------------------------------*/
+void UT_DefaultHandler_MRLIB_GetCmdStats(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    const MRLIB_CmdStats_t *Stats = NULL;
+
+    UT_Stub_CopyToLocal(FuncKey, &Stats, sizeof(Stats));
+    UT_Stub_SetReturnValue(FuncKey, Stats);
+}
+
+/*------------------------------------------------------------
+ *
+ * Default handler for MRLIB_PoseAt coverage stub function
+ *
+ * Fills in the pose from the data buffer, a zero pose without one
+ *
+ *------------------------------------------------------------*/
+void UT_DefaultHandler_MRLIB_PoseAt(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    MRLIB_Pose_t *Pose = UT_Hook_GetArgValueByName(Context, "Pose", MRLIB_Pose_t *);
+
+    if (UT_Stub_CopyToLocal(FuncKey, Pose, sizeof(*Pose)) < sizeof(*Pose))
+    {
+        memset(Pose, 0, sizeof(*Pose));
+    }
+}
+
+/*------------------------------------------------------------
+ *
+ * Default handler for MRLIB_RtApply coverage stub function
+ *
+ * Fills in what the task got from the data buffer, a zero status without
+ * one, whatever the return code
+ *
+ *------------------------------------------------------------*/
+void UT_DefaultHandler_MRLIB_RtApply(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    MRLIB_RtStatus_t *Status = UT_Hook_GetArgValueByName(Context, "Status", MRLIB_RtStatus_t *);
+
+    if (UT_Stub_CopyToLocal(FuncKey, Status, sizeof(*Status)) < sizeof(*Status))
+    {
+        memset(Status, 0, sizeof(*Status));
+    }
+}
+
+/*------------------------------------------------------------
+ *
+ * Default handler for MRLIB_RtValidate coverage stub function
+ *
+ * Every profile is valid unless the test sets a return code, which is
+ * then taken as the result
+ *
+ *------------------------------------------------------------*/
+void UT_DefaultHandler_MRLIB_RtValidate(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    int32 Status;
+    bool  Result = true;
+
+    if (UT_Stub_GetInt32StatusCode(Context, &Status))
+    {
+        Result = (Status != 0);
+    }
+
+    UT_Stub_SetReturnValue(FuncKey, Result);
+}
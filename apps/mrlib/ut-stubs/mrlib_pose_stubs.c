@@ -0,0 +1,54 @@
+/**
+ * @file
+ *
+ * Stub implementations for the functions defined in the mrlib_pose header
+ */
+
+#include "mrlib_pose.h"
+#include "utgenstub.h"
+
+void UT_DefaultHandler_MRLIB_PoseAt(void *, UT_EntryKey_t, const UT_StubContext_t *);
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_PoseAt()
+ * ----------------------------------------------------
+ */
+int32 MRLIB_PoseAt(uint16 Robot, CFE_TIME_SysTime_t Time, MRLIB_Pose_t *Pose)
+{
+    UT_GenStub_SetupReturnBuffer(MRLIB_PoseAt, int32);
+
+    UT_GenStub_AddParam(MRLIB_PoseAt, uint16, Robot);
+    UT_GenStub_AddParam(MRLIB_PoseAt, CFE_TIME_SysTime_t, Time);
+    UT_GenStub_AddParam(MRLIB_PoseAt, MRLIB_Pose_t *, Pose);
+
+    UT_GenStub_Execute(MRLIB_PoseAt, Basic, UT_DefaultHandler_MRLIB_PoseAt);
+
+    return UT_GenStub_GetReturnValue(MRLIB_PoseAt, int32);
+}
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_PoseClear()
+ * ----------------------------------------------------
+ */
+void MRLIB_PoseClear(uint16 Robot)
+{
+    UT_GenStub_AddParam(MRLIB_PoseClear, uint16, Robot);
+
+    UT_GenStub_Execute(MRLIB_PoseClear, Basic, NULL);
+}
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_PoseRecord()
+ * ----------------------------------------------------
+ */
+void MRLIB_PoseRecord(uint16 Robot, CFE_TIME_SysTime_t Time, const MRLIB_Pose_t *Pose)
+{
+    UT_GenStub_AddParam(MRLIB_PoseRecord, uint16, Robot);
+    UT_GenStub_AddParam(MRLIB_PoseRecord, CFE_TIME_SysTime_t, Time);
+    UT_GenStub_AddParam(MRLIB_PoseRecord, const MRLIB_Pose_t *, Pose);
+
+    UT_GenStub_Execute(MRLIB_PoseRecord, Basic, NULL);
+}
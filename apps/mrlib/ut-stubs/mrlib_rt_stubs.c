@@ -0,0 +1,44 @@
+/**
+ * @file
+ *
+ * Stub implementations for the functions defined in the mrlib_rt header
+ */
+
+#include "mrlib_rt.h"
+#include "utgenstub.h"
+
+void UT_DefaultHandler_MRLIB_RtApply(void *, UT_EntryKey_t, const UT_StubContext_t *);
+void UT_DefaultHandler_MRLIB_RtValidate(void *, UT_EntryKey_t, const UT_StubContext_t *);
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_RtApply()
+ * ----------------------------------------------------
+ */
+int32 MRLIB_RtApply(const MRLIB_RtProfile_t *Profile, MRLIB_RtStatus_t *Status)
+{
+    UT_GenStub_SetupReturnBuffer(MRLIB_RtApply, int32);
+
+    UT_GenStub_AddParam(MRLIB_RtApply, const MRLIB_RtProfile_t *, Profile);
+    UT_GenStub_AddParam(MRLIB_RtApply, MRLIB_RtStatus_t *, Status);
+
+    UT_GenStub_Execute(MRLIB_RtApply, Basic, UT_DefaultHandler_MRLIB_RtApply);
+
+    return UT_GenStub_GetReturnValue(MRLIB_RtApply, int32);
+}
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_RtValidate()
+ * ----------------------------------------------------
+ */
+bool MRLIB_RtValidate(const MRLIB_RtProfile_t *Profile)
+{
+    UT_GenStub_SetupReturnBuffer(MRLIB_RtValidate, bool);
+
+    UT_GenStub_AddParam(MRLIB_RtValidate, const MRLIB_RtProfile_t *, Profile);
+
+    UT_GenStub_Execute(MRLIB_RtValidate, Basic, UT_DefaultHandler_MRLIB_RtValidate);
+
+    return UT_GenStub_GetReturnValue(MRLIB_RtValidate, bool);
+}
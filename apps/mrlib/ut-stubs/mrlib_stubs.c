@@ -0,0 +1,22 @@
+/**
+ * @file
+ *
+ * Stub implementations for the functions defined in the mrlib header
+ */
+
+#include "mrlib.h"
+#include "utgenstub.h"
+
+/*
+ * ----------------------------------------------------
+ * Generated stub function for MRLIB_Init()
+ * ----------------------------------------------------
+ */
+int32 MRLIB_Init(void)
+{
+    UT_GenStub_SetupReturnBuffer(MRLIB_Init, int32);
+
+    UT_GenStub_Execute(MRLIB_Init, Basic, NULL);
+
+    return UT_GenStub_GetReturnValue(MRLIB_Init, int32);
+}
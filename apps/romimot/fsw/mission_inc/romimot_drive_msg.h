@@ -0,0 +1,55 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * ROMI Motor Driver App streamed wheel velocity command, the command other
+ * apps send to drive a Romi base
+ */
+
+#ifndef ROMIMOT_DRIVE_MSG_H
+#define ROMIMOT_DRIVE_MSG_H
+
+#include "cfe.h"
+
+#define ROMIMOT_SET_VELOCITY_CC 13 // uses ROMIMOT_SetVelocityCmd_t
+
+#define ROMIMOT_STREAM_SPEED_MAX      4000 /* counts/s, the firmware's ROMI_SPEED_MAX */
+#define ROMIMOT_STREAM_TIMEOUT_MAX_MS 1000
+
+/*
+** Type definition for the streamed wheel velocity command
+**
+** The control loop moves each wheel's intermediate target at the given
+** speed every cycle until the next setpoint arrives.  A stream that stops
+** for TimeoutMs stops the wheels, so a sender that dies cannot leave the
+** base driving.  Both speeds zero ends the stream with the intermediate
+** targets where it left them.
+*/
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader;  /**< \brief Command header */
+    int16                   SpeedLeft;  /**< \brief counts/s, +/- ROMIMOT_STREAM_SPEED_MAX */
+    int16                   SpeedRight; /**< \brief counts/s, +/- ROMIMOT_STREAM_SPEED_MAX */
+    uint16                  TimeoutMs;  /**< \brief 1..ROMIMOT_STREAM_TIMEOUT_MAX_MS */
+    uint8                   Device;     /**< \brief Instance, index in the table's Devices */
+    uint8                   Spare;
+} ROMIMOT_SetVelocityCmd_t;
+
+#endif /* ROMIMOT_DRIVE_MSG_H */
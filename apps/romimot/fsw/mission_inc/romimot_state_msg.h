@@ -0,0 +1,79 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * ROMI Motor Driver App state telemetry, the packet other apps subscribe to
+ * for the wheel state of each control cycle
+ */
+
+#ifndef ROMIMOT_STATE_MSG_H
+#define ROMIMOT_STATE_MSG_H
+
+#include "cfe.h"
+
+/*
+** Type definition (ROMI Motor Driver App batched state telemetry)
+**
+** One sample per control cycle.  The packet time is that of the first
+** sample and TimeOffsetUs is each sample's wakeup time relative to it.
+** Only SampleCount samples are sent, the packet length gives the rest.
+** In ROMIMOT_DRIVE_MODE_SPEED the powers are the wheel speeds written to
+** the firmware, in counts/s.  The velocities and RomiMicros come from the
+** firmware and are timed on its clock, free of wakeup jitter.
+** RomiSequence counts the firmware's samples: a cycle that repeats the one
+** before got no new sample, and its odometers did not move, while a jump
+** of more than one means firmware samples went unread.  Each enabled Romi
+** base sends its own, told apart by Instance.
+*/
+#define ROMIMOT_STATE_BATCH_MAX 16
+
+typedef struct __attribute__((__packed__))
+{
+    uint32 TimeOffsetUs;
+    int16  LeftPower;
+    int16  RightPower;
+    int32  LeftEncoderDelta;
+    int32  RightEncoderDelta;
+    int32  LeftMotorOdometer;
+    int32  RightMotorOdometer;
+    uint32 RomiMicros;    /* Romi clock when the encoders were read */
+    int16  LeftVelocity;  /* counts/s, measured by the firmware */
+    int16  RightVelocity;
+    uint16 VelocityAgeUs; /* Velocity sample time before RomiMicros */
+    uint16 RomiSequence;  /* Firmware sample counter, wraps */
+} ROMIMOT_StateSample_t;
+
+typedef struct __attribute__((__packed__))
+{
+    uint32                FirstCycle; /* Control cycle of Samples[0] */
+    uint8                 SampleCount;
+    uint8                 MotorsEnabled;
+    uint8                 Instance; /* Index in the table's Devices */
+    uint8                 Reserved;
+    ROMIMOT_StateSample_t Samples[ROMIMOT_STATE_BATCH_MAX];
+} ROMIMOT_StateBatchPayload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t   TelemetryHeader;
+    ROMIMOT_StateBatchPayload_t Payload;
+} ROMIMOT_StateBatchTlm_t;
+
+#endif /* ROMIMOT_STATE_MSG_H */
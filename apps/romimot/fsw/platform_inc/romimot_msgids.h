@@ -31,9 +31,11 @@
 #define ROMIMOT_CMD_MID     0x1892
 #define ROMIMOT_SEND_HK_MID 0x1893
 #define ROMIMOT_WAKEUP_MID  0x1894
-#define ROMIMOT_STATE_MID   0x1895
 
 /* V1 Telemetry Message IDs must be 0x08xx */
-#define ROMIMOT_HK_TLM_MID 0x0893
+#define ROMIMOT_HK_TLM_MID        0x0893
+#define ROMIMOT_STATE_TLM_MID     0x0895
+#define ROMIMOT_DIAG_TLM_MID      0x0896
+#define ROMIMOT_CMD_STATS_TLM_MID 0x0897
 
 #endif /* ROMIMOT_MSGIDS_H */
@@ -25,13 +25,165 @@
 #ifndef ROMIMOT_TABLE_H
 #define ROMIMOT_TABLE_H
 
+#include "mrlib_rt.h"
+
+/*
+** Hardware backend selections for HwBackend
+*/
+#define ROMIMOT_HW_BACKEND_DEFAULT 0 /* Build default, ROMIMOT_HW_BACKEND in the app CMakeLists.txt */
+#define ROMIMOT_HW_BACKEND_I2C     1 /* Romi on the Linux I2C bus */
+#define ROMIMOT_HW_BACKEND_SIM     2 /* Simulated Romi, no hardware needed */
+#define ROMIMOT_HW_BACKEND_REPLAY  3 /* Bus traffic played back from BusLogFile */
+
+#ifndef ROMIMOT_HW_DEFAULT_BACKEND
+#define ROMIMOT_HW_DEFAULT_BACKEND ROMIMOT_HW_BACKEND_I2C
+#endif
+
+/*
+** Values for ReplaySpeed
+*/
+#define ROMIMOT_REPLAY_FAST       0 /* Each bus access answers at once */
+#define ROMIMOT_REPLAY_WALL_CLOCK 1 /* Bus accesses take as long as they did on the robot */
+
+#define ROMIMOT_BUS_LOG_NAME_LEN 64
+
+/*
+** Romi bases driven by one ROMIMOT.  Each is polled in turn every control
+** cycle, so the cycle time grows with the number enabled.
+*/
+#define ROMIMOT_MAX_DEVICES  4
+#define ROMIMOT_I2C_ADDR_MIN 0x08 /* 7 bit addresses outside the reserved blocks */
+#define ROMIMOT_I2C_ADDR_MAX 0x77
+
+/*
+** Values for ControlMode
+*/
+#define ROMIMOT_CONTROL_MODE_WAKEUP 0 /* One control cycle per ROMIMOT_WAKEUP_MID */
+#define ROMIMOT_CONTROL_MODE_TIMER  1 /* Cycles paced by the ROMIMOT OSAL timer at ControlRateHz */
+
+#define ROMIMOT_CONTROL_RATE_MIN_HZ 50
+#define ROMIMOT_CONTROL_RATE_MAX_HZ 500
+
+/*
+** Wheel PID limits.  The firmware ignores motor commands beyond +/- 300.
+*/
+#define ROMIMOT_PID_OUTPUT_MAX 300
+
+/*
+** Values for ProfileMode, the shape of the move toward each odometer target
+*/
+#define ROMIMOT_PROFILE_LINEAR    0 /* Step by the target delta every cycle, no acceleration limit */
+#define ROMIMOT_PROFILE_TRAPEZOID 1 /* Acceleration limited */
+#define ROMIMOT_PROFILE_SCURVE    2 /* Acceleration and jerk limited */
+
+#define ROMIMOT_PROFILE_LIMIT_MAX ROMIMOT_Q16(1000) /* Bound on ProfileAccel and ProfileJerk */
+
+/*
+** Romi register ranges with their own read delay, in the order of the
+** ROMI_READ_RANGE_* values in romimot_hw.h
+*/
+#define ROMIMOT_READ_RANGES       3
+#define ROMIMOT_READ_DELAY_MAX_US 400
+
+/*
+** Q16.16 fixed-point literal, for the gains below
+*/
+#define ROMIMOT_Q16(x) ((int32)((x)*65536.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+/*
+** One leg of a queued path.  The distances are added to the targets the
+** previous leg ended on, and the speeds stand in for the target deltas
+** while the leg is driven; a speed of 0 keeps the commanded target delta.
+*/
+typedef struct
+{
+    int32 Left;       /* counts */
+    int32 Right;
+    int16 SpeedLeft;  /* counts/cycle, >= 0 */
+    int16 SpeedRight;
+} ROMIMOT_Segment_t;
+
+#define ROMIMOT_PATH_TABLE_MAX 16 /* Segments one table load can queue per device */
+
 /*
 ** Table structure
 */
 typedef struct
 {
-    uint16 Int1;
-    uint16 Int2;
+    uint8  Enabled;   /* Polled each control cycle */
+    uint8  BusNumber; /* /dev/i2c-<BusNumber> */
+    uint16 Address;   /* 7 bit, ROMIMOT_I2C_ADDR_MIN..ROMIMOT_I2C_ADDR_MAX, unique on its bus */
+
+    /*
+    ** Delay between the register pointer write and the data read for each
+    ** register range, 0 for a combined transfer.  ROMIMOT_CALIBRATE_READ_CC
+    ** writes this Romi's calibrated delays back here.
+    */
+    uint16 ReadDelayUs[ROMIMOT_READ_RANGES]; /* 0..ROMIMOT_READ_DELAY_MAX_US */
+
+    /*
+    ** Appended to the device's path queue each time a table is loaded
+    */
+    uint16            PathCount; /* 0..ROMIMOT_PATH_TABLE_MAX */
+    uint16            Spare;
+    ROMIMOT_Segment_t Path[ROMIMOT_PATH_TABLE_MAX];
+} ROMIMOT_DeviceConfig_t;
+
+typedef struct
+{
+    uint16 HwBackend;     /* Taken at the next bus open */
+    uint16 ControlMode;   /* ROMIMOT_CONTROL_MODE_* */
+    uint16 ControlRateHz; /* Timer mode rate, ROMIMOT_CONTROL_RATE_MIN_HZ..ROMIMOT_CONTROL_RATE_MAX_HZ */
+    int16  OutputLimit;   /* Motor power bound, 1..ROMIMOT_PID_OUTPUT_MAX */
+
+    /*
+    ** Wheel PID gains, Q16.16 and per control cycle, so they need retuning
+    ** whenever the control mode or rate changes
+    */
+    int32 Kp;            /* power per count of position error */
+    int32 Ki;            /* power per count of error per cycle */
+    int32 Kd;            /* power per count/cycle of error rate */
+    int32 Kff;           /* power per count/cycle of reference velocity */
+    int32 DAlpha;        /* derivative low-pass coefficient, 0 < DAlpha <= 1.0 */
+    int32 IntegralLimit; /* bound on the integral term, in power */
+
+    /*
+    ** Motion profile, taken at the next target command.  Q16.16 and per
+    ** control cycle like the gains; the cruise speed is the target delta.
+    */
+    uint16 ProfileMode;    /* ROMIMOT_PROFILE_* */
+    uint16 StateBatchSize; /* Control cycles per state packet, 1..ROMIMOT_STATE_BATCH_MAX */
+    int32  ProfileAccel;   /* counts/cycle^2, 0 < ProfileAccel <= ROMIMOT_PROFILE_LIMIT_MAX */
+    int32  ProfileJerk;    /* counts/cycle^3, S-curve only, same range */
+
+    /*
+    ** Added to the smallest read delay that passed calibration, for every
+    ** device; the delays themselves are in Devices
+    */
+    uint16 ReadDelayMarginUs; /* 0..ROMIMOT_READ_DELAY_MAX_US */
+
+    /*
+    ** Bus log, taken when a bus is opened while no other is.  With
+    ** BusRecord set every access to the Romis is recorded to BusLogFile;
+    ** the replay backend plays BusLogFile back instead of using a bus.
+    */
+    uint16 BusRecord;   /* 0 or 1, ignored by the replay backend */
+    uint16 ReplaySpeed; /* ROMIMOT_REPLAY_* */
+    char   BusLogFile[ROMIMOT_BUS_LOG_NAME_LEN];
+
+    /*
+    ** Real-time profiles, taken when the app starts.  The I/O task runs the
+    ** control loop and is the one to pin to an isolated core.
+    */
+    MRLIB_RtProfile_t RtProfile;   /* Main task */
+    MRLIB_RtProfile_t IoRtProfile; /* I/O task */
+
+    /*
+    ** Romi bases, indexed by instance.  Enabled takes effect at the next
+    ** housekeeping request, the bus and address at the next bus open,
+    ** the read delays with the next published command.
+    */
+    ROMIMOT_DeviceConfig_t Devices[ROMIMOT_MAX_DEVICES];
 } ROMIMOT_Table_t;
 
 #endif /* ROMIMOT_TABLE_H */
@@ -32,15 +32,77 @@
 
 #include <string.h>
 
-#include <sys/ioctl.h>
-#include <linux/i2c.h>
-#include <linux/i2c-dev.h>
-
 /*
 ** global data
 */
 ROMIMOT_Data_t ROMIMOT_Data;
 
+/*
+** Table entries, each handing the packet to its handler as its command type
+*/
+MRLIB_HANDLER_ADAPTER(ROMIMOT_Noop, ROMIMOT_NoopCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_ResetCounters, ROMIMOT_ResetCountersCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_Process, ROMIMOT_ProcessCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_MotEnable, ROMIMOT_SetEnableCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_MotDisable, ROMIMOT_SetEnableCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_SetTarget, ROMIMOT_SetTargetCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_SetTargetDelta, ROMIMOT_SetTargetDeltaCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_DumpTrace, ROMIMOT_DumpTraceCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_SendDiag, ROMIMOT_SendDiagCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_CalibrateRead, ROMIMOT_CalibrateReadCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_SetDriveMode, ROMIMOT_DriveModeCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_QueuePath, ROMIMOT_QueuePathCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_ClearPath, ROMIMOT_ClearPathCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_SetVelocity, ROMIMOT_SetVelocityCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_SendCmdStats, ROMIMOT_SendCmdStatsCmd_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_ReportHousekeeping, CFE_MSG_CommandHeader_t)
+MRLIB_HANDLER_ADAPTER(ROMIMOT_Wakeup, CFE_MSG_CommandHeader_t)
+
+/*
+** Command dispatch tables, indexed by function code
+*/
+static const MRLIB_Cmd_t ROMIMOT_GroundCmds[] = {
+    [ROMIMOT_NOOP_CC]             = {ROMIMOT_Noop_Handler, sizeof(ROMIMOT_NoopCmd_t)},
+    [ROMIMOT_RESET_COUNTERS_CC]   = {ROMIMOT_ResetCounters_Handler, sizeof(ROMIMOT_ResetCountersCmd_t)},
+    [ROMIMOT_PROCESS_CC]          = {ROMIMOT_Process_Handler, sizeof(ROMIMOT_ProcessCmd_t)},
+    [ROMIMOT_MOT_ENABLE_CC]       = {ROMIMOT_MotEnable_Handler, sizeof(ROMIMOT_SetEnableCmd_t)},
+    [ROMIMOT_MOT_DISABLE_CC]      = {ROMIMOT_MotDisable_Handler, sizeof(ROMIMOT_SetEnableCmd_t)},
+    [ROMIMOT_SET_TARGET_CC]       = {ROMIMOT_SetTarget_Handler, sizeof(ROMIMOT_SetTargetCmd_t)},
+    [ROMIMOT_SET_TARGET_DELTA_CC] = {ROMIMOT_SetTargetDelta_Handler, sizeof(ROMIMOT_SetTargetDeltaCmd_t)},
+    [ROMIMOT_DUMP_TRACE_CC]       = {ROMIMOT_DumpTrace_Handler, sizeof(ROMIMOT_DumpTraceCmd_t)},
+    [ROMIMOT_SEND_DIAG_CC]        = {ROMIMOT_SendDiag_Handler, sizeof(ROMIMOT_SendDiagCmd_t)},
+    [ROMIMOT_CALIBRATE_READ_CC]   = {ROMIMOT_CalibrateRead_Handler, sizeof(ROMIMOT_CalibrateReadCmd_t)},
+    [ROMIMOT_SET_DRIVE_MODE_CC]   = {ROMIMOT_SetDriveMode_Handler, sizeof(ROMIMOT_DriveModeCmd_t)},
+    [ROMIMOT_QUEUE_PATH_CC]       = {ROMIMOT_QueuePath_Handler, sizeof(ROMIMOT_QueuePathCmd_t)},
+    [ROMIMOT_CLEAR_PATH_CC]       = {ROMIMOT_ClearPath_Handler, sizeof(ROMIMOT_ClearPathCmd_t)},
+    [ROMIMOT_SET_VELOCITY_CC]     = {ROMIMOT_SetVelocity_Handler, sizeof(ROMIMOT_SetVelocityCmd_t)},
+    [ROMIMOT_SEND_CMD_STATS_CC]   = {ROMIMOT_SendCmdStats_Handler, sizeof(ROMIMOT_SendCmdStatsCmd_t)},
+};
+
+static const MRLIB_Cmd_t ROMIMOT_SendHkCmds[] = {
+    {ROMIMOT_ReportHousekeeping_Handler, sizeof(CFE_MSG_CommandHeader_t)},
+};
+
+static const MRLIB_Cmd_t ROMIMOT_WakeupCmds[] = {
+    {ROMIMOT_Wakeup_Handler, sizeof(CFE_MSG_CommandHeader_t)},
+};
+
+static MRLIB_CmdStats_t ROMIMOT_GroundStats[MRLIB_COUNT(ROMIMOT_GroundCmds)];
+static MRLIB_CmdStats_t ROMIMOT_SendHkStats[MRLIB_COUNT(ROMIMOT_SendHkCmds)];
+static MRLIB_CmdStats_t ROMIMOT_WakeupStats[MRLIB_COUNT(ROMIMOT_WakeupCmds)];
+
+/* The wakeup comes at the control rate, so it is searched first */
+static const MRLIB_Route_t ROMIMOT_Routes[] = {
+    {ROMIMOT_WAKEUP_MID, 0, ROMIMOT_WakeupCmds, ROMIMOT_WakeupStats},
+    {ROMIMOT_CMD_MID, MRLIB_COUNT(ROMIMOT_GroundCmds), ROMIMOT_GroundCmds, ROMIMOT_GroundStats},
+    {ROMIMOT_SEND_HK_MID, 0, ROMIMOT_SendHkCmds, ROMIMOT_SendHkStats},
+};
+
+const MRLIB_Dispatch_t ROMIMOT_Dispatch = {
+    ROMIMOT_Routes, MRLIB_COUNT(ROMIMOT_Routes), ROMIMOT_INVALID_MSGID_ERR_EID, ROMIMOT_COMMAND_ERR_EID,
+    ROMIMOT_LEN_ERR_EID,
+};
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  * *  * * * * **/
 /*                                                                            */
 /* Application entry point and main process loop                              */
@@ -103,54 +165,114 @@ void ROMIMOT_Main(void)
     */
     CFE_ES_PerfLogExit(ROMIMOT_PERF_ID);
 
+    /* flush the tail of any bus log, later I/O task accesses go unrecorded */
+    ROMIMOT_StopBusRecord();
+    romiRecordFlush();
+
     CFE_ES_ExitApp(ROMIMOT_Data.RunStatus);
 }
 
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  */
 /*                                                                            */
-/* Initialization                                                             */
+/* Reset one Romi base's main task state and initialize its packets           */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-int32 ROMIMOT_Init(void)
+static void ROMIMOT_InitDevice(ROMIMOT_Device_t *Dev, uint8 Instance)
 {
-    int32 status;
+    int i;
 
-    ROMIMOT_Data.RunStatus = CFE_ES_RunStatus_APP_RUN;
+    Dev->Instance      = Instance;
+    Dev->Enabled       = false;
+    Dev->I2CErrCounter = 0;
+    Dev->MotorsEnabled = 0;
+    Dev->DriveMode     = ROMIMOT_DRIVE_MODE_POWER;
+
+    Dev->LeftOdoTrgt  = 0;
+    Dev->RightOdoTrgt = 0;
 
-    ROMIMOT_Data.BatteryMillivolts = 0;
+    /*
+     * Amount to increment/decrement the target to make the wheel turn at constant speed.
+     */
+    Dev->TargetDeltaLeft  = 0;
+    Dev->TargetDeltaRight = 0;
 
-    ROMIMOT_Data.MotorsEnabled = 0;
+    Dev->StreamSeq       = 0;
+    Dev->StreamLeft      = 0;
+    Dev->StreamRight     = 0;
+    Dev->StreamTimeoutMs = 0;
 
-    ROMIMOT_Data.RawLeftEncoder  = 0;
-    ROMIMOT_Data.RawRightEncoder = 0;
+    /* the driver defaults until the table is applied */
+    for (i = 0; i < ROMIMOT_READ_RANGES; i++)
+    {
+        Dev->ReadDelayUs[i] = romiGetReadDelay(i);
+    }
 
-    ROMIMOT_Data.LeftEncoderDelta = 0;
-    ROMIMOT_Data.LeftEncoderDelta = 0;
+    memset(&Dev->Profile, 0, sizeof(Dev->Profile));
+    memset(&Dev->Sensor, 0, sizeof(Dev->Sensor));
+    Dev->ReadCalPending = false;
 
-    ROMIMOT_Data.LeftOdo  = 0;
-    ROMIMOT_Data.RightOdo = 0;
+    // the bus itself is opened by the I/O task on request
+    Dev->i2cfd     = -1;
+    Dev->i2c_open  = false;
+    Dev->BusNumber = 0;
+    Dev->Address   = 0;
 
-    ROMIMOT_Data.LeftMotSpeed  = 0;
-    ROMIMOT_Data.RightMotSpeed = 0;
+    /*
+    ** Housekeeping, batched state and bus diagnostic packets (clear user
+    ** data area).  Every device uses the same message IDs and tells its
+    ** packets apart by Instance.  The I/O task fills and sends the state
+    ** and diagnostic packets from then on.
+    */
+    CFE_MSG_Init(CFE_MSG_PTR(Dev->HkTlm.TelemetryHeader), CFE_SB_ValueToMsgId(ROMIMOT_HK_TLM_MID),
+                 sizeof(Dev->HkTlm));
+    CFE_MSG_Init(CFE_MSG_PTR(Dev->StateTlm.TelemetryHeader), CFE_SB_ValueToMsgId(ROMIMOT_STATE_TLM_MID),
+                 sizeof(Dev->StateTlm));
+    CFE_MSG_Init(CFE_MSG_PTR(Dev->DiagTlm.TelemetryHeader), CFE_SB_ValueToMsgId(ROMIMOT_DIAG_TLM_MID),
+                 sizeof(Dev->DiagTlm));
+    Dev->HkTlm.Payload.Instance    = Instance;
+    Dev->StateTlm.Payload.Instance = Instance;
+    Dev->DiagTlm.Payload.Instance  = Instance;
+}
 
-    ROMIMOT_Data.LeftOdoStep  = 0;
-    ROMIMOT_Data.RightOdoStep = 0;
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  */
+/*                                                                            */
+/* Initialization                                                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_Init(void)
+{
+    int32             status;
+    int               i;
+    ROMIMOT_Table_t * TblPtr;
+    MRLIB_RtProfile_t MainRtProfile;
 
-    ROMIMOT_Data.LeftOdoTrgt  = 0;
-    ROMIMOT_Data.RightOdoTrgt = 0;
+    ROMIMOT_Data.RunStatus = CFE_ES_RunStatus_APP_RUN;
 
     /*
-     * Amount to increment/decrement the target to make the wheel turn at constant speed.
-     */
-    ROMIMOT_Data.TargetDeltaLeft  = 0;
-    ROMIMOT_Data.TargetDeltaRight = 0;
+    ** Moves are linear until the table says otherwise
+    */
+    ROMIMOT_Data.ProfileMode  = ROMIMOT_PROFILE_LINEAR;
+    ROMIMOT_Data.ProfileAccel = 0;
+    ROMIMOT_Data.ProfileJerk  = 0;
+
+    /*
+    ** One state packet per control cycle until the table is applied
+    */
+    ROMIMOT_Data.StateBatchSize = 1;
+
+    /*
+    ** No calibration margin until the table is applied
+    */
+    ROMIMOT_Data.ReadDelayMarginUs = 0;
 
     /*
     ** Initialize app command execution counters
     */
-    ROMIMOT_Data.CmdCounter    = 0;
-    ROMIMOT_Data.ErrCounter    = 0;
-    ROMIMOT_Data.I2CErrCounter = 0;
+    ROMIMOT_Data.CmdCounter = 0;
+    ROMIMOT_Data.ErrCounter = 0;
+
+    CFE_MSG_Init(CFE_MSG_PTR(ROMIMOT_Data.CmdStatsTlm.TelemetryHeader), CFE_SB_ValueToMsgId(ROMIMOT_CMD_STATS_TLM_MID),
+                 sizeof(ROMIMOT_Data.CmdStatsTlm));
 
     /*
     ** Initialize app configuration data
@@ -161,9 +283,19 @@ int32 ROMIMOT_Init(void)
     ROMIMOT_Data.PipeName[sizeof(ROMIMOT_Data.PipeName) - 1] = 0;
 
     /*
-    ** Register the events
+    ** Register the events.  I2C errors stop after the first eight until the
+    ** bus recovers, and recovery errors after sixteen, until the counters
+    ** are reset.  Rejected velocity setpoints arrive at the control rate and
+    ** stop after eight.
     */
-    status = CFE_EVS_Register(NULL, 0, CFE_EVS_EventFilter_BINARY);
+    ROMIMOT_Data.EventFilters[0].EventID = ROMIMOT_I2C_ERR_EID;
+    ROMIMOT_Data.EventFilters[0].Mask    = CFE_EVS_FIRST_8_STOP;
+    ROMIMOT_Data.EventFilters[1].EventID = ROMIMOT_BUS_RECOVERY_ERR_EID;
+    ROMIMOT_Data.EventFilters[1].Mask    = CFE_EVS_FIRST_16_STOP;
+    ROMIMOT_Data.EventFilters[2].EventID = ROMIMOT_STREAM_ERR_EID;
+    ROMIMOT_Data.EventFilters[2].Mask    = CFE_EVS_FIRST_8_STOP;
+
+    status = CFE_EVS_Register(ROMIMOT_Data.EventFilters, ROMIMOT_EVENT_FILTERS, CFE_EVS_EventFilter_BINARY);
     if (status != CFE_SUCCESS)
     {
         CFE_ES_WriteToSysLog("ROMI Motor Driver App: Error Registering Events, RC = 0x%08lX\n", (unsigned long)status);
@@ -171,16 +303,13 @@ int32 ROMIMOT_Init(void)
     }
 
     /*
-    ** Initialize housekeeping packet (clear user data area).
-    */
-    CFE_MSG_Init(CFE_MSG_PTR(ROMIMOT_Data.HkTlm.TelemetryHeader), CFE_SB_ValueToMsgId(ROMIMOT_HK_TLM_MID),
-                 sizeof(ROMIMOT_Data.HkTlm));
-
-    /*
-    ** Initialize Motor State packet (clear user data area).
+    ** Each Romi base starts stopped and disabled, with its packets cleared,
+    ** until the table enables it and commands arrive
     */
-    CFE_MSG_Init(CFE_MSG_PTR(ROMIMOT_Data.MotState.TelemetryHeader), CFE_SB_ValueToMsgId(ROMIMOT_STATE_MID),
-                 sizeof(ROMIMOT_Data.MotState));
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        ROMIMOT_InitDevice(&ROMIMOT_Data.Device[i], i);
+    }
 
     /*
     ** Create Software Bus message pipe.
@@ -241,188 +370,382 @@ int32 ROMIMOT_Init(void)
         status = CFE_TBL_Load(ROMIMOT_Data.TblHandles[0], CFE_TBL_SRC_FILE, ROMIMOT_TABLE_FILE);
     }
 
-    CFE_EVS_SendEvent(ROMIMOT_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT Initialized.%s",
-                      ROMIMOT_VERSION_STRING);
+    /*
+    ** Real-time profiles, the main task's now and the I/O task's when it
+    ** starts.  Without a table both tasks stay as OSAL created them.
+    */
+    memset(&MainRtProfile, 0, sizeof(MainRtProfile));
+    memset(&ROMIMOT_Data.IoRtProfile, 0, sizeof(ROMIMOT_Data.IoRtProfile));
+    memset(&ROMIMOT_Data.IoRtStatus, 0, sizeof(ROMIMOT_Data.IoRtStatus));
+    if (CFE_TBL_GetAddress((void *)&TblPtr, ROMIMOT_Data.TblHandles[0]) >= CFE_SUCCESS)
+    {
+        MainRtProfile            = TblPtr->RtProfile;
+        ROMIMOT_Data.IoRtProfile = TblPtr->IoRtProfile;
+        CFE_TBL_ReleaseAddress(ROMIMOT_Data.TblHandles[0]);
+    }
+    ROMIMOT_ApplyRtProfile("main", &MainRtProfile, &ROMIMOT_Data.MainRtStatus);
+
+    // setup I2C, each bus is opened by the I/O task on request
+
+    /*
+    ** Start the I/O child task that owns the I2C bus
+    */
+    status = ROMIMOT_StartIoTask();
+    if (status != CFE_SUCCESS)
+    {
+        return status;
+    }
 
-    // setup I2C
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        ROMIMOT_PublishControl(&ROMIMOT_Data.Device[i]);
+    }
+    ROMIMOT_ApplyTableConfig();
 
-    ROMIMOT_Data.i2c_open = false;
+    CFE_EVS_SendEvent(ROMIMOT_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT Initialized.%s",
+                      ROMIMOT_VERSION_STRING);
 
     return CFE_SUCCESS;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Apply a real-time profile to the calling task and report what it got      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_ApplyRtProfile(const char *TaskName, const MRLIB_RtProfile_t *Profile, MRLIB_RtStatus_t *Status)
+{
+    if (MRLIB_RtApply(Profile, Status) != CFE_SUCCESS)
+    {
+        CFE_EVS_SendEvent(ROMIMOT_RT_PROFILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: %s task RT profile incomplete, errors 0x%02X, policy %u priority %u CPUs 0x%X",
+                          TaskName, (unsigned int)Status->Errors, (unsigned int)Status->Policy,
+                          (unsigned int)Status->Priority, (unsigned int)Status->CpuMask);
+    }
+    else if (Profile->Enabled)
+    {
+        CFE_EVS_SendEvent(ROMIMOT_RT_PROFILE_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "ROMIMOT: %s task RT profile applied, policy %u priority %u CPUs 0x%X, %u kB locked",
+                          TaskName, (unsigned int)Status->Policy, (unsigned int)Status->Priority,
+                          (unsigned int)Status->CpuMask, (unsigned int)Status->LockedKb);
+    }
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  */
 /*                                                                            */
 /* Initialize I2C Connection                                                  */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-int32 ROMIMOT_ConnectI2C(void)
+int32 ROMIMOT_ConnectI2C(ROMIMOT_Device_t *Dev)
 {
+    uint8 Version = 0;
 
-    if (ROMIMOT_Data.i2c_open == false)
+    if (Dev->i2c_open == false)
     {
         // setup I2C
 
-        bool fail_flag = false;
-        char busname[20];
-        snprintf(busname, 20, "/dev/i2c-%d", i2cBusNumber);
-        ROMIMOT_Data.i2cfd = open_i2c_device(busname);
+        ROMIMOT_SelectBackend(Dev);
+
+        Dev->i2cfd = romiOpen(Dev->BusNumber, Dev->Address);
 
-        if (ROMIMOT_Data.i2cfd < 0)
+        if (Dev->i2cfd == ROMIMOT_I2C_DEV_FD_ERR_EID)
         {
-            fail_flag = true;
-            CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: Failed to open I2C bus %s",
-                              busname);
-            CFE_ES_WriteToSysLog("failed to open I2C bus %20s", busname);
+            CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: Romi %u failed to open %s bus %d",
+                              (unsigned int)Dev->Instance, romiGetBackend()->name, Dev->BusNumber);
+            CFE_ES_WriteToSysLog("failed to open %s bus %d", romiGetBackend()->name, Dev->BusNumber);
         }
-
-        if (ioctl(ROMIMOT_Data.i2cfd, I2C_SLAVE, romiaddr) < 0)
+        else if (Dev->i2cfd < 0)
         {
-            fail_flag = true;
             CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "ROMIMOT: Failed to select romi I2C device address 0x%X", romiaddr);
+                              "ROMIMOT: Romi %u failed to select I2C device address 0x%X", (unsigned int)Dev->Instance,
+                              Dev->Address);
             CFE_ES_WriteToSysLog("failed to select romi I2C device");
         }
 
-        if (fail_flag)
+        if (Dev->i2cfd < 0)
+        {
+            Dev->I2CErrCounter++;
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+
+        // Only drive firmware that speaks the register map we were built with.
+        if (romiVersionRead(Dev->i2cfd, &Version) != 0 || Version != ROMI_REGMAP_VERSION)
         {
-            ROMIMOT_Data.I2CErrCounter++;
+            CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "ROMIMOT: Romi %u register map version %u, expected %u", (unsigned int)Dev->Instance,
+                              (unsigned int)Version, (unsigned int)ROMI_REGMAP_VERSION);
+            romiClose(Dev->i2cfd);
+            Dev->I2CErrCounter++;
             return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
         }
 
-        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT: Opened I2C bus %s", busname);
-        CFE_ES_WriteToSysLog("Opened I2C bus %s", busname);
+        CFE_EVS_SendEvent(ROMIMOT_I2C_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "ROMIMOT: Romi %u opened %s bus %d address 0x%X", (unsigned int)Dev->Instance,
+                          romiGetBackend()->name, Dev->BusNumber, Dev->Address);
+        CFE_ES_WriteToSysLog("Opened %s bus %d", romiGetBackend()->name, Dev->BusNumber);
 
-        ROMIMOT_Data.i2c_open = true;
+        Dev->i2c_open = true;
     }
 
     return CFE_SUCCESS;
 }
 
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  */
 /*                                                                            */
-/*  Purpose:                                                                  */
-/*     This routine will process any packet that is received on the ROMIMOT */
-/*     command pipe.                                                          */
+/* Pick the hardware backend and the device's bus and address from the table  */
 /*                                                                            */
-/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
-void ROMIMOT_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr)
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_SelectBackend(ROMIMOT_Device_t *Dev)
 {
-    CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
+    ROMIMOT_Table_t *  TblPtr;
+    uint16             Backend     = ROMIMOT_HW_BACKEND_DEFAULT;
+    uint16             BusRecord   = 0;
+    uint16             ReplaySpeed = ROMIMOT_REPLAY_FAST;
+    char               BusLogFile[ROMIMOT_BUS_LOG_NAME_LEN];
+    const RomiBackend *Target;
+    int                i;
+
+    memset(BusLogFile, 0, sizeof(BusLogFile));
+    if (CFE_TBL_GetAddress((void *)&TblPtr, ROMIMOT_Data.TblHandles[0]) >= CFE_SUCCESS)
+    {
+        Backend        = TblPtr->HwBackend;
+        BusRecord      = TblPtr->BusRecord;
+        ReplaySpeed    = TblPtr->ReplaySpeed;
+        Dev->BusNumber = TblPtr->Devices[Dev->Instance].BusNumber;
+        Dev->Address   = TblPtr->Devices[Dev->Instance].Address;
+        strncpy(BusLogFile, TblPtr->BusLogFile, sizeof(BusLogFile) - 1);
+        CFE_TBL_ReleaseAddress(ROMIMOT_Data.TblHandles[0]);
+    }
+
+    /* every open handle belongs to one backend, a switch waits until they all close */
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        if (&ROMIMOT_Data.Device[i] != Dev && ROMIMOT_Data.Device[i].i2c_open)
+        {
+            return;
+        }
+    }
 
-    CFE_MSG_GetMsgId(&SBBufPtr->Msg, &MsgId);
+    if (Backend == ROMIMOT_HW_BACKEND_DEFAULT)
+    {
+        Backend = ROMIMOT_HW_DEFAULT_BACKEND;
+    }
 
-    switch (CFE_SB_MsgIdToValue(MsgId))
+    if (Backend == ROMIMOT_HW_BACKEND_REPLAY)
     {
-        case ROMIMOT_CMD_MID:
-            ROMIMOT_ProcessGroundCommand(SBBufPtr);
-            break;
+        ROMIMOT_StopBusRecord();
+        ROMIMOT_StartBusReplay(BusLogFile, ReplaySpeed);
+        romiSetBackend(&romiBackendReplay);
+        return;
+    }
 
-        case ROMIMOT_SEND_HK_MID:
-            ROMIMOT_ReportHousekeeping((CFE_MSG_CommandHeader_t *)SBBufPtr);
-            break;
+    romiReplayUnload();
 
-        case ROMIMOT_WAKEUP_MID:
-            ROMIMOT_Wakeup((CFE_MSG_CommandHeader_t *)SBBufPtr);
-            break;
+    if (Backend == ROMIMOT_HW_BACKEND_SIM)
+    {
+        Target = &romiBackendSim;
+    }
+    else
+    {
+        Target = &romiBackendI2C;
+    }
 
-        default:
-            CFE_EVS_SendEvent(ROMIMOT_INVALID_MSGID_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "ROMIMOT: invalid command packet,MID = 0x%x", (unsigned int)CFE_SB_MsgIdToValue(MsgId));
-            break;
+    if (BusRecord && ROMIMOT_StartBusRecord(BusLogFile, Target) == CFE_SUCCESS)
+    {
+        romiSetBackend(&romiBackendRecord);
+    }
+    else
+    {
+        ROMIMOT_StopBusRecord();
+        romiSetBackend(Target);
     }
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
-/* ROMIMOT ground commands                                                 */
+/* Record the bus traffic through Target, carrying on a recording that runs   */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-void ROMIMOT_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr)
+int32 ROMIMOT_StartBusRecord(const char *BusLogFile, const RomiBackend *Target)
 {
-    CFE_MSG_FcnCode_t CommandCode = 0;
+    char         LocalPath[OS_MAX_LOCAL_PATH_LEN];
+    RomiLogStats Stats;
 
-    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &CommandCode);
+    romiRecordGetStats(&Stats);
+    if (Stats.active)
+    {
+        romiRecordStart(NULL, Target);
+        return CFE_SUCCESS;
+    }
 
-    CFE_EVS_SendEvent(ROMIMOT_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION,
-                      "ROMIMOT Process Ground Command called with CommandCode %x", CommandCode);
+    if (OS_TranslatePath(BusLogFile, LocalPath) != OS_SUCCESS || romiRecordStart(LocalPath, Target) != 0)
+    {
+        CFE_EVS_SendEvent(ROMIMOT_BUS_LOG_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: Cannot record the bus to %s",
+                          BusLogFile);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
 
-    /*
-    ** Process "known" ROMIMOT ground commands
-    */
-    switch (CommandCode)
+    CFE_EVS_SendEvent(ROMIMOT_BUS_LOG_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT: Recording the %s bus to %s",
+                      Target->name, BusLogFile);
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Close the bus recording, if one runs                                       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_StopBusRecord(void)
+{
+    RomiLogStats Stats;
+
+    romiRecordGetStats(&Stats);
+    if (!Stats.active)
     {
-        case ROMIMOT_NOOP_CC:
-            if (ROMIMOT_VerifyCmdLength(&SBBufPtr->Msg, sizeof(ROMIMOT_NoopCmd_t)))
-            {
-                ROMIMOT_Noop((ROMIMOT_NoopCmd_t *)SBBufPtr);
-            }
+        return;
+    }
 
-            break;
+    romiRecordStop();
+    CFE_EVS_SendEvent(ROMIMOT_BUS_LOG_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "ROMIMOT: Bus recording stopped, %lu records, %lu lost", (unsigned long)Stats.records,
+                      (unsigned long)Stats.lost);
+}
 
-        case ROMIMOT_RESET_COUNTERS_CC:
-            if (ROMIMOT_VerifyCmdLength(&SBBufPtr->Msg, sizeof(ROMIMOT_ResetCountersCmd_t)))
-            {
-                ROMIMOT_ResetCounters((ROMIMOT_ResetCountersCmd_t *)SBBufPtr);
-            }
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Load a bus log for the replay backend, unless one is being played          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_StartBusReplay(const char *BusLogFile, uint16 ReplaySpeed)
+{
+    char         LocalPath[OS_MAX_LOCAL_PATH_LEN];
+    RomiLogStats Stats;
 
-            break;
+    romiReplayGetStats(&Stats);
+    if (Stats.active)
+    {
+        return;
+    }
 
-        case ROMIMOT_PROCESS_CC:
-            if (ROMIMOT_VerifyCmdLength(&SBBufPtr->Msg, sizeof(ROMIMOT_ProcessCmd_t)))
-            {
-                ROMIMOT_Process((ROMIMOT_ProcessCmd_t *)SBBufPtr);
-            }
+    if (OS_TranslatePath(BusLogFile, LocalPath) != OS_SUCCESS ||
+        romiReplayLoad(LocalPath, ReplaySpeed == ROMIMOT_REPLAY_WALL_CLOCK) != 0)
+    {
+        /* the replay backend stays selected, so nothing reaches a real Romi */
+        CFE_EVS_SendEvent(ROMIMOT_BUS_LOG_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: Cannot replay the bus log %s",
+                          BusLogFile);
+        return;
+    }
 
-            break;
+    romiReplayGetStats(&Stats);
+    ROMIMOT_Data.BusReplayEnded = false;
+    CFE_EVS_SendEvent(ROMIMOT_BUS_LOG_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "ROMIMOT: Replaying %lu bus records from %s %s", (unsigned long)Stats.logged, BusLogFile,
+                      ReplaySpeed == ROMIMOT_REPLAY_WALL_CLOCK ? "at wall clock speed" : "as fast as possible");
+}
 
-        case ROMIMOT_MOT_ENABLE_CC:
-            if (ROMIMOT_VerifyCmdLength(&SBBufPtr->Msg, sizeof(ROMIMOT_SetEnableCmd_t)))
-            {
-                if (ROMIMOT_ConnectI2C() == CFE_SUCCESS)
-                {
-                    ROMIMOT_SetMotEnable((ROMIMOT_SetEnableCmd_t *)SBBufPtr, true);
-                }
-            }
-            break;
-        case ROMIMOT_MOT_DISABLE_CC:
-            if (ROMIMOT_VerifyCmdLength(&SBBufPtr->Msg, sizeof(ROMIMOT_SetEnableCmd_t)))
-            {
-                if (ROMIMOT_ConnectI2C() == CFE_SUCCESS)
-                {
-                    ROMIMOT_SetMotEnable((ROMIMOT_SetEnableCmd_t *)SBBufPtr, false);
-                }
-            }
-            break;
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Push the bus recording to its file and report the end of a replay          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_ReportBusLog(void)
+{
+    RomiLogStats Stats;
 
-        case ROMIMOT_SET_TARGET_CC:
-            if (ROMIMOT_VerifyCmdLength(&SBBufPtr->Msg, sizeof(ROMIMOT_SetTargetCmd_t)))
-            {
-                if (ROMIMOT_ConnectI2C() == CFE_SUCCESS)
-                {
-                    ROMIMOT_SetTarget((ROMIMOT_SetTargetCmd_t *)SBBufPtr);
-                }
-            }
-            break;
+    if (romiRecordFlush() != 0)
+    {
+        CFE_EVS_SendEvent(ROMIMOT_BUS_LOG_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: Bus recording write failed");
+    }
 
-        case ROMIMOT_SET_TARGET_DELTA_CC:
-            if (ROMIMOT_VerifyCmdLength(&SBBufPtr->Msg, sizeof(ROMIMOT_SetTargetDeltaCmd_t)))
-            {
-                if (ROMIMOT_ConnectI2C() == CFE_SUCCESS)
-                {
-                    ROMIMOT_SetTargetDelta((ROMIMOT_SetTargetDeltaCmd_t *)SBBufPtr);
-                }
-            }
-            break;
+    romiReplayGetStats(&Stats);
+    if (Stats.active && Stats.ended && !ROMIMOT_Data.BusReplayEnded)
+    {
+        ROMIMOT_Data.BusReplayEnded = true;
+        CFE_EVS_SendEvent(ROMIMOT_BUS_LOG_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "ROMIMOT: Bus replay done, %lu records, %lu skipped, %lu unmatched, %lu writes diverged",
+                          (unsigned long)Stats.records, (unsigned long)Stats.skipped, (unsigned long)Stats.unmatched,
+                          (unsigned long)Stats.diverged);
+    }
+}
 
-        /* default case already found during FC vs length test */
-        default:
-            CFE_EVS_SendEvent(ROMIMOT_COMMAND_ERR_EID, CFE_EVS_EventType_ERROR, "Invalid ground command code: CC = %d",
-                              CommandCode);
-            break;
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/*  Purpose:                                                                  */
+/*     This routine will process any packet that is received on the ROMIMOT */
+/*     command pipe.                                                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
+void ROMIMOT_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr)
+{
+    if (MRLIB_Dispatch(&ROMIMOT_Dispatch, SBBufPtr) != CFE_SUCCESS)
+    {
+        ROMIMOT_Data.ErrCounter++;
     }
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Gather and send one Romi base's housekeeping packet                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_ReportDevice(ROMIMOT_Device_t *Dev)
+{
+    ROMIMOT_HkTlm_Payload_t *    Payload = &Dev->HkTlm.Payload;
+    const ROMIMOT_SensorState_t *Sensor  = &Dev->Sensor;
+    const ROMIMOT_LoopStats_t *  Stats   = &Dev->Sensor.Stats;
+
+    /*
+    ** Get command execution counters...
+    */
+    Payload->CommandErrorCounter  = ROMIMOT_Data.ErrCounter;
+    Payload->CommandCounter       = ROMIMOT_Data.CmdCounter;
+    Payload->I2CErrorCounter      = __atomic_load_n(&Dev->I2CErrCounter, __ATOMIC_RELAXED);
+    Payload->Instance             = Dev->Instance;
+    Payload->BatteryMillivolts    = Sensor->Romi.batteryMillivolts;
+    Payload->MotorsEnabled        = Dev->MotorsEnabled;
+    Payload->DriveMode            = Dev->DriveMode;
+    Payload->RawLeftMotorEncoder  = Sensor->Ctl.RawLeftEncoder;
+    Payload->RawRightMotorEncoder = Sensor->Ctl.RawRightEncoder;
+    Payload->LeftMotorOdometer    = Sensor->Ctl.LeftOdo;
+    Payload->RightMotorOdometer   = Sensor->Ctl.RightOdo;
+
+    /*
+    ** Control loop timing since the previous report.  The latency of the
+    ** later devices includes the bus time of those served before them.
+    */
+    Payload->ControlMode     = ROMIMOT_Data.ControlMode;
+    Payload->ControlRateHz   = ROMIMOT_Data.ControlRateHz;
+    Payload->ControlCycles   = Stats->Cycles;
+    Payload->ControlOverruns = __atomic_load_n(&ROMIMOT_Data.IoOverruns, __ATOMIC_RELAXED);
+    Payload->LatencyAvgUs    = Stats->Cycles ? Stats->LatencySumUs / Stats->Cycles : 0;
+    Payload->LatencyMaxUs    = Stats->LatencyMaxUs;
+    Payload->PeriodJitterUs  = Stats->PeriodMaxUs - Stats->PeriodMinUs;
+    Payload->StaleSamples    = Stats->StaleSamples;
+    __atomic_store_n(&Dev->StatsResetReq, true, __ATOMIC_RELEASE);
+
+    Payload->TraceSamples = __atomic_load_n(&Dev->Trace.Head, __ATOMIC_RELAXED);
+    Payload->TraceFrozen  = __atomic_load_n(&Dev->Trace.Frozen, __ATOMIC_RELAXED);
+
+    Payload->ReadCalActive   = Sensor->ReadCalActive;
+    Payload->SnapshotDelayUs = Sensor->SnapshotDelayUs;
+    Payload->BusState        = Sensor->BusState;
+    Payload->BusReopens      = Sensor->BusReopens;
+
+    Payload->PathQueued   = ROMIMOT_PathQueued(&Dev->Path);
+    Payload->PathActive   = Sensor->Ctl.PathActive;
+    Payload->Streaming    = Sensor->Ctl.Streaming;
+    Payload->PathSegments = Sensor->Ctl.PathSegments;
+
+    Payload->MainRt = ROMIMOT_Data.MainRtStatus;
+    Payload->IoRt   = ROMIMOT_Data.IoRtStatus;
+
+    /*
+    ** Send housekeeping telemetry packet...
+    */
+    CFE_SB_TimeStampMsg(CFE_MSG_PTR(Dev->HkTlm.TelemetryHeader));
+    CFE_SB_TransmitMsg(CFE_MSG_PTR(Dev->HkTlm.TelemetryHeader), true);
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
 /*  Purpose:                                                                  */
@@ -434,25 +757,16 @@ void ROMIMOT_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr)
 int32 ROMIMOT_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
 {
     int i;
-    // CFE_EVS_SendEvent(ROMIMOT_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT Report HK");
-    /*
-    ** Get command execution counters...
-    */
-    ROMIMOT_Data.HkTlm.Payload.CommandErrorCounter  = ROMIMOT_Data.ErrCounter;
-    ROMIMOT_Data.HkTlm.Payload.CommandCounter       = ROMIMOT_Data.CmdCounter;
-    ROMIMOT_Data.HkTlm.Payload.I2CErrorCounter      = ROMIMOT_Data.I2CErrCounter;
-    ROMIMOT_Data.HkTlm.Payload.BatteryMillivolts    = ROMIMOT_Data.BatteryMillivolts;
-    ROMIMOT_Data.HkTlm.Payload.MotorsEnabled        = ROMIMOT_Data.MotorsEnabled;
-    ROMIMOT_Data.HkTlm.Payload.RawLeftMotorEncoder  = ROMIMOT_Data.RawLeftEncoder;
-    ROMIMOT_Data.HkTlm.Payload.RawRightMotorEncoder = ROMIMOT_Data.RawRightEncoder;
-    ROMIMOT_Data.HkTlm.Payload.LeftMotorOdometer    = ROMIMOT_Data.LeftOdo;
-    ROMIMOT_Data.HkTlm.Payload.RightMotorOdometer   = ROMIMOT_Data.RightOdo;
 
-    /*
-    ** Send housekeeping telemetry packet...
-    */
-    CFE_SB_TimeStampMsg(CFE_MSG_PTR(ROMIMOT_Data.HkTlm.TelemetryHeader));
-    CFE_SB_TransmitMsg(CFE_MSG_PTR(ROMIMOT_Data.HkTlm.TelemetryHeader), true);
+    // CFE_EVS_SendEvent(ROMIMOT_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT Report HK");
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        if (ROMIMOT_Data.Device[i].Enabled)
+        {
+            ROMIMOT_ReportDevice(&ROMIMOT_Data.Device[i]);
+        }
+        ROMIMOT_StoreReadCal(&ROMIMOT_Data.Device[i]);
+    }
 
     /*
     ** Manage any pending table loads, validations, etc.
@@ -462,6 +776,9 @@ int32 ROMIMOT_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
         CFE_TBL_Manage(ROMIMOT_Data.TblHandles[i]);
     }
 
+    ROMIMOT_ApplyTableConfig();
+    ROMIMOT_ReportBusLog();
+
     return CFE_SUCCESS;
 }
 
@@ -470,30 +787,39 @@ int32 ROMIMOT_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
 /* ROMIMOT Check I2C Transaction for Errors                                   */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-int32 ROMIMOT_CheckI2CTransaction(int RetCode)
+int32 ROMIMOT_CheckI2CTransaction(ROMIMOT_Device_t *Dev, int RetCode)
 {
     int32 status = CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
 
     if (RetCode == ROMIMOT_I2C_SETUP_WR_ERR_EID)
     {
-        ROMIMOT_Data.I2CErrCounter++;
-        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: I2C setup write operation failed");
+        Dev->I2CErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u I2C setup write operation failed", (unsigned int)Dev->Instance);
     }
     else if (RetCode == ROMIMOT_I2C_DAT_R_ERR_EID)
     {
-        ROMIMOT_Data.I2CErrCounter++;
-        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: I2C data read operation failed");
+        Dev->I2CErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u I2C data read operation failed", (unsigned int)Dev->Instance);
+    }
+    else if (RetCode == ROMIMOT_I2C_DAT_BAD_ERR_EID)
+    {
+        Dev->I2CErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u I2C data read did not validate", (unsigned int)Dev->Instance);
     }
     else if (RetCode == ROMIMOT_I2C_DAT_W_ERR_EID)
     {
-        ROMIMOT_Data.I2CErrCounter++;
-        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: I2C data write operation failed");
+        Dev->I2CErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u I2C data write operation failed", (unsigned int)Dev->Instance);
     }
     else if (RetCode != 0)
     {
-        ROMIMOT_Data.I2CErrCounter++;
-        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: I2C [unkown] operation failed 0x%x",
-                          RetCode);
+        Dev->I2CErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_I2C_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u I2C [unkown] operation failed 0x%x", (unsigned int)Dev->Instance, RetCode);
     }
     else
     {
@@ -510,123 +836,187 @@ int32 ROMIMOT_CheckI2CTransaction(int RetCode)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 int32 ROMIMOT_Wakeup(const CFE_MSG_CommandHeader_t *Msg)
 {
-    if (ROMIMOT_Data.i2c_open)
+    ROMIMOT_Device_t *     Dev;
+    ROMIMOT_SensorState_t *Sensor;
+    bool                   IsNew;
+    bool                   AnyOpen = false;
+    int                    i;
+
+    // In wakeup mode this message paces the control loop itself.
+    if (ROMIMOT_Data.ControlMode == ROMIMOT_CONTROL_MODE_WAKEUP)
     {
-        ROMIMOT_Data.CmdCounter++;
-        int       i2c_ret = 0;
-        uint8_t   buf[4];
-        uint16    battVolts;
-        MotorPair encVals;
-        float     pcoeff = 0.05;
+        ROMIMOT_TriggerIo();
+    }
 
-        // Read the buttons on the ROMI, emit an event if pressed.
-        i2c_ret = romiRead(ROMIMOT_Data.i2cfd, 3, 3, buf);
+    // Pick up the latest state published by the I/O task for each Romi.
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        Dev    = &ROMIMOT_Data.Device[i];
+        Sensor = &Dev->Sensor;
+        IsNew  = ROMIMOT_DblBuf_Read(&Dev->SensorBuf, Dev->SensorSlots, sizeof(*Sensor), Sensor, &Dev->SensorCount);
 
-        if (ROMIMOT_CheckI2CTransaction(i2c_ret) == CFE_SUCCESS)
+        if (Sensor->I2COpen)
         {
-            if (buf[0])
+            AnyOpen = true;
+
+            // Emit an event if the button is pressed.
+            if (IsNew && Sensor->Status == 0 && Sensor->Romi.buttonA)
             {
-                CFE_EVS_SendEvent(ROMIMOT_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT button");
+                CFE_EVS_SendEvent(ROMIMOT_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT button, Romi %u",
+                                  (unsigned int)Dev->Instance);
             }
         }
+    }
 
-        // Read the battery voltage on the ROMI, store it in the data struct.
-        i2c_ret = romiRead(ROMIMOT_Data.i2cfd, 10, 2, (uint8_t *)&battVolts);
-        if (ROMIMOT_CheckI2CTransaction(i2c_ret) == CFE_SUCCESS)
-        {
-            ROMIMOT_Data.BatteryMillivolts = battVolts;
-        }
+    if (AnyOpen)
+    {
+        ROMIMOT_Data.CmdCounter++;
+    }
 
-        // Read the motor encoders
-        i2c_ret = romiEncoderRead(ROMIMOT_Data.i2cfd, &encVals);
-        if (ROMIMOT_CheckI2CTransaction(i2c_ret) == CFE_SUCCESS)
-        {
-            ROMIMOT_Data.LeftEncoderDelta  = encVals.left - ROMIMOT_Data.RawLeftEncoder;
-            ROMIMOT_Data.RightEncoderDelta = encVals.right - ROMIMOT_Data.RawRightEncoder;
-            ROMIMOT_Data.RawLeftEncoder    = encVals.left;
-            ROMIMOT_Data.RawRightEncoder   = encVals.right;
+    return CFE_SUCCESS;
+}
 
-            ROMIMOT_Data.LeftOdo += ROMIMOT_Data.LeftEncoderDelta;
-            ROMIMOT_Data.RightOdo += ROMIMOT_Data.RightEncoderDelta;
-        }
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Hand the commanded motion to the control loop                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_PublishControl(ROMIMOT_Device_t *Dev)
+{
+    ROMIMOT_ControlCmd_t Cmd;
+
+    Cmd.MotorsEnabled    = Dev->MotorsEnabled;
+    Cmd.DriveMode        = Dev->DriveMode;
+    Cmd.LeftOdoTrgt      = Dev->LeftOdoTrgt;
+    Cmd.RightOdoTrgt     = Dev->RightOdoTrgt;
+    Cmd.TargetDeltaLeft  = Dev->TargetDeltaLeft;
+    Cmd.TargetDeltaRight = Dev->TargetDeltaRight;
+    Cmd.ProfileSeq       = Dev->Profile.Seq;
+    Cmd.Gains            = ROMIMOT_Data.Gains;
+    Cmd.StateBatchSize   = ROMIMOT_Data.StateBatchSize;
+    Cmd.ProfileMode      = ROMIMOT_Data.ProfileMode;
+    Cmd.ProfileAccel     = ROMIMOT_Data.ProfileAccel;
+    Cmd.ProfileJerk      = ROMIMOT_Data.ProfileJerk;
+    Cmd.StreamSeq        = Dev->StreamSeq;
+    Cmd.StreamLeft       = Dev->StreamLeft;
+    Cmd.StreamRight      = Dev->StreamRight;
+    Cmd.StreamTimeoutMs  = Dev->StreamTimeoutMs;
+    memcpy(Cmd.ReadDelayUs, Dev->ReadDelayUs, sizeof(Cmd.ReadDelayUs));
+
+    ROMIMOT_DblBuf_Write(&Dev->ControlBuf, Dev->ControlSlots, sizeof(Cmd), &Cmd);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Plan the moves toward new targets and hand the profile to the I/O task.    */
+/* Must be followed by ROMIMOT_PublishControl() so the targets and the        */
+/* profile reach the control loop together.                                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_PlanProfile(ROMIMOT_Device_t *Dev)
+{
+    ROMIMOT_Profile_t *Profile = &Dev->Profile;
+
+    Profile->Seq++;
+    Profile->Mode = ROMIMOT_Data.ProfileMode;
+    ROMIMOT_ProfileBuildRamp(&Profile->Left, ROMIMOT_Data.ProfileMode, Dev->TargetDeltaLeft,
+                             ROMIMOT_Data.ProfileAccel, ROMIMOT_Data.ProfileJerk);
+    ROMIMOT_ProfileBuildRamp(&Profile->Right, ROMIMOT_Data.ProfileMode, Dev->TargetDeltaRight,
+                             ROMIMOT_Data.ProfileAccel, ROMIMOT_Data.ProfileJerk);
+
+    ROMIMOT_DblBuf_Write(&Dev->ProfileBuf, Dev->ProfileSlots, sizeof(*Profile), Profile);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Apply the table settings that take effect without a bus reopen             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_ApplyTableConfig(void)
+{
+    ROMIMOT_Table_t *  TblPtr;
+    ROMIMOT_PidGains_t Gains;
+    uint16             Mode;
+    uint16             RateHz;
+    uint16             BatchSize;
+    uint16             ReadDelayUs[ROMIMOT_MAX_DEVICES][ROMIMOT_READ_RANGES];
+    bool               ProfileChanged;
+    bool               ConfigChanged;
+    int32              Status;
+    int                i;
+
+    Status = CFE_TBL_GetAddress((void *)&TblPtr, ROMIMOT_Data.TblHandles[0]);
+    if (Status < CFE_SUCCESS)
+    {
+        return;
+    }
+
+    Mode   = TblPtr->ControlMode;
+    RateHz = TblPtr->ControlRateHz;
 
-        // Write state data for HK payload
-        ROMIMOT_Data.MotState.Payload.MotorsEnabled      = ROMIMOT_Data.MotorsEnabled;
-        ROMIMOT_Data.MotState.Payload.LeftPower          = ROMIMOT_Data.LeftMotSpeed;
-        ROMIMOT_Data.MotState.Payload.RightPower         = ROMIMOT_Data.RightMotSpeed;
-        ROMIMOT_Data.MotState.Payload.LeftEncoderDelta   = ROMIMOT_Data.LeftEncoderDelta;
-        ROMIMOT_Data.MotState.Payload.RightEncoderDelta  = ROMIMOT_Data.RightEncoderDelta;
-        ROMIMOT_Data.MotState.Payload.LeftMotorOdometer  = ROMIMOT_Data.LeftOdo;
-        ROMIMOT_Data.MotState.Payload.RightMotorOdometer = ROMIMOT_Data.RightOdo;
+    BatchSize = TblPtr->StateBatchSize;
 
-        CFE_SB_TimeStampMsg(CFE_MSG_PTR(ROMIMOT_Data.MotState.TelemetryHeader));
-        CFE_SB_TransmitMsg(CFE_MSG_PTR(ROMIMOT_Data.MotState.TelemetryHeader), true);
+    Gains.Kp            = TblPtr->Kp;
+    Gains.Ki            = TblPtr->Ki;
+    Gains.Kd            = TblPtr->Kd;
+    Gains.Kff           = TblPtr->Kff;
+    Gains.DAlpha        = TblPtr->DAlpha;
+    Gains.IntegralLimit = TblPtr->IntegralLimit;
+    Gains.OutputLimit   = TblPtr->OutputLimit;
 
-        if (ROMIMOT_Data.MotorsEnabled)
+    ProfileChanged = TblPtr->ProfileMode != ROMIMOT_Data.ProfileMode ||
+                     TblPtr->ProfileAccel != ROMIMOT_Data.ProfileAccel ||
+                     TblPtr->ProfileJerk != ROMIMOT_Data.ProfileJerk;
+
+    ROMIMOT_Data.ProfileMode  = TblPtr->ProfileMode;
+    ROMIMOT_Data.ProfileAccel = TblPtr->ProfileAccel;
+    ROMIMOT_Data.ProfileJerk  = TblPtr->ProfileJerk;
+
+    ROMIMOT_Data.ReadDelayMarginUs = TblPtr->ReadDelayMarginUs;
+
+    // The I/O task stops and closes a device on the cycle after it is disabled.
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        __atomic_store_n(&ROMIMOT_Data.Device[i].Enabled, TblPtr->Devices[i].Enabled != 0, __ATOMIC_RELEASE);
+        memcpy(ReadDelayUs[i], TblPtr->Devices[i].ReadDelayUs, sizeof(ReadDelayUs[i]));
+    }
+
+    // Only a load flags the table updated, ROMIMOT's own CFE_TBL_Modified()
+    // does not, so each loaded path is queued once.
+    if (Status == CFE_TBL_INFO_UPDATED)
+    {
+        for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
         {
-            // Calculate the distance and direction between the Odo Step and the Odo target.
-            // If the distance is greater than the target delta, move the Odo step
-            // in the direction of the target by the target delta.  Otherwise
-            // set the Odo step to the target.
-            int32_t leftOdoDistance = ROMIMOT_Data.LeftOdoTrgt - ROMIMOT_Data.LeftOdoStep;
-            int32_t leftDir         = leftOdoDistance > 0 ? 1 : -1;
-            if (leftOdoDistance * leftDir > ROMIMOT_Data.TargetDeltaLeft)
-            {
-                ROMIMOT_Data.LeftOdoStep += ROMIMOT_Data.TargetDeltaLeft * leftDir;
-            }
-            else
-            {
-                ROMIMOT_Data.LeftOdoStep = ROMIMOT_Data.LeftOdoTrgt;
-            }
-            int32_t rightOdoDistance = ROMIMOT_Data.RightOdoTrgt - ROMIMOT_Data.RightOdoStep;
-            int32_t rightDir         = rightOdoDistance > 0 ? 1 : -1;
-            if (rightOdoDistance * rightDir > ROMIMOT_Data.TargetDeltaRight)
-            {
-                ROMIMOT_Data.RightOdoStep += ROMIMOT_Data.TargetDeltaRight * rightDir;
-            }
-            else
+            if (TblPtr->Devices[i].Enabled && TblPtr->Devices[i].PathCount > 0)
             {
-                ROMIMOT_Data.RightOdoStep = ROMIMOT_Data.RightOdoTrgt;
+                ROMIMOT_AppendPath(&ROMIMOT_Data.Device[i], TblPtr->Devices[i].Path, TblPtr->Devices[i].PathCount);
             }
+        }
+    }
 
-            // Calculate the speed of the motors based on the difference between
-            // the Odo step and the Odo, and the proportional coefficient.
-            ROMIMOT_Data.LeftMotSpeed  = pcoeff * (ROMIMOT_Data.LeftOdoStep - ROMIMOT_Data.LeftOdo);
-            ROMIMOT_Data.RightMotSpeed = pcoeff * (ROMIMOT_Data.RightOdoStep - ROMIMOT_Data.RightOdo);
+    CFE_TBL_ReleaseAddress(ROMIMOT_Data.TblHandles[0]);
 
-            // Cap speed at plus or minus 200
-            if (ROMIMOT_Data.LeftMotSpeed > 200)
-            {
-                ROMIMOT_Data.LeftMotSpeed = 200;
-            }
-            if (ROMIMOT_Data.LeftMotSpeed < -200)
-            {
-                ROMIMOT_Data.LeftMotSpeed = -200;
-            }
-            if (ROMIMOT_Data.RightMotSpeed > 200)
-            {
-                ROMIMOT_Data.RightMotSpeed = 200;
-            }
-            if (ROMIMOT_Data.RightMotSpeed < -200)
-            {
-                ROMIMOT_Data.RightMotSpeed = -200;
-            }
+    ROMIMOT_ConfigureControl(Mode, RateHz);
 
-            printf("motor set L: %d %d %d, R: %d %d %d\n", ROMIMOT_Data.LeftMotSpeed, ROMIMOT_Data.LeftOdoStep,
-                   ROMIMOT_Data.LeftOdoTrgt, ROMIMOT_Data.RightMotSpeed, ROMIMOT_Data.RightOdoStep,
-                   ROMIMOT_Data.RightOdoTrgt);
-            i2c_ret = romiMotorWrite(ROMIMOT_Data.i2cfd, ROMIMOT_Data.LeftMotSpeed, ROMIMOT_Data.RightMotSpeed);
-            ROMIMOT_CheckI2CTransaction(i2c_ret);
-        }
-        else
+    // Gains, the batch size, the read delays and the profile settings for
+    // queued segments reach the I/O task with the next published command.
+    // A device whose own read delays changed is published even if nothing
+    // shared did.
+    ConfigChanged = memcmp(&Gains, &ROMIMOT_Data.Gains, sizeof(Gains)) != 0 ||
+                    BatchSize != ROMIMOT_Data.StateBatchSize || ProfileChanged;
+
+    ROMIMOT_Data.Gains          = Gains;
+    ROMIMOT_Data.StateBatchSize = BatchSize;
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        if (ConfigChanged || memcmp(ReadDelayUs[i], ROMIMOT_Data.Device[i].ReadDelayUs, sizeof(ReadDelayUs[i])) != 0)
         {
-            i2c_ret = romiMotorWrite(ROMIMOT_Data.i2cfd, 0, 0);
-            ROMIMOT_CheckI2CTransaction(i2c_ret);
+            memcpy(ROMIMOT_Data.Device[i].ReadDelayUs, ReadDelayUs[i], sizeof(ReadDelayUs[i]));
+            ROMIMOT_PublishControl(&ROMIMOT_Data.Device[i]);
         }
     }
-
-    return CFE_SUCCESS;
 }
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
 /* ROMIMOT NOOP commands                                                   */
@@ -651,9 +1041,20 @@ int32 ROMIMOT_Noop(const ROMIMOT_NoopCmd_t *Msg)
 /* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
 int32 ROMIMOT_ResetCounters(const ROMIMOT_ResetCountersCmd_t *Msg)
 {
-    ROMIMOT_Data.CmdCounter    = 0;
-    ROMIMOT_Data.ErrCounter    = 0;
-    ROMIMOT_Data.I2CErrCounter = 0;
+    int i;
+
+    ROMIMOT_Data.CmdCounter = 0;
+    ROMIMOT_Data.ErrCounter = 0;
+    MRLIB_ResetCmdStats(&ROMIMOT_Dispatch);
+
+    // The I/O task clears the bus statistics and I2C error counts on its next cycle.
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        __atomic_store_n(&ROMIMOT_Data.Device[i].BusStatsResetReq, true, __ATOMIC_RELEASE);
+    }
+    CFE_EVS_ResetFilter(ROMIMOT_I2C_ERR_EID);
+    CFE_EVS_ResetFilter(ROMIMOT_BUS_RECOVERY_ERR_EID);
+    CFE_EVS_ResetFilter(ROMIMOT_STREAM_ERR_EID);
 
     CFE_EVS_SendEvent(ROMIMOT_COMMANDRST_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT: RESET command");
 
@@ -682,7 +1083,9 @@ int32 ROMIMOT_Process(const ROMIMOT_ProcessCmd_t *Msg)
         return status;
     }
 
-    CFE_ES_WriteToSysLog("ROMI Motor Driver App: Table Value 1: %d  Value 2: %d", TblPtr->Int1, TblPtr->Int2);
+    CFE_ES_WriteToSysLog("ROMI Motor Driver App: PID Kp %ld Ki %ld Kd %ld Kff %ld (Q16.16), limit %d",
+                         (long)TblPtr->Kp, (long)TblPtr->Ki, (long)TblPtr->Kd, (long)TblPtr->Kff,
+                         (int)TblPtr->OutputLimit);
 
     ROMIMOT_GetCrc(TableName);
 
@@ -696,72 +1099,422 @@ int32 ROMIMOT_Process(const ROMIMOT_ProcessCmd_t *Msg)
     return CFE_SUCCESS;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Look up the Romi base a command names, NULL if it is not enabled           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+ROMIMOT_Device_t *ROMIMOT_CmdDevice(uint8 Device)
+{
+    if (Device >= ROMIMOT_MAX_DEVICES || !ROMIMOT_Data.Device[Device].Enabled)
+    {
+        ROMIMOT_Data.ErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_DEVICE_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: Romi %u %s",
+                          (unsigned int)Device, Device >= ROMIMOT_MAX_DEVICES ? "does not exist" : "is not enabled");
+        return NULL;
+    }
+
+    return &ROMIMOT_Data.Device[Device];
+}
+
 int32 ROMIMOT_SetMotEnable(const ROMIMOT_SetEnableCmd_t *Msg, uint8_t enable)
 {
-    ROMIMOT_Data.MotorsEnabled = enable;
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
+
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    ROMIMOT_RequestI2C(Dev);
+    Dev->MotorsEnabled = enable;
+    ROMIMOT_PublishControl(Dev);
 
-    CFE_EVS_SendEvent(ROMIMOT_COMMANDRST_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT: Motor Enable command: %d",
-                      enable);
+    CFE_EVS_SendEvent(ROMIMOT_COMMANDRST_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "ROMIMOT: Romi %u Motor Enable command: %d", (unsigned int)Dev->Instance, enable);
 
     return CFE_SUCCESS;
 }
+
+int32 ROMIMOT_MotEnable(const ROMIMOT_SetEnableCmd_t *Msg)
+{
+    return ROMIMOT_SetMotEnable(Msg, true);
+}
+
+int32 ROMIMOT_MotDisable(const ROMIMOT_SetEnableCmd_t *Msg)
+{
+    return ROMIMOT_SetMotEnable(Msg, false);
+}
+
 int32 ROMIMOT_SetTarget(const ROMIMOT_SetTargetCmd_t *Msg)
 {
-    // ROMIMOT_Data.LeftMotSpeed  = Msg->cmdMotLeft;
-    // ROMIMOT_Data.RightMotSpeed = Msg->cmdMotRight;
-    ROMIMOT_Data.LeftOdoTrgt += Msg->cmdMotLeft;
-    ROMIMOT_Data.RightOdoTrgt += Msg->cmdMotRight;
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
+
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    ROMIMOT_RequestI2C(Dev);
+    // Dev->LeftMotSpeed  = Msg->cmdMotLeft;
+    // Dev->RightMotSpeed = Msg->cmdMotRight;
+    Dev->LeftOdoTrgt += Msg->cmdMotLeft;
+    Dev->RightOdoTrgt += Msg->cmdMotRight;
+    ROMIMOT_PlanProfile(Dev);
+    ROMIMOT_PublishControl(Dev);
 
     CFE_EVS_SendEvent(ROMIMOT_COMMANDRST_INF_EID, CFE_EVS_EventType_INFORMATION,
-                      "ROMIMOT: Motor Target set (Absolute) : %d %d", ROMIMOT_Data.LeftOdoTrgt,
-                      ROMIMOT_Data.RightOdoTrgt);
+                      "ROMIMOT: Romi %u Motor Target set (Absolute) : %d %d", (unsigned int)Dev->Instance,
+                      Dev->LeftOdoTrgt, Dev->RightOdoTrgt);
     return CFE_SUCCESS;
 }
 int32 ROMIMOT_SetTargetDelta(const ROMIMOT_SetTargetDeltaCmd_t *Msg)
 {
-    ROMIMOT_Data.TargetDeltaLeft  = Msg->cmdMotLeft;
-    ROMIMOT_Data.TargetDeltaRight = Msg->cmdMotRight;
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
+
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    ROMIMOT_RequestI2C(Dev);
+    Dev->TargetDeltaLeft  = Msg->cmdMotLeft;
+    Dev->TargetDeltaRight = Msg->cmdMotRight;
+    ROMIMOT_PlanProfile(Dev);
+    ROMIMOT_PublishControl(Dev);
 
     CFE_EVS_SendEvent(ROMIMOT_COMMANDRST_INF_EID, CFE_EVS_EventType_INFORMATION,
-                      "ROMIMOT: Motor Target Delta Set : %d %d", ROMIMOT_Data.TargetDeltaLeft,
-                      ROMIMOT_Data.TargetDeltaRight);
+                      "ROMIMOT: Romi %u Motor Target Delta Set : %d %d", (unsigned int)Dev->Instance,
+                      Dev->TargetDeltaLeft, Dev->TargetDeltaRight);
 
     return CFE_SUCCESS;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
-/* Verify command packet length                                               */
+/* Drain the control loop trace to a file                                     */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-bool ROMIMOT_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength)
+int32 ROMIMOT_DumpTrace(const ROMIMOT_DumpTraceCmd_t *Msg)
 {
-    bool              result       = true;
-    size_t            ActualLength = 0;
-    CFE_SB_MsgId_t    MsgId        = CFE_SB_INVALID_MSG_ID;
-    CFE_MSG_FcnCode_t FcnCode      = 0;
+    ROMIMOT_TraceFileHdr_t Info;
+    char                   FileName[CFE_MISSION_MAX_PATH_LEN];
+    int32                  status;
+    ROMIMOT_Device_t *     Dev = ROMIMOT_CmdDevice(Msg->Device);
 
-    CFE_MSG_GetSize(MsgPtr, &ActualLength);
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
 
-    /*
-    ** Verify the command packet length.
-    */
-    if (ExpectedLength != ActualLength)
+    if (Msg->FileName[0] == '\0')
+    {
+        strncpy(FileName, ROMIMOT_TRACE_FILE, sizeof(FileName) - 1);
+    }
+    else
+    {
+        strncpy(FileName, Msg->FileName, sizeof(FileName) - 1);
+    }
+    FileName[sizeof(FileName) - 1] = '\0';
+
+    status = ROMIMOT_TraceDrain(&Dev->Trace, FileName, &Info);
+    if (status != CFE_SUCCESS)
+    {
+        ROMIMOT_Data.ErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_TRACE_ERR_EID, CFE_EVS_EventType_ERROR, "ROMIMOT: Trace dump to %s failed", FileName);
+        return status;
+    }
+
+    CFE_EVS_SendEvent(ROMIMOT_TRACE_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "ROMIMOT: Romi %u trace dump to %s, %lu samples from cycle %lu%s", (unsigned int)Dev->Instance,
+                      FileName,
+                      (unsigned long)Info.SampleCount, (unsigned long)Info.FirstIndex,
+                      Info.Faulted ? ", frozen on I2C error" : "");
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Ask the I/O task to send the bus diagnostic packet on its next cycle       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_SendDiag(const ROMIMOT_SendDiagCmd_t *Msg)
+{
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
+
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    ROMIMOT_Data.CmdCounter++;
+
+    __atomic_store_n(&Dev->DiagReq, true, __ATOMIC_RELEASE);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Send the run counts and times of every command the app dispatches          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_SendCmdStats(const ROMIMOT_SendCmdStatsCmd_t *Msg)
+{
+    ROMIMOT_Data.CmdCounter++;
+
+    MRLIB_SendCmdStats(&ROMIMOT_Dispatch, &ROMIMOT_Data.CmdStatsTlm);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Start a read delay calibration on the I/O task                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_CalibrateRead(const ROMIMOT_CalibrateReadCmd_t *Msg)
+{
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
+
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    /* the trial reads get bad data on purpose, and check the encoders
+       against a reference read, so the wheels must stay still */
+    if (Dev->MotorsEnabled || Dev->ReadCalPending)
     {
-        CFE_MSG_GetMsgId(MsgPtr, &MsgId);
-        CFE_MSG_GetFcnCode(MsgPtr, &FcnCode);
+        ROMIMOT_Data.ErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_READCAL_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u read calibration rejected, %s", (unsigned int)Dev->Instance,
+                          Dev->ReadCalPending ? "already running" : "motors enabled");
+        return CFE_SUCCESS;
+    }
+
+    ROMIMOT_Data.CmdCounter++;
+    Dev->ReadCalPending  = true;
+    Dev->ReadCalMarginUs = ROMIMOT_Data.ReadDelayMarginUs;
+
+    __atomic_store_n(&Dev->ReadCalReq, true, __ATOMIC_RELEASE);
+
+    CFE_EVS_SendEvent(ROMIMOT_READCAL_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "ROMIMOT: Romi %u read calibration started, %u us margin", (unsigned int)Dev->Instance,
+                      (unsigned int)Dev->ReadCalMarginUs);
+
+    return CFE_SUCCESS;
+}
 
-        CFE_EVS_SendEvent(ROMIMOT_LEN_ERR_EID, CFE_EVS_EventType_ERROR,
-                          "Invalid Msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u",
-                          (unsigned int)CFE_SB_MsgIdToValue(MsgId), (unsigned int)FcnCode, (unsigned int)ActualLength,
-                          (unsigned int)ExpectedLength);
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Choose whether ROMIMOT or the Romi firmware closes the wheel loop          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_SetDriveMode(const ROMIMOT_DriveModeCmd_t *Msg)
+{
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
 
-        result = false;
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
 
+    /* the motor registers change meaning, so only switch while stopped */
+    if (Msg->DriveMode > ROMIMOT_DRIVE_MODE_SPEED || Dev->MotorsEnabled)
+    {
         ROMIMOT_Data.ErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_DRIVE_MODE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u drive mode %u rejected, %s", (unsigned int)Dev->Instance,
+                          (unsigned int)Msg->DriveMode, Dev->MotorsEnabled ? "motors enabled" : "unknown mode");
+        return CFE_SUCCESS;
     }
 
-    return result;
+    ROMIMOT_Data.CmdCounter++;
+    Dev->DriveMode = Msg->DriveMode;
+    ROMIMOT_PublishControl(Dev);
+
+    CFE_EVS_SendEvent(ROMIMOT_DRIVE_MODE_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT: Romi %u drive mode %s",
+                      (unsigned int)Dev->Instance,
+                      Dev->DriveMode == ROMIMOT_DRIVE_MODE_SPEED ? "firmware speed loop" : "motor power");
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Append segments to a device's path queue, all of them or none              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool ROMIMOT_AppendPath(ROMIMOT_Device_t *Dev, const ROMIMOT_Segment_t *Segments, uint32 Count)
+{
+    uint32 i;
+
+    for (i = 0; i < Count; i++)
+    {
+        if (Segments[i].SpeedLeft < 0 || Segments[i].SpeedRight < 0)
+        {
+            CFE_EVS_SendEvent(ROMIMOT_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "ROMIMOT: Romi %u path rejected, segment %u has a negative speed",
+                              (unsigned int)Dev->Instance, (unsigned int)i);
+            return false;
+        }
+    }
+
+    if (!ROMIMOT_PathAppend(&Dev->Path, Segments, Count))
+    {
+        CFE_EVS_SendEvent(ROMIMOT_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u path rejected, %u segments do not fit behind %u queued",
+                          (unsigned int)Dev->Instance, (unsigned int)Count,
+                          (unsigned int)ROMIMOT_PathQueued(&Dev->Path));
+        return false;
+    }
+
+    CFE_EVS_SendEvent(ROMIMOT_PATH_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "ROMIMOT: Romi %u path, %u segments added, %u queued", (unsigned int)Dev->Instance,
+                      (unsigned int)Count, (unsigned int)ROMIMOT_PathQueued(&Dev->Path));
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Queue path segments for the control loop to run on its own                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_QueuePath(const ROMIMOT_QueuePathCmd_t *Msg)
+{
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
+
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    if (Msg->Count < 1 || Msg->Count > ROMIMOT_PATH_CMD_MAX)
+    {
+        ROMIMOT_Data.ErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_PATH_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u path rejected, %u segments in the command", (unsigned int)Dev->Instance,
+                          (unsigned int)Msg->Count);
+        return CFE_SUCCESS;
+    }
+
+    if (!ROMIMOT_AppendPath(Dev, Msg->Segments, Msg->Count))
+    {
+        ROMIMOT_Data.ErrCounter++;
+        return CFE_SUCCESS;
+    }
+
+    ROMIMOT_Data.CmdCounter++;
+    ROMIMOT_RequestI2C(Dev);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Drop the queued path and stop the segment being driven                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_ClearPath(const ROMIMOT_ClearPathCmd_t *Msg)
+{
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
+
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    ROMIMOT_Data.CmdCounter++;
+
+    /* the queue's tail belongs to the I/O task, it flushes on its next cycle */
+    __atomic_store_n(&Dev->PathClearReq, true, __ATOMIC_RELEASE);
+
+    CFE_EVS_SendEvent(ROMIMOT_PATH_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT: Romi %u path cleared",
+                      (unsigned int)Dev->Instance);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Take a streamed wheel velocity setpoint.  Sent at the control rate, so a   */
+/* setpoint that is taken raises no event.                                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_SetVelocity(const ROMIMOT_SetVelocityCmd_t *Msg)
+{
+    ROMIMOT_Device_t *Dev = ROMIMOT_CmdDevice(Msg->Device);
+
+    if (Dev == NULL)
+    {
+        return CFE_SUCCESS;
+    }
+
+    if (Msg->SpeedLeft < -ROMIMOT_STREAM_SPEED_MAX || Msg->SpeedLeft > ROMIMOT_STREAM_SPEED_MAX ||
+        Msg->SpeedRight < -ROMIMOT_STREAM_SPEED_MAX || Msg->SpeedRight > ROMIMOT_STREAM_SPEED_MAX ||
+        Msg->TimeoutMs < 1 || Msg->TimeoutMs > ROMIMOT_STREAM_TIMEOUT_MAX_MS || !Dev->MotorsEnabled)
+    {
+        ROMIMOT_Data.ErrCounter++;
+        CFE_EVS_SendEvent(ROMIMOT_STREAM_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u velocity %d %d for %u ms rejected, %s", (unsigned int)Dev->Instance,
+                          Msg->SpeedLeft, Msg->SpeedRight, (unsigned int)Msg->TimeoutMs,
+                          Dev->MotorsEnabled ? "out of range" : "motors disabled");
+        return CFE_SUCCESS;
+    }
+
+    ROMIMOT_Data.CmdCounter++;
+
+    ROMIMOT_RequestI2C(Dev);
+    Dev->StreamSeq++;
+    Dev->StreamLeft      = Msg->SpeedLeft;
+    Dev->StreamRight     = Msg->SpeedRight;
+    Dev->StreamTimeoutMs = Msg->TimeoutMs;
+    ROMIMOT_PublishControl(Dev);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Write a finished calibration into the table                                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_StoreReadCal(ROMIMOT_Device_t *Dev)
+{
+    const ROMIMOT_ReadCal_t *Cal = &Dev->ReadCal;
+    ROMIMOT_Table_t *        TblPtr;
+
+    if (!__atomic_exchange_n(&Dev->ReadCalDone, false, __ATOMIC_ACQ_REL))
+    {
+        return;
+    }
+
+    /* the I/O task leaves ReadCal alone until the next calibration */
+    Dev->ReadCalPending = false;
+
+    if (CFE_TBL_GetAddress((void *)&TblPtr, ROMIMOT_Data.TblHandles[0]) < CFE_SUCCESS)
+    {
+        CFE_EVS_SendEvent(ROMIMOT_READCAL_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Read calibration not stored, table unavailable");
+        return;
+    }
+
+    /* this Romi's own delays, already in use on its turn of the bus; dump
+       the table to keep the result over a restart */
+    memcpy(TblPtr->Devices[Dev->Instance].ReadDelayUs, Cal->ResultUs, sizeof(Cal->ResultUs));
+    memcpy(Dev->ReadDelayUs, Cal->ResultUs, sizeof(Dev->ReadDelayUs));
+    CFE_TBL_ReleaseAddress(ROMIMOT_Data.TblHandles[0]);
+    CFE_TBL_Modified(ROMIMOT_Data.TblHandles[0]);
+
+    CFE_EVS_SendEvent(Cal->Failed ? ROMIMOT_READCAL_ERR_EID : ROMIMOT_READCAL_INF_EID,
+                      Cal->Failed ? CFE_EVS_EventType_ERROR : CFE_EVS_EventType_INFORMATION,
+                      "ROMIMOT: Romi %u read delays calibrated to %u/%u/%u us%s", (unsigned int)Dev->Instance,
+                      (unsigned int)Cal->ResultUs[0],
+                      (unsigned int)Cal->ResultUs[1], (unsigned int)Cal->ResultUs[2],
+                      Cal->Failed ? ", a range never read cleanly" : "");
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
@@ -773,15 +1526,94 @@ int32 ROMIMOT_TblValidationFunc(void *TblData)
 {
     int32            ReturnCode = CFE_SUCCESS;
     ROMIMOT_Table_t *TblDataPtr = (ROMIMOT_Table_t *)TblData;
+    int              i;
+    int              j;
 
     /*
     ** ROMI Motor Driver Table Validation
     */
-    if (TblDataPtr->Int1 > ROMIMOT_TBL_ELEMENT_1_MAX)
+    if (TblDataPtr->HwBackend > ROMIMOT_HW_BACKEND_REPLAY)
+    {
+        ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (TblDataPtr->BusRecord > 1 || TblDataPtr->ReplaySpeed > ROMIMOT_REPLAY_WALL_CLOCK ||
+             memchr(TblDataPtr->BusLogFile, '\0', sizeof(TblDataPtr->BusLogFile)) == NULL ||
+             ((TblDataPtr->BusRecord || TblDataPtr->HwBackend == ROMIMOT_HW_BACKEND_REPLAY) &&
+              TblDataPtr->BusLogFile[0] == '\0'))
+    {
+        /* the log needs a name to be recorded or replayed */
+        ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (!MRLIB_RtValidate(&TblDataPtr->RtProfile) || !MRLIB_RtValidate(&TblDataPtr->IoRtProfile))
+    {
+        ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (TblDataPtr->ControlMode > ROMIMOT_CONTROL_MODE_TIMER ||
+             TblDataPtr->ControlRateHz < ROMIMOT_CONTROL_RATE_MIN_HZ ||
+             TblDataPtr->ControlRateHz > ROMIMOT_CONTROL_RATE_MAX_HZ)
     {
-        /* First element is out of range, return an appropriate error code */
         ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
     }
+    else if (TblDataPtr->OutputLimit < 1 || TblDataPtr->OutputLimit > ROMIMOT_PID_OUTPUT_MAX ||
+             TblDataPtr->IntegralLimit < 0 || TblDataPtr->IntegralLimit > ROMIMOT_Q16(ROMIMOT_PID_OUTPUT_MAX))
+    {
+        ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (TblDataPtr->Kp < 0 || TblDataPtr->Ki < 0 || TblDataPtr->Kd < 0 || TblDataPtr->Kff < 0 ||
+             TblDataPtr->DAlpha <= 0 || TblDataPtr->DAlpha > ROMIMOT_Q16(1.0))
+    {
+        /* Negative gains would turn the loop into positive feedback */
+        ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (TblDataPtr->ProfileMode > ROMIMOT_PROFILE_SCURVE ||
+             (TblDataPtr->ProfileMode != ROMIMOT_PROFILE_LINEAR &&
+              (TblDataPtr->ProfileAccel <= 0 || TblDataPtr->ProfileAccel > ROMIMOT_PROFILE_LIMIT_MAX)) ||
+             (TblDataPtr->ProfileMode == ROMIMOT_PROFILE_SCURVE &&
+              (TblDataPtr->ProfileJerk <= 0 || TblDataPtr->ProfileJerk > ROMIMOT_PROFILE_LIMIT_MAX)))
+    {
+        ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (TblDataPtr->StateBatchSize < 1 || TblDataPtr->StateBatchSize > ROMIMOT_STATE_BATCH_MAX)
+    {
+        ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+    else if (TblDataPtr->ReadDelayMarginUs > ROMIMOT_READ_DELAY_MAX_US)
+    {
+        ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+
+    /* enabled devices each need a valid address of their own */
+    for (i = 0; i < ROMIMOT_MAX_DEVICES && ReturnCode == CFE_SUCCESS; i++)
+    {
+        if (TblDataPtr->Devices[i].PathCount > ROMIMOT_PATH_TABLE_MAX ||
+            TblDataPtr->Devices[i].ReadDelayUs[ROMI_READ_RANGE_STATUS] > ROMIMOT_READ_DELAY_MAX_US ||
+            TblDataPtr->Devices[i].ReadDelayUs[ROMI_READ_RANGE_ENCODERS] > ROMIMOT_READ_DELAY_MAX_US ||
+            TblDataPtr->Devices[i].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT] > ROMIMOT_READ_DELAY_MAX_US)
+        {
+            ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+        }
+
+        if (!TblDataPtr->Devices[i].Enabled)
+        {
+            continue;
+        }
+
+        if (TblDataPtr->Devices[i].Address < ROMIMOT_I2C_ADDR_MIN ||
+            TblDataPtr->Devices[i].Address > ROMIMOT_I2C_ADDR_MAX)
+        {
+            ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+        }
+
+        for (j = 0; j < i; j++)
+        {
+            if (TblDataPtr->Devices[j].Enabled &&
+                TblDataPtr->Devices[j].BusNumber == TblDataPtr->Devices[i].BusNumber &&
+                TblDataPtr->Devices[j].Address == TblDataPtr->Devices[i].Address)
+            {
+                ReturnCode = ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE;
+            }
+        }
+    }
 
     return ReturnCode;
 }
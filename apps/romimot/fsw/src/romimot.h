@@ -37,43 +37,339 @@
 #include "romimot_perfids.h"
 #include "romimot_msgids.h"
 #include "romimot_msg.h"
+#include "romimot_hw.h"
+#include "romimot_dblbuf.h"
+#include "romimot_pid.h"
+#include "romimot_profile.h"
+#include "romimot_trace.h"
+#include "romimot_busstats.h"
+#include "romimot_readcal.h"
+#include "romimot_recovery.h"
+#include "romimot_path.h"
+#include "romimot_table.h"
+
+#include "mrlib.h"
 
 /***********************************************************************/
 #define ROMIMOT_PIPE_DEPTH 32 /* Depth of the Command Pipe for Application */
 
 #define ROMIMOT_NUMBER_OF_TABLES 1 /* Number of Table(s) */
 
+#define ROMIMOT_EVENT_FILTERS 3 /* Number of filtered event IDs */
+
+#if ROMIMOT_STREAM_SPEED_MAX > ROMI_SPEED_MAX
+#error "ROMIMOT_STREAM_SPEED_MAX must not exceed the firmware's ROMI_SPEED_MAX"
+#endif
+
 /* Define filenames of default data images for tables */
 #define ROMIMOT_TABLE_FILE "/cf/romimot_tbl.tbl"
 
 #define ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE -1
 
-#define ROMIMOT_TBL_ELEMENT_1_MAX 10
+#define ROMIMOT_IO_TASK_NAME       "ROMIMOT_IO"
+#define ROMIMOT_IO_TASK_STACK_SIZE 16384
+#define ROMIMOT_IO_TASK_PRIORITY   45 /* Just above the ROMIMOT main task */
+
+#define ROMIMOT_TIMEBASE_NAME "ROMIMOT_TB"
+#define ROMIMOT_TIMER_NAME    "ROMIMOT_CTL"
+
+/*
+** In ROMIMOT_DRIVE_MODE_SPEED a wheel lagging its intermediate target gets
+** this fraction of the gap added to its speed every cycle
+*/
+#define ROMIMOT_SPEED_CATCHUP_CYCLES 8
+
+/*
+** Profile sequence numbers of queued path segments have this bit set, so
+** they never match one planned by the main task
+*/
+#define ROMIMOT_PATH_SEQ_BIT 0x80000000u
+
 /************************************************************************
 ** Type Definitions
 *************************************************************************/
 
 /*
-** Global Data
+** Motion command published by the main task for the control loop
+*/
+typedef struct
+{
+    uint8  MotorsEnabled;
+    uint8  DriveMode; /* ROMIMOT_DRIVE_MODE_* */
+    int32  LeftOdoTrgt;
+    int32  RightOdoTrgt;
+    int16  TargetDeltaLeft;
+    int16  TargetDeltaRight;
+    uint32 ProfileSeq;     /* ROMIMOT_Profile_t planned for these targets */
+    uint16 StateBatchSize; /* Control cycles per state packet */
+    uint16 ReadDelayUs[ROMIMOT_READ_RANGES];
+
+    /* Profile settings, for the I/O task to plan queued path segments */
+    uint16 ProfileMode;
+    int32  ProfileAccel;
+    int32  ProfileJerk;
+
+    /* Streamed wheel velocity, a new StreamSeq for every setpoint */
+    uint32 StreamSeq;
+    int16  StreamLeft; /* counts/s */
+    int16  StreamRight;
+    uint16 StreamTimeoutMs;
+
+    ROMIMOT_PidGains_t Gains;
+} ROMIMOT_ControlCmd_t;
+
+/*
+** Control loop working state, owned by the I/O task
 */
 typedef struct
 {
+    /* Raw 32 bit wheel encoder counts, stored for next encoder delta calculation */
+    int32 RawLeftEncoder;
+    int32 RawRightEncoder;
+
+    /* Change in encoder values since the last reading */
+    int32 LeftEncoderDelta;
+    int32 RightEncoderDelta;
+
+    /* Wheel velocities measured by the firmware, counts/s */
+    int16 LeftVelocity;
+    int16 RightVelocity;
+
+    /* Absolute position of each motor since ROMIMOT app started */
+    int32 LeftOdo;
+    int32 RightOdo;
+
+    /* Odometer intermediate targets */
+    int32 LeftOdoStep;
+    int32 RightOdoStep;
+
+    /* Motion profiles the intermediate targets follow */
+    uint32                 ProfileSeq;
+    ROMIMOT_ProfileState_t LeftProfile;
+    ROMIMOT_ProfileState_t RightProfile;
+
     /*
-    ** Command interface counters...
+    ** Queued path.  The segments started so far move the commanded targets
+    ** by PathLeft/PathRight; while one is active its own targets, speeds
+    ** and profile stand in for the commanded ones.
     */
-    uint16 CmdCounter;
-    uint8  ErrCounter;
-    uint8  I2CErrCounter;
+    bool   PathActive;
+    uint32 PathSegments; /* Segments started */
+    int32  PathLeft;
+    int32  PathRight;
+    int16  PathSpeedLeft;
+    int16  PathSpeedRight;
+
+    /*
+    ** Streamed velocity.  While Streaming the intermediate targets run at
+    ** the setpoint speeds and move PathLeft/PathRight with them, so the
+    ** commanded targets and the path carry on from where the stream ends.
+    */
+    bool   Streaming;
+    uint32 StreamSeq;     /* Of the setpoint in use */
+    int16  StreamLeft;    /* counts/s, zeroed when the setpoints stop */
+    int16  StreamRight;
+    uint32 StreamAgeUs;   /* Since the setpoint arrived */
+    int32  StreamRemLeft; /* Travel short of a whole count, counts * 1e6 */
+    int32  StreamRemRight;
+
+    /* Motor speed settings, powers or wheel speeds in counts/s by drive mode */
+    int16 LeftMotSpeed;
+    int16 RightMotSpeed;
+
+    /* Wakeup to wakeup time of this cycle, 0 until there have been two */
+    uint32 PeriodUs;
+
+    /* Wheel PID state */
+    ROMIMOT_PidState_t LeftPid;
+    ROMIMOT_PidState_t RightPid;
+} ROMIMOT_ControlState_t;
+
+/*
+** Loop timing gathered by the I/O task since the last housekeeping request
+*/
+typedef struct
+{
+    uint32 Cycles;       /* Completed control cycles */
+    uint32 LatencySumUs; /* Wakeup to motor write, summed over Cycles */
+    uint32 LatencyMaxUs;
+    uint32 PeriodMinUs; /* Wakeup to wakeup */
+    uint32 PeriodMaxUs;
+    uint32 StaleSamples; /* Snapshots that repeated the previous one, dropped */
+} ROMIMOT_LoopStats_t;
+
+/*
+** State published by the I/O task after every bus cycle
+*/
+typedef struct
+{
+    uint32                 Sequence;        /* I/O cycle counter */
+    int32                  Status;          /* romiSnapshotRead() return code, 0 on success */
+    bool                   I2COpen;         /* Bus state at the time of the snapshot */
+    bool                   ReadCalActive;   /* Read delay calibration in progress */
+    uint16                 SnapshotDelayUs; /* Snapshot read delay in use */
+    uint8                  BusState;        /* ROMIMOT_BUS_STATE_* */
+    uint32                 BusReopens;      /* Bus reopens by the recovery */
+    RomiSnapshot           Romi;
+    ROMIMOT_ControlState_t Ctl;
+    ROMIMOT_LoopStats_t    Stats;
+} ROMIMOT_SensorState_t;
+
+/*
+** One Romi base.  The main task owns its commanded motion, the I/O task its
+** bus; the two meet only in the double buffers and the request flags.
+*/
+typedef struct
+{
+    uint8 Instance; /* Index in ROMIMOT_Data.Device and the table's Devices */
+    bool  Enabled;  /* From the table, the I/O task leaves the device alone while clear */
 
     /*
     ** Housekeeping telemetry packet...
     */
     ROMIMOT_HkTlm_t HkTlm;
+    uint8           I2CErrCounter; /* Written by the I/O task only, reset through BusStatsResetReq */
+
+    /*
+     * Are the motors enabled
+     */
+    uint8 MotorsEnabled;
+
+    /*
+    ** Who closes the wheel loop, ROMIMOT_DRIVE_MODE_*
+    */
+    uint8 DriveMode;
+
+    /*
+    ** Odometer targets
+    */
+    int32 LeftOdoTrgt;
+    int32 RightOdoTrgt;
+
+    /*
+     * amount to increment/decrement the target to make the wheel turn at constant speed.
+     */
+    int16_t TargetDeltaLeft;
+    int16_t TargetDeltaRight;
+
+    /*
+    ** Latest streamed velocity setpoint
+    */
+    uint32 StreamSeq;
+    int16  StreamLeft;
+    int16  StreamRight;
+    uint16 StreamTimeoutMs;
+
+    /*
+    ** This Romi's read delays from the table
+    */
+    uint16 ReadDelayUs[ROMIMOT_READ_RANGES];
+
+    /*
+    ** Last motion profile planned
+    */
+    ROMIMOT_Profile_t Profile;
+
+    /*
+    ** Latest I/O task state seen by the main task
+    */
+    ROMIMOT_SensorState_t Sensor;
 
     /*
-    ** State output packet...
+    ** A read calibration waiting to be written back to the table
     */
-    ROMIMOT_MotorState_t MotState;
+    bool ReadCalPending;
+
+    /* file desccriptor for I2C bus, owned by the I/O task */
+    int    i2cfd;
+    uint8  BusNumber; /* Taken from the table at each bus open */
+    uint16 Address;
+
+    /* I2C connection status flag, owned by the I/O task */
+    bool i2c_open;
+
+    /*
+    ** Requests from the main task, taken by the I/O task on its next cycle
+    */
+    bool I2CConnectReq;
+    bool StatsResetReq;
+    bool BusStatsResetReq;
+    bool DiagReq;
+    bool ReadCalReq;
+    bool ReadCalDone;
+    bool PathClearReq;
+
+    int64                 LastWakeUs; /* Wakeup time of the previous cycle */
+    ROMIMOT_SensorState_t IoSensor;
+    ROMIMOT_ControlCmd_t  IoCmd;
+
+    ROMIMOT_DblBuf_t      SensorBuf;
+    ROMIMOT_SensorState_t SensorSlots[2];
+    uint32                SensorCount;
+
+    ROMIMOT_DblBuf_t     ControlBuf;
+    ROMIMOT_ControlCmd_t ControlSlots[2];
+    uint32               ControlCount;
+
+    ROMIMOT_Profile_t IoProfile;
+    ROMIMOT_DblBuf_t  ProfileBuf;
+    ROMIMOT_Profile_t ProfileSlots[2];
+    uint32            ProfileCount;
+
+    /*
+    ** Path queue, appended by the main task and run by the I/O task, which
+    ** plans each segment's profile itself
+    */
+    ROMIMOT_Path_t    Path;
+    ROMIMOT_Profile_t IoPathProfile;
+
+    /*
+    ** Control loop trace, recorded by the I/O task and drained by command
+    */
+    ROMIMOT_Trace_t Trace;
+
+    /*
+    ** Batched state packet, filled and sent by the I/O task
+    */
+    ROMIMOT_StateBatchTlm_t StateTlm;
+    int64                   StateBaseUs; /* Wakeup time of the first sample */
+
+    /*
+    ** Bus latency statistics, recorded by the I/O task and sent on command
+    */
+    ROMIMOT_BusStats_t BusStats;
+    ROMIMOT_DiagTlm_t  DiagTlm;
+
+    /*
+    ** Read delay calibration and back-off, run by the I/O task
+    */
+    ROMIMOT_ReadCal_t     ReadCal;
+    ROMIMOT_ReadBackoff_t ReadBackoff;
+    uint16                IoReadDelayUs[ROMIMOT_READ_RANGES];  /* Last delays taken from the command */
+    uint16                BusReadDelayUs[ROMIMOT_READ_RANGES]; /* In use, after calibration or back-off */
+    uint16                ReadCalMarginUs;
+
+    /*
+    ** I2C fault recovery, run by the I/O task
+    */
+    ROMIMOT_BusRecovery_t BusRecovery;
+} ROMIMOT_Device_t;
+
+/*
+** Global Data
+*/
+typedef struct
+{
+    /*
+    ** Command interface counters...
+    */
+    uint16 CmdCounter;
+    uint8  ErrCounter;
+
+    /*
+    ** Dispatch statistics packet, sent on ROMIMOT_SEND_CMD_STATS_CC
+    */
+    MRLIB_CmdStatsTlm_t CmdStatsTlm;
 
     /*
     ** Run Status variable used in the main processing loop
@@ -81,62 +377,68 @@ typedef struct
     uint32 RunStatus;
 
     /*
-    ** Battery voltage expressed in millivolts
+    ** Wheel PID gains from the table
     */
-    uint16 BatteryMillivolts;
+    ROMIMOT_PidGains_t Gains;
 
     /*
-     * Are the motors enabled
-     */
-    uint8 MotorsEnabled;
+    ** Motion profile settings from the table
+    */
+    uint16 ProfileMode;
+    int32  ProfileAccel;
+    int32  ProfileJerk;
 
     /*
-    ** Raw wheel encoder values, stored for next encoder delta calculation
+    ** Control cycles per state packet, from the table
     */
-    int16 RawLeftEncoder;
-    int16 RawRightEncoder;
+    uint16 StateBatchSize;
 
     /*
-    ** Change in encoder values since the last reading
+    ** Read calibration margin from the table
     */
-    int16 LeftEncoderDelta;
-    int16 RightEncoderDelta;
+    uint16 ReadDelayMarginUs;
 
     /*
-    ** Absolute position of each motor since ROMIMOT app started
+    ** Control loop scheduling, ROMIMOT_CONTROL_MODE_* from the table
     */
-    int32 LeftOdo;
-    int32 RightOdo;
+    uint16    ControlMode;
+    uint16    ControlRateHz;
+    osal_id_t TimeBaseId;
+    osal_id_t TimerId;
 
     /*
-    ** Odometer intermediate targets
+    ** Romi bases, polled in turn by the I/O task every control cycle
     */
-    int32 LeftOdoStep;
-    int32 RightOdoStep;
+    ROMIMOT_Device_t Device[ROMIMOT_MAX_DEVICES];
 
     /*
-    ** Odometer targets
+    ** I/O child task.  It is the only task that touches a device's bus, and
+    ** it exchanges data with the main task only through the double buffers
     */
-    int32 LeftOdoTrgt;
-    int32 RightOdoTrgt;
+    CFE_ES_TaskId_t   IoTaskId;
+    osal_id_t         IoWakeSem;
+    bool              IoBusy;
+    uint32            IoOverruns; /* Wakeups that found the previous cycle still running */
+    int64             WakeTimeUs; /* Time of the most recent wakeup */
+    ROMIMOT_Device_t *IoDevice;   /* Device on the bus, for the bus timing hook */
 
     /*
-     * Motor speed settings
-     */
-    int16 LeftMotSpeed;
-    int16 RightMotSpeed;
+    ** Real-time profiles from the table, and what each task got.  The I/O
+    ** task applies its own profile, copied here before it starts.
+    */
+    MRLIB_RtProfile_t IoRtProfile;
+    MRLIB_RtStatus_t  MainRtStatus;
+    MRLIB_RtStatus_t  IoRtStatus;
 
     /*
-     * amount to increment/decrement the target to make the wheel turn at constant speed.
-     */
-    int16_t TargetDeltaLeft;
-    int16_t TargetDeltaRight;
-
-    /* file desccriptor for I2C bus */
-    int i2cfd;
+    ** The end of the bus log replay has been reported
+    */
+    bool BusReplayEnded;
 
-    /* I2C connection status flag */
-    bool i2c_open;
+    /*
+    ** Event filters, the I2C errors of a failing bus would otherwise flood EVS
+    */
+    CFE_EVS_BinFilter_t EventFilters[ROMIMOT_EVENT_FILTERS];
 
     /*
     ** Operational data (not reported in housekeeping)...
@@ -161,22 +463,60 @@ typedef struct
 */
 void  ROMIMOT_Main(void);
 int32 ROMIMOT_Init(void);
-int32 ROMIMOT_ConnectI2C(void);
+int32 ROMIMOT_ConnectI2C(ROMIMOT_Device_t *Dev);
+void  ROMIMOT_SelectBackend(ROMIMOT_Device_t *Dev);
+int32 ROMIMOT_StartBusRecord(const char *BusLogFile, const RomiBackend *Target);
+void  ROMIMOT_StopBusRecord(void);
+void  ROMIMOT_StartBusReplay(const char *BusLogFile, uint16 ReplaySpeed);
+void  ROMIMOT_ReportBusLog(void);
+void  ROMIMOT_ApplyRtProfile(const char *TaskName, const MRLIB_RtProfile_t *Profile, MRLIB_RtStatus_t *Status);
+int32 ROMIMOT_StartIoTask(void);
+void  ROMIMOT_IoTaskMain(void);
+void  ROMIMOT_IoCycle(void);
+void  ROMIMOT_RequestI2C(ROMIMOT_Device_t *Dev);
+void  ROMIMOT_TriggerIo(void);
+void  ROMIMOT_TimerCallback(osal_id_t TimerId, void *Arg);
+int32 ROMIMOT_ConfigureControl(uint16 Mode, uint16 RateHz);
+int64 ROMIMOT_GetTimeUs(void);
+void  ROMIMOT_PublishControl(ROMIMOT_Device_t *Dev);
+void  ROMIMOT_PlanProfile(ROMIMOT_Device_t *Dev);
+void  ROMIMOT_ApplyTableConfig(void);
+void  ROMIMOT_UpdateOdometry(ROMIMOT_ControlState_t *Ctl, const RomiSnapshot *Romi);
+void  ROMIMOT_ControlHold(ROMIMOT_ControlState_t *Ctl);
+void  ROMIMOT_ControlStep(ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd,
+                          const ROMIMOT_Profile_t *Profile);
+const ROMIMOT_Profile_t *ROMIMOT_ControlPath(ROMIMOT_ControlState_t *Ctl, ROMIMOT_ControlCmd_t *Cmd,
+                                             const ROMIMOT_Profile_t *Profile, ROMIMOT_Path_t *Path,
+                                             ROMIMOT_Profile_t *PathProfile);
+void  ROMIMOT_ControlPathStop(ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd);
+bool  ROMIMOT_ControlStream(ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd);
 void  ROMIMOT_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr);
-void  ROMIMOT_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr);
 int32 ROMIMOT_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg);
-int32 ROMIMOT_CheckI2CTransaction(int32 RetCode);
+int32 ROMIMOT_CheckI2CTransaction(ROMIMOT_Device_t *Dev, int32 RetCode);
 int32 ROMIMOT_Wakeup(const CFE_MSG_CommandHeader_t *Msg);
 int32 ROMIMOT_ResetCounters(const ROMIMOT_ResetCountersCmd_t *Msg);
 int32 ROMIMOT_Process(const ROMIMOT_ProcessCmd_t *Msg);
 int32 ROMIMOT_SetMotEnable(const ROMIMOT_SetEnableCmd_t *Msg, uint8_t enable);
+int32 ROMIMOT_MotEnable(const ROMIMOT_SetEnableCmd_t *Msg);
+int32 ROMIMOT_MotDisable(const ROMIMOT_SetEnableCmd_t *Msg);
 int32 ROMIMOT_SetTarget(const ROMIMOT_MotCmd_t *Msg);
 int32 ROMIMOT_SetTargetDelta(const ROMIMOT_MotCmd_t *Msg);
+int32 ROMIMOT_DumpTrace(const ROMIMOT_DumpTraceCmd_t *Msg);
+int32 ROMIMOT_SendDiag(const ROMIMOT_SendDiagCmd_t *Msg);
+int32 ROMIMOT_SendCmdStats(const ROMIMOT_SendCmdStatsCmd_t *Msg);
+int32 ROMIMOT_CalibrateRead(const ROMIMOT_CalibrateReadCmd_t *Msg);
+int32 ROMIMOT_SetDriveMode(const ROMIMOT_DriveModeCmd_t *Msg);
+int32 ROMIMOT_QueuePath(const ROMIMOT_QueuePathCmd_t *Msg);
+int32 ROMIMOT_ClearPath(const ROMIMOT_ClearPathCmd_t *Msg);
+int32 ROMIMOT_SetVelocity(const ROMIMOT_SetVelocityCmd_t *Msg);
+bool  ROMIMOT_AppendPath(ROMIMOT_Device_t *Dev, const ROMIMOT_Segment_t *Segments, uint32 Count);
+void  ROMIMOT_StoreReadCal(ROMIMOT_Device_t *Dev);
+ROMIMOT_Device_t *ROMIMOT_CmdDevice(uint8 Device);
 int32 ROMIMOT_Noop(const ROMIMOT_NoopCmd_t *Msg);
 void  ROMIMOT_GetCrc(const char *TableName);
 
 int32 ROMIMOT_TblValidationFunc(void *TblData);
 
-bool ROMIMOT_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength);
+extern const MRLIB_Dispatch_t ROMIMOT_Dispatch;
 
 #endif /* ROMIMOT_H */
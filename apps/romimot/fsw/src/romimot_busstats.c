@@ -0,0 +1,70 @@
+/**
+ * @file
+ *
+ * Latency statistics for the Romi bus operations.
+ */
+
+#include <string.h>
+
+#include "romimot_busstats.h"
+
+void ROMIMOT_BusStatsReset(ROMIMOT_BusStats_t *Stats)
+{
+    memset(Stats, 0, sizeof(*Stats));
+}
+
+/*  Called by the I/O task after each bus operation.  Failed operations are
+    timed like the others and also counted in Errors. */
+void ROMIMOT_BusStatsRecord(ROMIMOT_BusStats_t *Stats, int Op, uint32 ElapsedUs, int Status)
+{
+    ROMIMOT_BusOpStats_t *OpStats;
+    uint32                Bucket = 0;
+
+    if (Op < 0 || Op >= ROMIMOT_BUS_OP_COUNT)
+    {
+        return;
+    }
+    OpStats = &Stats->Ops[Op];
+
+    while (Bucket < ROMIMOT_BUS_HIST_BUCKETS - 1 && ElapsedUs >= ((uint32)ROMIMOT_BUS_HIST_BASE_US << Bucket))
+    {
+        Bucket++;
+    }
+    OpStats->Buckets[Bucket]++;
+
+    if (OpStats->Count == 0 || ElapsedUs < OpStats->MinUs)
+    {
+        OpStats->MinUs = ElapsedUs;
+    }
+    if (ElapsedUs > OpStats->MaxUs)
+    {
+        OpStats->MaxUs = ElapsedUs;
+    }
+    OpStats->SumUs += ElapsedUs;
+    OpStats->Count++;
+
+    if (Status != 0)
+    {
+        OpStats->Errors++;
+    }
+}
+
+void ROMIMOT_BusStatsReport(const ROMIMOT_BusStats_t *Stats, ROMIMOT_DiagTlm_Payload_t *Payload)
+{
+    const ROMIMOT_BusOpStats_t *  OpStats;
+    ROMIMOT_BusOpStats_Payload_t *Out;
+    int                           Op;
+
+    for (Op = 0; Op < ROMIMOT_BUS_OP_COUNT; Op++)
+    {
+        OpStats = &Stats->Ops[Op];
+        Out     = &Payload->Ops[Op];
+
+        Out->Count  = OpStats->Count;
+        Out->Errors = OpStats->Errors;
+        Out->MinUs  = OpStats->MinUs;
+        Out->MaxUs  = OpStats->MaxUs;
+        Out->MeanUs = OpStats->Count ? OpStats->SumUs / OpStats->Count : 0;
+        memcpy(Out->Buckets, OpStats->Buckets, sizeof(Out->Buckets));
+    }
+}
@@ -0,0 +1,37 @@
+/**
+ * @file
+ *
+ * Latency statistics for the Romi bus operations.
+ *
+ * The I/O task records every timed romi* call into fixed-size histograms,
+ * one per ROMIMOT_BUS_OP_* type, with no allocation or formatting on the
+ * loop thread.  Min, max and mean come from the same samples.
+ */
+
+#ifndef ROMIMOT_BUSSTATS_H
+#define ROMIMOT_BUSSTATS_H
+
+#include "cfe.h"
+
+#include "romimot_msg.h"
+
+typedef struct
+{
+    uint32 Count;
+    uint32 Errors;
+    uint32 MinUs;
+    uint32 MaxUs;
+    uint64 SumUs;
+    uint32 Buckets[ROMIMOT_BUS_HIST_BUCKETS];
+} ROMIMOT_BusOpStats_t;
+
+typedef struct
+{
+    ROMIMOT_BusOpStats_t Ops[ROMIMOT_BUS_OP_COUNT];
+} ROMIMOT_BusStats_t;
+
+void ROMIMOT_BusStatsReset(ROMIMOT_BusStats_t *Stats);
+void ROMIMOT_BusStatsRecord(ROMIMOT_BusStats_t *Stats, int Op, uint32 ElapsedUs, int Status);
+void ROMIMOT_BusStatsReport(const ROMIMOT_BusStats_t *Stats, ROMIMOT_DiagTlm_Payload_t *Payload);
+
+#endif /* ROMIMOT_BUSSTATS_H */
@@ -0,0 +1,376 @@
+/**
+ * @file
+ *
+ * ROMIMOT wheel control law.  Runs in the I/O task once per control cycle,
+ * between the sensor read and the motor write.
+ */
+
+#include "romimot.h"
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Fold a new encoder reading into the odometers                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_UpdateOdometry(ROMIMOT_ControlState_t *Ctl, const RomiSnapshot *Romi)
+{
+    Ctl->LeftEncoderDelta  = romiCountDelta32(Romi->encoders.left, Ctl->RawLeftEncoder);
+    Ctl->RightEncoderDelta = romiCountDelta32(Romi->encoders.right, Ctl->RawRightEncoder);
+    Ctl->RawLeftEncoder    = Romi->encoders.left;
+    Ctl->RawRightEncoder   = Romi->encoders.right;
+
+    Ctl->LeftOdo += Ctl->LeftEncoderDelta;
+    Ctl->RightOdo += Ctl->RightEncoderDelta;
+
+    Ctl->LeftVelocity  = Romi->velocity.left;
+    Ctl->RightVelocity = Romi->velocity.right;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Move an intermediate target toward its final target                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int32 ROMIMOT_StepTarget(int32 *OdoStep, int32 OdoTrgt, int16 TargetDelta)
+{
+    // If the distance is greater than the target delta, move the Odo step
+    // in the direction of the target by the target delta.  Otherwise
+    // set the Odo step to the target.  The target delta is applied once per
+    // control cycle, so the wheel speed it gives scales with the loop rate.
+    int32 Previous = *OdoStep;
+    int32 Distance = OdoTrgt - *OdoStep;
+    int32 Dir      = Distance > 0 ? 1 : -1;
+
+    if (Distance * Dir > TargetDelta)
+    {
+        *OdoStep += TargetDelta * Dir;
+    }
+    else
+    {
+        *OdoStep = OdoTrgt;
+    }
+
+    // The step taken is the reference velocity for the feedforward term.
+    return *OdoStep - Previous;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Advance one wheel's intermediate target, returning the step taken          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int32 ROMIMOT_StepWheel(ROMIMOT_ProfileState_t *Profile, const ROMIMOT_Ramp_t *Ramp, int32 *OdoStep,
+                               int32 OdoTrgt, int16 TargetDelta)
+{
+    int32 Previous = *OdoStep;
+
+    if (Profile->Active)
+    {
+        *OdoStep = ROMIMOT_ProfileNext(Profile, Ramp);
+        return *OdoStep - Previous;
+    }
+
+    // Linear profile, or a move that has finished.
+    return ROMIMOT_StepTarget(OdoStep, OdoTrgt, TargetDelta);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Motor power from one wheel PID                                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int16 ROMIMOT_WheelPower(ROMIMOT_PidState_t *Pid, const ROMIMOT_PidGains_t *Gains, int32 Error,
+                                int32 RefVelocity, int16 Velocity, uint32 PeriodUs)
+{
+    int64 ErrorRate;
+
+    if (PeriodUs == 0)
+    {
+        return ROMIMOT_PidStep(Pid, Gains, Error, RefVelocity);
+    }
+
+    // The error rate comes from the firmware's velocity rather than from
+    // differencing errors across wakeups of uneven length.
+    ErrorRate = (int64)RefVelocity * ROMIMOT_Q16_ONE - (int64)Velocity * PeriodUs * ROMIMOT_Q16_ONE / 1000000;
+
+    return ROMIMOT_PidStepRate(Pid, Gains, Error, RefVelocity, ErrorRate);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Wheel speed for the firmware speed loop, counts/s                          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int16 ROMIMOT_WheelSpeed(int32 Error, int32 RefVelocity, uint32 PeriodUs)
+{
+    int64 Speed;
+
+    if (PeriodUs == 0)
+    {
+        return 0;
+    }
+
+    // The firmware holds the speed, so only drift needs correcting here.
+    Speed = (int64)(RefVelocity * ROMIMOT_SPEED_CATCHUP_CYCLES + Error) * 1000000 /
+            ((int64)PeriodUs * ROMIMOT_SPEED_CATCHUP_CYCLES);
+
+    if (Speed > ROMI_SPEED_MAX)
+    {
+        return ROMI_SPEED_MAX;
+    }
+    if (Speed < -ROMI_SPEED_MAX)
+    {
+        return -ROMI_SPEED_MAX;
+    }
+
+    return Speed;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Stop the motors and let the wheel PIDs start over.  A streamed setpoint   */
+/* is dropped too, its sender has to send a fresh one after the hold.         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_ControlHold(ROMIMOT_ControlState_t *Ctl)
+{
+    Ctl->LeftMotSpeed  = 0;
+    Ctl->RightMotSpeed = 0;
+    Ctl->StreamLeft    = 0;
+    Ctl->StreamRight   = 0;
+    ROMIMOT_PidReset(&Ctl->LeftPid);
+    ROMIMOT_PidReset(&Ctl->RightPid);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Drive the wheels after the intermediate targets, which moved by the        */
+/* velocities given this cycle                                                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_ControlTrack(ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd, int32 LeftVelocity,
+                                 int32 RightVelocity)
+{
+    if (Cmd->DriveMode == ROMIMOT_DRIVE_MODE_SPEED)
+    {
+        Ctl->LeftMotSpeed  = ROMIMOT_WheelSpeed(Ctl->LeftOdoStep - Ctl->LeftOdo, LeftVelocity, Ctl->PeriodUs);
+        Ctl->RightMotSpeed = ROMIMOT_WheelSpeed(Ctl->RightOdoStep - Ctl->RightOdo, RightVelocity, Ctl->PeriodUs);
+        return;
+    }
+
+    // Track the intermediate targets with the wheel PIDs.
+    Ctl->LeftMotSpeed  = ROMIMOT_WheelPower(&Ctl->LeftPid, &Cmd->Gains, Ctl->LeftOdoStep - Ctl->LeftOdo,
+                                            LeftVelocity, Ctl->LeftVelocity, Ctl->PeriodUs);
+    Ctl->RightMotSpeed = ROMIMOT_WheelPower(&Ctl->RightPid, &Cmd->Gains, Ctl->RightOdoStep - Ctl->RightOdo,
+                                            RightVelocity, Ctl->RightVelocity, Ctl->PeriodUs);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Compute the motor powers for this cycle                                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_ControlStep(ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd,
+                         const ROMIMOT_Profile_t *Profile)
+{
+    int32 LeftVelocity;
+    int32 RightVelocity;
+
+    if (!Cmd->MotorsEnabled)
+    {
+        ROMIMOT_ControlHold(Ctl);
+        return;
+    }
+
+    // A new target starts its moves from the current intermediate targets,
+    // once the profile planned for it has arrived.
+    if (Cmd->ProfileSeq != Ctl->ProfileSeq && Profile->Seq == Cmd->ProfileSeq)
+    {
+        Ctl->ProfileSeq = Cmd->ProfileSeq;
+        ROMIMOT_ProfileStart(&Ctl->LeftProfile, &Profile->Left, Ctl->LeftOdoStep, Cmd->LeftOdoTrgt);
+        ROMIMOT_ProfileStart(&Ctl->RightProfile, &Profile->Right, Ctl->RightOdoStep, Cmd->RightOdoTrgt);
+    }
+
+    LeftVelocity  = ROMIMOT_StepWheel(&Ctl->LeftProfile, &Profile->Left, &Ctl->LeftOdoStep, Cmd->LeftOdoTrgt,
+                                      Cmd->TargetDeltaLeft);
+    RightVelocity = ROMIMOT_StepWheel(&Ctl->RightProfile, &Profile->Right, &Ctl->RightOdoStep, Cmd->RightOdoTrgt,
+                                      Cmd->TargetDeltaRight);
+
+    ROMIMOT_ControlTrack(Ctl, Cmd, LeftVelocity, RightVelocity);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Are the intermediate targets at Cmd's targets, with no move running        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static bool ROMIMOT_ControlArrived(const ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd)
+{
+    return Ctl->LeftOdoStep == Cmd->LeftOdoTrgt && Ctl->RightOdoStep == Cmd->RightOdoTrgt &&
+           !Ctl->LeftProfile.Active && !Ctl->RightProfile.Active;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Turn the published command into this cycle's, following the path queue.  */
+/* Cmd is the I/O task's working copy; the profile to step with is returned.  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+const ROMIMOT_Profile_t *ROMIMOT_ControlPath(ROMIMOT_ControlState_t *Ctl, ROMIMOT_ControlCmd_t *Cmd,
+                                             const ROMIMOT_Profile_t *Profile, ROMIMOT_Path_t *Path,
+                                             ROMIMOT_Profile_t *PathProfile)
+{
+    ROMIMOT_Segment_t Segment;
+
+    // The segments already started carry on from the commanded targets, so
+    // targets commanded while a path runs add to it.
+    Cmd->LeftOdoTrgt += Ctl->PathLeft;
+    Cmd->RightOdoTrgt += Ctl->PathRight;
+
+    if (Ctl->PathActive && ROMIMOT_ControlArrived(Ctl, Cmd))
+    {
+        Ctl->PathActive = false;
+    }
+
+    // The next segment starts on the cycle the previous target is reached,
+    // so the wheels never wait on the ground between legs.
+    if (!Ctl->PathActive && Cmd->MotorsEnabled && ROMIMOT_ControlArrived(Ctl, Cmd) &&
+        ROMIMOT_PathTake(Path, &Segment))
+    {
+        Ctl->PathSegments++;
+        Ctl->PathLeft += Segment.Left;
+        Ctl->PathRight += Segment.Right;
+        Cmd->LeftOdoTrgt += Segment.Left;
+        Cmd->RightOdoTrgt += Segment.Right;
+        Ctl->PathSpeedLeft  = Segment.SpeedLeft > 0 ? Segment.SpeedLeft : Cmd->TargetDeltaLeft;
+        Ctl->PathSpeedRight = Segment.SpeedRight > 0 ? Segment.SpeedRight : Cmd->TargetDeltaRight;
+
+        PathProfile->Seq  = ROMIMOT_PATH_SEQ_BIT | Ctl->PathSegments;
+        PathProfile->Mode = Cmd->ProfileMode;
+        ROMIMOT_ProfileBuildRamp(&PathProfile->Left, Cmd->ProfileMode, Ctl->PathSpeedLeft, Cmd->ProfileAccel,
+                                 Cmd->ProfileJerk);
+        ROMIMOT_ProfileBuildRamp(&PathProfile->Right, Cmd->ProfileMode, Ctl->PathSpeedRight, Cmd->ProfileAccel,
+                                 Cmd->ProfileJerk);
+
+        Ctl->PathActive = true;
+    }
+
+    if (!Ctl->PathActive)
+    {
+        return Profile;
+    }
+
+    Cmd->TargetDeltaLeft  = Ctl->PathSpeedLeft;
+    Cmd->TargetDeltaRight = Ctl->PathSpeedRight;
+    Cmd->ProfileSeq       = PathProfile->Seq;
+
+    return PathProfile;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Abandon the segment being driven, holding the intermediate targets         */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_ControlPathStop(ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd)
+{
+    if (!Ctl->PathActive)
+    {
+        return;
+    }
+
+    Ctl->PathLeft            = Ctl->LeftOdoStep - Cmd->LeftOdoTrgt;
+    Ctl->PathRight           = Ctl->RightOdoStep - Cmd->RightOdoTrgt;
+    Ctl->LeftProfile.Active  = false;
+    Ctl->RightProfile.Active = false;
+    Ctl->PathActive          = false;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Whole counts a wheel travels this cycle at Speed, keeping the remainder    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static int32 ROMIMOT_StreamTravel(int16 Speed, uint32 PeriodUs, int32 *Remainder)
+{
+    int64 Travel = (int64)Speed * PeriodUs + *Remainder;
+    int32 Counts = (int32)(Travel / 1000000);
+
+    *Remainder = (int32)(Travel - (int64)Counts * 1000000);
+
+    return Counts;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Run this cycle from the streamed velocity, if a stream is driving.         */
+/* Returns false when the commanded targets and the path have the wheels.     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool ROMIMOT_ControlStream(ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd)
+{
+    int32 LeftVelocity;
+    int32 RightVelocity;
+
+    // Setpoints sent while the motors were off are dropped, not kept for
+    // when they come back on.
+    if (!Cmd->MotorsEnabled)
+    {
+        Ctl->Streaming   = false;
+        Ctl->StreamSeq   = Cmd->StreamSeq;
+        Ctl->StreamLeft  = 0;
+        Ctl->StreamRight = 0;
+        return false;
+    }
+
+    if (Cmd->StreamSeq != Ctl->StreamSeq)
+    {
+        Ctl->StreamSeq   = Cmd->StreamSeq;
+        Ctl->StreamLeft  = Cmd->StreamLeft;
+        Ctl->StreamRight = Cmd->StreamRight;
+        Ctl->StreamAgeUs = 0;
+    }
+    else
+    {
+        Ctl->StreamAgeUs += Ctl->PeriodUs;
+    }
+
+    // The watchdog, a sender that stops sending stops the wheels.
+    if (Ctl->StreamAgeUs > (uint32)Cmd->StreamTimeoutMs * 1000)
+    {
+        Ctl->StreamLeft  = 0;
+        Ctl->StreamRight = 0;
+    }
+
+    if (Ctl->StreamLeft == 0 && Ctl->StreamRight == 0)
+    {
+        Ctl->Streaming = false;
+        return false;
+    }
+
+    // The stream takes over from wherever the intermediate targets are,
+    // abandoning any move or path segment under way.
+    if (!Ctl->Streaming)
+    {
+        Ctl->Streaming           = true;
+        Ctl->StreamRemLeft       = 0;
+        Ctl->StreamRemRight      = 0;
+        Ctl->PathLeft            = Ctl->LeftOdoStep - Cmd->LeftOdoTrgt;
+        Ctl->PathRight           = Ctl->RightOdoStep - Cmd->RightOdoTrgt;
+        Ctl->LeftProfile.Active  = false;
+        Ctl->RightProfile.Active = false;
+        Ctl->PathActive          = false;
+    }
+
+    LeftVelocity  = ROMIMOT_StreamTravel(Ctl->StreamLeft, Ctl->PeriodUs, &Ctl->StreamRemLeft);
+    RightVelocity = ROMIMOT_StreamTravel(Ctl->StreamRight, Ctl->PeriodUs, &Ctl->StreamRemRight);
+
+    Ctl->LeftOdoStep += LeftVelocity;
+    Ctl->RightOdoStep += RightVelocity;
+    Ctl->PathLeft += LeftVelocity;
+    Ctl->PathRight += RightVelocity;
+
+    ROMIMOT_ControlTrack(Ctl, Cmd, LeftVelocity, RightVelocity);
+
+    return true;
+}
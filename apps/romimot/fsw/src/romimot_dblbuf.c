@@ -0,0 +1,60 @@
+/**
+ * @file
+ *
+ * Lock-free double buffer shared by the ROMIMOT main and I/O tasks.
+ */
+
+#include <string.h>
+
+#include "romimot_dblbuf.h"
+
+void ROMIMOT_DblBuf_Init(ROMIMOT_DblBuf_t *Buf)
+{
+    memset(Buf, 0, sizeof(*Buf));
+}
+
+/*  Publishes SlotSize bytes from Src.  Slots points at an array of two
+    SlotSize elements owned by the buffer.  Only one task may write. */
+void ROMIMOT_DblBuf_Write(ROMIMOT_DblBuf_t *Buf, void *Slots, size_t SlotSize, const void *Src)
+{
+    uint32 Next = __atomic_load_n(&Buf->Count, __ATOMIC_RELAXED) + 1;
+    uint32 Slot = Next & 1;
+    uint32 Seq  = __atomic_load_n(&Buf->Seq[Slot], __ATOMIC_RELAXED);
+
+    __atomic_store_n(&Buf->Seq[Slot], Seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    memcpy((uint8 *)Slots + (Slot * SlotSize), Src, SlotSize);
+
+    __atomic_store_n(&Buf->Seq[Slot], Seq + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&Buf->Count, Next, __ATOMIC_RELEASE);
+}
+
+/*  Copies the most recently published slot into Dst.  LastCount holds the
+    publish count seen by the previous call; returns true if the copy is
+    newer than that.  Only one task may read. */
+bool ROMIMOT_DblBuf_Read(ROMIMOT_DblBuf_t *Buf, const void *Slots, size_t SlotSize, void *Dst, uint32 *LastCount)
+{
+    uint32 Count;
+    uint32 Slot;
+    uint32 SeqBefore;
+    uint32 SeqAfter;
+    bool   IsNew;
+
+    do
+    {
+        Count     = __atomic_load_n(&Buf->Count, __ATOMIC_ACQUIRE);
+        Slot      = Count & 1;
+        SeqBefore = __atomic_load_n(&Buf->Seq[Slot], __ATOMIC_ACQUIRE);
+
+        memcpy(Dst, (const uint8 *)Slots + (Slot * SlotSize), SlotSize);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        SeqAfter = __atomic_load_n(&Buf->Seq[Slot], __ATOMIC_RELAXED);
+    } while ((SeqBefore & 1) != 0 || SeqBefore != SeqAfter);
+
+    IsNew      = (Count != *LastCount);
+    *LastCount = Count;
+
+    return IsNew;
+}
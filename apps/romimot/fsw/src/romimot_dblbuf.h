@@ -0,0 +1,28 @@
+/**
+ * @file
+ *
+ * Lock-free single-producer/single-consumer double buffer used to pass
+ * snapshots between the ROMIMOT main task and its I/O child task.
+ *
+ * The writer always fills the slot that is not currently published and then
+ * flips the publish count; each slot carries a sequence number that is odd
+ * while it is being written so a reader that raced a second publish can
+ * detect the torn copy and retry.  Neither side ever blocks.
+ */
+
+#ifndef ROMIMOT_DBLBUF_H
+#define ROMIMOT_DBLBUF_H
+
+#include "cfe.h"
+
+typedef struct
+{
+    uint32 Count;  /* Number of completed publishes, low bit selects the readable slot */
+    uint32 Seq[2]; /* Per-slot sequence, odd while the writer owns the slot */
+} ROMIMOT_DblBuf_t;
+
+void ROMIMOT_DblBuf_Init(ROMIMOT_DblBuf_t *Buf);
+void ROMIMOT_DblBuf_Write(ROMIMOT_DblBuf_t *Buf, void *Slots, size_t SlotSize, const void *Src);
+bool ROMIMOT_DblBuf_Read(ROMIMOT_DblBuf_t *Buf, const void *Slots, size_t SlotSize, void *Dst, uint32 *LastCount);
+
+#endif /* ROMIMOT_DBLBUF_H */
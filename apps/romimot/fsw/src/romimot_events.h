@@ -35,5 +35,23 @@
 #define ROMIMOT_PIPE_ERR_EID          7
 #define ROMIMOT_I2C_ERR_EID           8
 #define ROMIMOT_I2C_INF_EID           9
+#define ROMIMOT_CONTROL_INF_EID       10
+#define ROMIMOT_CONTROL_ERR_EID       11
+#define ROMIMOT_TRACE_INF_EID         12
+#define ROMIMOT_TRACE_ERR_EID         13
+#define ROMIMOT_READCAL_INF_EID       14
+#define ROMIMOT_READCAL_ERR_EID       15
+#define ROMIMOT_BUS_RECOVERY_INF_EID  16
+#define ROMIMOT_BUS_RECOVERY_ERR_EID  17
+#define ROMIMOT_DRIVE_MODE_INF_EID    18
+#define ROMIMOT_DRIVE_MODE_ERR_EID    19
+#define ROMIMOT_DEVICE_ERR_EID        20
+#define ROMIMOT_PATH_INF_EID          21
+#define ROMIMOT_PATH_ERR_EID          22
+#define ROMIMOT_BUS_LOG_INF_EID       23
+#define ROMIMOT_BUS_LOG_ERR_EID       24
+#define ROMIMOT_RT_PROFILE_INF_EID    25
+#define ROMIMOT_RT_PROFILE_ERR_EID    26
+#define ROMIMOT_STREAM_ERR_EID        27
 
 #endif /* ROMIMOT_EVENTS_H */
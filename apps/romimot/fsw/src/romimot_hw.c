@@ -1,46 +1,116 @@
 
-
-#include <errno.h>
-#include <fcntl.h>
-// #include <i2c/smbus.h>
-#include <linux/types.h>
-#include <linux/i2c.h>
-#include <linux/i2c-dev.h>
 #include <stdint.h>
 #include <stdio.h>
-#include <sys/ioctl.h>
-#include <unistd.h>
-#include <signal.h>
+#include <string.h>
+#include <time.h>
 
 #include "cfe.h"
-#include "cfe_error.h"
-#include "cfe_evs.h"
-#include "cfe_sb.h"
-#include "cfe_es.h"
 
 #include "romimot_hw.h"
 #include "romimot_msg.h"
 
-const int romiaddr = 0x14; /* The I2C address */
+/* Delay in uS per ROMI_READ_RANGE_*.  Needed for the slightly broken SMBUS-ish implemetation on the Romi 32u4 */
+static int romiReadDelay[ROMI_READ_RANGE_COUNT] = {100, 100, 100};
+
+/* Battery change allowed between a calibration trial and its reference read */
+#define ROMI_CAL_BATTERY_TOL_MV 50
+
+static const RomiBackend *romiBackend = &romiBackendI2C;
+
+static RomiTimingHook romiTimingHook;
+
+/* Little-endian field decode for the telemetry block, addr is a ROMI_REG_* */
+static uint16_t romiGetU16(const uint8_t *buf, uint8_t addr)
+{
+    const uint8_t *p = &buf[addr - ROMI_REG_TLM];
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t romiGetU32(const uint8_t *buf, uint8_t addr)
+{
+    return romiGetU16(buf, addr) | ((uint32_t)romiGetU16(buf, addr + 2) << 16);
+}
+
+/* Encoder pair from a buffer holding the block at ROMI_REG_TLM */
+static void romiGetEncoders(const uint8_t *buf, EncoderPair *encoders)
+{
+    encoders->left  = (int32_t)romiGetU32(buf, ROMI_REG_ENCODERS);
+    encoders->right = (int32_t)romiGetU32(buf, ROMI_REG_ENCODERS + 4);
+}
 
-const int readDelay = 100; /* Delay in uS. Needed for the slightly broken SMBUS-ish implemetation on the Romi 32u4 */
+void romiSetBackend(const RomiBackend *backend)
+{
+    romiBackend = backend;
+}
 
-const int i2cBusNumber = 1; /* pi's bus connected to the Romi */
+const RomiBackend *romiGetBackend(void)
+{
+    return romiBackend;
+}
 
-const uint8_t romiCmdMotor   = 6;
-const uint8_t romiCmdEncoder = 39;
+void romiSetTimingHook(RomiTimingHook hook)
+{
+    romiTimingHook = hook;
+}
 
-// Opens the specified I2C device.  Returns a non-negative file descriptor
-// on success, or -1 [ROMIMOT_I2C_DEV_FD_ERR_EID] on failure.
-int open_i2c_device(const char *device)
+void romiSetReadDelay(int range, int delayUs)
 {
-    int fd = open(device, O_RDWR);
-    if (fd == -1)
+    if (range >= 0 && range < ROMI_READ_RANGE_COUNT)
     {
-        perror(device);
-        return ROMIMOT_I2C_DEV_FD_ERR_EID;
+        romiReadDelay[range] = delayUs;
     }
-    return fd;
+}
+
+int romiGetReadDelay(int range)
+{
+    if (range >= 0 && range < ROMI_READ_RANGE_COUNT)
+    {
+        return romiReadDelay[range];
+    }
+    return 0;
+}
+
+static uint64_t romiNowUs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* Start time for romiTimingEnd(), 0 when nobody is listening */
+static uint64_t romiTimingStart(void)
+{
+    return romiTimingHook != NULL ? romiNowUs() : 0;
+}
+
+static int romiTimingEnd(int op, uint64_t startUs, int status)
+{
+    if (romiTimingHook != NULL)
+    {
+        romiTimingHook(op, (uint32_t)(romiNowUs() - startUs), status);
+    }
+    return status;
+}
+
+// Opens the bus through the selected backend and selects the Romi at addr.
+// Returns a non-negative handle on success, or a ROMIMOT_I2C_*_ERR_EID code.
+int romiOpen(int busNumber, int addr)
+{
+    return romiBackend->open(busNumber, addr);
+}
+
+void romiClose(int i2cfd)
+{
+    romiBackend->close(i2cfd);
+}
+
+/*  Reads the register map version the firmware reports, to compare with
+    ROMI_REGMAP_VERSION.  returns 0 on success, a ROMIMOT_I2C_*_ERR_EID code
+    on failure */
+int romiVersionRead(int i2cfd, uint8_t *version)
+{
+    return romiRead(i2cfd, ROMI_REG_VERSION, 1, version);
 }
 
 /*  implements the slightly-janky SMBUS-ish implemetation on the Romi 32u4
@@ -48,54 +118,193 @@ int open_i2c_device(const char *device)
     addr - register address we want to write into
     len - number of bytes to read from the remote memory of the Romi
     buf is the pointer to the buf that we'll read into.
-    returns -1 on failure, 0 on success */
+    returns a ROMIMOT_I2C_*_ERR_EID code on failure, 0 on success */
 int romiRead(int i2cfd, uint8_t addr, uint8_t len, uint8_t *buf)
 {
-    uint8_t wbuf[1] = {addr};
-    if (write(i2cfd, wbuf, 1) != 1)
+    uint64_t start = romiTimingStart();
+    int      range = ROMI_READ_RANGE_STATUS;
+
+    if (addr >= ROMI_REG_ENCODERS && addr < ROMI_REG_ENCODERS + ROMI_ENCODERS_LEN)
+    {
+        range = ROMI_READ_RANGE_ENCODERS;
+    }
+
+    return romiTimingEnd(ROMIMOT_BUS_OP_READ, start,
+                         romiBackend->readReg(i2cfd, addr, buf, len, romiReadDelay[range]));
+}
+
+int romiEncoderRead(int i2cfd, EncoderPair *encoders)
+{
+    uint8_t  buf[ROMI_TLM_LEN];
+    uint64_t start = romiTimingStart();
+
+    /* read into the block's place so the snapshot decoding applies */
+    int retcode = romiBackend->readReg(i2cfd, ROMI_REG_ENCODERS, &buf[ROMI_REG_ENCODERS - ROMI_REG_TLM],
+                                       ROMI_ENCODERS_LEN, romiReadDelay[ROMI_READ_RANGE_ENCODERS]);
+    if (retcode == 0)
+    {
+        romiGetEncoders(buf, encoders);
+    }
+
+    return romiTimingEnd(ROMIMOT_BUS_OP_ENCODER_READ, start, retcode);
+}
+
+/*  Reads the telemetry block into buf at delayUs and checks it against its
+    check byte.  returns 0, a ROMIMOT_I2C_*_ERR_EID code from the transport,
+    or ROMIMOT_I2C_DAT_BAD_ERR_EID when the check does not match */
+static int romiBlockRead(int i2cfd, uint8_t *buf, int delayUs)
+{
+    int retcode = romiBackend->readReg(i2cfd, ROMI_REG_TLM, buf, ROMI_TLM_LEN, delayUs);
+
+    if (retcode == 0 && buf[ROMI_REG_CHECK - ROMI_REG_TLM] != romiTlmCheck(buf))
+    {
+        retcode = ROMIMOT_I2C_DAT_BAD_ERR_EID;
+    }
+    return retcode;
+}
+
+/*  Reads the whole telemetry block in a single combined I2C_RDWR
+    transaction (register address write, repeated start, read) and decodes
+    it into snapshot.  This replaces three write/usleep/read cycles with one
+    bus turnaround per wakeup.  A block whose check byte does not match was
+    answered by a slave that had not staged it yet and is not decoded.
+    returns 0 on success, a ROMIMOT_I2C_*_ERR_EID code on failure */
+int romiSnapshotRead(int i2cfd, RomiSnapshot *snapshot)
+{
+    uint8_t  buf[ROMI_TLM_LEN];
+    int      i;
+    uint64_t start   = romiTimingStart();
+    int      retcode = romiTimingEnd(ROMIMOT_BUS_OP_SNAPSHOT_READ, start,
+                                romiBlockRead(i2cfd, buf, romiReadDelay[ROMI_READ_RANGE_SNAPSHOT]));
+
+    if (retcode != 0)
     {
-        return ROMIMOT_I2C_SETUP_WR_ERR_EID;
+        return retcode;
     }
-    usleep(readDelay);
-    if (read(i2cfd, buf, len) != len)
+
+    snapshot->sequence          = romiGetU16(buf, ROMI_REG_SEQUENCE);
+    snapshot->micros            = romiGetU32(buf, ROMI_REG_MICROS);
+    snapshot->buttonA           = buf[ROMI_REG_BUTTONS - ROMI_REG_TLM];
+    snapshot->buttonB           = buf[ROMI_REG_BUTTONS + 1 - ROMI_REG_TLM];
+    snapshot->buttonC           = buf[ROMI_REG_BUTTONS + 2 - ROMI_REG_TLM];
+    snapshot->batteryMillivolts = romiGetU16(buf, ROMI_REG_BATTERY);
+    for (i = 0; i < ROMI_ANALOG_LEN; i++)
     {
-        return ROMIMOT_I2C_DAT_R_ERR_EID;
+        snapshot->analog[i] = romiGetU16(buf, ROMI_REG_ANALOG + 2 * i);
     }
+    romiGetEncoders(buf, &snapshot->encoders);
+    snapshot->velocity.left  = (int16_t)romiGetU16(buf, ROMI_REG_VELOCITY);
+    snapshot->velocity.right = (int16_t)romiGetU16(buf, ROMI_REG_VELOCITY + 2);
+    snapshot->velocityAgeUs  = romiGetU16(buf, ROMI_REG_VEL_AGE);
+
     return 0;
 }
 
-int romiEncoderRead(int i2cfd, MotorPair *encoders)
+/*  True when the status registers of two blocks agree as they do on an idle
+    Romi: same buttons, battery within ROMI_CAL_BATTERY_TOL_MV */
+static int romiStatusMatches(const uint8_t *buf, const uint8_t *ref)
 {
-    MotorPair encVals;
+    int batteryDiff = romiGetU16(buf, ROMI_REG_BATTERY) - romiGetU16(ref, ROMI_REG_BATTERY);
 
-    int retcode = romiRead(i2cfd, romiCmdEncoder, 4, (uint8_t *)&encVals);
-    if (retcode == 0)
+    return batteryDiff <= ROMI_CAL_BATTERY_TOL_MV && batteryDiff >= -ROMI_CAL_BATTERY_TOL_MV &&
+           memcmp(&buf[ROMI_REG_BUTTONS - ROMI_REG_TLM], &ref[ROMI_REG_BUTTONS - ROMI_REG_TLM], 3) == 0;
+}
+
+/*  One validated read of a register range at its current delay, for read
+    delay calibration.  A 32u4 that is read before it has staged the buffer
+    still acknowledges, and answers with what it staged for the transfer
+    before.  So each trial first reads other registers at refDelayUs, a
+    delay known to be safe, which makes a stale answer come back misaligned,
+    and then checks the range against that reference.  The motors are off
+    during a calibration, so the encoders and buttons hold still and the
+    battery stays within ROMI_CAL_BATTERY_TOL_MV:
+    - a snapshot must pass its check byte and agree with the status
+      registers read before it
+    - the status and encoder registers must agree with the whole block
+      read before them
+    returns 0 when the data was good, a ROMIMOT_I2C_*_ERR_EID code from the
+    transport, or ROMIMOT_I2C_DAT_BAD_ERR_EID when it did not validate */
+int romiRangeRead(int i2cfd, int range, int refDelayUs)
+{
+    uint8_t ref[ROMI_TLM_LEN];
+    uint8_t buf[ROMI_TLM_LEN];
+    int     retcode;
+
+    switch (range)
     {
-        encoders->left  = encVals.left;
-        encoders->right = encVals.right;
+        case ROMI_READ_RANGE_SNAPSHOT:
+            retcode = romiBackend->readReg(i2cfd, ROMI_REG_BATTERY, &ref[ROMI_REG_BATTERY - ROMI_REG_TLM],
+                                           ROMI_STATUS_LEN, refDelayUs);
+            if (retcode == 0)
+            {
+                retcode = romiBlockRead(i2cfd, buf, romiReadDelay[range]);
+            }
+            break;
+
+        case ROMI_READ_RANGE_STATUS:
+        case ROMI_READ_RANGE_ENCODERS:
+            retcode = romiBlockRead(i2cfd, ref, refDelayUs);
+            if (retcode != 0)
+            {
+                return retcode;
+            }
+
+            /* read into the block's place so the same offsets apply */
+            memcpy(buf, ref, sizeof(buf));
+            if (range == ROMI_READ_RANGE_STATUS)
+            {
+                retcode = romiBackend->readReg(i2cfd, ROMI_REG_BATTERY, &buf[ROMI_REG_BATTERY - ROMI_REG_TLM],
+                                               ROMI_STATUS_LEN, romiReadDelay[range]);
+            }
+            else
+            {
+                retcode = romiBackend->readReg(i2cfd, ROMI_REG_ENCODERS, &buf[ROMI_REG_ENCODERS - ROMI_REG_TLM],
+                                               ROMI_ENCODERS_LEN, romiReadDelay[range]);
+                if (retcode == 0 && memcmp(buf, ref, sizeof(buf)) != 0)
+                {
+                    retcode = ROMIMOT_I2C_DAT_BAD_ERR_EID;
+                }
+            }
+            break;
+
+        default:
+            return ROMIMOT_I2C_DAT_R_ERR_EID;
     }
 
+    if (retcode == 0 && !romiStatusMatches(buf, ref))
+    {
+        retcode = ROMIMOT_I2C_DAT_BAD_ERR_EID;
+    }
     return retcode;
 }
 
 int romiMotorWrite(int i2cfd, int16_t left, int16_t right)
+{
+    return romiDriveWrite(i2cfd, ROMI_DRIVE_POWER, left, right);
+}
+
+int romiDriveWrite(int i2cfd, uint8_t mode, int16_t left, int16_t right)
 {
 
     // printf("motor set %d %d\n",left, right);
-    uint8_t buf[5];
-    buf[0] = romiCmdMotor;
-    buf[1] = left;
-    buf[2] = left >> 8;
-    buf[3] = right;
-    buf[4] = right >> 8;
-    if (write(i2cfd, buf, 5) != 5)
+    // The mode shares the transfer so the firmware never reads the motor
+    // registers under the wrong one.
+    uint8_t  buf[6];
+    uint64_t start = romiTimingStart();
+    buf[0]         = ROMI_REG_DRIVE;
+    buf[1]         = mode;
+    buf[2]         = left;
+    buf[3]         = left >> 8;
+    buf[4]         = right;
+    buf[5]         = right >> 8;
+    if (romiBackend->write(i2cfd, buf, 6) != 0)
     {
-        return ROMIMOT_I2C_DAT_W_ERR_EID;
+        return romiTimingEnd(ROMIMOT_BUS_OP_MOTOR_WRITE, start, ROMIMOT_I2C_DAT_W_ERR_EID);
     }
     // usleep(readDelay);
     // int ret = i2c_smbus_write_block_data(i2cfd, romiCmdMotor, 4, (uint8_t *)&mVals);
     // int ret = i2c_smbus_write_block_data(i2cfd, romiCmdMotor, 4, buf);
     // int ret = i2c_smbus_write_byte_data(i2cfd, romiCmdMotor, 70);
     // ret = i2c_smbus_write_byte_data(i2cfd, romiCmdMotor+1, 0);
-    return 0;
+    return romiTimingEnd(ROMIMOT_BUS_OP_MOTOR_WRITE, start, 0);
 }
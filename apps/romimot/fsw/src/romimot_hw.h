@@ -1,4 +1,10 @@
+#ifndef ROMIMOT_HW_H
+#define ROMIMOT_HW_H
 
+#include <stdint.h>
+
+#include "romi_encoder.h"
+#include "romi_regmap.h"
 
 typedef struct
 {
@@ -6,16 +12,193 @@ typedef struct
     int16_t right;
 } MotorPair;
 
+typedef struct
+{
+    int32_t left; /* Accumulated counts, wrap at 32 bits, see romi_encoder.h */
+    int32_t right;
+} EncoderPair;
+
+#define ROMI_STATUS_LEN (ROMI_REG_TLM_END - ROMI_REG_BATTERY) /* battery, analog and buttons */
+
+/*
+** Decoded copy of the telemetry block (romi_regmap.h) read once per cycle
+*/
+typedef struct
+{
+    uint16_t    sequence; /* Firmware publish counter */
+    uint32_t    micros;   /* Firmware clock when the sample was taken */
+    uint8_t     buttonA, buttonB, buttonC;
+    uint16_t    batteryMillivolts;
+    uint16_t    analog[ROMI_ANALOG_LEN];
+    EncoderPair encoders;
+    MotorPair   velocity;      /* counts/s, averaged by the firmware */
+    uint16_t    velocityAgeUs; /* How long before micros the velocity was sampled */
+} RomiSnapshot;
+
+/*
+** Transport used by the romi* calls below.  An implementation only moves
+** bytes to and from the 32u4 register file; all register layout knowledge
+** stays in romimot_hw.c so every backend sees identical traffic.
+**
+**   open     - open the bus and select the device, returns a handle >= 0 or a
+**              ROMIMOT_I2C_*_ERR_EID code.  Up to ROMI_MAX_DEVICES handles,
+**              each for a different bus and address, may be open at once
+**   close    - release a handle returned by open
+**   readReg  - set the register pointer to addr and read len bytes.  A
+**              delayUs of 0 asks for a combined (repeated start) transfer,
+**              otherwise the read follows the pointer write after delayUs
+**   write    - write len bytes, the first being the register address
+*/
+typedef struct
+{
+    const char *name;
+    int (*open)(int busNumber, int addr);
+    void (*close)(int handle);
+    int (*readReg)(int handle, uint8_t addr, uint8_t *buf, uint8_t len, int delayUs);
+    int (*write)(int handle, const uint8_t *buf, uint8_t len);
+} RomiBackend;
+
+#define ROMI_MAX_DEVICES 8
+
+extern const RomiBackend romiBackendI2C;    /* Linux i2c-dev, romimot_hw_i2c.c */
+extern const RomiBackend romiBackendSim;    /* simulated Romi, romimot_hw_sim.c */
+extern const RomiBackend romiBackendRecord; /* another backend, recorded, romimot_hw_log.c */
+extern const RomiBackend romiBackendReplay; /* a recorded log played back, romimot_hw_log.c */
+
+void               romiSetBackend(const RomiBackend *backend);
+const RomiBackend *romiGetBackend(void);
+
+/*
+** Bus timing.  While a hook is set, each romiRead(), romiEncoderRead(),
+** romiSnapshotRead() and romiMotorWrite() or romiDriveWrite() is timed
+** against CLOCK_MONOTONIC and reported to it with its ROMIMOT_BUS_OP_* type,
+** the elapsed time and the return code.  The hook runs on the calling task.
+*/
+typedef void (*RomiTimingHook)(int op, uint32_t elapsedUs, int status);
+
+void romiSetTimingHook(RomiTimingHook hook);
+
+/*
+** Register ranges, each with its own delay between the pointer write and
+** the data read.  A delay of 0 uses a combined (repeated start) transfer.
+** The delays apply to every handle; a caller that drives several Romis
+** with different delays sets them before each one's turn on the bus.
+*/
+#define ROMI_READ_RANGE_STATUS   0 /* romiRead() outside the encoders */
+#define ROMI_READ_RANGE_ENCODERS 1 /* romiRead() of the encoders, romiEncoderRead() */
+#define ROMI_READ_RANGE_SNAPSHOT 2 /* romiSnapshotRead() */
+#define ROMI_READ_RANGE_COUNT    3
+
+void romiSetReadDelay(int range, int delayUs);
+int  romiGetReadDelay(int range);
+int  romiRangeRead(int i2cfd, int range, int refDelayUs); /* refDelayUs is a delay known to be safe */
+
+int  romiOpen(int busNumber, int addr);
+void romiClose(int i2cfd);
+int  romiVersionRead(int i2cfd, uint8_t *version);
+
 int open_i2c_device(const char *device);
 int romiRead(int i2cfd, uint8_t addr, uint8_t len, uint8_t *buf);
-int romiEncoderRead(int i2cfd, MotorPair *encoders);
+int romiEncoderRead(int i2cfd, EncoderPair *encoders);
+int romiSnapshotRead(int i2cfd, RomiSnapshot *snapshot);
 int romiMotorWrite(int i2cfd, int16_t left, int16_t right);
+int romiDriveWrite(int i2cfd, uint8_t mode, int16_t left, int16_t right); /* mode is a ROMI_DRIVE_* */
 
-extern const int romiaddr;
+/*
+** Simulation controls.  Each bus and address opened gets its own simulated
+** Romi.  By default a simulated Romi integrates its dynamics against
+** CLOCK_MONOTONIC on every bus access; with the wall clock disabled they
+** all only move when romiSimAdvance() is called, which gives repeatable
+** runs for tests and benchmarks.  With a minimum read delay set, reads
+** issued with a shorter delay succeed but get stale data, like a 32u4 that
+** was not ready: the bytes it staged for the last read that waited long
+** enough, from that read's register on.  While offline, every read and
+** write fails like a Romi that dropped off the bus.
+*/
+void romiSimReset(void);
+void romiSimUseWallClock(int enable);
+void romiSimAdvance(double seconds);
+void romiSimSetMinReadDelay(int delayUs);
+void romiSimSetOffline(int offline);
+
+/*
+** Bus log.  While a recording runs, the record backend passes every open,
+** close, register read and write on to its target backend and appends it
+** to a binary log with its start time, duration, return code and data.
+** A log starts with a RomiLogHeader; each RomiLogRecord is followed by its
+** data: the bytes read for a read that succeeded, the bytes written after
+** the register address for a write.  Byte order is the recording host's.
+**
+** The replay backend answers from such a log instead of a bus.  Each call
+** takes the next record of the same kind for the same device, register
+** and length, passing over at most ROMI_REPLAY_RESYNC others to get back
+** in step after the caller took a different path; a call with no such
+** record fails.  Reads return the recorded data and code, writes the
+** recorded code, and writes whose data differs from the log are counted
+** as diverged.  Played as fast as possible each call returns at once; at
+** wall clock speed a call returns no earlier than it did in the session.
+*/
+#define ROMI_LOG_MAGIC     0x4F494D52 /* "RMIO" */
+#define ROMI_LOG_VERSION   1
+#define ROMI_REPLAY_RESYNC 16
+
+#define ROMI_LOG_OPEN  1 /* addr is the I2C address, arg the bus number */
+#define ROMI_LOG_CLOSE 2
+#define ROMI_LOG_READ  3 /* arg is the read delay (us) */
+#define ROMI_LOG_WRITE 4
+
+typedef struct
+{
+    uint32_t magic;         /* ROMI_LOG_MAGIC */
+    uint16_t version;       /* ROMI_LOG_VERSION */
+    uint8_t  regmapVersion; /* ROMI_REGMAP_VERSION of the recording build */
+    uint8_t  recordSize;    /* sizeof(RomiLogRecord) */
+    uint64_t startTimeUs;   /* CLOCK_REALTIME when the recording started */
+} RomiLogHeader;
+
+typedef struct
+{
+    uint32_t deltaUs;    /* Start time, after the previous record's start */
+    uint16_t durationUs; /* Time spent in the target backend, saturated */
+    uint8_t  op;         /* ROMI_LOG_* */
+    uint8_t  device;     /* Handle slot, in the order the handles were opened */
+    int16_t  status;     /* 0 or a ROMIMOT_I2C_*_ERR_EID code */
+    uint8_t  addr;       /* Register address */
+    uint8_t  len;        /* Bytes requested or written */
+    uint16_t arg;
+    uint16_t spare;
+} RomiLogRecord;
+
+typedef struct
+{
+    int      active;    /* Recording, or a log is loaded */
+    uint32_t records;   /* Recorded, or replayed */
+    uint32_t logged;    /* Replay: records in the log */
+    uint32_t skipped;   /* Replay: records passed over to get back in step */
+    uint32_t unmatched; /* Replay: calls that found no record */
+    uint32_t diverged;  /* Replay: writes whose data differed from the log */
+    uint32_t lost;      /* Record: records the file did not take */
+    int      ended;     /* Replay: the whole log has been played */
+} RomiLogStats;
 
-extern const int readDelay;
+/*
+** romiLogInit() creates the lock of the bus log and is called once before
+** any of the calls below.  romiRecordStart() records the traffic through
+** target into a ring, for path; if a recording is already running it only
+** moves it to target.  The record backend must be selected once no handle
+** is open.  Only romiRecordFlush() touches the file: called by one task,
+** typically at housekeeping, it creates the file of a new recording,
+** writes out the queued records and closes the file once the recording
+** stops.  A record that finds the ring full is lost.  All return 0, or -1.
+*/
+int  romiLogInit(void);
+int  romiRecordStart(const char *path, const RomiBackend *target);
+int  romiRecordFlush(void);
+void romiRecordStop(void);
+void romiRecordGetStats(RomiLogStats *stats);
 
-extern const int i2cBusNumber;
+int  romiReplayLoad(const char *path, int wallClock);
+void romiReplayUnload(void);
+void romiReplayGetStats(RomiLogStats *stats);
 
-extern const uint8_t romiCmdMotor;
-extern const uint8_t romiCmdEncoder;
+#endif /* ROMIMOT_HW_H */
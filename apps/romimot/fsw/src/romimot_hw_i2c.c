@@ -0,0 +1,165 @@
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/types.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "cfe.h"
+
+#include "romimot_hw.h"
+#include "romimot_msg.h"
+
+/* A stuck transfer gives up after one 10 ms tick instead of the adapter's
+   default of about a second, and is not retried by the kernel; the
+   recovery in the I/O task decides what happens next */
+#define ROMI_I2C_TIMEOUT_10MS 1
+#define ROMI_I2C_RETRIES      0
+
+/* Device address of each open handle, for I2C_RDWR, which does not use the
+   one selected with I2C_SLAVE */
+static struct
+{
+    int      inUse;
+    int      fd;
+    uint16_t addr;
+} i2cDevices[ROMI_MAX_DEVICES];
+
+/* Slot of an open handle, or with inUse 0 a free one; -1 if none */
+static int i2cFindDevice(int inUse, int fd)
+{
+    int i;
+
+    for (i = 0; i < ROMI_MAX_DEVICES; i++)
+    {
+        if (i2cDevices[i].inUse == inUse && (!inUse || i2cDevices[i].fd == fd))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Opens the specified I2C device.  Returns a non-negative file descriptor
+// on success, or -1 [ROMIMOT_I2C_DEV_FD_ERR_EID] on failure.
+int open_i2c_device(const char *device)
+{
+    int fd = open(device, O_RDWR);
+    if (fd == -1)
+    {
+        perror(device);
+        return ROMIMOT_I2C_DEV_FD_ERR_EID;
+    }
+    return fd;
+}
+
+static int i2cOpen(int busNumber, int addr)
+{
+    char busname[20];
+    int  fd;
+    int  slot = i2cFindDevice(0, 0);
+
+    if (slot < 0)
+    {
+        return ROMIMOT_I2C_DEV_FD_ERR_EID;
+    }
+
+    snprintf(busname, sizeof(busname), "/dev/i2c-%d", busNumber);
+    fd = open_i2c_device(busname);
+    if (fd < 0)
+    {
+        return fd;
+    }
+
+    if (ioctl(fd, I2C_SLAVE, addr) < 0)
+    {
+        close(fd);
+        return ROMIMOT_I2C_ADDR_ERR_EID;
+    }
+
+    if (ioctl(fd, I2C_TIMEOUT, ROMI_I2C_TIMEOUT_10MS) < 0 || ioctl(fd, I2C_RETRIES, ROMI_I2C_RETRIES) < 0)
+    {
+        close(fd);
+        return ROMIMOT_I2C_DEV_FD_ERR_EID;
+    }
+
+    i2cDevices[slot].inUse = 1;
+    i2cDevices[slot].fd    = fd;
+    i2cDevices[slot].addr  = addr;
+    return fd;
+}
+
+static void i2cClose(int handle)
+{
+    int slot = i2cFindDevice(1, handle);
+
+    if (slot >= 0)
+    {
+        i2cDevices[slot].inUse = 0;
+    }
+    close(handle);
+}
+
+/*  delayUs > 0: pointer write, usleep, plain read, for the 32u4 slave that
+    needs time to latch the pointer.  delayUs == 0: one I2C_RDWR transaction
+    with a repeated start between the pointer write and the read. */
+static int i2cReadReg(int handle, uint8_t addr, uint8_t *buf, uint8_t len, int delayUs)
+{
+    struct i2c_msg             msgs[2];
+    struct i2c_rdwr_ioctl_data xfer;
+    int                        slot;
+
+    if (delayUs > 0)
+    {
+        if (write(handle, &addr, 1) != 1)
+        {
+            return ROMIMOT_I2C_SETUP_WR_ERR_EID;
+        }
+        usleep(delayUs);
+        if (read(handle, buf, len) != len)
+        {
+            return ROMIMOT_I2C_DAT_R_ERR_EID;
+        }
+        return 0;
+    }
+
+    slot = i2cFindDevice(1, handle);
+    if (slot < 0)
+    {
+        return ROMIMOT_I2C_SETUP_WR_ERR_EID;
+    }
+
+    msgs[0].addr  = i2cDevices[slot].addr;
+    msgs[0].flags = 0;
+    msgs[0].len   = 1;
+    msgs[0].buf   = &addr;
+
+    msgs[1].addr  = i2cDevices[slot].addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len   = len;
+    msgs[1].buf   = buf;
+
+    xfer.msgs  = msgs;
+    xfer.nmsgs = 2;
+
+    if (ioctl(handle, I2C_RDWR, &xfer) != 2)
+    {
+        return ROMIMOT_I2C_DAT_R_ERR_EID;
+    }
+    return 0;
+}
+
+static int i2cWrite(int handle, const uint8_t *buf, uint8_t len)
+{
+    if (write(handle, buf, len) != len)
+    {
+        return ROMIMOT_I2C_DAT_W_ERR_EID;
+    }
+    return 0;
+}
+
+const RomiBackend romiBackendI2C = {"i2c", i2cOpen, i2cClose, i2cReadReg, i2cWrite};
@@ -0,0 +1,675 @@
+/*  Bus log backends: recording and replay of the Romi transport.
+
+    The record backend sits in front of the I2C or simulated backend and
+    copies every call into a preallocated ring, so the I/O task never waits
+    on the file system or a lock; the main task drains the ring to the log
+    file at housekeeping and does all the file I/O.  The replay backend
+    reads a whole log into memory when it is loaded, so a replayed control
+    cycle never waits on the file system, and plays it back in the order it
+    was recorded.  See romimot_hw.h for the log format and the matching
+    rules. */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cfe.h"
+
+#include "romimot_hw.h"
+#include "romimot_msg.h"
+
+#define LOG_RING_SIZE    65536 /* bytes, a power of two */
+#define LOG_RING_MASK    (LOG_RING_SIZE - 1)
+#define LOG_NO_DEVICE    0xFF
+#define LOG_DURATION_MAX 0xFFFF
+#define LOG_LOCK_NAME    "ROMI_BUS_LOG"
+#define REPLAY_HANDLE    0x7E7E /* handle of device 0, the others follow */
+
+/*  Guards the recording's path and session, and the replay.  Never held
+    across file I/O. */
+static osal_id_t logLock;
+
+static struct
+{
+    /* I/O task only */
+    const RomiBackend *target;
+    int                handles[ROMI_MAX_DEVICES];
+    int                inUse[ROMI_MAX_DEVICES];
+    uint64_t           lastUs; /* start of the previous record */
+
+    /* shared, the ring is single producer (I/O task), single consumer (main task) */
+    int      active;                      /* records are queued */
+    uint32_t head;                        /* bytes queued, written by the I/O task only */
+    uint32_t tail;                        /* bytes drained, written by the main task only */
+    uint32_t session;                     /* recordings started, under logLock */
+    uint32_t sessionHead;                 /* head when the current one started, under logLock */
+    char     path[OS_MAX_LOCAL_PATH_LEN]; /* file of the current one, under logLock */
+    uint32_t records;                     /* queued, written by the I/O task only */
+    uint32_t lost;                        /* not in the file: the ring was full or the write failed */
+
+    /* main task only */
+    FILE *   file;
+    uint32_t fileSession;
+
+    uint8_t ring[LOG_RING_SIZE];
+} recorder;
+
+static struct
+{
+    uint8_t *    data;
+    size_t       size;
+    size_t       cursor;   /* offset of the next record */
+    uint64_t     cursorUs; /* start of the record before it, in the session */
+    int          wallClock;
+    int          started;
+    uint64_t     baseUs; /* CLOCK_MONOTONIC at session time 0 */
+    RomiLogStats stats;
+} replay;
+
+int romiLogInit(void)
+{
+    return OS_MutSemCreate(&logLock, LOG_LOCK_NAME, 0) == OS_SUCCESS ? 0 : -1;
+}
+
+static uint64_t logNowUs(clockid_t clock)
+{
+    struct timespec now;
+
+    clock_gettime(clock, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* Bytes that follow a record */
+static size_t logDataLen(const RomiLogRecord *rec)
+{
+    if (rec->op == ROMI_LOG_WRITE || (rec->op == ROMI_LOG_READ && rec->status == 0))
+    {
+        return rec->len;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/*  Recording                                                               */
+/* ------------------------------------------------------------------------ */
+
+static int recSlot(int handle)
+{
+    int i;
+
+    for (i = 0; i < ROMI_MAX_DEVICES; i++)
+    {
+        if (recorder.inUse[i] && recorder.handles[i] == handle)
+        {
+            return i;
+        }
+    }
+    return LOG_NO_DEVICE;
+}
+
+/* Copies len bytes into the ring at position pos, wrapping at its end */
+static void recPut(uint32_t pos, const void *data, size_t len)
+{
+    size_t slot  = pos & LOG_RING_MASK;
+    size_t chunk = LOG_RING_SIZE - slot;
+
+    if (chunk > len)
+    {
+        chunk = len;
+    }
+    memcpy(&recorder.ring[slot], data, chunk);
+    memcpy(recorder.ring, (const uint8_t *)data + chunk, len - chunk);
+}
+
+/* Copies len bytes out of the ring from position pos */
+static void recGet(uint32_t pos, void *data, size_t len)
+{
+    size_t slot  = pos & LOG_RING_MASK;
+    size_t chunk = LOG_RING_SIZE - slot;
+
+    if (chunk > len)
+    {
+        chunk = len;
+    }
+    memcpy(data, &recorder.ring[slot], chunk);
+    memcpy((uint8_t *)data + chunk, recorder.ring, len - chunk);
+}
+
+/*  Called by the I/O task.  Never blocks: a record that does not fit in
+    the ring is counted as lost. */
+static void recAppend(const RomiLogRecord *rec, const uint8_t *data)
+{
+    uint32_t head = recorder.head;
+    uint32_t size = sizeof(*rec) + logDataLen(rec);
+
+    if (LOG_RING_SIZE - (head - __atomic_load_n(&recorder.tail, __ATOMIC_ACQUIRE)) < size)
+    {
+        __atomic_add_fetch(&recorder.lost, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    recPut(head, rec, sizeof(*rec));
+    recPut(head + sizeof(*rec), data, logDataLen(rec));
+    __atomic_store_n(&recorder.head, head + size, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&recorder.records, 1, __ATOMIC_RELAXED);
+}
+
+/* Log one call that started at startUs */
+static void recLog(uint8_t op, int device, uint8_t addr, uint8_t len, uint16_t arg, int status, uint64_t startUs,
+                   const uint8_t *data)
+{
+    RomiLogRecord rec;
+    uint64_t      durationUs = logNowUs(CLOCK_MONOTONIC) - startUs;
+
+    if (!__atomic_load_n(&recorder.active, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    memset(&rec, 0, sizeof(rec));
+    rec.op          = op;
+    rec.device      = (uint8_t)device;
+    rec.addr        = addr;
+    rec.len         = len;
+    rec.arg         = arg;
+    rec.status      = (int16_t)status;
+    rec.durationUs  = durationUs < LOG_DURATION_MAX ? (uint16_t)durationUs : LOG_DURATION_MAX;
+    rec.deltaUs     = recorder.lastUs != 0 ? (uint32_t)(startUs - recorder.lastUs) : 0;
+    recorder.lastUs = startUs;
+
+    recAppend(&rec, data);
+}
+
+static int recOpen(int busNumber, int addr)
+{
+    uint64_t start  = logNowUs(CLOCK_MONOTONIC);
+    int      handle = recorder.target->open(busNumber, addr);
+    int      slot   = LOG_NO_DEVICE;
+    int      i;
+
+    if (handle >= 0)
+    {
+        for (i = 0; i < ROMI_MAX_DEVICES && slot == LOG_NO_DEVICE; i++)
+        {
+            if (!recorder.inUse[i])
+            {
+                recorder.inUse[i]   = 1;
+                recorder.handles[i] = handle;
+                slot                = i;
+            }
+        }
+    }
+
+    recLog(ROMI_LOG_OPEN, slot, (uint8_t)addr, 0, (uint16_t)busNumber, handle >= 0 ? 0 : handle, start, NULL);
+    return handle;
+}
+
+static void recClose(int handle)
+{
+    uint64_t start = logNowUs(CLOCK_MONOTONIC);
+    int      slot;
+
+    recorder.target->close(handle);
+
+    slot = recSlot(handle);
+    if (slot != LOG_NO_DEVICE)
+    {
+        recorder.inUse[slot] = 0;
+    }
+
+    recLog(ROMI_LOG_CLOSE, slot, 0, 0, 0, 0, start, NULL);
+}
+
+static int recReadReg(int handle, uint8_t addr, uint8_t *buf, uint8_t len, int delayUs)
+{
+    uint64_t start  = logNowUs(CLOCK_MONOTONIC);
+    int      status = recorder.target->readReg(handle, addr, buf, len, delayUs);
+
+    recLog(ROMI_LOG_READ, recSlot(handle), addr, len, (uint16_t)delayUs, status, start, buf);
+    return status;
+}
+
+static int recWrite(int handle, const uint8_t *buf, uint8_t len)
+{
+    uint64_t start  = logNowUs(CLOCK_MONOTONIC);
+    int      status = recorder.target->write(handle, buf, len);
+
+    if (len > 0)
+    {
+        recLog(ROMI_LOG_WRITE, recSlot(handle), buf[0], len - 1, 0, status, start, &buf[1]);
+    }
+    return status;
+}
+
+const RomiBackend romiBackendRecord = {"record", recOpen, recClose, recReadReg, recWrite};
+
+/*  Called on the task that drives the bus.  Only arms the ring, the main
+    task creates the file at its next romiRecordFlush(). */
+int romiRecordStart(const char *path, const RomiBackend *target)
+{
+    int status = 0;
+
+    recorder.target = target;
+    if (__atomic_load_n(&recorder.active, __ATOMIC_ACQUIRE))
+    {
+        return 0;
+    }
+
+    OS_MutSemTake(logLock);
+    if (path == NULL || strlen(path) >= sizeof(recorder.path))
+    {
+        errno  = EINVAL;
+        status = -1;
+    }
+    else
+    {
+        strcpy(recorder.path, path);
+        recorder.session++;
+        recorder.sessionHead = recorder.head;
+        recorder.lastUs      = 0;
+        __atomic_store_n(&recorder.records, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&recorder.lost, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&recorder.active, 1, __ATOMIC_RELEASE);
+    }
+    OS_MutSemGive(logLock);
+
+    return status;
+}
+
+static int recWriteHeader(FILE *file)
+{
+    RomiLogHeader header;
+
+    memset(&header, 0, sizeof(header));
+    header.magic         = ROMI_LOG_MAGIC;
+    header.version       = ROMI_LOG_VERSION;
+    header.regmapVersion = ROMI_REGMAP_VERSION;
+    header.recordSize    = sizeof(RomiLogRecord);
+    header.startTimeUs   = logNowUs(CLOCK_REALTIME);
+    return fwrite(&header, sizeof(header), 1, file) == 1 ? 0 : -1;
+}
+
+/*  Writes the queued records up to end to the file, or drops them if there
+    is none, and hands their room back to the I/O task.  Returns -1 if the
+    file refused any. */
+static int recDrain(uint32_t end)
+{
+    RomiLogRecord rec;
+    uint8_t       data[sizeof(rec) + UINT8_MAX];
+    uint32_t      tail   = recorder.tail;
+    size_t        size;
+    int           status = 0;
+
+    while (tail != end)
+    {
+        recGet(tail, &rec, sizeof(rec));
+        size = sizeof(rec) + logDataLen(&rec);
+        recGet(tail, data, size);
+
+        if (recorder.file == NULL)
+        {
+            __atomic_add_fetch(&recorder.lost, 1, __ATOMIC_RELAXED);
+        }
+        else if (fwrite(data, size, 1, recorder.file) != 1)
+        {
+            __atomic_add_fetch(&recorder.lost, 1, __ATOMIC_RELAXED);
+            status = -1;
+        }
+        tail += size;
+    }
+    __atomic_store_n(&recorder.tail, tail, __ATOMIC_RELEASE);
+
+    return status;
+}
+
+static int recCloseFile(void)
+{
+    int status = fclose(recorder.file) == 0 ? 0 : -1;
+
+    recorder.file = NULL;
+    return status;
+}
+
+/*  Called by the main task.  Writes out everything queued, creating the
+    file of a recording that started since the last call and closing the
+    file of one that stopped or was replaced.  A file that cannot be
+    created stops the recording. */
+int romiRecordFlush(void)
+{
+    char     path[OS_MAX_LOCAL_PATH_LEN];
+    uint32_t session;
+    uint32_t sessionHead;
+    uint32_t head;
+    int      active;
+    int      status = 0;
+
+    OS_MutSemTake(logLock);
+    active      = __atomic_load_n(&recorder.active, __ATOMIC_ACQUIRE);
+    session     = recorder.session;
+    sessionHead = recorder.sessionHead;
+    head        = __atomic_load_n(&recorder.head, __ATOMIC_ACQUIRE);
+    strcpy(path, recorder.path);
+    OS_MutSemGive(logLock);
+
+    if (recorder.fileSession != session)
+    {
+        /* the records before sessionHead belong to the previous recording */
+        status |= recDrain(sessionHead);
+        if (recorder.file != NULL)
+        {
+            status |= recCloseFile();
+        }
+
+        recorder.fileSession = session;
+        recorder.file        = fopen(path, "wb");
+        if (recorder.file != NULL && recWriteHeader(recorder.file) != 0)
+        {
+            recCloseFile();
+        }
+        if (recorder.file == NULL)
+        {
+            __atomic_store_n(&recorder.active, 0, __ATOMIC_RELEASE);
+            status = -1;
+        }
+    }
+
+    status |= recDrain(head);
+    if (recorder.file != NULL && fflush(recorder.file) != 0)
+    {
+        status = -1;
+    }
+
+    if (recorder.file != NULL && !active)
+    {
+        status |= recCloseFile();
+    }
+
+    return status;
+}
+
+/*  Stops queueing, the main task closes the file once it has drained the
+    ring.  Handles still open through the record backend keep reaching the
+    target, unrecorded. */
+void romiRecordStop(void)
+{
+    __atomic_store_n(&recorder.active, 0, __ATOMIC_RELEASE);
+}
+
+void romiRecordGetStats(RomiLogStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->active  = __atomic_load_n(&recorder.active, __ATOMIC_ACQUIRE);
+    stats->records = __atomic_load_n(&recorder.records, __ATOMIC_RELAXED);
+    stats->lost    = __atomic_load_n(&recorder.lost, __ATOMIC_RELAXED);
+}
+
+/* ------------------------------------------------------------------------ */
+/*  Replay                                                                  */
+/* ------------------------------------------------------------------------ */
+
+static int replayMatches(const RomiLogRecord *rec, const RomiLogRecord *call)
+{
+    if (rec->op != call->op)
+    {
+        return 0;
+    }
+    if (call->op == ROMI_LOG_OPEN)
+    {
+        return rec->addr == call->addr && rec->arg == call->arg;
+    }
+    return rec->device == call->device && rec->addr == call->addr && rec->len == call->len;
+}
+
+/*  Takes the record that answers call, and sets *data to what follows it.
+    Returns 0 if there is none within ROMI_REPLAY_RESYNC records, leaving
+    the log where it was. */
+static int replayTake(const RomiLogRecord *call, RomiLogRecord *rec, const uint8_t **data)
+{
+    size_t   pos;
+    size_t   next;
+    uint64_t timeUs;
+    uint64_t deadlineUs = 0;
+    int      skipped;
+    int      found = 0;
+
+    OS_MutSemTake(logLock);
+    pos    = replay.cursor;
+    timeUs = replay.cursorUs;
+    for (skipped = 0; skipped <= ROMI_REPLAY_RESYNC && pos + sizeof(*rec) <= replay.size; skipped++)
+    {
+        memcpy(rec, &replay.data[pos], sizeof(*rec));
+        next = pos + sizeof(*rec) + logDataLen(rec);
+        timeUs += rec->deltaUs;
+
+        if (replayMatches(rec, call))
+        {
+            *data           = &replay.data[pos + sizeof(*rec)];
+            replay.cursor   = next;
+            replay.cursorUs = timeUs;
+            replay.stats.records++;
+            replay.stats.skipped += skipped;
+            replay.stats.ended = replay.cursor >= replay.size;
+
+            if (!replay.started)
+            {
+                replay.baseUs  = logNowUs(CLOCK_MONOTONIC) - timeUs;
+                replay.started = 1;
+            }
+            if (replay.wallClock)
+            {
+                deadlineUs = replay.baseUs + timeUs + rec->durationUs;
+            }
+            found = 1;
+            break;
+        }
+        pos = next;
+    }
+    if (!found)
+    {
+        replay.stats.unmatched++;
+    }
+    OS_MutSemGive(logLock);
+
+    /* hold the caller as long as the robot's bus did */
+    if (deadlineUs != 0)
+    {
+        struct timespec until;
+
+        until.tv_sec  = deadlineUs / 1000000;
+        until.tv_nsec = (deadlineUs % 1000000) * 1000;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR)
+        {
+        }
+    }
+
+    return found;
+}
+
+/* Device of a replay handle, LOG_NO_DEVICE if it is not one */
+static int replayDevice(int handle)
+{
+    int device = handle - REPLAY_HANDLE;
+
+    return (device >= 0 && device < ROMI_MAX_DEVICES) ? device : LOG_NO_DEVICE;
+}
+
+static int replayOpen(int busNumber, int addr)
+{
+    RomiLogRecord  call;
+    RomiLogRecord  rec;
+    const uint8_t *data;
+
+    memset(&call, 0, sizeof(call));
+    call.op   = ROMI_LOG_OPEN;
+    call.addr = (uint8_t)addr;
+    call.arg  = (uint16_t)busNumber;
+
+    if (!replayTake(&call, &rec, &data))
+    {
+        return ROMIMOT_I2C_DEV_FD_ERR_EID;
+    }
+    if (rec.status != 0)
+    {
+        return rec.status;
+    }
+    return REPLAY_HANDLE + rec.device;
+}
+
+static void replayClose(int handle)
+{
+    RomiLogRecord  call;
+    RomiLogRecord  rec;
+    const uint8_t *data;
+
+    memset(&call, 0, sizeof(call));
+    call.op     = ROMI_LOG_CLOSE;
+    call.device = (uint8_t)replayDevice(handle);
+
+    replayTake(&call, &rec, &data);
+}
+
+static int replayReadReg(int handle, uint8_t addr, uint8_t *buf, uint8_t len, int delayUs)
+{
+    RomiLogRecord  call;
+    RomiLogRecord  rec;
+    const uint8_t *data;
+
+    memset(&call, 0, sizeof(call));
+    call.op     = ROMI_LOG_READ;
+    call.device = (uint8_t)replayDevice(handle);
+    call.addr   = addr;
+    call.len    = len;
+
+    if (call.device == LOG_NO_DEVICE)
+    {
+        return ROMIMOT_I2C_SETUP_WR_ERR_EID;
+    }
+    if (!replayTake(&call, &rec, &data))
+    {
+        return ROMIMOT_I2C_DAT_R_ERR_EID;
+    }
+    if (rec.status == 0)
+    {
+        memcpy(buf, data, len);
+    }
+    return rec.status;
+}
+
+static int replayWrite(int handle, const uint8_t *buf, uint8_t len)
+{
+    RomiLogRecord  call;
+    RomiLogRecord  rec;
+    const uint8_t *data;
+
+    memset(&call, 0, sizeof(call));
+    call.op     = ROMI_LOG_WRITE;
+    call.device = (uint8_t)replayDevice(handle);
+
+    if (call.device == LOG_NO_DEVICE || len < 1)
+    {
+        return ROMIMOT_I2C_DAT_W_ERR_EID;
+    }
+
+    call.addr = buf[0];
+    call.len  = len - 1;
+    if (!replayTake(&call, &rec, &data))
+    {
+        return ROMIMOT_I2C_DAT_W_ERR_EID;
+    }
+
+    if (memcmp(data, &buf[1], call.len) != 0)
+    {
+        OS_MutSemTake(logLock);
+        replay.stats.diverged++;
+        OS_MutSemGive(logLock);
+    }
+    return rec.status;
+}
+
+const RomiBackend romiBackendReplay = {"replay", replayOpen, replayClose, replayReadReg, replayWrite};
+
+/*  Reads the whole log and checks it record by record, so a truncated or
+    foreign file is refused before any of it is played.  Replaces a log
+    already loaded. */
+int romiReplayLoad(const char *path, int wallClock)
+{
+    FILE *        file;
+    RomiLogHeader header;
+    RomiLogRecord rec;
+    uint8_t *     data = NULL;
+    long          size;
+    size_t        pos;
+    uint32_t      count = 0;
+
+    file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != ROMI_LOG_MAGIC ||
+        header.version != ROMI_LOG_VERSION || header.regmapVersion != ROMI_REGMAP_VERSION ||
+        header.recordSize != sizeof(RomiLogRecord) || fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0)
+    {
+        fclose(file);
+        errno = EINVAL;
+        return -1;
+    }
+
+    size -= sizeof(header);
+    if (size > 0)
+    {
+        data = malloc(size);
+    }
+    if (size > 0 && (data == NULL || fseek(file, sizeof(header), SEEK_SET) != 0 || fread(data, size, 1, file) != 1))
+    {
+        free(data);
+        fclose(file);
+        errno = EIO;
+        return -1;
+    }
+    fclose(file);
+
+    for (pos = 0; pos + sizeof(rec) <= (size_t)size; count++)
+    {
+        memcpy(&rec, &data[pos], sizeof(rec));
+        pos += sizeof(rec) + logDataLen(&rec);
+    }
+    if (pos != (size_t)size)
+    {
+        free(data);
+        errno = EINVAL;
+        return -1;
+    }
+
+    OS_MutSemTake(logLock);
+    free(replay.data);
+    memset(&replay, 0, sizeof(replay));
+    replay.data         = data;
+    replay.size         = size;
+    replay.wallClock    = wallClock;
+    replay.stats.active = 1;
+    replay.stats.logged = count;
+    replay.stats.ended  = size == 0;
+    OS_MutSemGive(logLock);
+
+    return 0;
+}
+
+void romiReplayUnload(void)
+{
+    OS_MutSemTake(logLock);
+    free(replay.data);
+    memset(&replay, 0, sizeof(replay));
+    OS_MutSemGive(logLock);
+}
+
+void romiReplayGetStats(RomiLogStats *stats)
+{
+    OS_MutSemTake(logLock);
+    *stats = replay.stats;
+    OS_MutSemGive(logLock);
+}
@@ -0,0 +1,405 @@
+
+/*  Simulated Romi 32u4 backend.
+
+    Emulates the register file of arduino_code/RomiRPiRemoteControl behind the
+    same byte-level transport as the I2C backend, plus a simple model of the
+    robot behind it:
+
+    - each wheel is a first order lag from commanded power to encoder rate,
+      scaled by the loaded battery voltage
+    - the encoders are sampled every ROMI_SPEED_PERIOD_US of simulated time
+      for the firmware velocity estimate (romi_velocity.h), and in
+      ROMI_DRIVE_SPEED mode the firmware speed loop (romi_speed.h) sets the
+      power from the same samples
+    - encoder counts integrate that rate; the 16 bit library counters feed
+      the firmware loops and the published counts wrap at 32 bits
+    - the battery is a 6 cell NiMH pack: open circuit voltage falls as charge
+      is drawn, and the terminal voltage sags with the motor current
+
+    Every bus and address opened gets a Romi of its own, up to
+    ROMI_MAX_DEVICES, so a bench of them can be driven at once.  No I2C
+    hardware or root access is needed, so the control loop can be run and
+    profiled at kHz rates on any Linux host. */
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "cfe.h"
+
+#include "romimot_hw.h"
+#include "romimot_msg.h"
+#include "romi_speed.h"
+#include "romi_velocity.h"
+
+#define SIM_REG_LEN       ROMI_REG_TLM_END /* sizeof(RomiRegisters) in romi_regmap.h */
+#define SIM_HANDLE        0x5A5A /* handle of sims[0], the others follow */
+#define SIM_MAX_STEP      0.001  /* integration step (s) */
+#define SIM_MAX_CATCHUP   0.1    /* longest gap integrated after a stall (s) */
+#define SIM_MAX_POWER     ROMI_POWER_MAX /* firmware ignores commands outside +/- this */
+#define SIM_SAMPLE_PERIOD (ROMI_SPEED_PERIOD_US * 1e-6) /* firmware encoder sampling period (s) */
+#define SIM_NOLOAD_SPEED  3600.0 /* counts/s at full power and nominal voltage */
+#define SIM_TAU           0.08   /* wheel speed time constant (s) */
+#define SIM_VNOM_MV       7200.0 /* fully charged open circuit voltage */
+#define SIM_VEMPTY_MV     6000.0 /* open circuit voltage at SIM_CAPACITY_MAS */
+#define SIM_CAPACITY_MAS  (2000.0 * 3600.0) /* pack capacity (mA*s) */
+#define SIM_RINT_OHM      0.6    /* pack internal resistance */
+#define SIM_STALL_MA      1250.0 /* per motor stall current at nominal voltage */
+#define SIM_IDLE_MA       150.0  /* control board draw */
+
+typedef struct
+{
+    int             inUse;
+    int             busNumber;
+    int             addr;
+    uint8_t         regs[SIM_REG_LEN];
+    int16_t         power[2];    /* last accepted motor command, or the speed loop output */
+    uint8_t         driveMode;   /* ROMI_DRIVE_* latched from the registers */
+    int16_t         target[2];   /* last accepted speed command, counts/s */
+    RomiSpeedLoop   speedLoop[2];
+    RomiVelocity    velocity;
+    double          sampleS;     /* simulated time since the last encoder sample */
+    double          speed[2];    /* counts/s */
+    double          position[2]; /* counts */
+    double          chargeUsed;  /* mA*s */
+    double          batteryMv;   /* terminal voltage */
+    double          timeS;       /* simulated time since reset, for micros */
+    uint16_t        sequence;    /* publish counter */
+    uint8_t         stagedAddr;  /* register the slave transmit buffer below was staged for */
+    uint8_t         staged[SIM_REG_LEN];
+    int             clockValid;
+    struct timespec last;
+} RomiSimState;
+
+static RomiSimState sims[ROMI_MAX_DEVICES];
+static int          simUseWallClock = 1;
+static int          simMinReadDelay; /* us, shorter read delays get stale data */
+static int          simOffline;      /* every transfer fails */
+
+static void simPutU16(RomiSimState *sim, uint8_t addr, uint16_t value)
+{
+    sim->regs[addr]     = value & 0xFF;
+    sim->regs[addr + 1] = value >> 8;
+}
+
+static int16_t simGetS16(const RomiSimState *sim, uint8_t addr)
+{
+    return (int16_t)(sim->regs[addr] | (sim->regs[addr + 1] << 8));
+}
+
+static void simPutU32(RomiSimState *sim, uint8_t addr, uint32_t value)
+{
+    simPutU16(sim, addr, value & 0xFFFF);
+    simPutU16(sim, addr + 2, value >> 16);
+}
+
+/* Accumulated count the firmware publishes */
+static int32_t simCount(const RomiSimState *sim, int wheel)
+{
+    return (int32_t)(uint32_t)(int64_t)sim->position[wheel];
+}
+
+/* Romi32U4Encoders library counter, its low 16 bits */
+static int16_t simRawCount(const RomiSimState *sim, int wheel)
+{
+    return (int16_t)(uint16_t)(uint32_t)simCount(sim, wheel);
+}
+
+static uint32_t simMicros(const RomiSimState *sim)
+{
+    return (uint32_t)(int64_t)(sim->timeS * 1e6 + 0.5);
+}
+
+/* Mirrors the firmware loop(): latch a valid motor command, publish sensors */
+static void simUpdateRegisters(RomiSimState *sim)
+{
+    uint8_t mode  = sim->regs[ROMI_REG_DRIVE];
+    int16_t left  = simGetS16(sim, ROMI_REG_MOTORS);
+    int16_t right = simGetS16(sim, ROMI_REG_MOTORS + 2);
+    int     i;
+
+    if (mode != sim->driveMode)
+    {
+        sim->driveMode = mode;
+        for (i = 0; i < 2; i++)
+        {
+            sim->power[i]  = 0;
+            sim->target[i] = 0;
+            romiSpeedReset(&sim->speedLoop[i], simRawCount(sim, i));
+        }
+    }
+
+    if (mode == ROMI_DRIVE_SPEED)
+    {
+        if (left >= -ROMI_SPEED_MAX && left <= ROMI_SPEED_MAX && right >= -ROMI_SPEED_MAX && right <= ROMI_SPEED_MAX)
+        {
+            sim->target[0] = left;
+            sim->target[1] = right;
+        }
+    }
+    else if (left >= -SIM_MAX_POWER && left <= SIM_MAX_POWER && right >= -SIM_MAX_POWER && right <= SIM_MAX_POWER)
+    {
+        sim->power[0] = left;
+        sim->power[1] = right;
+    }
+
+    simPutU16(sim, ROMI_REG_BATTERY, (uint16_t)sim->batteryMv);
+    simPutU32(sim, ROMI_REG_ENCODERS, (uint32_t)simCount(sim, 0));
+    simPutU32(sim, ROMI_REG_ENCODERS + 4, (uint32_t)simCount(sim, 1));
+    simPutU16(sim, ROMI_REG_VELOCITY, (uint16_t)sim->velocity.leftVelocity);
+    simPutU16(sim, ROMI_REG_VELOCITY + 2, (uint16_t)sim->velocity.rightVelocity);
+    simPutU16(sim, ROMI_REG_VEL_AGE, (uint16_t)(simMicros(sim) - romiVelocityTime(&sim->velocity)));
+
+    sim->regs[ROMI_REG_VERSION] = ROMI_REGMAP_VERSION;
+    simPutU32(sim, ROMI_REG_MICROS, simMicros(sim));
+    simPutU16(sim, ROMI_REG_SEQUENCE, ++sim->sequence);
+    sim->regs[ROMI_REG_CHECK] = romiTlmCheck(&sim->regs[ROMI_REG_TLM]);
+}
+
+static void simStep(RomiSimState *sim, double dt)
+{
+    double openMv    = SIM_VNOM_MV - (SIM_VNOM_MV - SIM_VEMPTY_MV) * sim->chargeUsed / SIM_CAPACITY_MAS;
+    double scale     = sim->batteryMv / SIM_VNOM_MV;
+    double currentMa = SIM_IDLE_MA;
+    double drive;
+    double target;
+    int    i;
+
+    sim->sampleS += dt;
+    if (sim->sampleS >= SIM_SAMPLE_PERIOD - 1e-9)
+    {
+        sim->sampleS -= SIM_SAMPLE_PERIOD;
+        romiVelocitySample(&sim->velocity, simRawCount(sim, 0), simRawCount(sim, 1), simMicros(sim));
+
+        if (sim->driveMode == ROMI_DRIVE_SPEED)
+        {
+            for (i = 0; i < 2; i++)
+            {
+                sim->power[i] = romiSpeedStep(&sim->speedLoop[i], sim->target[i], simRawCount(sim, i));
+            }
+        }
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        drive  = scale * sim->power[i] / SIM_MAX_POWER;
+        target = drive * SIM_NOLOAD_SPEED;
+
+        sim->speed[i] += (target - sim->speed[i]) * dt / SIM_TAU;
+        sim->position[i] += sim->speed[i] * dt;
+
+        /* current follows the gap between applied voltage and back EMF */
+        drive -= sim->speed[i] / SIM_NOLOAD_SPEED;
+        currentMa += SIM_STALL_MA * (drive < 0 ? -drive : drive);
+    }
+
+    sim->timeS += dt;
+    sim->chargeUsed += currentMa * dt;
+    if (openMv < SIM_VEMPTY_MV)
+    {
+        openMv = SIM_VEMPTY_MV;
+    }
+    sim->batteryMv = openMv - SIM_RINT_OHM * currentMa;
+}
+
+static void simAdvance(RomiSimState *sim, double seconds)
+{
+    double dt;
+
+    while (seconds > 0)
+    {
+        dt = seconds < SIM_MAX_STEP ? seconds : SIM_MAX_STEP;
+        simStep(sim, dt);
+        seconds -= dt;
+    }
+
+    simUpdateRegisters(sim);
+}
+
+void romiSimAdvance(double seconds)
+{
+    int i;
+
+    for (i = 0; i < ROMI_MAX_DEVICES; i++)
+    {
+        if (sims[i].inUse)
+        {
+            simAdvance(&sims[i], seconds);
+        }
+    }
+}
+
+static void simSyncClock(RomiSimState *sim)
+{
+    struct timespec now;
+    double          elapsed;
+
+    if (!simUseWallClock)
+    {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (sim->clockValid)
+    {
+        elapsed = (now.tv_sec - sim->last.tv_sec) + (now.tv_nsec - sim->last.tv_nsec) * 1e-9;
+        simAdvance(sim, elapsed < SIM_MAX_CATCHUP ? elapsed : SIM_MAX_CATCHUP);
+    }
+    sim->last       = now;
+    sim->clockValid = 1;
+}
+
+/* Power on state, keeping the bus and address */
+static void simResetOne(RomiSimState *sim)
+{
+    int busNumber = sim->busNumber;
+    int addr      = sim->addr;
+
+    memset(sim, 0, sizeof(*sim));
+    sim->inUse     = 1;
+    sim->busNumber = busNumber;
+    sim->addr      = addr;
+    sim->batteryMv = SIM_VNOM_MV - SIM_RINT_OHM * SIM_IDLE_MA;
+    simUpdateRegisters(sim);
+}
+
+void romiSimReset(void)
+{
+    int i;
+
+    for (i = 0; i < ROMI_MAX_DEVICES; i++)
+    {
+        if (sims[i].inUse)
+        {
+            simResetOne(&sims[i]);
+        }
+    }
+}
+
+void romiSimUseWallClock(int enable)
+{
+    int i;
+
+    simUseWallClock = enable;
+    for (i = 0; i < ROMI_MAX_DEVICES; i++)
+    {
+        sims[i].clockValid = 0;
+    }
+}
+
+void romiSimSetMinReadDelay(int delayUs)
+{
+    simMinReadDelay = delayUs;
+}
+
+void romiSimSetOffline(int offline)
+{
+    simOffline = offline;
+}
+
+static RomiSimState *simFromHandle(int handle)
+{
+    int i = handle - SIM_HANDLE;
+
+    if (i < 0 || i >= ROMI_MAX_DEVICES || !sims[i].inUse)
+    {
+        return NULL;
+    }
+    return &sims[i];
+}
+
+/* A Romi answers at any valid 7 bit address, one per bus and address.  Like
+   a power cycled board, a reopened one starts from rest. */
+static int simOpen(int busNumber, int addr)
+{
+    int slot = -1;
+    int i;
+
+    if (addr < 0x08 || addr > 0x77)
+    {
+        return ROMIMOT_I2C_ADDR_ERR_EID;
+    }
+
+    for (i = ROMI_MAX_DEVICES - 1; i >= 0; i--)
+    {
+        if (sims[i].inUse && sims[i].busNumber == busNumber && sims[i].addr == addr)
+        {
+            slot = i;
+            break;
+        }
+        if (!sims[i].inUse)
+        {
+            slot = i;
+        }
+    }
+    if (slot < 0)
+    {
+        return ROMIMOT_I2C_DEV_FD_ERR_EID;
+    }
+
+    sims[slot].busNumber = busNumber;
+    sims[slot].addr      = addr;
+    simResetOne(&sims[slot]);
+    return SIM_HANDLE + slot;
+}
+
+static void simClose(int handle)
+{
+    RomiSimState *sim = simFromHandle(handle);
+
+    if (sim != NULL)
+    {
+        sim->inUse = 0;
+    }
+}
+
+static int simReadReg(int handle, uint8_t addr, uint8_t *buf, uint8_t len, int delayUs)
+{
+    RomiSimState *sim = simFromHandle(handle);
+    int           i;
+
+    if (sim == NULL)
+    {
+        return ROMIMOT_I2C_SETUP_WR_ERR_EID;
+    }
+    if (addr + len > SIM_REG_LEN || simOffline)
+    {
+        return ROMIMOT_I2C_DAT_R_ERR_EID;
+    }
+
+    simSyncClock(sim);
+
+    /* like the 32u4, a slave read before it is ready still acknowledges and
+       sends what it staged for the read before, from where that one started;
+       past the end of the buffer the bus floats high */
+    if (delayUs < simMinReadDelay)
+    {
+        for (i = 0; i < len; i++)
+        {
+            buf[i] = sim->stagedAddr + i < SIM_REG_LEN ? sim->staged[sim->stagedAddr + i] : 0xFF;
+        }
+        return 0;
+    }
+
+    memcpy(sim->staged, sim->regs, sizeof(sim->staged));
+    sim->stagedAddr = addr;
+    memcpy(buf, &sim->regs[addr], len);
+    return 0;
+}
+
+static int simWrite(int handle, const uint8_t *buf, uint8_t len)
+{
+    RomiSimState *sim = simFromHandle(handle);
+
+    if (sim == NULL || len < 1 || buf[0] + len - 1 > SIM_REG_LEN || simOffline)
+    {
+        return ROMIMOT_I2C_DAT_W_ERR_EID;
+    }
+
+    simSyncClock(sim);
+    memcpy(&sim->regs[buf[0]], &buf[1], len - 1);
+    simUpdateRegisters(sim);
+    return 0;
+}
+
+const RomiBackend romiBackendSim = {"sim", simOpen, simClose, simReadReg, simWrite};
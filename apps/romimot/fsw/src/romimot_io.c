@@ -0,0 +1,780 @@
+/**
+ * @file
+ *
+ * ROMIMOT I/O child task.  All I2C traffic to the Romis runs here so that a
+ * slow or failing bus transaction never delays the command pipe on the
+ * main task.  Each control cycle serves the enabled devices in turn, so a
+ * cycle lasts about as long as one device's bus traffic times their number.
+ */
+
+#include "romimot_events.h"
+#include "romimot.h"
+#include "romimot_table.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if ROMIMOT_MAX_DEVICES > ROMI_MAX_DEVICES
+#error ROMIMOT_MAX_DEVICES is more than the Romi backends can hold open
+#endif
+
+/*
+** global data
+*/
+extern ROMIMOT_Data_t ROMIMOT_Data;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Bus timing hook, runs on the I/O task after every Romi register access     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_BusTiming(int Op, uint32_t ElapsedUs, int Status)
+{
+    if (ROMIMOT_Data.IoDevice != NULL)
+    {
+        ROMIMOT_BusStatsRecord(&ROMIMOT_Data.IoDevice->BusStats, Op, ElapsedUs, Status);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Reset one device context, before the I/O task starts                       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_IoInitDevice(ROMIMOT_Device_t *Dev)
+{
+    int Range;
+
+    ROMIMOT_DblBuf_Init(&Dev->SensorBuf);
+    ROMIMOT_DblBuf_Init(&Dev->ControlBuf);
+    ROMIMOT_DblBuf_Init(&Dev->ProfileBuf);
+    ROMIMOT_TraceInit(&Dev->Trace);
+    ROMIMOT_PathInit(&Dev->Path);
+    ROMIMOT_BusStatsReset(&Dev->BusStats);
+    memset(&Dev->ReadCal, 0, sizeof(Dev->ReadCal));
+    memset(&Dev->ReadBackoff, 0, sizeof(Dev->ReadBackoff));
+    ROMIMOT_BusRecoveryReset(&Dev->BusRecovery);
+    memset(Dev->SensorSlots, 0, sizeof(Dev->SensorSlots));
+    memset(Dev->ControlSlots, 0, sizeof(Dev->ControlSlots));
+    memset(Dev->ProfileSlots, 0, sizeof(Dev->ProfileSlots));
+    memset(&Dev->IoSensor, 0, sizeof(Dev->IoSensor));
+    memset(&Dev->IoCmd, 0, sizeof(Dev->IoCmd));
+    memset(&Dev->IoProfile, 0, sizeof(Dev->IoProfile));
+    memset(&Dev->IoPathProfile, 0, sizeof(Dev->IoPathProfile));
+    Dev->StateTlm.Payload.SampleCount = 0;
+    Dev->StateBaseUs                  = 0;
+    Dev->SensorCount      = 0;
+    Dev->ControlCount     = 0;
+    Dev->ProfileCount     = 0;
+    Dev->I2CConnectReq    = false;
+    Dev->StatsResetReq    = false;
+    Dev->BusStatsResetReq = false;
+    Dev->DiagReq          = false;
+    Dev->ReadCalReq       = false;
+    Dev->ReadCalDone      = false;
+    Dev->PathClearReq     = false;
+    Dev->LastWakeUs       = 0;
+
+    for (Range = 0; Range < ROMIMOT_READ_RANGES; Range++)
+    {
+        Dev->IoReadDelayUs[Range]  = romiGetReadDelay(Range);
+        Dev->BusReadDelayUs[Range] = Dev->IoReadDelayUs[Range];
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Create the wakeup semaphore and spawn the I/O child task                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_StartIoTask(void)
+{
+    int32 status;
+    int   i;
+
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        ROMIMOT_IoInitDevice(&ROMIMOT_Data.Device[i]);
+    }
+    ROMIMOT_Data.IoBusy        = false;
+    ROMIMOT_Data.IoOverruns    = 0;
+    ROMIMOT_Data.WakeTimeUs    = 0;
+    ROMIMOT_Data.IoDevice      = NULL;
+    ROMIMOT_Data.ControlMode   = ROMIMOT_CONTROL_MODE_WAKEUP;
+    ROMIMOT_Data.ControlRateHz = 0;
+
+    /* every bus operation is timed, all of them run on the I/O task */
+    romiSetTimingHook(ROMIMOT_BusTiming);
+
+    if (romiLogInit() != 0)
+    {
+        CFE_ES_WriteToSysLog("ROMI Motor Driver App: Error creating bus log lock\n");
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    status = OS_BinSemCreate(&ROMIMOT_Data.IoWakeSem, ROMIMOT_IO_TASK_NAME, OS_SEM_EMPTY, 0);
+    if (status != OS_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("ROMI Motor Driver App: Error creating I/O semaphore, RC = %ld\n", (long)status);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    status = CFE_ES_CreateChildTask(&ROMIMOT_Data.IoTaskId, ROMIMOT_IO_TASK_NAME, ROMIMOT_IoTaskMain,
+                                    CFE_ES_TASK_STACK_ALLOCATE, ROMIMOT_IO_TASK_STACK_SIZE, ROMIMOT_IO_TASK_PRIORITY,
+                                    0);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("ROMI Motor Driver App: Error creating I/O task, RC = 0x%08lX\n", (unsigned long)status);
+        return status;
+    }
+
+    /*
+    ** Dedicated timebase for the control loop timer, left stopped until
+    ** the table selects ROMIMOT_CONTROL_MODE_TIMER
+    */
+    status = OS_TimeBaseCreate(&ROMIMOT_Data.TimeBaseId, ROMIMOT_TIMEBASE_NAME, NULL);
+    if (status != OS_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("ROMI Motor Driver App: Error creating timebase, RC = %ld\n", (long)status);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    status = OS_TimerAdd(&ROMIMOT_Data.TimerId, ROMIMOT_TIMER_NAME, ROMIMOT_Data.TimeBaseId, ROMIMOT_TimerCallback,
+                         NULL);
+    if (status != OS_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("ROMI Motor Driver App: Error adding control timer, RC = %ld\n", (long)status);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* I/O child task entry point, runs one bus cycle per wakeup                  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_IoTaskMain(void)
+{
+    ROMIMOT_ApplyRtProfile("I/O", &ROMIMOT_Data.IoRtProfile, &ROMIMOT_Data.IoRtStatus);
+
+    while (ROMIMOT_Data.RunStatus == CFE_ES_RunStatus_APP_RUN)
+    {
+        if (OS_BinSemTake(ROMIMOT_Data.IoWakeSem) != OS_SUCCESS)
+        {
+            break;
+        }
+
+        ROMIMOT_IoCycle();
+    }
+
+    CFE_ES_ExitChildTask();
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Accumulate wakeup latency and period for housekeeping                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_UpdateLoopStats(ROMIMOT_Device_t *Dev, ROMIMOT_LoopStats_t *Stats, int64 WakeUs, int64 ActuatedUs)
+{
+    uint32 LatencyUs = ActuatedUs - WakeUs;
+    uint32 PeriodUs;
+
+    if (Dev->LastWakeUs != 0 && WakeUs != Dev->LastWakeUs)
+    {
+        PeriodUs = WakeUs - Dev->LastWakeUs;
+        if (Stats->PeriodMaxUs == 0 || PeriodUs < Stats->PeriodMinUs)
+        {
+            Stats->PeriodMinUs = PeriodUs;
+        }
+        if (PeriodUs > Stats->PeriodMaxUs)
+        {
+            Stats->PeriodMaxUs = PeriodUs;
+        }
+    }
+    Dev->LastWakeUs = WakeUs;
+
+    Stats->Cycles++;
+    Stats->LatencySumUs += LatencyUs;
+    if (LatencyUs > Stats->LatencyMaxUs)
+    {
+        Stats->LatencyMaxUs = LatencyUs;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Append this cycle to the trace ring                                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_TraceCycle(ROMIMOT_Device_t *Dev, const ROMIMOT_SensorState_t *Sensor, int64 WakeUs, int32 Status)
+{
+    ROMIMOT_TraceSample_t Sample;
+
+    Sample.TimeUs            = WakeUs;
+    Sample.Cycle             = Sensor->Sequence + 1;
+    Sample.Status            = Status;
+    Sample.LeftSetpoint      = Sensor->Ctl.LeftOdoStep;
+    Sample.RightSetpoint     = Sensor->Ctl.RightOdoStep;
+    Sample.LeftOdo           = Sensor->Ctl.LeftOdo;
+    Sample.RightOdo          = Sensor->Ctl.RightOdo;
+    Sample.LeftMotSpeed      = Sensor->Ctl.LeftMotSpeed;
+    Sample.RightMotSpeed     = Sensor->Ctl.RightMotSpeed;
+    Sample.BatteryMillivolts = Sensor->Romi.batteryMillivolts;
+    Sample.Spare             = 0;
+
+    ROMIMOT_TraceRecord(&Dev->Trace, &Sample);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Add this cycle to the state packet, sending it once the batch is full      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_StateCycle(ROMIMOT_Device_t *Dev, const ROMIMOT_SensorState_t *Sensor, int64 WakeUs)
+{
+    ROMIMOT_StateBatchTlm_t *    Tlm   = &Dev->StateTlm;
+    ROMIMOT_StateBatchPayload_t *Batch = &Tlm->Payload;
+    ROMIMOT_StateSample_t *      Sample;
+
+    if (Batch->SampleCount == 0)
+    {
+        Batch->FirstCycle = Sensor->Sequence + 1;
+        Dev->StateBaseUs  = WakeUs;
+        CFE_MSG_SetMsgTime(CFE_MSG_PTR(Tlm->TelemetryHeader), CFE_TIME_GetTime());
+    }
+
+    Sample                     = &Batch->Samples[Batch->SampleCount++];
+    Sample->TimeOffsetUs       = WakeUs - Dev->StateBaseUs;
+    Sample->LeftPower          = Sensor->Ctl.LeftMotSpeed;
+    Sample->RightPower         = Sensor->Ctl.RightMotSpeed;
+    Sample->LeftEncoderDelta   = Sensor->Ctl.LeftEncoderDelta;
+    Sample->RightEncoderDelta  = Sensor->Ctl.RightEncoderDelta;
+    Sample->LeftMotorOdometer  = Sensor->Ctl.LeftOdo;
+    Sample->RightMotorOdometer = Sensor->Ctl.RightOdo;
+    Sample->RomiMicros         = Sensor->Romi.micros;
+    Sample->LeftVelocity       = Sensor->Ctl.LeftVelocity;
+    Sample->RightVelocity      = Sensor->Ctl.RightVelocity;
+    Sample->VelocityAgeUs      = Sensor->Romi.velocityAgeUs;
+    Sample->RomiSequence       = Sensor->Romi.sequence;
+
+    Batch->MotorsEnabled = Dev->IoCmd.MotorsEnabled;
+    Batch->Instance      = Dev->Instance;
+
+    /* a smaller batch size from a table update takes effect here too */
+    if (Batch->SampleCount >= Dev->IoCmd.StateBatchSize || Batch->SampleCount >= ROMIMOT_STATE_BATCH_MAX)
+    {
+        CFE_MSG_SetSize(CFE_MSG_PTR(Tlm->TelemetryHeader),
+                        offsetof(ROMIMOT_StateBatchTlm_t, Payload.Samples) +
+                            Batch->SampleCount * sizeof(ROMIMOT_StateSample_t));
+        CFE_SB_TransmitMsg(CFE_MSG_PTR(Tlm->TelemetryHeader), true);
+        Batch->SampleCount = 0;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Apply read delays published by the main task                               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_ApplyReadDelays(ROMIMOT_Device_t *Dev, const ROMIMOT_ControlCmd_t *Cmd)
+{
+    int Range;
+
+    /* only ranges the table changed, so a snapshot back-off survives
+       unrelated commands */
+    for (Range = 0; Range < ROMIMOT_READ_RANGES; Range++)
+    {
+        if (Cmd->ReadDelayUs[Range] != Dev->IoReadDelayUs[Range])
+        {
+            Dev->IoReadDelayUs[Range]  = Cmd->ReadDelayUs[Range];
+            Dev->BusReadDelayUs[Range] = Cmd->ReadDelayUs[Range];
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Lengthen the snapshot read delay when bad reads cluster                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_ReadBackoffCycle(ROMIMOT_Device_t *Dev, int Status)
+{
+    int DelayUs;
+
+    if (!ROMIMOT_ReadBackoffCheck(&Dev->ReadBackoff, Status))
+    {
+        return;
+    }
+
+    DelayUs = Dev->BusReadDelayUs[ROMI_READ_RANGE_SNAPSHOT];
+    if (DelayUs >= ROMIMOT_READ_DELAY_MAX_US)
+    {
+        return;
+    }
+
+    DelayUs += ROMIMOT_READ_BACKOFF_STEP_US;
+    if (DelayUs > ROMIMOT_READ_DELAY_MAX_US)
+    {
+        DelayUs = ROMIMOT_READ_DELAY_MAX_US;
+    }
+    Dev->BusReadDelayUs[ROMI_READ_RANGE_SNAPSHOT] = DelayUs;
+    romiSetReadDelay(ROMI_READ_RANGE_SNAPSHOT, DelayUs);
+
+    CFE_EVS_SendEvent(ROMIMOT_READCAL_ERR_EID, CFE_EVS_EventType_ERROR,
+                      "ROMIMOT: Romi %u bad snapshot reads, delay backed off to %d us", (unsigned int)Dev->Instance,
+                      DelayUs);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Run this cycle's calibration trial reads                                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_ReadCalCycle(ROMIMOT_Device_t *Dev)
+{
+    ROMIMOT_ReadCal_t *Cal = &Dev->ReadCal;
+    int                Range;
+    int                SavedUs;
+    int                Status;
+    int                Trial;
+
+    for (Trial = 0; Trial < ROMIMOT_READ_CAL_PER_CYCLE && Cal->Active; Trial++)
+    {
+        Range   = Cal->Range;
+        SavedUs = romiGetReadDelay(Range);
+
+        /* the loop's own reads keep the delay in use */
+        romiSetReadDelay(Range, Cal->DelayUs);
+        Status = romiRangeRead(Dev->i2cfd, Range, ROMIMOT_READ_DELAY_MAX_US);
+        romiSetReadDelay(Range, SavedUs);
+
+        if (ROMIMOT_ReadCalRecord(Cal, Status))
+        {
+            CFE_EVS_SendEvent(ROMIMOT_READCAL_INF_EID, CFE_EVS_EventType_INFORMATION,
+                              "ROMIMOT: Romi %u read range %d settled at %u us, %u/%d failures before",
+                              (unsigned int)Dev->Instance, Range, (unsigned int)Cal->ResultUs[Range],
+                              (unsigned int)Cal->RejectFailures[Range], ROMIMOT_READ_CAL_TRIALS);
+        }
+    }
+
+    if (!Cal->Active)
+    {
+        /* in use straight away, the main task then stores them in the table */
+        for (Range = 0; Range < ROMIMOT_READ_RANGES; Range++)
+        {
+            Dev->IoReadDelayUs[Range]  = Cal->ResultUs[Range];
+            Dev->BusReadDelayUs[Range] = Cal->ResultUs[Range];
+            romiSetReadDelay(Range, Cal->ResultUs[Range]);
+        }
+        __atomic_store_n(&Dev->ReadCalDone, true, __ATOMIC_RELEASE);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Report that the recovery closed the bus                                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_ReportBusDown(const ROMIMOT_Device_t *Dev)
+{
+    const ROMIMOT_BusRecovery_t *Recovery = &Dev->BusRecovery;
+
+    if (Recovery->State == ROMIMOT_BUS_STATE_REOPEN)
+    {
+        CFE_EVS_SendEvent(ROMIMOT_BUS_RECOVERY_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u I2C bus down, reopen %u of %d in %lu ms", (unsigned int)Dev->Instance,
+                          (unsigned int)Recovery->Attempts, ROMIMOT_BUS_REOPEN_ATTEMPTS,
+                          (unsigned long)(Recovery->BackoffUs / 1000));
+    }
+    else
+    {
+        CFE_EVS_SendEvent(ROMIMOT_BUS_RECOVERY_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Romi %u I2C bus given up after %d reopens, motors stopped until the next command",
+                          (unsigned int)Dev->Instance, ROMIMOT_BUS_REOPEN_ATTEMPTS);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Reopen the bus once the recovery wait is over                              */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_ReopenBus(ROMIMOT_Device_t *Dev, int64 WakeUs)
+{
+    ROMIMOT_BusRecovery_t *Recovery = &Dev->BusRecovery;
+
+    Recovery->Reopens++;
+    if (ROMIMOT_ConnectI2C(Dev) == CFE_SUCCESS)
+    {
+        ROMIMOT_BusRecoveryOpened(Recovery);
+        return;
+    }
+
+    ROMIMOT_BusRecoveryOpenFailed(Recovery, WakeUs);
+    ROMIMOT_ReportBusDown(Dev);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Feed this cycle's bus status to the recovery, closing the bus if it asks   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_RecoveryCycle(ROMIMOT_Device_t *Dev, int Status, int64 WakeUs)
+{
+    ROMIMOT_BusRecovery_t *Recovery = &Dev->BusRecovery;
+    uint16                 Attempts = Recovery->Attempts;
+
+    ROMIMOT_BusRecoveryCycle(Recovery, Status, WakeUs);
+
+    if (Recovery->State == ROMIMOT_BUS_STATE_OK && Attempts > 0)
+    {
+        /* errors from the next fault are worth reporting again */
+        CFE_EVS_ResetFilter(ROMIMOT_I2C_ERR_EID);
+        CFE_EVS_SendEvent(ROMIMOT_BUS_RECOVERY_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "ROMIMOT: Romi %u I2C bus recovered after %u reopens", (unsigned int)Dev->Instance,
+                          (unsigned int)Attempts);
+    }
+    else if (Recovery->State == ROMIMOT_BUS_STATE_REOPEN || Recovery->State == ROMIMOT_BUS_STATE_CLOSED)
+    {
+        romiClose(Dev->i2cfd);
+        Dev->i2c_open = false;
+        ROMIMOT_ReportBusDown(Dev);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Stop and close the bus of a device the table disabled                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_IoDeviceOff(ROMIMOT_Device_t *Dev)
+{
+    if (!Dev->i2c_open)
+    {
+        return;
+    }
+
+    romiDriveWrite(Dev->i2cfd, ROMI_DRIVE_POWER, 0, 0);
+    romiClose(Dev->i2cfd);
+    Dev->i2c_open = false;
+    ROMIMOT_BusRecoveryReset(&Dev->BusRecovery);
+
+    CFE_EVS_SendEvent(ROMIMOT_I2C_INF_EID, CFE_EVS_EventType_INFORMATION, "ROMIMOT: Romi %u disabled, bus closed",
+                      (unsigned int)Dev->Instance);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* One device's turn: read the Romi, run the control law, write the motors    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static void ROMIMOT_IoDeviceCycle(ROMIMOT_Device_t *Dev, int64 WakeUs)
+{
+    ROMIMOT_SensorState_t *  Sensor = &Dev->IoSensor;
+    ROMIMOT_ControlCmd_t     Cmd;
+    const ROMIMOT_Profile_t *Profile;
+    int                      i2c_ret;
+    int                      Range;
+    bool                     ConnectReq;
+    bool                     Stale;
+    uint16                   PrevSequence;
+    int64                    ActuatedUs;
+
+    if (__atomic_exchange_n(&Dev->StatsResetReq, false, __ATOMIC_ACQ_REL))
+    {
+        memset(&Sensor->Stats, 0, sizeof(Sensor->Stats));
+    }
+
+    if (__atomic_exchange_n(&Dev->BusStatsResetReq, false, __ATOMIC_ACQ_REL))
+    {
+        ROMIMOT_BusStatsReset(&Dev->BusStats);
+        Dev->BusRecovery.Reopens = 0;
+        Dev->I2CErrCounter       = 0;
+    }
+
+    /* commands reopen a bus the recovery gave up on, but do not cut its
+       wait short while it is still trying */
+    ConnectReq = __atomic_exchange_n(&Dev->I2CConnectReq, false, __ATOMIC_ACQ_REL);
+    if (ConnectReq && Dev->BusRecovery.State == ROMIMOT_BUS_STATE_CLOSED && !Dev->i2c_open)
+    {
+        if (ROMIMOT_ConnectI2C(Dev) == CFE_SUCCESS)
+        {
+            ROMIMOT_BusRecoveryOpened(&Dev->BusRecovery);
+        }
+    }
+    else if (ROMIMOT_BusRecoveryDue(&Dev->BusRecovery, WakeUs))
+    {
+        ROMIMOT_ReopenBus(Dev, WakeUs);
+    }
+
+    if (ROMIMOT_DblBuf_Read(&Dev->ControlBuf, Dev->ControlSlots, sizeof(Dev->IoCmd), &Dev->IoCmd,
+                            &Dev->ControlCount))
+    {
+        ROMIMOT_ApplyReadDelays(Dev, &Dev->IoCmd);
+    }
+
+    if (__atomic_exchange_n(&Dev->ReadCalReq, false, __ATOMIC_ACQ_REL))
+    {
+        ROMIMOT_ReadCalStart(&Dev->ReadCal, Dev->ReadCalMarginUs);
+    }
+
+    /* a cleared path stops where the intermediate targets are */
+    if (__atomic_exchange_n(&Dev->PathClearReq, false, __ATOMIC_ACQ_REL))
+    {
+        ROMIMOT_PathFlush(&Dev->Path);
+        ROMIMOT_ControlPathStop(&Sensor->Ctl, &Dev->IoCmd);
+    }
+
+    /* profiles are only copied when a command refers to a new one */
+    if (Dev->IoCmd.ProfileSeq != Dev->IoProfile.Seq)
+    {
+        ROMIMOT_DblBuf_Read(&Dev->ProfileBuf, Dev->ProfileSlots, sizeof(Dev->IoProfile), &Dev->IoProfile,
+                            &Dev->ProfileCount);
+    }
+
+    /* the driver's delays are shared, this device's go in for its turn */
+    for (Range = 0; Range < ROMIMOT_READ_RANGES; Range++)
+    {
+        romiSetReadDelay(Range, Dev->BusReadDelayUs[Range]);
+    }
+
+    if (Dev->i2c_open)
+    {
+        PrevSequence   = Sensor->Romi.sequence;
+        Sensor->Status = romiSnapshotRead(Dev->i2cfd, &Sensor->Romi);
+        ROMIMOT_CheckI2CTransaction(Dev, Sensor->Status);
+
+        /* a sample the firmware already gave us is dropped, the control
+           step then runs on the odometry it had */
+        Stale = Sensor->Status == 0 && Sensor->Romi.sequence == PrevSequence;
+        if (Stale)
+        {
+            Sensor->Stats.StaleSamples++;
+        }
+
+        /* a repeat is also what a slave read too early sends back */
+        if (!Dev->ReadCal.Active)
+        {
+            ROMIMOT_ReadBackoffCycle(Dev, Stale ? ROMIMOT_I2C_DAT_BAD_ERR_EID : Sensor->Status);
+        }
+        if (Sensor->Status == 0 && !Stale)
+        {
+            ROMIMOT_UpdateOdometry(&Sensor->Ctl, &Sensor->Romi);
+        }
+        else
+        {
+            /* nothing new was measured, the next fresh sample carries the motion */
+            Sensor->Ctl.LeftEncoderDelta  = 0;
+            Sensor->Ctl.RightEncoderDelta = 0;
+        }
+
+        Sensor->Ctl.PeriodUs = Dev->LastWakeUs != 0 ? WakeUs - Dev->LastWakeUs : 0;
+
+        /* a failing bus gets zero power written until it reads cleanly */
+        if (ROMIMOT_BusRecoveryHolding(&Dev->BusRecovery))
+        {
+            ROMIMOT_ControlHold(&Sensor->Ctl);
+        }
+        else if (!ROMIMOT_ControlStream(&Sensor->Ctl, &Dev->IoCmd))
+        {
+            Cmd     = Dev->IoCmd;
+            Profile = ROMIMOT_ControlPath(&Sensor->Ctl, &Cmd, &Dev->IoProfile, &Dev->Path, &Dev->IoPathProfile);
+            ROMIMOT_ControlStep(&Sensor->Ctl, &Cmd, Profile);
+        }
+
+        /* once held, a bus that just failed the read is not written too, so
+           a failing cycle costs one transfer; the zero power goes out with
+           the first read that succeeds */
+        if (Sensor->Status != 0 && Dev->BusRecovery.State == ROMIMOT_BUS_STATE_RETRY)
+        {
+            i2c_ret = 0;
+        }
+        else
+        {
+            i2c_ret = romiDriveWrite(Dev->i2cfd,
+                                     Dev->IoCmd.DriveMode == ROMIMOT_DRIVE_MODE_SPEED ? ROMI_DRIVE_SPEED
+                                                                                      : ROMI_DRIVE_POWER,
+                                     Sensor->Ctl.LeftMotSpeed, Sensor->Ctl.RightMotSpeed);
+            ROMIMOT_CheckI2CTransaction(Dev, i2c_ret);
+        }
+        ActuatedUs = ROMIMOT_GetTimeUs();
+
+        ROMIMOT_TraceCycle(Dev, Sensor, WakeUs, Sensor->Status != 0 ? Sensor->Status : i2c_ret);
+        ROMIMOT_StateCycle(Dev, Sensor, WakeUs);
+
+        /* latency ends at the motor write, the telemetry after it is not counted */
+        ROMIMOT_UpdateLoopStats(Dev, &Sensor->Stats, WakeUs, ActuatedUs);
+
+        /* trials go after the motor write so they never delay it */
+        if (Dev->ReadCal.Active && !ROMIMOT_BusRecoveryHolding(&Dev->BusRecovery))
+        {
+            ROMIMOT_ReadCalCycle(Dev);
+        }
+
+        ROMIMOT_RecoveryCycle(Dev, Sensor->Status != 0 ? Sensor->Status : i2c_ret, WakeUs);
+    }
+
+    Sensor->I2COpen         = Dev->i2c_open;
+    Sensor->ReadCalActive   = Dev->ReadCal.Active;
+    Sensor->SnapshotDelayUs = Dev->BusReadDelayUs[ROMI_READ_RANGE_SNAPSHOT];
+    Sensor->BusState        = Dev->BusRecovery.State;
+    Sensor->BusReopens      = Dev->BusRecovery.Reopens;
+    Sensor->Sequence++;
+
+    ROMIMOT_DblBuf_Write(&Dev->SensorBuf, Dev->SensorSlots, sizeof(*Sensor), Sensor);
+
+    /* the statistics belong to this task, so it answers ROMIMOT_SEND_DIAG_CC */
+    if (__atomic_exchange_n(&Dev->DiagReq, false, __ATOMIC_ACQ_REL))
+    {
+        ROMIMOT_BusStatsReport(&Dev->BusStats, &Dev->DiagTlm.Payload);
+        Dev->DiagTlm.Payload.Instance = Dev->Instance;
+        CFE_SB_TimeStampMsg(CFE_MSG_PTR(Dev->DiagTlm.TelemetryHeader));
+        CFE_SB_TransmitMsg(CFE_MSG_PTR(Dev->DiagTlm.TelemetryHeader), true);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* One control cycle, every enabled device in turn                            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_IoCycle(void)
+{
+    ROMIMOT_Device_t *Dev;
+    int64             WakeUs = __atomic_load_n(&ROMIMOT_Data.WakeTimeUs, __ATOMIC_ACQUIRE);
+    int               i;
+
+    __atomic_store_n(&ROMIMOT_Data.IoBusy, true, __ATOMIC_RELEASE);
+
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        Dev                   = &ROMIMOT_Data.Device[i];
+        ROMIMOT_Data.IoDevice = Dev;
+
+        if (__atomic_load_n(&Dev->Enabled, __ATOMIC_ACQUIRE))
+        {
+            ROMIMOT_IoDeviceCycle(Dev, WakeUs);
+        }
+        else
+        {
+            ROMIMOT_IoDeviceOff(Dev);
+        }
+    }
+    ROMIMOT_Data.IoDevice = NULL;
+
+    __atomic_store_n(&ROMIMOT_Data.IoBusy, false, __ATOMIC_RELEASE);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Release the I/O task for one control cycle                                 */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_TriggerIo(void)
+{
+    if (__atomic_load_n(&ROMIMOT_Data.IoBusy, __ATOMIC_ACQUIRE))
+    {
+        __atomic_add_fetch(&ROMIMOT_Data.IoOverruns, 1, __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&ROMIMOT_Data.WakeTimeUs, ROMIMOT_GetTimeUs(), __ATOMIC_RELEASE);
+    OS_BinSemGive(ROMIMOT_Data.IoWakeSem);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Control timer tick, runs in the OSAL timebase context                      */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_TimerCallback(osal_id_t TimerId, void *Arg)
+{
+    ROMIMOT_TriggerIo();
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Start, retune or stop the control timer                                    */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 ROMIMOT_ConfigureControl(uint16 Mode, uint16 RateHz)
+{
+    int32  status;
+    uint32 PeriodUs;
+    int    i;
+
+    if (Mode == ROMIMOT_Data.ControlMode &&
+        (Mode != ROMIMOT_CONTROL_MODE_TIMER || RateHz == ROMIMOT_Data.ControlRateHz))
+    {
+        return CFE_SUCCESS;
+    }
+
+    if (Mode == ROMIMOT_CONTROL_MODE_TIMER)
+    {
+        PeriodUs = 1000000 / RateHz;
+
+        status = OS_TimerSet(ROMIMOT_Data.TimerId, PeriodUs, PeriodUs);
+        if (status == OS_SUCCESS)
+        {
+            status = OS_TimeBaseSet(ROMIMOT_Data.TimeBaseId, PeriodUs, PeriodUs);
+        }
+    }
+    else
+    {
+        status = OS_TimeBaseSet(ROMIMOT_Data.TimeBaseId, 0, 0);
+    }
+
+    if (status != OS_SUCCESS)
+    {
+        CFE_EVS_SendEvent(ROMIMOT_CONTROL_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "ROMIMOT: Control timer setup failed for %u Hz, RC = %ld", (unsigned int)RateHz,
+                          (long)status);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    ROMIMOT_Data.ControlMode   = Mode;
+    ROMIMOT_Data.ControlRateHz = RateHz;
+    for (i = 0; i < ROMIMOT_MAX_DEVICES; i++)
+    {
+        ROMIMOT_Data.Device[i].LastWakeUs = 0;
+    }
+
+    if (Mode == ROMIMOT_CONTROL_MODE_TIMER)
+    {
+        CFE_EVS_SendEvent(ROMIMOT_CONTROL_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "ROMIMOT: Control loop on timer at %u Hz", (unsigned int)RateHz);
+    }
+    else
+    {
+        CFE_EVS_SendEvent(ROMIMOT_CONTROL_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "ROMIMOT: Control loop on wakeup");
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Local time in microseconds, for loop timing only                           */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int64 ROMIMOT_GetTimeUs(void)
+{
+    OS_time_t Now;
+
+    OS_GetLocalTime(&Now);
+
+    return OS_TimeGetTotalMicroseconds(Now);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Ask the I/O task to open a device's bus on its next cycle                  */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void ROMIMOT_RequestI2C(ROMIMOT_Device_t *Dev)
+{
+    __atomic_store_n(&Dev->I2CConnectReq, true, __ATOMIC_RELEASE);
+}
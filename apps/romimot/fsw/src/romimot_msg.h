@@ -25,16 +25,36 @@
 #ifndef ROMIMOT_MSG_H
 #define ROMIMOT_MSG_H
 
+#include "romimot_table.h"
+#include "romimot_state_msg.h"
+#include "romimot_drive_msg.h"
+
 /*
 ** ROMIMOT command codes
 */
 #define ROMIMOT_NOOP_CC             0
 #define ROMIMOT_RESET_COUNTERS_CC   1
 #define ROMIMOT_PROCESS_CC          2
-#define ROMIMOT_MOT_ENABLE_CC       3
-#define ROMIMOT_MOT_DISABLE_CC      4
+#define ROMIMOT_MOT_ENABLE_CC       3 // uses ROMIMOT_DeviceCmd_t
+#define ROMIMOT_MOT_DISABLE_CC      4 // uses ROMIMOT_DeviceCmd_t
 #define ROMIMOT_SET_TARGET_CC       5 // uses ROMIMOT_MotCmd_t
 #define ROMIMOT_SET_TARGET_DELTA_CC 6 // uses ROMIMOT_MotCmd_t
+#define ROMIMOT_DUMP_TRACE_CC       7 // uses ROMIMOT_DumpTraceCmd_t
+#define ROMIMOT_SEND_DIAG_CC        8 // uses ROMIMOT_DeviceCmd_t
+#define ROMIMOT_CALIBRATE_READ_CC   9 // uses ROMIMOT_DeviceCmd_t
+#define ROMIMOT_SET_DRIVE_MODE_CC   10 // uses ROMIMOT_DriveModeCmd_t
+#define ROMIMOT_QUEUE_PATH_CC       11 // uses ROMIMOT_QueuePathCmd_t
+#define ROMIMOT_CLEAR_PATH_CC       12 // uses ROMIMOT_DeviceCmd_t
+
+/* ROMIMOT_SET_VELOCITY_CC 13 is in romimot_drive_msg.h, for the apps that send it */
+
+#define ROMIMOT_SEND_CMD_STATS_CC 14
+
+/*
+** ROMIMOT drive modes, who closes the wheel loop
+*/
+#define ROMIMOT_DRIVE_MODE_POWER 0 /* ROMIMOT runs the wheel PIDs and writes motor powers */
+#define ROMIMOT_DRIVE_MODE_SPEED 1 /* The Romi firmware runs its speed loop, ROMIMOT writes wheel speeds */
 
 /*
 ** ROMIMOT I2C error codes
@@ -43,6 +63,25 @@
 #define ROMIMOT_I2C_SETUP_WR_ERR_EID -2
 #define ROMIMOT_I2C_DAT_R_ERR_EID    -3
 #define ROMIMOT_I2C_DAT_W_ERR_EID    -4
+#define ROMIMOT_I2C_ADDR_ERR_EID     -5
+#define ROMIMOT_I2C_DAT_BAD_ERR_EID  -6 /* Read went through but the data did not validate */
+
+/*
+** ROMIMOT bus operations timed for the diagnostic packet
+*/
+#define ROMIMOT_BUS_OP_READ          0 /* romiRead() */
+#define ROMIMOT_BUS_OP_ENCODER_READ  1 /* romiEncoderRead() */
+#define ROMIMOT_BUS_OP_SNAPSHOT_READ 2 /* romiSnapshotRead() */
+#define ROMIMOT_BUS_OP_MOTOR_WRITE   3 /* romiMotorWrite() */
+#define ROMIMOT_BUS_OP_COUNT         4
+
+/*
+** Latency histogram layout.  Bucket i counts operations that took less than
+** ROMIMOT_BUS_HIST_BASE_US << i microseconds and were not counted by a lower
+** bucket; the last bucket counts everything slower.
+*/
+#define ROMIMOT_BUS_HIST_BUCKETS 16
+#define ROMIMOT_BUS_HIST_BASE_US 16
 
 /*************************************************************************/
 
@@ -54,6 +93,16 @@ typedef struct
     CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
 } ROMIMOT_NoArgsCmd_t;
 
+/*
+** Type definition for commands to one Romi base and no other arguments
+*/
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
+    uint8                   Device;    /**< \brief Instance, index in the table's Devices */
+    uint8                   Spare;
+} ROMIMOT_DeviceCmd_t;
+
 /*
 ** Type definition for two-arg motor paramater setting commands
 */
@@ -62,8 +111,46 @@ typedef struct
     CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
     int16                   cmdMotLeft;
     int16                   cmdMotRight;
+    uint8                   Device; /**< \brief Instance, index in the table's Devices */
+    uint8                   Spare;
 } ROMIMOT_MotCmd_t;
 
+/*
+** Type definition for the trace dump command
+*/
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader;                          /**< \brief Command header */
+    char                    FileName[CFE_MISSION_MAX_PATH_LEN]; /**< \brief Empty for ROMIMOT_TRACE_FILE */
+    uint8                   Device;                             /**< \brief Instance whose trace to dump */
+    uint8                   Spare;
+} ROMIMOT_DumpTraceCmd_t;
+
+/*
+** Type definition for the drive mode command
+*/
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
+    uint8                   DriveMode; /**< \brief ROMIMOT_DRIVE_MODE_* */
+    uint8                   Device;    /**< \brief Instance, index in the table's Devices */
+} ROMIMOT_DriveModeCmd_t;
+
+/*
+** Type definition for the path queue command.  Segments[0..Count-1] are
+** appended to the device's path in order, all of them or none.
+*/
+#define ROMIMOT_PATH_CMD_MAX 8 /* Segments per ROMIMOT_QUEUE_PATH_CC */
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
+    uint8                   Device;    /**< \brief Instance, index in the table's Devices */
+    uint8                   Count;     /**< \brief Segments used, 1..ROMIMOT_PATH_CMD_MAX */
+    uint16                  Spare;
+    ROMIMOT_Segment_t       Segments[ROMIMOT_PATH_CMD_MAX];
+} ROMIMOT_QueuePathCmd_t;
+
 /*
 ** The following commands all share the "NoArgs" format
 **
@@ -74,7 +161,12 @@ typedef struct
 typedef ROMIMOT_NoArgsCmd_t ROMIMOT_NoopCmd_t;
 typedef ROMIMOT_NoArgsCmd_t ROMIMOT_ResetCountersCmd_t;
 typedef ROMIMOT_NoArgsCmd_t ROMIMOT_ProcessCmd_t;
-typedef ROMIMOT_NoArgsCmd_t ROMIMOT_SetEnableCmd_t;
+typedef ROMIMOT_NoArgsCmd_t ROMIMOT_SendCmdStatsCmd_t;
+
+typedef ROMIMOT_DeviceCmd_t ROMIMOT_SetEnableCmd_t;
+typedef ROMIMOT_DeviceCmd_t ROMIMOT_SendDiagCmd_t;
+typedef ROMIMOT_DeviceCmd_t ROMIMOT_CalibrateReadCmd_t;
+typedef ROMIMOT_DeviceCmd_t ROMIMOT_ClearPathCmd_t;
 
 typedef ROMIMOT_MotCmd_t ROMIMOT_SetTargetCmd_t;
 typedef ROMIMOT_MotCmd_t ROMIMOT_SetTargetDeltaCmd_t;
@@ -82,6 +174,9 @@ typedef ROMIMOT_MotCmd_t ROMIMOT_SetTargetDeltaCmd_t;
 /*************************************************************************/
 /*
 ** Type definition (ROMI Motor Driver App housekeeping)
+**
+** One packet per enabled Romi base, told apart by Instance.  The command
+** counters and ControlOverruns are the app's own and the same in each.
 */
 
 typedef struct __attribute__((__packed__))
@@ -90,12 +185,36 @@ typedef struct __attribute__((__packed__))
     uint8  CommandErrorCounter;
     uint8  I2CErrorCounter;
     uint8  MotorsEnabled;
-    uint8  Reserved0;
+    uint8  DriveMode; /* ROMIMOT_DRIVE_MODE_* */
     uint16 BatteryMillivolts;
-    int16  RawLeftMotorEncoder;
-    int16  RawRightMotorEncoder;
+    int32  RawLeftMotorEncoder; /* 32 bit firmware counts, wrap freely */
+    int32  RawRightMotorEncoder;
     int32  LeftMotorOdometer;
     int32  RightMotorOdometer;
+    uint8  ControlMode;
+    uint8  Instance; /* Index in the table's Devices */
+    uint16 ControlRateHz;
+    uint32 ControlCycles;   /* Control cycles since the previous HK packet */
+    uint32 ControlOverruns; /* Wakeups that found the previous cycle still running */
+    uint32 LatencyAvgUs;    /* Wakeup to motor write */
+    uint32 LatencyMaxUs;
+    uint32 PeriodJitterUs;  /* Longest minus shortest wakeup period */
+    uint32 TraceSamples;    /* Control cycles recorded in the trace */
+    uint8  TraceFrozen;     /* Trace stopped after an I2C error, waiting for a dump */
+    uint8  ReadCalActive;   /* Read delay calibration in progress */
+    uint16 SnapshotDelayUs; /* Snapshot read delay in use, after any back-off */
+    uint8  BusState;        /* ROMIMOT_BUS_STATE_* */
+    uint8  Reserved2;
+    uint16 BusReopens;      /* Bus reopens by the fault recovery */
+    uint16 PathQueued;      /* Segments waiting in the path queue */
+    uint8  PathActive;      /* A queued segment is being driven */
+    uint8  Streaming;       /* Driven by ROMIMOT_SET_VELOCITY_CC setpoints */
+    uint32 PathSegments;    /* Queued segments started since the app started */
+    uint32 StaleSamples;    /* Snapshots dropped as repeats since the previous HK packet */
+
+    /* Real-time profiles as the kernel applied them at startup */
+    MRLIB_RtStatus_t MainRt;
+    MRLIB_RtStatus_t IoRt;
 } ROMIMOT_HkTlm_Payload_t;
 
 typedef struct
@@ -105,24 +224,33 @@ typedef struct
 } ROMIMOT_HkTlm_t;
 
 /*
-** Type definition (ROMI Motor Driver App Process Telemetry and state)
+** Type definition (ROMI Motor Driver App bus diagnostics)
+**
+** Latencies since the app started or the last ROMIMOT_RESET_COUNTERS_CC,
+** sent in reply to ROMIMOT_SEND_DIAG_CC for the Romi base it names.  Ops is
+** indexed by ROMIMOT_BUS_OP_*.
 */
+typedef struct __attribute__((__packed__))
+{
+    uint32 Count;  /* Operations timed */
+    uint32 Errors; /* Of which failed */
+    uint32 MinUs;
+    uint32 MaxUs;
+    uint32 MeanUs;
+    uint32 Buckets[ROMIMOT_BUS_HIST_BUCKETS];
+} ROMIMOT_BusOpStats_Payload_t;
 
-typedef struct
+typedef struct __attribute__((__packed__))
 {
-    uint8 MotorsEnabled;
-    int16 LeftPower;
-    int16 RightPower;
-    int16 LeftEncoderDelta;
-    int16 RightEncoderDelta;
-    int32 LeftMotorOdometer;
-    int32 RightMotorOdometer;
-} ROMIMOT_MotorStateData_t;
+    uint8                        Instance; /* Index in the table's Devices */
+    uint8                        Spare[3];
+    ROMIMOT_BusOpStats_Payload_t Ops[ROMIMOT_BUS_OP_COUNT];
+} ROMIMOT_DiagTlm_Payload_t;
 
 typedef struct
 {
     CFE_MSG_TelemetryHeader_t TelemetryHeader;
-    ROMIMOT_MotorStateData_t  Payload;
-} ROMIMOT_MotorState_t;
+    ROMIMOT_DiagTlm_Payload_t Payload;
+} ROMIMOT_DiagTlm_t;
 
 #endif /* ROMIMOT_MSG_H */
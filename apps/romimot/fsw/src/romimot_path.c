@@ -0,0 +1,65 @@
+/**
+ * @file
+ *
+ * On-board path queue for one Romi base.
+ */
+
+#include <string.h>
+
+#include "romimot_path.h"
+
+#define ROMIMOT_PATH_MASK (ROMIMOT_PATH_DEPTH - 1)
+
+void ROMIMOT_PathInit(ROMIMOT_Path_t *Path)
+{
+    memset(Path, 0, sizeof(*Path));
+}
+
+/*  Segments waiting, as seen from either task */
+uint32 ROMIMOT_PathQueued(const ROMIMOT_Path_t *Path)
+{
+    return __atomic_load_n(&Path->Head, __ATOMIC_ACQUIRE) - __atomic_load_n(&Path->Tail, __ATOMIC_ACQUIRE);
+}
+
+/*  Called by the main task.  Appends all Count segments, or none if they
+    do not fit. */
+bool ROMIMOT_PathAppend(ROMIMOT_Path_t *Path, const ROMIMOT_Segment_t *Segments, uint32 Count)
+{
+    uint32 Head = Path->Head;
+    uint32 i;
+
+    if (Count > ROMIMOT_PATH_DEPTH - (Head - __atomic_load_n(&Path->Tail, __ATOMIC_ACQUIRE)))
+    {
+        return false;
+    }
+
+    for (i = 0; i < Count; i++)
+    {
+        Path->Segments[(Head + i) & ROMIMOT_PATH_MASK] = Segments[i];
+    }
+    __atomic_store_n(&Path->Head, Head + Count, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/*  Called by the I/O task.  Never blocks. */
+bool ROMIMOT_PathTake(ROMIMOT_Path_t *Path, ROMIMOT_Segment_t *Segment)
+{
+    uint32 Tail = Path->Tail;
+
+    if (__atomic_load_n(&Path->Head, __ATOMIC_ACQUIRE) == Tail)
+    {
+        return false;
+    }
+
+    *Segment = Path->Segments[Tail & ROMIMOT_PATH_MASK];
+    __atomic_store_n(&Path->Tail, Tail + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/*  Called by the I/O task, drops everything appended so far */
+void ROMIMOT_PathFlush(ROMIMOT_Path_t *Path)
+{
+    __atomic_store_n(&Path->Tail, __atomic_load_n(&Path->Head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
@@ -0,0 +1,35 @@
+/**
+ * @file
+ *
+ * On-board path queue for one Romi base.
+ *
+ * The main task appends ROMIMOT_Segment_t legs, from ROMIMOT_QUEUE_PATH_CC
+ * or a table load, to a preallocated ring; the I/O task takes the next one
+ * on the cycle the previous target is reached, so a multi-leg path runs
+ * without a ground round trip between legs.  Head is only written by the
+ * main task and Tail only by the I/O task, so neither side ever blocks.
+ */
+
+#ifndef ROMIMOT_PATH_H
+#define ROMIMOT_PATH_H
+
+#include "cfe.h"
+#include "romimot_table.h"
+
+#define ROMIMOT_PATH_DEPTH 32 /* Segments in the ring, a power of two */
+
+typedef struct
+{
+    uint32 Head; /* Segments appended, main task only */
+    uint32 Tail; /* Segments taken or flushed, I/O task only */
+
+    ROMIMOT_Segment_t Segments[ROMIMOT_PATH_DEPTH];
+} ROMIMOT_Path_t;
+
+void   ROMIMOT_PathInit(ROMIMOT_Path_t *Path);
+uint32 ROMIMOT_PathQueued(const ROMIMOT_Path_t *Path);
+bool   ROMIMOT_PathAppend(ROMIMOT_Path_t *Path, const ROMIMOT_Segment_t *Segments, uint32 Count);
+bool   ROMIMOT_PathTake(ROMIMOT_Path_t *Path, ROMIMOT_Segment_t *Segment);
+void   ROMIMOT_PathFlush(ROMIMOT_Path_t *Path);
+
+#endif /* ROMIMOT_PATH_H */
@@ -0,0 +1,102 @@
+/**
+ * @file
+ *
+ * Fixed-point PID controller for the ROMIMOT wheel loop.
+ */
+
+#include <string.h>
+
+#include "romimot_pid.h"
+
+/* Q16.16 to integer, rounding half away from zero */
+static int64 ROMIMOT_Q16Round(int64 Value)
+{
+    if (Value < 0)
+    {
+        return -((-Value + (ROMIMOT_Q16_ONE / 2)) / ROMIMOT_Q16_ONE);
+    }
+    return (Value + (ROMIMOT_Q16_ONE / 2)) / ROMIMOT_Q16_ONE;
+}
+
+/* Q16.16 * Q16.16 -> Q16.16 */
+static int64 ROMIMOT_Q16Mul(int64 A, int64 B)
+{
+    return ROMIMOT_Q16Round(A * B);
+}
+
+static int64 ROMIMOT_Clamp(int64 Value, int64 Limit)
+{
+    if (Value > Limit)
+    {
+        return Limit;
+    }
+    if (Value < -Limit)
+    {
+        return -Limit;
+    }
+    return Value;
+}
+
+void ROMIMOT_PidReset(ROMIMOT_PidState_t *State)
+{
+    memset(State, 0, sizeof(*State));
+}
+
+/*  Integral and output stages, shared by both derivative sources.  Anti-windup
+    is two-fold: the integral term is clamped to IntegralLimit, and it is not
+    allowed to grow while the output is saturated in the same direction. */
+static int16 ROMIMOT_PidOutput(ROMIMOT_PidState_t *State, const ROMIMOT_PidGains_t *Gains, int32 Error,
+                               int32 RefVelocity)
+{
+    int64 OutLimit = (int64)Gains->OutputLimit * ROMIMOT_Q16_ONE;
+    int64 Integral;
+    int64 Unsaturated;
+    int64 Output;
+
+    Integral = ROMIMOT_Clamp(State->Integral + (int64)Gains->Ki * Error, Gains->IntegralLimit);
+
+    Unsaturated = (int64)Gains->Kp * Error + ROMIMOT_Q16Mul(Gains->Kd, State->DFiltered) +
+                  (int64)Gains->Kff * RefVelocity;
+
+    Output = Unsaturated + Integral;
+    if ((Output > OutLimit && Integral > State->Integral) || (Output < -OutLimit && Integral < State->Integral))
+    {
+        /* saturated: hold the integral rather than wind it further */
+        Integral = State->Integral;
+        Output   = Unsaturated + Integral;
+    }
+    State->Integral = (int32)Integral;
+
+    return ROMIMOT_Q16Round(ROMIMOT_Clamp(Output, OutLimit));
+}
+
+/*  One controller update.  Error is the position error in encoder counts and
+    RefVelocity the reference motion in counts for this cycle.  Returns the
+    motor power, bounded by Gains->OutputLimit. */
+int16 ROMIMOT_PidStep(ROMIMOT_PidState_t *State, const ROMIMOT_PidGains_t *Gains, int32 Error, int32 RefVelocity)
+{
+    int64 Rate;
+
+    /* derivative on the error, first order low-pass */
+    if (State->Primed)
+    {
+        Rate = ((int64)Error - State->PrevError) * ROMIMOT_Q16_ONE;
+        State->DFiltered += (int32)ROMIMOT_Q16Mul(Gains->DAlpha, Rate - State->DFiltered);
+    }
+    State->PrevError = Error;
+    State->Primed    = true;
+
+    return ROMIMOT_PidOutput(State, Gains, Error, RefVelocity);
+}
+
+/*  As ROMIMOT_PidStep(), with the error rate measured rather than differenced:
+    ErrorRate is Q16.16 counts per cycle, the same low-pass applies. */
+int16 ROMIMOT_PidStepRate(ROMIMOT_PidState_t *State, const ROMIMOT_PidGains_t *Gains, int32 Error, int32 RefVelocity,
+                          int64 ErrorRate)
+{
+    State->DFiltered += (int32)ROMIMOT_Q16Mul(Gains->DAlpha, ErrorRate - State->DFiltered);
+    State->PrevError = Error;
+    State->Primed    = true;
+
+    return ROMIMOT_PidOutput(State, Gains, Error, RefVelocity);
+}
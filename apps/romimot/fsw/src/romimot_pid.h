@@ -0,0 +1,43 @@
+/**
+ * @file
+ *
+ * Fixed-point PID controller for the ROMIMOT wheel loop.
+ *
+ * Gains and intermediate terms are Q16.16 and every product is formed in
+ * 64 bits and rounded half away from zero, so a given input sequence gives
+ * the same motor powers on every target regardless of how the compiler
+ * treats right shifts of negative values.  All gains are per control cycle.
+ */
+
+#ifndef ROMIMOT_PID_H
+#define ROMIMOT_PID_H
+
+#include "cfe.h"
+
+#define ROMIMOT_Q16_ONE ((int32)1 << 16)
+
+typedef struct
+{
+    int32 Kp;            /* Q16.16 power per count of position error */
+    int32 Ki;            /* Q16.16 power per count of error per cycle */
+    int32 Kd;            /* Q16.16 power per count/cycle of error rate */
+    int32 Kff;           /* Q16.16 power per count/cycle of reference velocity */
+    int32 DAlpha;        /* Q16.16 derivative low-pass coefficient, ROMIMOT_Q16_ONE = unfiltered */
+    int32 IntegralLimit; /* Q16.16 bound on the magnitude of the integral term */
+    int16 OutputLimit;   /* Bound on the magnitude of the motor power */
+} ROMIMOT_PidGains_t;
+
+typedef struct
+{
+    int32 Integral;  /* Q16.16 integral term, already scaled by Ki */
+    int32 DFiltered; /* Q16.16 filtered error rate, counts/cycle */
+    int32 PrevError; /* counts */
+    bool  Primed;    /* PrevError is valid */
+} ROMIMOT_PidState_t;
+
+void  ROMIMOT_PidReset(ROMIMOT_PidState_t *State);
+int16 ROMIMOT_PidStep(ROMIMOT_PidState_t *State, const ROMIMOT_PidGains_t *Gains, int32 Error, int32 RefVelocity);
+int16 ROMIMOT_PidStepRate(ROMIMOT_PidState_t *State, const ROMIMOT_PidGains_t *Gains, int32 Error, int32 RefVelocity,
+                          int64 ErrorRate);
+
+#endif /* ROMIMOT_PID_H */
@@ -0,0 +1,143 @@
+/**
+ * @file
+ *
+ * Motion profiles for the ROMIMOT wheel targets.
+ */
+
+#include <string.h>
+
+#include "romimot_pid.h"
+#include "romimot_profile.h"
+#include "romimot_table.h"
+
+/* Distance covered after Cycles cycles of the ramp */
+static int32 ROMIMOT_RampAt(const ROMIMOT_Ramp_t *Ramp, int32 Cycles)
+{
+    return Cycles > 0 ? Ramp->Position[Cycles - 1] : 0;
+}
+
+/*  Build the ramp from rest up to Speed counts/cycle.  Accel (counts/cycle^2)
+    and Jerk (counts/cycle^3) are Q16.16.  A trapezoid adds Accel to the speed
+    every cycle; an S-curve also ramps the acceleration up and down by Jerk,
+    starting to ease off once the speed it would still gain reaches Speed.
+    Ramps that would not reach Speed within ROMIMOT_PROFILE_RAMP_MAX cycles
+    top out at whatever speed they reached. */
+void ROMIMOT_ProfileBuildRamp(ROMIMOT_Ramp_t *Ramp, uint16 Mode, int32 Speed, int32 Accel, int32 Jerk)
+{
+    int64 Top      = (int64)Speed * ROMIMOT_Q16_ONE;
+    int64 Velocity = 0;
+    int64 Rate     = 0;
+    int64 Position = 0;
+    int64 MinRate  = Jerk < Accel ? Jerk : Accel;
+    int32 i;
+
+    memset(Ramp, 0, sizeof(*Ramp));
+
+    if (Speed <= 0 || Mode == ROMIMOT_PROFILE_LINEAR)
+    {
+        return;
+    }
+
+    for (i = 0; i < ROMIMOT_PROFILE_RAMP_MAX && Velocity < Top; i++)
+    {
+        if (Mode == ROMIMOT_PROFILE_SCURVE)
+        {
+            if ((Top - Velocity) * 2 * Jerk <= Rate * Rate)
+            {
+                Rate = (Rate - Jerk > MinRate) ? Rate - Jerk : MinRate;
+            }
+            else
+            {
+                Rate = (Rate + Jerk < Accel) ? Rate + Jerk : Accel;
+            }
+        }
+        else
+        {
+            Rate = Accel;
+        }
+
+        Velocity = (Velocity + Rate < Top) ? Velocity + Rate : Top;
+        Position += Velocity;
+
+        Ramp->Position[i] = (int32)((Position + ROMIMOT_Q16_ONE / 2) / ROMIMOT_Q16_ONE);
+    }
+
+    Ramp->Length = i;
+}
+
+/*  Plan a move from From to To.  The ramp is used for as many cycles as fit
+    in half the distance, and whatever is left is covered at the speed the
+    ramp reached, rounded up to whole cycles. */
+void ROMIMOT_ProfileStart(ROMIMOT_ProfileState_t *State, const ROMIMOT_Ramp_t *Ramp, int32 From, int32 To)
+{
+    int32 Low  = 0;
+    int32 High = Ramp->Length;
+    int32 Mid;
+    int32 Speed;
+
+    memset(State, 0, sizeof(*State));
+
+    State->Start    = From;
+    State->Dir      = To >= From ? 1 : -1;
+    State->Distance = (To - From) * State->Dir;
+
+    if (State->Distance == 0 || Ramp->Length == 0)
+    {
+        return;
+    }
+
+    /* longest ramp with 2 * RampAt(Ramp) <= Distance */
+    while (Low < High)
+    {
+        Mid = (Low + High + 1) / 2;
+        if ((int64)2 * ROMIMOT_RampAt(Ramp, Mid) <= State->Distance)
+        {
+            Low = Mid;
+        }
+        else
+        {
+            High = Mid - 1;
+        }
+    }
+
+    Speed = ROMIMOT_RampAt(Ramp, Low > 0 ? Low : 1) - ROMIMOT_RampAt(Ramp, Low > 0 ? Low - 1 : 0);
+    if (Speed < 1)
+    {
+        Speed = 1;
+    }
+
+    State->Ramp      = Low;
+    State->Remainder = State->Distance - 2 * ROMIMOT_RampAt(Ramp, Low);
+    State->Cruise    = (State->Remainder + Speed - 1) / Speed;
+    State->Active    = true;
+}
+
+/*  Advance one cycle and return the new intermediate odometer target */
+int32 ROMIMOT_ProfileNext(ROMIMOT_ProfileState_t *State, const ROMIMOT_Ramp_t *Ramp)
+{
+    int32 Total = 2 * State->Ramp + State->Cruise;
+    int32 Covered;
+
+    State->Tick++;
+
+    if (State->Tick >= Total)
+    {
+        State->Active = false;
+        Covered       = State->Distance;
+    }
+    else if (State->Tick <= State->Ramp)
+    {
+        Covered = ROMIMOT_RampAt(Ramp, State->Tick);
+    }
+    else if (State->Tick >= State->Ramp + State->Cruise)
+    {
+        Covered = State->Distance - ROMIMOT_RampAt(Ramp, Total - State->Tick);
+    }
+    else
+    {
+        Covered = ROMIMOT_RampAt(Ramp, State->Ramp) +
+                  (int32)((int64)State->Remainder * (State->Tick - State->Ramp) / State->Cruise);
+    }
+
+    return State->Start + Covered * State->Dir;
+}
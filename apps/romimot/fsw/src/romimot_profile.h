@@ -0,0 +1,57 @@
+/**
+ * @file
+ *
+ * Motion profiles for the ROMIMOT wheel targets.
+ *
+ * The main task turns the commanded cruise speed into an acceleration ramp
+ * (trapezoidal or jerk-limited S-curve) once per target command and hands
+ * it to the I/O task.  The ramp holds the distance covered after each cycle
+ * starting from rest; the deceleration is the same ramp played backwards
+ * from the target, with a constant speed stretch between the two, so every
+ * control cycle is a single table lookup.
+ */
+
+#ifndef ROMIMOT_PROFILE_H
+#define ROMIMOT_PROFILE_H
+
+#include "cfe.h"
+
+#define ROMIMOT_PROFILE_RAMP_MAX 256 /* Longest ramp, in control cycles */
+
+typedef struct
+{
+    uint16 Length;                             /* Cycles to reach cruise speed, 0 = cannot move */
+    int32  Position[ROMIMOT_PROFILE_RAMP_MAX]; /* Counts covered after cycle 1..Length */
+} ROMIMOT_Ramp_t;
+
+/*
+** Profile published by the main task, matched to a command by Seq
+*/
+typedef struct
+{
+    uint32         Seq;
+    uint16         Mode; /* ROMIMOT_PROFILE_* */
+    ROMIMOT_Ramp_t Left;
+    ROMIMOT_Ramp_t Right;
+} ROMIMOT_Profile_t;
+
+/*
+** Progress of one wheel along its profile, owned by the I/O task
+*/
+typedef struct
+{
+    bool  Active;
+    int32 Start;     /* Odometer position the move started from */
+    int32 Distance;  /* Length of the move, counts */
+    int32 Dir;       /* +1 or -1 */
+    int32 Ramp;      /* Ramp cycles at each end */
+    int32 Cruise;    /* Constant speed cycles */
+    int32 Remainder; /* Counts covered while cruising */
+    int32 Tick;      /* Cycles since Start */
+} ROMIMOT_ProfileState_t;
+
+void  ROMIMOT_ProfileBuildRamp(ROMIMOT_Ramp_t *Ramp, uint16 Mode, int32 Speed, int32 Accel, int32 Jerk);
+void  ROMIMOT_ProfileStart(ROMIMOT_ProfileState_t *State, const ROMIMOT_Ramp_t *Ramp, int32 From, int32 To);
+int32 ROMIMOT_ProfileNext(ROMIMOT_ProfileState_t *State, const ROMIMOT_Ramp_t *Ramp);
+
+#endif /* ROMIMOT_PROFILE_H */
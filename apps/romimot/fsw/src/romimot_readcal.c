@@ -0,0 +1,93 @@
+/**
+ * @file
+ *
+ * Read delay calibration and back-off for the Romi register reads.
+ */
+
+#include <string.h>
+
+#include "romimot_readcal.h"
+#include "romimot_msg.h"
+
+void ROMIMOT_ReadCalStart(ROMIMOT_ReadCal_t *Cal, uint16 MarginUs)
+{
+    memset(Cal, 0, sizeof(*Cal));
+    Cal->MarginUs = MarginUs;
+    Cal->Active   = true;
+}
+
+/*  Records the result of one trial read at Cal->DelayUs, a romiRangeRead()
+    status where anything but 0 is a failure.  Every candidate gets the full
+    ROMIMOT_READ_CAL_TRIALS reads so its failure rate is known.  Returns
+    true when the range under test has settled, at which point Cal->Range
+    has moved on to the next one. */
+bool ROMIMOT_ReadCalRecord(ROMIMOT_ReadCal_t *Cal, int Status)
+{
+    uint32 Result;
+    bool   Settled = false;
+
+    Cal->Trials++;
+    if (Status != 0)
+    {
+        Cal->Failures++;
+    }
+    if (Cal->Trials < ROMIMOT_READ_CAL_TRIALS)
+    {
+        return false;
+    }
+
+    if (Cal->Failures == 0 || Cal->DelayUs >= ROMIMOT_READ_DELAY_MAX_US)
+    {
+        if (Cal->Failures != 0)
+        {
+            Cal->Failed = true;
+        }
+
+        Result = (uint32)Cal->DelayUs + Cal->MarginUs;
+        if (Result > ROMIMOT_READ_DELAY_MAX_US)
+        {
+            Result = ROMIMOT_READ_DELAY_MAX_US;
+        }
+        Cal->ResultUs[Cal->Range] = Result;
+
+        Cal->Range++;
+        Cal->DelayUs = 0;
+        Cal->Active  = Cal->Range < ROMIMOT_READ_RANGES;
+        Settled      = true;
+    }
+    else
+    {
+        Cal->RejectFailures[Cal->Range] = Cal->Failures;
+        Cal->DelayUs += ROMIMOT_READ_CAL_STEP_US;
+    }
+
+    Cal->Trials   = 0;
+    Cal->Failures = 0;
+    return Settled;
+}
+
+/*  Called once per control cycle with the snapshot read status.  Returns
+    true when ROMIMOT_READ_BACKOFF_ERRORS bad reads, failed or with data
+    that did not validate, have been seen within one window, and starts a
+    new window. */
+bool ROMIMOT_ReadBackoffCheck(ROMIMOT_ReadBackoff_t *Backoff, int Status)
+{
+    if (Status == ROMIMOT_I2C_DAT_R_ERR_EID || Status == ROMIMOT_I2C_DAT_BAD_ERR_EID)
+    {
+        Backoff->Errors++;
+    }
+
+    if (Backoff->Errors >= ROMIMOT_READ_BACKOFF_ERRORS)
+    {
+        Backoff->Cycles = 0;
+        Backoff->Errors = 0;
+        return true;
+    }
+
+    if (++Backoff->Cycles >= ROMIMOT_READ_BACKOFF_WINDOW)
+    {
+        Backoff->Cycles = 0;
+        Backoff->Errors = 0;
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file
+ *
+ * Read delay calibration and back-off for the Romi register reads.
+ *
+ * The 32u4 slave needs time between the register pointer write and the
+ * data read to stage its buffer.  Read too early it still acknowledges,
+ * but sends stale bytes, so a trial passes on the data it got back, not
+ * on the transfer status (romiRangeRead()).  A calibration run tries each
+ * register range at increasing delays, starting from a combined transfer
+ * (0 us), and settles on the first delay at which ROMIMOT_READ_CAL_TRIALS
+ * reads in a row return good data, plus a margin.  The trial reads are
+ * spread over the control cycles so the loop keeps its timing.
+ *
+ * Outside calibration the control loop backs its snapshot delay off when
+ * read errors or snapshots that fail their check cluster, until the table
+ * is next loaded or calibrated.
+ */
+
+#ifndef ROMIMOT_READCAL_H
+#define ROMIMOT_READCAL_H
+
+#include "cfe.h"
+
+#include "romimot_table.h"
+
+#define ROMIMOT_READ_CAL_STEP_US     10  /* Candidate delay increment */
+#define ROMIMOT_READ_CAL_TRIALS      50  /* Reads that must all pass at a candidate */
+#define ROMIMOT_READ_CAL_PER_CYCLE   5   /* Trial reads added to each control cycle */
+#define ROMIMOT_READ_BACKOFF_WINDOW  100 /* Control cycles */
+#define ROMIMOT_READ_BACKOFF_ERRORS  3   /* Bad reads within a window that trigger a back-off */
+#define ROMIMOT_READ_BACKOFF_STEP_US 20
+
+typedef struct
+{
+    bool   Active;
+    bool   Failed;   /* A range found no safe delay and was left at the maximum */
+    uint16 Range;    /* Range under test */
+    uint16 DelayUs;  /* Candidate under test */
+    uint16 Trials;   /* Reads done at the candidate */
+    uint16 Failures; /* Of which failed */
+    uint16 MarginUs;
+
+    uint16 ResultUs[ROMIMOT_READ_RANGES];       /* Settled delays, margin included */
+    uint16 RejectFailures[ROMIMOT_READ_RANGES]; /* Failed trials at the last rejected candidate */
+} ROMIMOT_ReadCal_t;
+
+typedef struct
+{
+    uint16 Cycles;
+    uint16 Errors;
+} ROMIMOT_ReadBackoff_t;
+
+void ROMIMOT_ReadCalStart(ROMIMOT_ReadCal_t *Cal, uint16 MarginUs);
+bool ROMIMOT_ReadCalRecord(ROMIMOT_ReadCal_t *Cal, int Status);
+bool ROMIMOT_ReadBackoffCheck(ROMIMOT_ReadBackoff_t *Backoff, int Status);
+
+#endif /* ROMIMOT_READCAL_H */
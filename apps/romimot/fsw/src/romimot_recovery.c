@@ -0,0 +1,89 @@
+/**
+ * @file
+ *
+ * I2C fault recovery for the ROMIMOT control loop.
+ */
+
+#include <string.h>
+
+#include "romimot_recovery.h"
+
+void ROMIMOT_BusRecoveryReset(ROMIMOT_BusRecovery_t *Recovery)
+{
+    memset(Recovery, 0, sizeof(*Recovery));
+}
+
+/*  The bus has just been opened.  A first open is trusted straight away;
+    after a reopen the motors stay held until a cycle runs cleanly. */
+void ROMIMOT_BusRecoveryOpened(ROMIMOT_BusRecovery_t *Recovery)
+{
+    Recovery->Failures = 0;
+    Recovery->State    = Recovery->Attempts == 0 ? ROMIMOT_BUS_STATE_OK : ROMIMOT_BUS_STATE_RETRY;
+}
+
+/*  Schedules the next reopen, or gives up once the attempts run out.  The
+    bus must already be closed. */
+void ROMIMOT_BusRecoveryOpenFailed(ROMIMOT_BusRecovery_t *Recovery, int64 NowUs)
+{
+    Recovery->Failures = 0;
+
+    if (Recovery->Attempts >= ROMIMOT_BUS_REOPEN_ATTEMPTS)
+    {
+        Recovery->State    = ROMIMOT_BUS_STATE_CLOSED;
+        Recovery->Attempts = 0;
+        return;
+    }
+
+    if (Recovery->Attempts == 0)
+    {
+        Recovery->BackoffUs = ROMIMOT_BUS_REOPEN_MIN_US;
+    }
+    else if (Recovery->BackoffUs < ROMIMOT_BUS_REOPEN_MAX_US / 2)
+    {
+        Recovery->BackoffUs *= 2;
+    }
+    else
+    {
+        Recovery->BackoffUs = ROMIMOT_BUS_REOPEN_MAX_US;
+    }
+
+    Recovery->Attempts++;
+    Recovery->State      = ROMIMOT_BUS_STATE_REOPEN;
+    Recovery->NextOpenUs = NowUs + Recovery->BackoffUs;
+}
+
+/*  Called once per control cycle while the bus is open, with the first
+    non-zero status of the cycle's transfers.  When the state moves to
+    ROMIMOT_BUS_STATE_REOPEN or ROMIMOT_BUS_STATE_CLOSED the caller closes
+    the bus. */
+void ROMIMOT_BusRecoveryCycle(ROMIMOT_BusRecovery_t *Recovery, int Status, int64 NowUs)
+{
+    if (Status == 0)
+    {
+        Recovery->State    = ROMIMOT_BUS_STATE_OK;
+        Recovery->Failures = 0;
+        Recovery->Attempts = 0;
+        return;
+    }
+
+    Recovery->Failures++;
+    if (Recovery->Failures >= ROMIMOT_BUS_REOPEN_FAILURES)
+    {
+        ROMIMOT_BusRecoveryOpenFailed(Recovery, NowUs);
+    }
+    else if (Recovery->Failures >= ROMIMOT_BUS_RETRY_FAILURES)
+    {
+        Recovery->State = ROMIMOT_BUS_STATE_RETRY;
+    }
+}
+
+bool ROMIMOT_BusRecoveryDue(const ROMIMOT_BusRecovery_t *Recovery, int64 NowUs)
+{
+    return Recovery->State == ROMIMOT_BUS_STATE_REOPEN && NowUs >= Recovery->NextOpenUs;
+}
+
+/*  True while the motors must be held at zero power. */
+bool ROMIMOT_BusRecoveryHolding(const ROMIMOT_BusRecovery_t *Recovery)
+{
+    return Recovery->State == ROMIMOT_BUS_STATE_RETRY || Recovery->State == ROMIMOT_BUS_STATE_REOPEN;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file
+ *
+ * I2C fault recovery for the ROMIMOT control loop.
+ *
+ * The I/O task feeds the outcome of every bus cycle in.  Isolated errors
+ * are ridden out; repeated errors hold the motors at zero power, and if
+ * the bus keeps failing it is closed and reopened with an exponentially
+ * growing wait between attempts.  After ROMIMOT_BUS_REOPEN_ATTEMPTS the
+ * bus is left closed until the next motor command asks for it again.
+ * Every step is bounded: a transfer times out after one 10 ms tick with no
+ * kernel retries, and once the motors are held a cycle whose read fails
+ * skips the motor write, so a misbehaving bus costs one transfer per cycle.
+ */
+
+#ifndef ROMIMOT_RECOVERY_H
+#define ROMIMOT_RECOVERY_H
+
+#include "cfe.h"
+
+/*
+** Bus states, reported in housekeeping
+*/
+#define ROMIMOT_BUS_STATE_CLOSED 0 /* Not opened yet, or given up until the next command */
+#define ROMIMOT_BUS_STATE_OK     1
+#define ROMIMOT_BUS_STATE_RETRY  2 /* Open but failing, motors held at zero */
+#define ROMIMOT_BUS_STATE_REOPEN 3 /* Closed, waiting to reopen */
+
+#define ROMIMOT_BUS_RETRY_FAILURES  2       /* Consecutive failed cycles before the motors are held */
+#define ROMIMOT_BUS_REOPEN_FAILURES 10      /* Consecutive failed cycles before the bus is reopened */
+#define ROMIMOT_BUS_REOPEN_ATTEMPTS 8       /* Reopens without a clean cycle before giving up */
+#define ROMIMOT_BUS_REOPEN_MIN_US   10000   /* First wait, doubled on every attempt */
+#define ROMIMOT_BUS_REOPEN_MAX_US   1000000
+
+typedef struct
+{
+    uint8  State;
+    uint16 Failures;   /* Consecutive failed cycles */
+    uint16 Attempts;   /* Reopens since the last clean cycle */
+    uint32 BackoffUs;  /* Current wait before reopening */
+    int64  NextOpenUs; /* When the next reopen is due */
+    uint32 Reopens;    /* Total, for housekeeping */
+} ROMIMOT_BusRecovery_t;
+
+void ROMIMOT_BusRecoveryReset(ROMIMOT_BusRecovery_t *Recovery);
+void ROMIMOT_BusRecoveryOpened(ROMIMOT_BusRecovery_t *Recovery);
+void ROMIMOT_BusRecoveryOpenFailed(ROMIMOT_BusRecovery_t *Recovery, int64 NowUs);
+void ROMIMOT_BusRecoveryCycle(ROMIMOT_BusRecovery_t *Recovery, int Status, int64 NowUs);
+bool ROMIMOT_BusRecoveryDue(const ROMIMOT_BusRecovery_t *Recovery, int64 NowUs);
+bool ROMIMOT_BusRecoveryHolding(const ROMIMOT_BusRecovery_t *Recovery);
+
+#endif /* ROMIMOT_RECOVERY_H */
@@ -0,0 +1,132 @@
+/**
+ * @file
+ *
+ * Binary trace of the ROMIMOT control loop.
+ */
+
+#include <string.h>
+
+#include "romimot_trace.h"
+
+#define ROMIMOT_TRACE_MASK (ROMIMOT_TRACE_DEPTH - 1)
+
+void ROMIMOT_TraceInit(ROMIMOT_Trace_t *Trace)
+{
+    memset(Trace, 0, sizeof(*Trace));
+}
+
+/*  Called by the I/O task once per cycle.  Never blocks. */
+void ROMIMOT_TraceRecord(ROMIMOT_Trace_t *Trace, const ROMIMOT_TraceSample_t *Sample)
+{
+    uint32 Head;
+
+    if (__atomic_load_n(&Trace->Frozen, __ATOMIC_SEQ_CST))
+    {
+        return;
+    }
+
+    Head                                      = Trace->Head;
+    Trace->Samples[Head & ROMIMOT_TRACE_MASK] = *Sample;
+    __atomic_store_n(&Trace->Head, Head + 1, __ATOMIC_RELEASE);
+
+    if (Sample->Status != 0 && !__atomic_load_n(&Trace->Faulted, __ATOMIC_ACQUIRE))
+    {
+        Trace->FreezeAt = Head + 1 + ROMIMOT_TRACE_POST_FAULT;
+        __atomic_store_n(&Trace->Faulted, true, __ATOMIC_RELEASE);
+    }
+
+    if (__atomic_load_n(&Trace->Faulted, __ATOMIC_ACQUIRE) && Head + 1 == Trace->FreezeAt)
+    {
+        __atomic_store_n(&Trace->Frozen, true, __ATOMIC_SEQ_CST);
+    }
+}
+
+static int32 ROMIMOT_TraceWrite(osal_id_t FileId, const void *Data, size_t Size)
+{
+    int32 Written = OS_write(FileId, Data, Size);
+
+    return (Written == (int32)Size) ? CFE_SUCCESS : CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+}
+
+/*  Called by the main task.  Writes the samples recorded since the previous
+    dump, then clears any fault freeze and resumes recording.  Recording is
+    paused while the file is written, and a failed dump leaves the ring as
+    it was.
+
+    A cycle may be storing into the oldest slot at the moment the ring is
+    paused, so when the ring has wrapped the oldest sample is left out. */
+int32 ROMIMOT_TraceDrain(ROMIMOT_Trace_t *Trace, const char *FileName, ROMIMOT_TraceFileHdr_t *Info)
+{
+    CFE_FS_Header_t FileHdr;
+    osal_id_t       FileId;
+    uint32          Head;
+    uint32          First;
+    uint32          Slot;
+    uint32          Count;
+    uint32          Chunk;
+    int32           Status;
+    bool            WasFrozen;
+
+    WasFrozen = __atomic_exchange_n(&Trace->Frozen, true, __ATOMIC_SEQ_CST);
+    Head = __atomic_load_n(&Trace->Head, __ATOMIC_ACQUIRE);
+
+    First = Trace->Tail;
+    if (Head - First > ROMIMOT_TRACE_DEPTH - 1)
+    {
+        First = Head - (ROMIMOT_TRACE_DEPTH - 1);
+    }
+
+    memset(Info, 0, sizeof(*Info));
+    Info->SampleCount = Head - First;
+    Info->SampleSize  = sizeof(ROMIMOT_TraceSample_t);
+    Info->FirstIndex  = First;
+    Info->Faulted     = __atomic_load_n(&Trace->Faulted, __ATOMIC_ACQUIRE);
+
+    Status = OS_OpenCreate(&FileId, FileName, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+    if (Status == OS_SUCCESS)
+    {
+        CFE_FS_InitHeader(&FileHdr, "ROMIMOT control loop trace", ROMIMOT_TRACE_FILE_SUBTYPE);
+        if (CFE_FS_WriteHeader(FileId, &FileHdr) == sizeof(FileHdr))
+        {
+            Status = ROMIMOT_TraceWrite(FileId, Info, sizeof(*Info));
+        }
+        else
+        {
+            Status = CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+
+        /* oldest first, in at most two pieces where the ring wraps */
+        Count = Info->SampleCount;
+        Slot  = First & ROMIMOT_TRACE_MASK;
+        while (Status == CFE_SUCCESS && Count > 0)
+        {
+            Chunk = ROMIMOT_TRACE_DEPTH - Slot;
+            if (Chunk > Count)
+            {
+                Chunk = Count;
+            }
+
+            Status = ROMIMOT_TraceWrite(FileId, &Trace->Samples[Slot], Chunk * sizeof(ROMIMOT_TraceSample_t));
+            Count -= Chunk;
+            Slot = 0;
+        }
+
+        OS_close(FileId);
+    }
+    else
+    {
+        Status = CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    /* the samples are consumed only once they are safely on file */
+    if (Status == CFE_SUCCESS)
+    {
+        Trace->Tail = Head;
+        __atomic_store_n(&Trace->Faulted, false, __ATOMIC_RELEASE);
+        WasFrozen = false;
+    }
+
+    __atomic_store_n(&Trace->Frozen, WasFrozen, __ATOMIC_SEQ_CST);
+
+    return Status;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file
+ *
+ * Binary trace of the ROMIMOT control loop.
+ *
+ * The I/O task appends one fixed-size sample per control cycle to a
+ * preallocated ring; nothing is formatted or written on the loop thread.
+ * The main task drains the ring to a file on command.  An I2C error arms
+ * a freeze: ROMIMOT_TRACE_POST_FAULT more samples are recorded and the
+ * ring then stops, so the cycles leading up to the fault survive until
+ * the next dump.
+ *
+ * Dump files are a cFE file header, a ROMIMOT_TraceFileHdr_t and then
+ * SampleCount ROMIMOT_TraceSample_t records, oldest first, in the byte
+ * order of the target.
+ */
+
+#ifndef ROMIMOT_TRACE_H
+#define ROMIMOT_TRACE_H
+
+#include "cfe.h"
+
+#define ROMIMOT_TRACE_DEPTH        1024 /* Samples in the ring, a power of two */
+#define ROMIMOT_TRACE_POST_FAULT   32   /* Samples kept after an I2C error before freezing */
+#define ROMIMOT_TRACE_FILE         "/ram/romimot_trace.bin"
+#define ROMIMOT_TRACE_FILE_SUBTYPE 0x524D5452 /* "RMTR" */
+
+typedef struct
+{
+    int64  TimeUs;        /* Wakeup time of the cycle */
+    uint32 Cycle;         /* I/O cycle counter */
+    int32  Status;        /* First I2C error of the cycle, 0 on success */
+    int32  LeftSetpoint;  /* Intermediate odometer targets */
+    int32  RightSetpoint;
+    int32  LeftOdo;
+    int32  RightOdo;
+    int16  LeftMotSpeed;
+    int16  RightMotSpeed;
+    uint16 BatteryMillivolts;
+    uint16 Spare;
+} ROMIMOT_TraceSample_t;
+
+typedef struct
+{
+    uint32 SampleCount;
+    uint32 SampleSize; /* sizeof(ROMIMOT_TraceSample_t) */
+    uint32 FirstIndex; /* Number of samples recorded before the first one in the file */
+    uint8  Faulted;    /* The ring froze on an I2C error */
+    uint8  Spare[3];
+} ROMIMOT_TraceFileHdr_t;
+
+typedef struct
+{
+    uint32 Head;     /* Samples recorded, written by the I/O task only */
+    uint32 Tail;     /* Samples already dumped, main task only */
+    uint32 FreezeAt; /* Head value at which a fault freeze takes effect */
+    bool   Faulted;  /* A fault freeze is armed or in effect */
+    bool   Frozen;   /* Recording is stopped */
+
+    ROMIMOT_TraceSample_t Samples[ROMIMOT_TRACE_DEPTH];
+} ROMIMOT_Trace_t;
+
+void  ROMIMOT_TraceInit(ROMIMOT_Trace_t *Trace);
+void  ROMIMOT_TraceRecord(ROMIMOT_Trace_t *Trace, const ROMIMOT_TraceSample_t *Sample);
+int32 ROMIMOT_TraceDrain(ROMIMOT_Trace_t *Trace, const char *FileName, ROMIMOT_TraceFileHdr_t *Info);
+
+#endif /* ROMIMOT_TRACE_H */
@@ -23,7 +23,47 @@
 ** The following is an example of the declaration statement that defines the desired
 ** contents of the table image.
 */
-ROMIMOT_Table_t RomimotTable = {1, 2};
+ROMIMOT_Table_t RomimotTable = {
+    .HwBackend     = ROMIMOT_HW_BACKEND_DEFAULT,
+    .ControlMode   = ROMIMOT_CONTROL_MODE_WAKEUP,
+    .ControlRateHz = 200,
+    .OutputLimit   = 200,
+
+    /* Tuned for the 10 Hz wakeup rate, where one unit of power moves a
+       wheel about 1.2 counts per cycle */
+    .Kp            = ROMIMOT_Q16(0.05),
+    .Ki            = ROMIMOT_Q16(0.002),
+    .Kd            = ROMIMOT_Q16(0.02),
+    .Kff           = ROMIMOT_Q16(0.8),
+    .DAlpha        = ROMIMOT_Q16(0.5),
+    .IntegralLimit = ROMIMOT_Q16(60),
+
+    /* Full speed (about 300 counts per cycle) in half a second */
+    .ProfileMode  = ROMIMOT_PROFILE_SCURVE,
+    .ProfileAccel = ROMIMOT_Q16(60),
+    .ProfileJerk  = ROMIMOT_Q16(30),
+
+    /* Two state packets a second at the 10 Hz wakeup rate */
+    .StateBatchSize = 5,
+
+    /* Calibrated delays keep some room above the shortest that read cleanly */
+    .ReadDelayMarginUs = 20,
+
+    /* Set BusRecord to capture a session for replay on the bench */
+    .BusRecord   = 0,
+    .ReplaySpeed = ROMIMOT_REPLAY_WALL_CLOCK,
+    .BusLogFile  = "/ram/romimot_bus.bin",
+
+    /* The main task keeps its OSAL priority.  The I/O task takes core 3 of
+       the Pi, kept free of other work with isolcpus=3 on the kernel command
+       line, and ranks above everything but the kernel's own threads. */
+    .RtProfile   = {.Enabled = 0},
+    .IoRtProfile = {.Enabled = 1, .Priority = 80, .LockMemory = 1, .CpuMask = 0x8, .PrefaultBytes = 8192},
+
+    /* One Romi on the Pi's I2C bus.  Every read waits for the 32u4 until a
+       calibration finds shorter delays. */
+    .Devices = {{.Enabled = 1, .BusNumber = 1, .Address = 0x14, .ReadDelayUs = {100, 100, 100}}},
+};
 
 /*
 ** This is alternate table contents:
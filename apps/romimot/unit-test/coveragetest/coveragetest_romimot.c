@@ -18,6 +18,8 @@
  * Includes
  */
 
+#include <stdio.h>
+
 #include "romimot_coveragetest_common.h"
 #include "ut_romimot.h"
 
@@ -252,63 +254,154 @@ void Test_ROMIMOT_Init(void)
     UT_SetDeferredRetcode(UT_KEY(CFE_TBL_Register), 1, CFE_TBL_ERR_INVALID_OPTIONS);
     UtAssert_INT32_EQ(ROMIMOT_Init(), CFE_TBL_ERR_INVALID_OPTIONS);
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 5);
+
+    UT_SetDeferredRetcode(UT_KEY(OS_MutSemCreate), 1, OS_ERROR);
+    UtAssert_INT32_EQ(ROMIMOT_Init(), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 6);
+
+    UT_SetDeferredRetcode(UT_KEY(OS_BinSemCreate), 1, OS_ERROR);
+    UtAssert_INT32_EQ(ROMIMOT_Init(), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 7);
+
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_CreateChildTask), 1, CFE_ES_ERR_CHILD_TASK_CREATE);
+    UtAssert_INT32_EQ(ROMIMOT_Init(), CFE_ES_ERR_CHILD_TASK_CREATE);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 8);
+
+    UT_SetDeferredRetcode(UT_KEY(OS_TimeBaseCreate), 1, OS_ERROR);
+    UtAssert_INT32_EQ(ROMIMOT_Init(), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 9);
+
+    UT_SetDeferredRetcode(UT_KEY(OS_TimerAdd), 1, OS_ERROR);
+    UtAssert_INT32_EQ(ROMIMOT_Init(), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 10);
 }
 
-void Test_ROMIMOT_ProcessCommandPacket(void)
+void Test_ROMIMOT_RtProfile(void)
 {
     /*
      * Test Case For:
-     * void ROMIMOT_ProcessCommandPacket
+     * void ROMIMOT_ApplyRtProfile( const char *TaskName, const MRLIB_RtProfile_t *Profile, MRLIB_RtStatus_t *Status )
      */
-    /* a buffer large enough for any command message */
-    union
-    {
-        CFE_SB_Buffer_t   SBBuf;
-        ROMIMOT_NoopCmd_t Noop;
-    } TestMsg;
-    CFE_SB_MsgId_t    TestMsgId;
-    CFE_MSG_FcnCode_t FcnCode;
-    size_t            MsgSize;
+    ROMIMOT_Table_t   TestTblData;
+    ROMIMOT_Table_t * TblPtr = &TestTblData;
+    MRLIB_RtProfile_t Profile;
+    MRLIB_RtStatus_t  Status;
+    MRLIB_RtStatus_t  Got = {.Policy = MRLIB_RT_POLICY_FIFO, .Priority = 80, .CpuMask = 0x4, .LockedKb = 512};
     UT_CheckEvent_t   EventTest;
 
-    memset(&TestMsg, 0, sizeof(TestMsg));
-    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_INVALID_MSGID_ERR_EID, "ROMIMOT: invalid command packet,MID = 0x%x");
+    /* a disabled profile is only read back, without an event */
+    memset(&Profile, 0, sizeof(Profile));
+    UT_SetDataBuffer(UT_KEY(MRLIB_RtApply), &Got, sizeof(Got), false);
+    ROMIMOT_ApplyRtProfile("main", &Profile, &Status);
+    UtAssert_STUB_COUNT(MRLIB_RtApply, 1);
+    UtAssert_STUB_COUNT(CFE_EVS_SendEvent, 0);
+    UtAssert_UINT32_EQ(Status.CpuMask, 0x4);
+
+    /* an applied profile is reported with what the task got */
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_RT_PROFILE_INF_EID, NULL);
+    Profile.Enabled       = 1;
+    Profile.Priority      = 80;
+    Profile.CpuMask       = 0x4;
+    Profile.PrefaultBytes = 4096;
+    ROMIMOT_ApplyRtProfile("I/O", &Profile, &Status);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+
+    /* a step the kernel refused is reported as an error */
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_RT_PROFILE_ERR_EID, NULL);
+    UT_SetDeferredRetcode(UT_KEY(MRLIB_RtApply), 1, CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    ROMIMOT_ApplyRtProfile("I/O", &Profile, &Status);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+
+    /* Init keeps the I/O task's profile for it */
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.IoRtProfile = Profile;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UtAssert_INT32_EQ(ROMIMOT_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.IoRtProfile.Enabled, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.IoRtProfile.CpuMask, Profile.CpuMask);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.IoRtProfile.PrefaultBytes, 4096);
+
+    /* housekeeping reports both tasks */
+    ROMIMOT_Data.Device[0].Enabled   = true;
+    ROMIMOT_Data.IoRtStatus.Policy   = MRLIB_RT_POLICY_FIFO;
+    ROMIMOT_Data.IoRtStatus.Priority = 80;
+    ROMIMOT_Data.IoRtStatus.CpuMask  = 0x8;
+    ROMIMOT_Data.MainRtStatus.Errors = MRLIB_RT_ERR_PRIORITY;
+    ROMIMOT_ReportHousekeeping(NULL);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.IoRt.Policy, MRLIB_RT_POLICY_FIFO);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.IoRt.Priority, 80);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.IoRt.CpuMask, 0x8);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.MainRt.Errors, MRLIB_RT_ERR_PRIORITY);
+
+    /* without a table both tasks stay as OSAL made them */
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+    UtAssert_INT32_EQ(ROMIMOT_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.IoRtProfile.Enabled, 0);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.IoRtStatus.CpuMask, 0);
+}
 
+void Test_ROMIMOT_ProcessCommandPacket(void)
+{
     /*
-     * The CFE_MSG_GetMsgId() stub uses a data buffer to hold the
-     * message ID values to return.
+     * Test Case For:
+     * void ROMIMOT_ProcessCommandPacket
      */
-    TestMsgId = CFE_SB_ValueToMsgId(ROMIMOT_CMD_MID);
-    FcnCode   = ROMIMOT_NOOP_CC;
-    MsgSize   = sizeof(TestMsg.Noop);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &MsgSize, sizeof(MsgSize), false);
-    ROMIMOT_ProcessCommandPacket(&TestMsg.SBBuf);
+    CFE_SB_Buffer_t TestMsg;
 
-    TestMsgId = CFE_SB_ValueToMsgId(ROMIMOT_SEND_HK_MID);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
-    ROMIMOT_ProcessCommandPacket(&TestMsg.SBBuf);
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    ROMIMOT_Data.ErrCounter = 0;
+
+    /* a packet the table takes is counted by its handler */
+    ROMIMOT_ProcessCommandPacket(&TestMsg);
+    UtAssert_STUB_COUNT(MRLIB_Dispatch, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 0);
+
+    /* MRLIB sends the event for a rejected packet, the app only counts it */
+    UT_SetDeferredRetcode(UT_KEY(MRLIB_Dispatch), 1, CFE_STATUS_UNKNOWN_MSG_ID);
+    ROMIMOT_ProcessCommandPacket(&TestMsg);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 1);
+    UtAssert_STUB_COUNT(CFE_EVS_SendEvent, 0);
+}
 
-    /* invalid message id */
-    TestMsgId = CFE_SB_INVALID_MSG_ID;
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
-    ROMIMOT_ProcessCommandPacket(&TestMsg.SBBuf);
+/*
+ * The command ROMIMOT_Dispatch holds for a message ID and function code,
+ * found the way MRLIB_Dispatch() finds it, NULL if there is none.  MRLIB
+ * is stubbed, so the tests call the table's handlers through this.
+ */
+static const MRLIB_Cmd_t *UT_FindCmd(CFE_SB_MsgId_Atom_t MsgId, CFE_MSG_FcnCode_t FcnCode)
+{
+    const MRLIB_Route_t *Route;
+    uint16               i;
 
-    /*
-     * Confirm that the event was generated only _once_
-     */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    for (i = 0; i < ROMIMOT_Dispatch.RouteCount; i++)
+    {
+        Route = &ROMIMOT_Dispatch.Routes[i];
+        if (Route->MsgId != MsgId)
+        {
+            continue;
+        }
+        if (Route->FcnCodes == 0)
+        {
+            return &Route->Cmds[0];
+        }
+        if (FcnCode < Route->FcnCodes && Route->Cmds[FcnCode].Handler != NULL)
+        {
+            return &Route->Cmds[FcnCode];
+        }
+        break;
+    }
+
+    return NULL;
 }
 
-void Test_ROMIMOT_ProcessGroundCommand(void)
+void Test_ROMIMOT_DispatchTable(void)
 {
     /*
      * Test Case For:
-     * void ROMIMOT_ProcessGroundCommand
+     * const MRLIB_Dispatch_t ROMIMOT_Dispatch
      */
-    CFE_MSG_FcnCode_t FcnCode;
-    size_t            Size;
+    const MRLIB_Cmd_t *Cmd;
+    CFE_MSG_FcnCode_t  FcnCode;
 
     /* a buffer large enough for any command message */
     union
@@ -317,63 +410,66 @@ void Test_ROMIMOT_ProcessGroundCommand(void)
         ROMIMOT_NoopCmd_t          Noop;
         ROMIMOT_ResetCountersCmd_t Reset;
         ROMIMOT_ProcessCmd_t       Process;
+        ROMIMOT_SetEnableCmd_t     Enable;
     } TestMsg;
     UT_CheckEvent_t EventTest;
 
     memset(&TestMsg, 0, sizeof(TestMsg));
 
-    /*
-     * call with each of the supported command codes
-     * The CFE_MSG_GetFcnCode stub allows the code to be
-     * set to whatever is needed.  There is no return
-     * value here and the actual implementation of these
-     * commands have separate test cases, so this just
-     * needs to exercise the "switch" statement.
-     */
-
-    /* test dispatch of NOOP */
-    FcnCode = ROMIMOT_NOOP_CC;
-    Size    = sizeof(TestMsg.Noop);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
-    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_COMMANDNOP_INF_EID, NULL);
+    /* rejected packets are reported with the app's own events */
+    UtAssert_UINT32_EQ(ROMIMOT_Dispatch.MsgIdErrEventId, ROMIMOT_INVALID_MSGID_ERR_EID);
+    UtAssert_UINT32_EQ(ROMIMOT_Dispatch.FcnCodeErrEventId, ROMIMOT_COMMAND_ERR_EID);
+    UtAssert_UINT32_EQ(ROMIMOT_Dispatch.LengthErrEventId, ROMIMOT_LEN_ERR_EID);
 
-    ROMIMOT_ProcessGroundCommand(&TestMsg.SBBuf);
+    /* every ground command has a handler, and none lies past the last */
+    for (FcnCode = 0; FcnCode <= ROMIMOT_SEND_CMD_STATS_CC; FcnCode++)
+    {
+        UtAssert_True(UT_FindCmd(ROMIMOT_CMD_MID, FcnCode) != NULL, "Command code %u has a handler",
+                      (unsigned int)FcnCode);
+    }
+    UtAssert_NULL(UT_FindCmd(ROMIMOT_CMD_MID, ROMIMOT_SEND_CMD_STATS_CC + 1));
+    UtAssert_NULL(UT_FindCmd(ROMIMOT_CMD_MID, 1000));
 
+    /* NOOP, the only event is the NOOP's own */
+    Cmd = UT_FindCmd(ROMIMOT_CMD_MID, ROMIMOT_NOOP_CC);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(TestMsg.Noop));
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_COMMANDNOP_INF_EID, NULL);
+    UtAssert_INT32_EQ(Cmd->Handler(&TestMsg.SBBuf), CFE_SUCCESS);
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_STUB_COUNT(CFE_EVS_SendEvent, 1);
 
-    /* test dispatch of RESET */
-    FcnCode = ROMIMOT_RESET_COUNTERS_CC;
-    Size    = sizeof(TestMsg.Reset);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    /* RESET, which also clears the dispatch statistics */
+    Cmd = UT_FindCmd(ROMIMOT_CMD_MID, ROMIMOT_RESET_COUNTERS_CC);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(TestMsg.Reset));
     UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_COMMANDRST_INF_EID, NULL);
-
-    ROMIMOT_ProcessGroundCommand(&TestMsg.SBBuf);
-
+    UtAssert_INT32_EQ(Cmd->Handler(&TestMsg.SBBuf), CFE_SUCCESS);
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_STUB_COUNT(MRLIB_ResetCmdStats, 1);
 
-    /* test dispatch of PROCESS */
-    /* note this will end up calling ROMIMOT_Process(), and as such it needs to
-     * avoid dereferencing a table which does not exist. */
-    FcnCode = ROMIMOT_PROCESS_CC;
-    Size    = sizeof(TestMsg.Process);
+    /* PROCESS, whose missing table is the handler's error for MRLIB to count */
+    Cmd = UT_FindCmd(ROMIMOT_CMD_MID, ROMIMOT_PROCESS_CC);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(TestMsg.Process));
     UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
-
-    ROMIMOT_ProcessGroundCommand(&TestMsg.SBBuf);
-
-    /* test an invalid CC */
-    FcnCode = 1000;
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_COMMAND_ERR_EID, "Invalid ground command code: CC = %d");
-    ROMIMOT_ProcessGroundCommand(&TestMsg.SBBuf);
-
-    /*
-     * Confirm that the event was generated only _once_
-     */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_True(Cmd->Handler(&TestMsg.SBBuf) != CFE_SUCCESS, "PROCESS without a table fails");
+
+    /* enable and disable share a handler */
+    ROMIMOT_Data.Device[0].Enabled = true;
+    Cmd                            = UT_FindCmd(ROMIMOT_CMD_MID, ROMIMOT_MOT_ENABLE_CC);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(TestMsg.Enable));
+    Cmd->Handler(&TestMsg.SBBuf);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].MotorsEnabled, 1);
+    Cmd = UT_FindCmd(ROMIMOT_CMD_MID, ROMIMOT_MOT_DISABLE_CC);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(TestMsg.Enable));
+    Cmd->Handler(&TestMsg.SBBuf);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].MotorsEnabled, 0);
+
+    /* the housekeeping request and the wakeup take any function code */
+    Cmd = UT_FindCmd(ROMIMOT_SEND_HK_MID, 1000);
+    UtAssert_NOT_NULL(Cmd);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(CFE_MSG_CommandHeader_t));
+    Cmd = UT_FindCmd(ROMIMOT_WAKEUP_MID, 1000);
+    UtAssert_NOT_NULL(Cmd);
+    UtAssert_UINT32_EQ(Cmd->Length, sizeof(CFE_MSG_CommandHeader_t));
 }
 
 void Test_ROMIMOT_ReportHousekeeping(void)
@@ -384,10 +480,9 @@ void Test_ROMIMOT_ReportHousekeeping(void)
      */
     CFE_MSG_Message_t *MsgSend;
     CFE_MSG_Message_t *MsgTimestamp;
-    CFE_SB_MsgId_t     MsgId = CFE_SB_ValueToMsgId(ROMIMOT_SEND_HK_MID);
 
-    /* Set message id to return so ROMIMOT_Housekeeping will be called */
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    /* one packet for each enabled Romi */
+    ROMIMOT_Data.Device[0].Enabled = true;
 
     /* Set up to capture send message address */
     UT_SetDataBuffer(UT_KEY(CFE_SB_TransmitMsg), &MsgSend, sizeof(MsgSend), false);
@@ -396,15 +491,15 @@ void Test_ROMIMOT_ReportHousekeeping(void)
     UT_SetDataBuffer(UT_KEY(CFE_SB_TimeStampMsg), &MsgTimestamp, sizeof(MsgTimestamp), false);
 
     /* Call unit under test, NULL pointer confirms command access is through APIs */
-    ROMIMOT_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    ROMIMOT_ReportHousekeeping(NULL);
 
     /* Confirm message sent*/
     UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 1);
-    UtAssert_ADDRESS_EQ(MsgSend, &ROMIMOT_Data.HkTlm);
+    UtAssert_ADDRESS_EQ(MsgSend, &ROMIMOT_Data.Device[0].HkTlm);
 
     /* Confirm timestamp msg address */
     UtAssert_STUB_COUNT(CFE_SB_TimeStampMsg, 1);
-    UtAssert_ADDRESS_EQ(MsgTimestamp, &ROMIMOT_Data.HkTlm);
+    UtAssert_ADDRESS_EQ(MsgTimestamp, &ROMIMOT_Data.Device[0].HkTlm);
 
     /*
      * Confirm that the CFE_TBL_Manage() call was done
@@ -444,6 +539,7 @@ void Test_ROMIMOT_ResetCounters(void)
     UT_CheckEvent_t            EventTest;
 
     memset(&TestMsg, 0, sizeof(TestMsg));
+    ROMIMOT_Data.Device[0].I2CErrCounter = 3;
 
     UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_COMMANDRST_INF_EID, "ROMIMOT: RESET command");
 
@@ -453,6 +549,30 @@ void Test_ROMIMOT_ResetCounters(void)
      * Confirm that the event was generated
      */
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+
+    /* the bus statistics and I2C error count are cleared by the I/O task */
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].BusStatsResetReq);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].I2CErrCounter, 3);
+
+    /* and I2C errors are reported again */
+    UtAssert_STUB_COUNT(CFE_EVS_ResetFilter, 2);
+}
+
+void Test_ROMIMOT_SendCmdStats(void)
+{
+    /*
+     * Test Case For:
+     * int32 ROMIMOT_SendCmdStats( const ROMIMOT_SendCmdStatsCmd_t *Msg )
+     */
+    ROMIMOT_SendCmdStatsCmd_t TestMsg;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    ROMIMOT_Data.CmdCounter = 0;
+
+    /* MRLIB fills in and sends the packet */
+    UtAssert_INT32_EQ(ROMIMOT_SendCmdStats(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.CmdCounter, 1);
+    UtAssert_STUB_COUNT(MRLIB_SendCmdStats, 1);
 }
 
 void Test_ROMIMOT_ProcessCC(void)
@@ -469,8 +589,8 @@ void Test_ROMIMOT_ProcessCC(void)
     memset(&TestMsg, 0, sizeof(TestMsg));
 
     /* Provide some table data for the ROMIMOT_Process() function to use */
-    TestTblData.Int1 = 40;
-    TestTblData.Int2 = 50;
+    TestTblData.Kp          = ROMIMOT_Q16(0.05);
+    TestTblData.OutputLimit = 200;
     UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
     UtAssert_INT32_EQ(ROMIMOT_Process(&TestMsg), CFE_SUCCESS);
 
@@ -487,61 +607,130 @@ void Test_ROMIMOT_ProcessCC(void)
     UtAssert_INT32_EQ(ROMIMOT_Process(&TestMsg), CFE_TBL_ERR_UNREGISTERED);
 }
 
-void Test_ROMIMOT_VerifyCmdLength(void)
+void Test_ROMIMOT_TblValidationFunc(void)
 {
     /*
      * Test Case For:
-     * bool ROMIMOT_VerifyCmdLength
+     * int32 ROMIMOT_TblValidationFunc( void *TblData )
      */
-    UT_CheckEvent_t   EventTest;
-    size_t            size    = 1;
-    CFE_MSG_FcnCode_t fcncode = 2;
-    CFE_SB_MsgId_t    msgid   = CFE_SB_ValueToMsgId(3);
+    ROMIMOT_Table_t TestTblData;
 
-    /*
-     * test a match case
-     */
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &size, sizeof(size), false);
-    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_LEN_ERR_EID,
-                        "Invalid Msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u");
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.ControlRateHz  = ROMIMOT_CONTROL_RATE_MIN_HZ;
+    TestTblData.OutputLimit    = ROMIMOT_PID_OUTPUT_MAX;
+    TestTblData.DAlpha         = ROMIMOT_Q16(1.0);
+    TestTblData.StateBatchSize = 1;
 
-    ROMIMOT_VerifyCmdLength(NULL, size);
+    /* nominal case (0) should succeed */
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-    /*
-     * Confirm that the event was NOT generated
-     */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 0);
+    /* unknown hardware backend */
+    TestTblData.HwBackend = 1 + ROMIMOT_HW_BACKEND_REPLAY;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
 
-    /*
-     * test a mismatch case
-     */
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &size, sizeof(size), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &msgid, sizeof(msgid), false);
-    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &fcncode, sizeof(fcncode), false);
-    ROMIMOT_VerifyCmdLength(NULL, size + 1);
+    /* a bus log to record or replay needs a terminated name */
+    TestTblData.HwBackend = ROMIMOT_HW_BACKEND_REPLAY;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    strncpy(TestTblData.BusLogFile, "/ram/bus.bin", sizeof(TestTblData.BusLogFile) - 1);
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+    TestTblData.ReplaySpeed = ROMIMOT_REPLAY_WALL_CLOCK + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ReplaySpeed = ROMIMOT_REPLAY_WALL_CLOCK;
+    TestTblData.HwBackend   = ROMIMOT_HW_BACKEND_DEFAULT;
+    TestTblData.BusRecord   = 2;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.BusRecord = 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+    memset(TestTblData.BusLogFile, 'x', sizeof(TestTblData.BusLogFile));
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    memset(TestTblData.BusLogFile, 0, sizeof(TestTblData.BusLogFile));
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.BusRecord = 0;
 
-    /*
-     * Confirm that the event WAS generated
-     */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
-}
+    /* a real-time profile MRLIB rejects, for either task */
+    UT_SetDeferredRetcode(UT_KEY(MRLIB_RtValidate), 1, false);
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    UT_SetDeferredRetcode(UT_KEY(MRLIB_RtValidate), 2, false);
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-void Test_ROMIMOT_TblValidationFunc(void)
-{
-    /*
-     * Test Case For:
-     * int32 ROMIMOT_TblValidationFunc( void *TblData )
-     */
-    ROMIMOT_Table_t TestTblData;
+    /* control rate outside 50-500 Hz and unknown control mode */
+    TestTblData.HwBackend     = ROMIMOT_HW_BACKEND_DEFAULT;
+    TestTblData.ControlRateHz = ROMIMOT_CONTROL_RATE_MIN_HZ - 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ControlRateHz = ROMIMOT_CONTROL_RATE_MAX_HZ + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ControlRateHz = ROMIMOT_CONTROL_RATE_MAX_HZ;
+    TestTblData.ControlMode   = ROMIMOT_CONTROL_MODE_TIMER + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
 
-    memset(&TestTblData, 0, sizeof(TestTblData));
+    /* output and integral limits beyond what the firmware accepts */
+    TestTblData.ControlMode = ROMIMOT_CONTROL_MODE_TIMER;
+    TestTblData.OutputLimit = 0;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.OutputLimit = ROMIMOT_PID_OUTPUT_MAX + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.OutputLimit   = ROMIMOT_PID_OUTPUT_MAX;
+    TestTblData.IntegralLimit = ROMIMOT_Q16(ROMIMOT_PID_OUTPUT_MAX) + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
 
-    /* nominal case (0) should succeed */
+    /* negative gains and an out of range derivative filter */
+    TestTblData.IntegralLimit = ROMIMOT_Q16(60);
+    TestTblData.Ki            = -1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.Ki     = 0;
+    TestTblData.DAlpha = 0;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.DAlpha = ROMIMOT_Q16(1.0) + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.DAlpha = ROMIMOT_Q16(1.0);
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+
+    /* profiles need an acceleration limit, and S-curves a jerk limit too */
+    TestTblData.ProfileMode = ROMIMOT_PROFILE_SCURVE + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ProfileMode = ROMIMOT_PROFILE_TRAPEZOID;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ProfileAccel = ROMIMOT_PROFILE_LIMIT_MAX + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ProfileAccel = ROMIMOT_Q16(60);
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+    TestTblData.ProfileMode = ROMIMOT_PROFILE_SCURVE;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ProfileJerk = ROMIMOT_PROFILE_LIMIT_MAX + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ProfileJerk = ROMIMOT_Q16(30);
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+
+    /* state batches hold 1 to ROMIMOT_STATE_BATCH_MAX samples */
+    TestTblData.StateBatchSize = 0;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.StateBatchSize = ROMIMOT_STATE_BATCH_MAX + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.StateBatchSize = ROMIMOT_STATE_BATCH_MAX;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+
+    /* read delays and their calibration margin are bounded */
+    TestTblData.Devices[0].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT] = ROMIMOT_READ_DELAY_MAX_US + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.Devices[0].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT] = ROMIMOT_READ_DELAY_MAX_US;
+    TestTblData.ReadDelayMarginUs                                = ROMIMOT_READ_DELAY_MAX_US + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.ReadDelayMarginUs = ROMIMOT_READ_DELAY_MAX_US;
     UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 
-    /* error case should return ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE */
-    TestTblData.Int1 = 1 + ROMIMOT_TBL_ELEMENT_1_MAX;
+    /* enabled devices need a 7 bit address, each bus and address used once */
+    TestTblData.Devices[0].Enabled = 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.Devices[0].Address = ROMIMOT_I2C_ADDR_MAX + 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.Devices[0].Address = ROMI_I2C_ADDRESS;
+    TestTblData.Devices[1].Address = ROMI_I2C_ADDRESS;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+    TestTblData.Devices[1].Enabled = 1;
     UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.Devices[1].BusNumber = 1;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
 }
 
 void Test_ROMIMOT_GetCrc(void)
@@ -569,12 +758,2103 @@ void Test_ROMIMOT_GetCrc(void)
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 2);
 }
 
+void Test_ROMIMOT_DblBuf(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_DblBuf_Write( ROMIMOT_DblBuf_t *Buf, void *Slots, size_t SlotSize, const void *Src )
+     * bool ROMIMOT_DblBuf_Read( ROMIMOT_DblBuf_t *Buf, const void *Slots, size_t SlotSize, void *Dst,
+     *                           uint32 *LastCount )
+     */
+    ROMIMOT_DblBuf_t   Buf;
+    ROMIMOT_ControlCmd_t Slots[2];
+    ROMIMOT_ControlCmd_t In;
+    ROMIMOT_ControlCmd_t Out;
+    uint32               LastCount = 0;
+
+    ROMIMOT_DblBuf_Init(&Buf);
+    memset(Slots, 0, sizeof(Slots));
+
+    /* nothing published yet */
+    UtAssert_BOOL_FALSE(ROMIMOT_DblBuf_Read(&Buf, Slots, sizeof(Out), &Out, &LastCount));
+
+    memset(&In, 0, sizeof(In));
+    In.TargetDeltaLeft  = 10;
+    In.TargetDeltaRight = -20;
+    ROMIMOT_DblBuf_Write(&Buf, Slots, sizeof(In), &In);
+    UtAssert_BOOL_TRUE(ROMIMOT_DblBuf_Read(&Buf, Slots, sizeof(Out), &Out, &LastCount));
+    UtAssert_INT32_EQ(Out.TargetDeltaLeft, 10);
+    UtAssert_INT32_EQ(Out.TargetDeltaRight, -20);
+
+    /* a second read of the same publish is not new but still returns the data */
+    UtAssert_BOOL_FALSE(ROMIMOT_DblBuf_Read(&Buf, Slots, sizeof(Out), &Out, &LastCount));
+    UtAssert_INT32_EQ(Out.TargetDeltaLeft, 10);
+
+    /* the next publish lands in the other slot */
+    In.TargetDeltaLeft = 30;
+    ROMIMOT_DblBuf_Write(&Buf, Slots, sizeof(In), &In);
+    UtAssert_BOOL_TRUE(ROMIMOT_DblBuf_Read(&Buf, Slots, sizeof(Out), &Out, &LastCount));
+    UtAssert_INT32_EQ(Out.TargetDeltaLeft, 30);
+    UtAssert_INT32_EQ(Slots[0].TargetDeltaLeft, 30);
+    UtAssert_INT32_EQ(Slots[1].TargetDeltaLeft, 10);
+}
+
+void Test_ROMIMOT_IoCycle(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_IoCycle( void )
+     */
+    ROMIMOT_SensorState_t Sensor;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+
+    /* with the bus closed a cycle still publishes a snapshot */
+    ROMIMOT_IoCycle();
+    UtAssert_BOOL_TRUE(ROMIMOT_DblBuf_Read(&ROMIMOT_Data.Device[0].SensorBuf, ROMIMOT_Data.Device[0].SensorSlots,
+                                           sizeof(Sensor), &Sensor, &ROMIMOT_Data.Device[0].SensorCount));
+    UtAssert_BOOL_FALSE(Sensor.I2COpen);
+    UtAssert_UINT32_EQ(Sensor.Sequence, 1);
+
+    /* Wakeup hands the cycle to the I/O task */
+    UtAssert_INT32_EQ(ROMIMOT_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OS_BinSemGive, 1);
+}
+
+void Test_ROMIMOT_SimBackend(void)
+{
+    /*
+     * Test Case For:
+     * int32 ROMIMOT_ConnectI2C( void )
+     * void ROMIMOT_SelectBackend( void )
+     * const RomiBackend romiBackendSim
+     */
+    ROMIMOT_Table_t TestTblData;
+    void *          TblPtr = &TestTblData;
+    RomiSnapshot    Snapshot;
+    EncoderPair     Encoders;
+    uint8           Version;
+    uint16          Sequence;
+    uint32          Micros;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestTblData, 0, sizeof(TestTblData));
+
+    /* the table selects the simulated Romi */
+    TestTblData.HwBackend            = ROMIMOT_HW_BACKEND_SIM;
+    TestTblData.Devices[0].BusNumber = 1;
+    TestTblData.Devices[0].Address   = ROMI_I2C_ADDRESS;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UtAssert_INT32_EQ(ROMIMOT_ConnectI2C(&ROMIMOT_Data.Device[0]), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].i2c_open);
+    UtAssert_ADDRESS_EQ(romiGetBackend(), &romiBackendSim);
+
+    romiSimUseWallClock(0);
+
+    /* the firmware reports the register map it was built with */
+    UtAssert_INT32_EQ(romiVersionRead(ROMIMOT_Data.Device[0].i2cfd, &Version), 0);
+    UtAssert_UINT32_EQ(Version, ROMI_REGMAP_VERSION);
+
+    /* idle robot does not move */
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &Snapshot), 0);
+    UtAssert_INT32_EQ(Snapshot.encoders.left, 0);
+    UtAssert_INT32_EQ(Snapshot.encoders.right, 0);
+    Sequence = Snapshot.sequence;
+    Micros   = Snapshot.micros;
+
+    /* wheels follow the commanded direction and the battery sags under load */
+    UtAssert_INT32_EQ(romiMotorWrite(ROMIMOT_Data.Device[0].i2cfd, 300, -150), 0);
+    romiSimAdvance(0.5);
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &Snapshot), 0);
+    UtAssert_True(Snapshot.sequence != Sequence, "sample %u is a new one", Snapshot.sequence);
+    UtAssert_UINT32_EQ(Snapshot.micros - Micros, 500000);
+    UtAssert_True(Snapshot.encoders.left > 1000, "left encoder %d advanced", Snapshot.encoders.left);
+    UtAssert_True(Snapshot.encoders.right < -500, "right encoder %d reversed", Snapshot.encoders.right);
+    UtAssert_True(Snapshot.encoders.left > -2 * Snapshot.encoders.right - 50 &&
+                      Snapshot.encoders.left < -2 * Snapshot.encoders.right + 50,
+                  "wheel travel follows power ratio");
+    UtAssert_True(Snapshot.batteryMillivolts < 7200 && Snapshot.batteryMillivolts > 6000, "battery %u mV",
+                  Snapshot.batteryMillivolts);
+
+    /* out of range commands are ignored like the firmware does */
+    UtAssert_INT32_EQ(romiMotorWrite(ROMIMOT_Data.Device[0].i2cfd, 400, 0), 0);
+    romiSimAdvance(0.5);
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &Snapshot), 0);
+    UtAssert_True(Snapshot.encoders.right < -1200, "right encoder %d still reversing", Snapshot.encoders.right);
+
+    /* the counts run well past 16 bits between two polls */
+    UtAssert_INT32_EQ(romiMotorWrite(ROMIMOT_Data.Device[0].i2cfd, 300, -300), 0);
+    romiSimAdvance(20.0);
+    UtAssert_INT32_EQ(romiEncoderRead(ROMIMOT_Data.Device[0].i2cfd, &Encoders), 0);
+    UtAssert_True(Encoders.left > 40000, "left encoder %d past 16 bits", Encoders.left);
+    UtAssert_True(Encoders.right < -40000, "right encoder %d past 16 bits", Encoders.right);
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &Snapshot), 0);
+    UtAssert_INT32_EQ(Snapshot.encoders.left, Encoders.left);
+    UtAssert_INT32_EQ(Snapshot.encoders.right, Encoders.right);
+
+    /* a full I/O cycle runs against the simulator, and its odometers see the whole move */
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].I2CErrCounter, 0);
+    UtAssert_INT32_EQ(ROMIMOT_Data.Device[0].Sensor.Ctl.LeftOdo, Encoders.left);
+    UtAssert_INT32_EQ(ROMIMOT_Data.Device[0].Sensor.Ctl.RightOdo, Encoders.right);
+
+    /* the build default is used when the table does not choose */
+    TestTblData.HwBackend = ROMIMOT_HW_BACKEND_DEFAULT;
+    ROMIMOT_SelectBackend(&ROMIMOT_Data.Device[0]);
+    UtAssert_ADDRESS_EQ(romiGetBackend(), ROMIMOT_HW_DEFAULT_BACKEND == ROMIMOT_HW_BACKEND_SIM ? &romiBackendSim
+                                                                                              : &romiBackendI2C);
+
+    /* a table that cannot be read also falls back to the build default */
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+    ROMIMOT_SelectBackend(&ROMIMOT_Data.Device[0]);
+    UtAssert_STUB_COUNT(CFE_TBL_ReleaseAddress, 2);
+
+    romiSimUseWallClock(1);
+}
+
+/*
+ * Simulated Romi whose reads have one bit flipped in transit
+ */
+static int UT_CorruptReadReg(int handle, uint8_t addr, uint8_t *buf, uint8_t len, int delayUs)
+{
+    int status = romiBackendSim.readReg(handle, addr, buf, len, delayUs);
+
+    buf[len / 2] ^= 0x10;
+    return status;
+}
+
+static const RomiBackend UT_CorruptBackend = {"corrupt", NULL, NULL, UT_CorruptReadReg, NULL};
+
+void Test_romiSnapshotRead(void)
+{
+    /*
+     * Test Case For:
+     * int romiSnapshotRead( int i2cfd, RomiSnapshot *snapshot )
+     */
+    RomiSnapshot Snapshot;
+    uint8        Block[ROMI_TLM_LEN];
+    int          Handle;
+
+    romiSetBackend(&romiBackendSim);
+    romiSimUseWallClock(0);
+    Handle = romiOpen(1, ROMI_I2C_ADDRESS);
+    UtAssert_INT32_GTEQ(Handle, 0);
+    UtAssert_INT32_EQ(romiMotorWrite(Handle, 200, -100), 0);
+    romiSimAdvance(0.2);
+
+    /* every field decodes from its place in the block */
+    UtAssert_INT32_EQ(romiRead(Handle, ROMI_REG_TLM, sizeof(Block), Block), 0);
+    UtAssert_INT32_EQ(romiSnapshotRead(Handle, &Snapshot), 0);
+    UtAssert_UINT32_EQ(Snapshot.sequence, Block[0] | (Block[1] << 8));
+    UtAssert_UINT32_EQ(Snapshot.micros, 200000);
+    UtAssert_INT32_EQ(Snapshot.encoders.left,
+                      (int32)(Block[6] | (Block[7] << 8) | (Block[8] << 16) | ((uint32)Block[9] << 24)));
+    UtAssert_True(Snapshot.encoders.left > 0 && Snapshot.encoders.right < 0, "encoders %d %d",
+                  Snapshot.encoders.left, Snapshot.encoders.right);
+    UtAssert_INT32_EQ(Snapshot.velocity.left, (int16)(Block[14] | (Block[15] << 8)));
+    UtAssert_UINT32_EQ(Snapshot.batteryMillivolts, Block[20] | (Block[21] << 8));
+    UtAssert_UINT32_EQ(Block[ROMI_REG_CHECK - ROMI_REG_TLM], romiTlmCheck(Block));
+
+    /* a block that does not match its check byte is refused, not decoded */
+    memset(&Snapshot, 0, sizeof(Snapshot));
+    romiSetBackend(&UT_CorruptBackend);
+    UtAssert_INT32_EQ(romiSnapshotRead(Handle, &Snapshot), ROMIMOT_I2C_DAT_BAD_ERR_EID);
+    UtAssert_UINT32_EQ(Snapshot.sequence, 0);
+    UtAssert_INT32_EQ(Snapshot.encoders.left, 0);
+
+    /* so is a blank one */
+    memset(Block, 0, sizeof(Block));
+    UtAssert_True(romiTlmCheck(Block) != 0, "all zero block fails its check");
+
+    romiSetBackend(&romiBackendSim);
+    romiClose(Handle);
+    romiSimUseWallClock(1);
+}
+
+#define UT_BUS_LOG "/tmp/romimot_ut_bus.bin"
+
+void Test_ROMIMOT_BusLog(void)
+{
+    /*
+     * Test Case For:
+     * const RomiBackend romiBackendRecord
+     * const RomiBackend romiBackendReplay
+     * int32 ROMIMOT_StartBusRecord( const char *BusLogFile, const RomiBackend *Target )
+     * void ROMIMOT_StartBusReplay( const char *BusLogFile, uint16 ReplaySpeed )
+     * void ROMIMOT_ReportBusLog( void )
+     * int romiRecordFlush( void )
+     */
+    ROMIMOT_Table_t TestTblData;
+    void *          TblPtr = &TestTblData;
+    RomiSnapshot    Recorded[2];
+    RomiSnapshot    Snapshot;
+    RomiLogStats    Stats;
+    RomiLogHeader   Header;
+    RomiLogRecord   Record;
+    uint8           Buf[4];
+    int             Handle;
+    int             i;
+    FILE *          File;
+    UT_CheckEvent_t EventTest;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.HwBackend            = ROMIMOT_HW_BACKEND_SIM;
+    TestTblData.BusRecord            = 1;
+    TestTblData.Devices[0].BusNumber = 1;
+    TestTblData.Devices[0].Address   = ROMI_I2C_ADDRESS;
+    strncpy(TestTblData.BusLogFile, UT_BUS_LOG, sizeof(TestTblData.BusLogFile) - 1);
+    romiSimUseWallClock(0);
+
+    /* a session against the simulated Romi is recorded as it runs */
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UtAssert_INT32_EQ(ROMIMOT_ConnectI2C(&ROMIMOT_Data.Device[0]), CFE_SUCCESS);
+    UtAssert_ADDRESS_EQ(romiGetBackend(), &romiBackendRecord);
+    Handle = ROMIMOT_Data.Device[0].i2cfd;
+
+    UtAssert_INT32_EQ(romiSnapshotRead(Handle, &Recorded[0]), 0);
+    UtAssert_INT32_EQ(romiMotorWrite(Handle, 200, -200), 0);
+    romiSimAdvance(0.2);
+    UtAssert_INT32_EQ(romiSnapshotRead(Handle, &Recorded[1]), 0);
+    UtAssert_INT32_EQ(romiRead(Handle, ROMI_REG_TLM_END, sizeof(Buf), Buf), ROMIMOT_I2C_DAT_R_ERR_EID);
+    romiClose(Handle);
+    ROMIMOT_Data.Device[0].i2c_open = false;
+
+    /* reopening carries on with the same file */
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    ROMIMOT_SelectBackend(&ROMIMOT_Data.Device[0]);
+    ROMIMOT_ReportBusLog();
+    romiRecordGetStats(&Stats);
+    UtAssert_UINT32_EQ(Stats.active, 1);
+    UtAssert_UINT32_EQ(Stats.records, 7); /* open, version, snapshot, write, snapshot, failed read, close */
+    UtAssert_UINT32_EQ(Stats.lost, 0);
+
+    /* switching to the replay closes the recording and loads it */
+    TestTblData.HwBackend = ROMIMOT_HW_BACKEND_REPLAY;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UtAssert_INT32_EQ(ROMIMOT_ConnectI2C(&ROMIMOT_Data.Device[0]), CFE_SUCCESS);
+    UtAssert_ADDRESS_EQ(romiGetBackend(), &romiBackendReplay);
+    romiRecordGetStats(&Stats);
+    UtAssert_UINT32_EQ(Stats.active, 0);
+    romiReplayGetStats(&Stats);
+    UtAssert_UINT32_EQ(Stats.logged, 7);
+    Handle = ROMIMOT_Data.Device[0].i2cfd;
+
+    /* the Romi answers as it did, whatever the simulator does now */
+    romiSimAdvance(1.0);
+    UtAssert_INT32_EQ(romiSnapshotRead(Handle, &Snapshot), 0);
+    UtAssert_UINT32_EQ(Snapshot.micros, Recorded[0].micros);
+    UtAssert_UINT32_EQ(Snapshot.sequence, Recorded[0].sequence);
+
+    /* a motor command other than the recorded one is counted, not refused */
+    UtAssert_INT32_EQ(romiMotorWrite(Handle, 100, -200), 0);
+    UtAssert_INT32_EQ(romiSnapshotRead(Handle, &Snapshot), 0);
+    UtAssert_INT32_EQ(Snapshot.encoders.left, Recorded[1].encoders.left);
+    UtAssert_INT32_EQ(Snapshot.encoders.right, Recorded[1].encoders.right);
+    UtAssert_UINT32_EQ(Snapshot.micros, Recorded[1].micros);
+
+    /* recorded failures fail again, and accesses the log never saw fail too */
+    UtAssert_INT32_EQ(romiRead(Handle, ROMI_REG_TLM_END, sizeof(Buf), Buf), ROMIMOT_I2C_DAT_R_ERR_EID);
+    UtAssert_INT32_EQ(romiRead(Handle, ROMI_REG_BATTERY, sizeof(Buf), Buf), ROMIMOT_I2C_DAT_R_ERR_EID);
+    romiClose(Handle);
+    ROMIMOT_Data.Device[0].i2c_open = false;
+
+    romiReplayGetStats(&Stats);
+    UtAssert_UINT32_EQ(Stats.records, 7);
+    UtAssert_UINT32_EQ(Stats.unmatched, 1);
+    UtAssert_UINT32_EQ(Stats.diverged, 1);
+    UtAssert_UINT32_EQ(Stats.ended, 1);
+
+    /* the end of the replay is reported once */
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_BUS_LOG_INF_EID, NULL);
+    ROMIMOT_ReportBusLog();
+    ROMIMOT_ReportBusLog();
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+
+    /* a caller that takes another path gets back in step */
+    UtAssert_INT32_EQ(romiReplayLoad(UT_BUS_LOG, 1), 0);
+    UtAssert_INT32_EQ(romiOpen(2, ROMI_I2C_ADDRESS), ROMIMOT_I2C_DEV_FD_ERR_EID);
+    Handle = romiOpen(1, ROMI_I2C_ADDRESS);
+    UtAssert_INT32_GTEQ(Handle, 0);
+    UtAssert_INT32_EQ(romiMotorWrite(Handle, 200, -200), 0);
+    UtAssert_INT32_EQ(romiMotorWrite(Handle + ROMI_MAX_DEVICES, 200, -200), ROMIMOT_I2C_DAT_W_ERR_EID);
+    romiReplayGetStats(&Stats);
+    UtAssert_UINT32_EQ(Stats.skipped, 2);
+    UtAssert_UINT32_EQ(Stats.diverged, 0);
+    UtAssert_UINT32_EQ(Stats.unmatched, 1);
+
+    /* logs that are missing, foreign or cut short are refused */
+    UtAssert_INT32_EQ(romiReplayLoad("romimot_ut_missing.bin", 0), -1);
+    memset(&Header, 0, sizeof(Header));
+    File = fopen(UT_BUS_LOG, "wb");
+    fwrite(&Header, sizeof(Header), 1, File);
+    fclose(File);
+    UtAssert_INT32_EQ(romiReplayLoad(UT_BUS_LOG, 0), -1);
+
+    Header.magic         = ROMI_LOG_MAGIC;
+    Header.version       = ROMI_LOG_VERSION;
+    Header.regmapVersion = ROMI_REGMAP_VERSION;
+    Header.recordSize    = sizeof(RomiLogRecord);
+    memset(&Record, 0, sizeof(Record));
+    Record.op  = ROMI_LOG_READ;
+    Record.len = 4;
+    File       = fopen(UT_BUS_LOG, "wb");
+    fwrite(&Header, sizeof(Header), 1, File);
+    fwrite(&Record, sizeof(Record), 1, File);
+    fclose(File);
+    UtAssert_INT32_EQ(romiReplayLoad(UT_BUS_LOG, 0), -1);
+
+    /* a replay that cannot load keeps the replay backend, so no bus is driven */
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_BUS_LOG_ERR_EID, NULL);
+    romiReplayUnload();
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UtAssert_INT32_EQ(ROMIMOT_ConnectI2C(&ROMIMOT_Data.Device[0]), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_ADDRESS_EQ(romiGetBackend(), &romiBackendReplay);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+
+    /* a recording whose file cannot be created stops at the next housekeeping */
+    TestTblData.HwBackend = ROMIMOT_HW_BACKEND_SIM;
+    strncpy(TestTblData.BusLogFile, "romimot_ut_missing/bus.bin", sizeof(TestTblData.BusLogFile) - 1);
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    ROMIMOT_SelectBackend(&ROMIMOT_Data.Device[0]);
+    UtAssert_ADDRESS_EQ(romiGetBackend(), &romiBackendRecord);
+    ROMIMOT_ReportBusLog();
+    romiRecordGetStats(&Stats);
+    UtAssert_UINT32_EQ(Stats.active, 0);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 2);
+
+    /* a recording that cannot start leaves the bus unrecorded */
+    UT_SetDeferredRetcode(UT_KEY(OS_TranslatePath), 1, OS_ERROR);
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    ROMIMOT_SelectBackend(&ROMIMOT_Data.Device[0]);
+    UtAssert_ADDRESS_EQ(romiGetBackend(), &romiBackendSim);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 3);
+
+    /* records that find the ring full are lost, the bus is never held up */
+    strncpy(TestTblData.BusLogFile, UT_BUS_LOG, sizeof(TestTblData.BusLogFile) - 1);
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    ROMIMOT_SelectBackend(&ROMIMOT_Data.Device[0]);
+    UtAssert_ADDRESS_EQ(romiGetBackend(), &romiBackendRecord);
+    Handle = romiOpen(1, ROMI_I2C_ADDRESS);
+    for (i = 0; i < 4096; i++)
+    {
+        UtAssert_INT32_EQ(romiRead(Handle, ROMI_REG_BATTERY, sizeof(Buf), Buf), 0);
+    }
+    romiRecordGetStats(&Stats);
+    UtAssert_UINT32_EQ(Stats.records, 3277); /* the open and the reads that filled the ring */
+    UtAssert_UINT32_EQ(Stats.lost, 820);
+
+    /* the main task writes out what the ring holds once the recording stops */
+    romiClose(Handle);
+    ROMIMOT_StopBusRecord();
+    UtAssert_INT32_EQ(romiRecordFlush(), 0);
+    UtAssert_INT32_EQ(romiReplayLoad(UT_BUS_LOG, 0), 0);
+    romiReplayGetStats(&Stats);
+    UtAssert_UINT32_EQ(Stats.logged, 3277);
+    romiReplayUnload();
+
+    remove(UT_BUS_LOG);
+    romiSimUseWallClock(1);
+}
+
+void Test_ROMIMOT_ControlStep(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_UpdateOdometry( ROMIMOT_ControlState_t *Ctl, const RomiSnapshot *Romi )
+     * void ROMIMOT_ControlStep( ROMIMOT_ControlState_t *Ctl, const ROMIMOT_ControlCmd_t *Cmd )
+     */
+    ROMIMOT_ControlState_t Ctl;
+    ROMIMOT_ControlCmd_t   Cmd;
+    ROMIMOT_Profile_t      Profile;
+    RomiSnapshot           Romi;
+
+    memset(&Ctl, 0, sizeof(Ctl));
+    memset(&Cmd, 0, sizeof(Cmd));
+    memset(&Profile, 0, sizeof(Profile));
+    memset(&Romi, 0, sizeof(Romi));
+    Cmd.Gains.Kp          = ROMIMOT_Q16(0.05);
+    Cmd.Gains.DAlpha      = ROMIMOT_Q16(1.0);
+    Cmd.Gains.OutputLimit = 200;
+
+    /* encoder deltas accumulate into the odometers across a 32 bit wrap */
+    Ctl.RawLeftEncoder   = 2147483640;
+    Ctl.LeftOdo          = 100;
+    Romi.encoders.left   = -2147483646;
+    Romi.encoders.right  = -5;
+    ROMIMOT_UpdateOdometry(&Ctl, &Romi);
+    UtAssert_INT32_EQ(Ctl.LeftEncoderDelta, 10);
+    UtAssert_INT32_EQ(Ctl.LeftOdo, 110);
+    UtAssert_INT32_EQ(Ctl.RightOdo, -5);
+
+    /* a long gap between readings loses nothing */
+    Romi.encoders.right = -100005;
+    ROMIMOT_UpdateOdometry(&Ctl, &Romi);
+    UtAssert_INT32_EQ(Ctl.RightEncoderDelta, -100000);
+    UtAssert_INT32_EQ(Ctl.RightOdo, -100005);
+
+    /* disabled motors are held at zero power */
+    Ctl.LeftMotSpeed = 50;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 0);
+    UtAssert_INT32_EQ(Ctl.RightMotSpeed, 0);
+
+    /* the intermediate target walks toward the target by the delta each cycle */
+    Cmd.MotorsEnabled    = 1;
+    Cmd.LeftOdoTrgt      = 1000;
+    Cmd.RightOdoTrgt     = -1000;
+    Cmd.TargetDeltaLeft  = 400;
+    Cmd.TargetDeltaRight = 400;
+    Ctl.LeftOdo          = 0;
+    Ctl.RightOdo         = 0;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 400);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, -400);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 20);
+    UtAssert_INT32_EQ(Ctl.RightMotSpeed, -20);
+
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 1000);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, -1000);
+
+    /* power is capped at +/- 200 */
+    Cmd.LeftOdoTrgt  = 20000;
+    Cmd.RightOdoTrgt = -20000;
+    Ctl.LeftOdoStep  = 20000;
+    Ctl.RightOdoStep = -20000;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 200);
+    UtAssert_INT32_EQ(Ctl.RightMotSpeed, -200);
+
+    /* feedforward follows the step actually taken toward the target */
+    Cmd.Gains.Kp    = 0;
+    Cmd.Gains.Kff   = ROMIMOT_Q16(0.5);
+    Cmd.LeftOdoTrgt = 20100;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 50);
+    UtAssert_INT32_EQ(Ctl.RightMotSpeed, 0);
+
+    /* a new target follows its profile once the profile has arrived */
+    Cmd.LeftOdoTrgt = Ctl.LeftOdoStep + 100;
+    Cmd.ProfileSeq  = 1;
+    ROMIMOT_ProfileBuildRamp(&Profile.Left, ROMIMOT_PROFILE_TRAPEZOID, 10, ROMIMOT_Q16(2.5), 0);
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.ProfileSeq, 0);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, Cmd.LeftOdoTrgt);
+
+    Cmd.LeftOdoTrgt += 100;
+    Profile.Seq = 1;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.ProfileSeq, 1);
+    UtAssert_BOOL_TRUE(Ctl.LeftProfile.Active);
+    UtAssert_BOOL_FALSE(Ctl.RightProfile.Active);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, Cmd.LeftOdoTrgt - 97);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 2);
+
+    /* disabling resets the wheel PIDs and pauses the move */
+    Cmd.MotorsEnabled = 0;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_BOOL_FALSE(Ctl.LeftPid.Primed);
+    UtAssert_INT32_EQ(Ctl.LeftProfile.Tick, 1);
+}
+
+void Test_ROMIMOT_Profile(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_ProfileBuildRamp( ROMIMOT_Ramp_t *Ramp, uint16 Mode, int32 Speed, int32 Accel, int32 Jerk )
+     * void ROMIMOT_ProfileStart( ROMIMOT_ProfileState_t *State, const ROMIMOT_Ramp_t *Ramp, int32 From, int32 To )
+     * int32 ROMIMOT_ProfileNext( ROMIMOT_ProfileState_t *State, const ROMIMOT_Ramp_t *Ramp )
+     */
+    ROMIMOT_Ramp_t         Ramp;
+    ROMIMOT_ProfileState_t State;
+    int32                  Position;
+    int32                  Previous;
+    int32                  Step;
+    int32                  Cycles;
+
+    /* trapezoid: 2.5 counts/cycle^2 up to 10 counts/cycle */
+    ROMIMOT_ProfileBuildRamp(&Ramp, ROMIMOT_PROFILE_TRAPEZOID, 10, ROMIMOT_Q16(2.5), 0);
+    UtAssert_UINT32_EQ(Ramp.Length, 4);
+    UtAssert_INT32_EQ(Ramp.Position[0], 3);
+    UtAssert_INT32_EQ(Ramp.Position[3], 25);
+
+    /* a long move ramps up, cruises, and ramps down onto the target */
+    ROMIMOT_ProfileStart(&State, &Ramp, 1000, 1100);
+    UtAssert_INT32_EQ(State.Ramp, 4);
+    UtAssert_INT32_EQ(State.Cruise, 5);
+    UtAssert_INT32_EQ(ROMIMOT_ProfileNext(&State, &Ramp), 1003);
+    Previous = 1003;
+    Cycles   = 1;
+    while (State.Active)
+    {
+        Position = ROMIMOT_ProfileNext(&State, &Ramp);
+        Step     = Position - Previous;
+        UtAssert_True(Step >= 3 && Step <= 10, "Step %d within ramp limits", (int)Step);
+        Previous = Position;
+        Cycles++;
+    }
+    UtAssert_INT32_EQ(Previous, 1100);
+    UtAssert_INT32_EQ(Cycles, 13);
+
+    /* a short move never reaches cruise speed, and moves backward as well */
+    ROMIMOT_ProfileStart(&State, &Ramp, 0, -20);
+    UtAssert_INT32_EQ(State.Ramp, 2);
+    UtAssert_INT32_EQ(ROMIMOT_ProfileNext(&State, &Ramp), -3);
+    UtAssert_INT32_EQ(ROMIMOT_ProfileNext(&State, &Ramp), -8);
+    UtAssert_INT32_EQ(ROMIMOT_ProfileNext(&State, &Ramp), -12);
+    UtAssert_INT32_EQ(ROMIMOT_ProfileNext(&State, &Ramp), -17);
+    UtAssert_INT32_EQ(ROMIMOT_ProfileNext(&State, &Ramp), -20);
+    UtAssert_BOOL_FALSE(State.Active);
+
+    /* no move needed */
+    ROMIMOT_ProfileStart(&State, &Ramp, 5, 5);
+    UtAssert_BOOL_FALSE(State.Active);
+
+    /* S-curve: the acceleration itself ramps by the jerk limit */
+    ROMIMOT_ProfileBuildRamp(&Ramp, ROMIMOT_PROFILE_SCURVE, 300, ROMIMOT_Q16(60), ROMIMOT_Q16(30));
+    UtAssert_UINT32_EQ(Ramp.Length, 6);
+    UtAssert_INT32_EQ(Ramp.Position[0], 30);
+    UtAssert_INT32_EQ(Ramp.Position[1], 120);
+    UtAssert_INT32_EQ(Ramp.Position[4] - Ramp.Position[3], 270);
+    UtAssert_INT32_EQ(Ramp.Position[5] - Ramp.Position[4], 300);
+
+    /* ramps that would be too long top out early */
+    ROMIMOT_ProfileBuildRamp(&Ramp, ROMIMOT_PROFILE_TRAPEZOID, 300, ROMIMOT_Q16(0.5), 0);
+    UtAssert_UINT32_EQ(Ramp.Length, ROMIMOT_PROFILE_RAMP_MAX);
+
+    /* linear mode and a zero speed leave no ramp to follow */
+    ROMIMOT_ProfileBuildRamp(&Ramp, ROMIMOT_PROFILE_LINEAR, 300, ROMIMOT_Q16(60), 0);
+    UtAssert_UINT32_EQ(Ramp.Length, 0);
+    ROMIMOT_ProfileBuildRamp(&Ramp, ROMIMOT_PROFILE_TRAPEZOID, 0, ROMIMOT_Q16(60), 0);
+    UtAssert_UINT32_EQ(Ramp.Length, 0);
+    ROMIMOT_ProfileStart(&State, &Ramp, 0, 100);
+    UtAssert_BOOL_FALSE(State.Active);
+}
+
+void Test_ROMIMOT_PlanProfile(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_PlanProfile( void )
+     * Profile hand-off in ROMIMOT_IoCycle( void )
+     */
+    ROMIMOT_SetTargetCmd_t TestMsg;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestMsg, 0, sizeof(TestMsg));
+
+    ROMIMOT_Data.ProfileMode      = ROMIMOT_PROFILE_TRAPEZOID;
+    ROMIMOT_Data.ProfileAccel     = ROMIMOT_Q16(2.5);
+    ROMIMOT_Data.Device[0].TargetDeltaLeft  = 10;
+    ROMIMOT_Data.Device[0].TargetDeltaRight = 20;
+    ROMIMOT_Data.Device[0].MotorsEnabled    = 1;
+
+    /* each target command plans a new profile */
+    TestMsg.cmdMotLeft = 100;
+    UtAssert_INT32_EQ(ROMIMOT_SetTarget(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].Profile.Seq, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].Profile.Left.Length, 4);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].Profile.Right.Length, 8);
+
+    /* the I/O task picks it up with the command that refers to it */
+    romiSetBackend(&romiBackendSim);
+    romiSimUseWallClock(0);
+    ROMIMOT_Data.Device[0].i2cfd    = romiOpen(1, ROMI_I2C_ADDRESS);
+    ROMIMOT_Data.Device[0].i2c_open = true;
+
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoProfile.Seq, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Ctl.ProfileSeq, 1);
+    UtAssert_INT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Ctl.LeftOdoStep, 3);
+    UtAssert_INT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Ctl.RightOdoStep, 0);
+
+    romiClose(ROMIMOT_Data.Device[0].i2cfd);
+    romiSetBackend(&romiBackendI2C);
+    romiSimUseWallClock(1);
+}
+
+void Test_ROMIMOT_Pid(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_PidReset( ROMIMOT_PidState_t *State )
+     * int16 ROMIMOT_PidStep( ROMIMOT_PidState_t *State, const ROMIMOT_PidGains_t *Gains, int32 Error,
+     *                        int32 RefVelocity )
+     * int16 ROMIMOT_PidStepRate( ROMIMOT_PidState_t *State, const ROMIMOT_PidGains_t *Gains, int32 Error,
+     *                            int32 RefVelocity, int64 ErrorRate )
+     */
+    ROMIMOT_PidState_t State;
+    ROMIMOT_PidGains_t Gains;
+
+    memset(&Gains, 0, sizeof(Gains));
+    Gains.DAlpha      = ROMIMOT_Q16(1.0);
+    Gains.OutputLimit = 300;
+
+    /* proportional term rounds half away from zero, the same both ways */
+    ROMIMOT_PidReset(&State);
+    Gains.Kp = ROMIMOT_Q16(0.5);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 3, 0), 2);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, -3, 0), -2);
+
+    /* feedforward on the reference velocity */
+    ROMIMOT_PidReset(&State);
+    Gains.Kp  = 0;
+    Gains.Kff = ROMIMOT_Q16(0.8);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 0, 10), 8);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 0, -10), -8);
+
+    /* the integral accumulates up to its limit */
+    ROMIMOT_PidReset(&State);
+    Gains.Kff           = 0;
+    Gains.Ki            = ROMIMOT_Q16(1.0);
+    Gains.IntegralLimit = ROMIMOT_Q16(5);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 3, 0), 3);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 3, 0), 5);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, -3, 0), 2);
+
+    /* it is held while the output is saturated, and unwinds straight away */
+    ROMIMOT_PidReset(&State);
+    Gains.Kp            = ROMIMOT_Q16(1.0);
+    Gains.IntegralLimit = ROMIMOT_Q16(100);
+    Gains.OutputLimit   = 10;
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 20, 0), 10);
+    UtAssert_INT32_EQ(State.Integral, 0);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, -20, 0), -10);
+    UtAssert_INT32_EQ(State.Integral, 0);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, -2, 0), -4);
+    UtAssert_INT32_EQ(State.Integral, ROMIMOT_Q16(-2));
+
+    /* the derivative skips the first sample and is low-pass filtered */
+    ROMIMOT_PidReset(&State);
+    Gains.Kp          = 0;
+    Gains.Ki          = 0;
+    Gains.Kd          = ROMIMOT_Q16(1.0);
+    Gains.DAlpha      = ROMIMOT_Q16(0.5);
+    Gains.OutputLimit = 300;
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 100, 0), 0);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 110, 0), 5);
+    UtAssert_INT32_EQ(ROMIMOT_PidStep(&State, &Gains, 110, 0), 3);
+    UtAssert_BOOL_TRUE(State.Primed);
+
+    /* a measured error rate needs no previous sample, and is filtered alike */
+    ROMIMOT_PidReset(&State);
+    UtAssert_INT32_EQ(ROMIMOT_PidStepRate(&State, &Gains, 100, 0, ROMIMOT_Q16(10)), 5);
+    UtAssert_INT32_EQ(ROMIMOT_PidStepRate(&State, &Gains, 100, 0, ROMIMOT_Q16(10)), 8);
+
+    ROMIMOT_PidReset(&State);
+    UtAssert_BOOL_FALSE(State.Primed);
+    UtAssert_INT32_EQ(State.DFiltered, 0);
+}
+
+void Test_ROMIMOT_ControlTimer(void)
+{
+    /*
+     * Test Case For:
+     * int32 ROMIMOT_ConfigureControl( uint16 Mode, uint16 RateHz )
+     * void ROMIMOT_TimerCallback( osal_id_t TimerId, void *Arg )
+     */
+    ROMIMOT_Table_t TestTblData;
+    void *          TblPtr = &TestTblData;
+    UT_CheckEvent_t EventTest;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestTblData, 0, sizeof(TestTblData));
+
+    /* staying in wakeup mode does not touch the timer */
+    UtAssert_INT32_EQ(ROMIMOT_ConfigureControl(ROMIMOT_CONTROL_MODE_WAKEUP, 100), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OS_TimeBaseSet, 0);
+
+    /* the table switches to timer mode at 250 Hz */
+    TestTblData.ControlMode   = ROMIMOT_CONTROL_MODE_TIMER;
+    TestTblData.ControlRateHz = 250;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_CONTROL_INF_EID, NULL);
+    ROMIMOT_ApplyTableConfig();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ControlMode, ROMIMOT_CONTROL_MODE_TIMER);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ControlRateHz, 250);
+    UtAssert_STUB_COUNT(OS_TimerSet, 1);
+    UtAssert_STUB_COUNT(OS_TimeBaseSet, 1);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+
+    /* the same settings again are a no-op */
+    UtAssert_INT32_EQ(ROMIMOT_ConfigureControl(ROMIMOT_CONTROL_MODE_TIMER, 250), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OS_TimeBaseSet, 1);
+
+    /* timer ticks release the I/O task; in timer mode WAKEUP does not */
+    ROMIMOT_TimerCallback(ROMIMOT_Data.TimerId, NULL);
+    UtAssert_STUB_COUNT(OS_BinSemGive, 1);
+    UtAssert_INT32_EQ(ROMIMOT_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OS_BinSemGive, 1);
+
+    /* a tick that lands while a cycle is still running is an overrun */
+    ROMIMOT_Data.IoBusy = true;
+    ROMIMOT_TimerCallback(ROMIMOT_Data.TimerId, NULL);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.IoOverruns, 1);
+    ROMIMOT_Data.IoBusy = false;
+
+    /* timer failures leave the previous configuration in place */
+    UT_SetDeferredRetcode(UT_KEY(OS_TimerSet), 1, OS_ERROR);
+    UtAssert_INT32_EQ(ROMIMOT_ConfigureControl(ROMIMOT_CONTROL_MODE_TIMER, 500), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ControlRateHz, 250);
+
+    /* back to wakeup mode stops the timebase */
+    UtAssert_INT32_EQ(ROMIMOT_ConfigureControl(ROMIMOT_CONTROL_MODE_WAKEUP, 250), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ControlMode, ROMIMOT_CONTROL_MODE_WAKEUP);
+    UtAssert_STUB_COUNT(OS_TimeBaseSet, 2);
+}
+
+/*
+ * Clock for the latency tests, only moved by the telemetry sends
+ */
+static int64 UT_NowUs;
+
+static void UT_Handler_OS_GetLocalTime(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    OS_time_t *TimeStruct = UT_Hook_GetArgValueByName(Context, "time_struct", OS_time_t *);
+
+    *TimeStruct = OS_TimeAssembleFromMicroseconds(UT_NowUs / 1000000, UT_NowUs % 1000000);
+}
+
+static void UT_Handler_SlowTransmit(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    UT_NowUs += 1000;
+}
+
+void Test_ROMIMOT_LoopStats(void)
+{
+    /*
+     * Test Case For:
+     * Latency and jitter reporting in ROMIMOT_ReportHousekeeping( const CFE_MSG_CommandHeader_t *Msg )
+     */
+    OS_time_t Now;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&Now, 0, sizeof(Now));
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+
+    /* two cycles on the simulated Romi, woken 5 ms apart */
+    romiSetBackend(&romiBackendSim);
+    ROMIMOT_Data.Device[0].i2cfd    = romiOpen(1, ROMI_I2C_ADDRESS);
+    ROMIMOT_Data.Device[0].i2c_open = true;
+
+    Now.seconds = 1;
+    UT_SetDataBuffer(UT_KEY(OS_GetLocalTime), &Now, sizeof(Now), false);
+    ROMIMOT_TriggerIo();
+    ROMIMOT_IoCycle();
+    ROMIMOT_Data.WakeTimeUs += 5000;
+    ROMIMOT_IoCycle();
+    ROMIMOT_Data.WakeTimeUs += 5200;
+    ROMIMOT_IoCycle();
+
+    UtAssert_INT32_EQ(ROMIMOT_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].Sensor.Stats.Cycles, 3);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].Sensor.Stats.PeriodMinUs, 5000);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].Sensor.Stats.PeriodMaxUs, 5200);
+
+    UtAssert_INT32_EQ(ROMIMOT_ReportHousekeeping(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.ControlCycles, 3);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.PeriodJitterUs, 200);
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].StatsResetReq);
+
+    /* the next cycle starts a fresh window */
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Stats.Cycles, 1);
+    UtAssert_BOOL_FALSE(ROMIMOT_Data.Device[0].StatsResetReq);
+
+    /* latency runs from wakeup to the motor write, the state packet sent
+       after it is not counted */
+    UT_NowUs = ROMIMOT_Data.WakeTimeUs + 300;
+    UT_SetHandlerFunction(UT_KEY(OS_GetLocalTime), UT_Handler_OS_GetLocalTime, NULL);
+    UT_SetHandlerFunction(UT_KEY(CFE_SB_TransmitMsg), UT_Handler_SlowTransmit, NULL);
+    ROMIMOT_Data.Device[0].StatsResetReq = true;
+    ROMIMOT_IoCycle();
+    UtAssert_INT32_EQ(UT_NowUs - ROMIMOT_Data.WakeTimeUs, 1300);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Stats.LatencyMaxUs, 300);
+
+    romiClose(ROMIMOT_Data.Device[0].i2cfd);
+    romiSetBackend(&romiBackendI2C);
+}
+
+void Test_ROMIMOT_StateBatch(void)
+{
+    /*
+     * Test Case For:
+     * Batched state telemetry from void ROMIMOT_IoCycle( void )
+     */
+    ROMIMOT_StateBatchPayload_t *Batch = &ROMIMOT_Data.Device[0].StateTlm.Payload;
+    CFE_MSG_Message_t *          MsgSend;
+    int                          i;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+
+    romiSetBackend(&romiBackendSim);
+    ROMIMOT_Data.Device[0].i2cfd    = romiOpen(1, ROMI_I2C_ADDRESS);
+    ROMIMOT_Data.Device[0].i2c_open = true;
+
+    ROMIMOT_Data.StateBatchSize = 3;
+    ROMIMOT_Data.Device[0].MotorsEnabled  = 1;
+    ROMIMOT_PublishControl(&ROMIMOT_Data.Device[0]);
+
+    /* three cycles 10 ms apart make one packet */
+    UT_SetDataBuffer(UT_KEY(CFE_SB_TransmitMsg), &MsgSend, sizeof(MsgSend), false);
+    ROMIMOT_Data.WakeTimeUs = 1000000;
+    for (i = 0; i < 2; i++)
+    {
+        ROMIMOT_IoCycle();
+        ROMIMOT_Data.WakeTimeUs += 10000;
+    }
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 0);
+    UtAssert_UINT32_EQ(Batch->SampleCount, 2);
+
+    ROMIMOT_IoCycle();
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 1);
+    UtAssert_ADDRESS_EQ(MsgSend, &ROMIMOT_Data.Device[0].StateTlm);
+    UtAssert_STUB_COUNT(CFE_MSG_SetMsgTime, 1);
+    UtAssert_UINT32_EQ(Batch->SampleCount, 0);
+    UtAssert_UINT32_EQ(Batch->FirstCycle, 1);
+    UtAssert_UINT32_EQ(Batch->MotorsEnabled, 1);
+    UtAssert_UINT32_EQ(Batch->Samples[0].TimeOffsetUs, 0);
+    UtAssert_UINT32_EQ(Batch->Samples[2].TimeOffsetUs, 20000);
+    UtAssert_INT32_EQ(Batch->Samples[2].LeftMotorOdometer, ROMIMOT_Data.Device[0].IoSensor.Ctl.LeftOdo);
+
+    /* the next batch starts its own time base */
+    ROMIMOT_Data.WakeTimeUs += 10000;
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(Batch->FirstCycle, 4);
+    UtAssert_UINT32_EQ(Batch->Samples[0].TimeOffsetUs, 0);
+    UtAssert_STUB_COUNT(CFE_MSG_SetMsgTime, 2);
+
+    /* shrinking the batch flushes what is already queued */
+    ROMIMOT_Data.StateBatchSize = 1;
+    ROMIMOT_PublishControl(&ROMIMOT_Data.Device[0]);
+    ROMIMOT_IoCycle();
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 2);
+    UtAssert_UINT32_EQ(Batch->SampleCount, 0);
+
+    /* Wakeup no longer sends motor state itself */
+    UtAssert_INT32_EQ(ROMIMOT_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 2);
+
+    romiClose(ROMIMOT_Data.Device[0].i2cfd);
+    romiSetBackend(&romiBackendI2C);
+}
+
+/*
+ * Simulated Romi whose reads, while UT_Replay is set, all answer with the
+ * block captured in UT_ReplayBlock
+ */
+static bool  UT_Replay;
+static uint8 UT_ReplayBlock[ROMI_TLM_LEN];
+
+static int UT_ReplayReadReg(int handle, uint8_t addr, uint8_t *buf, uint8_t len, int delayUs)
+{
+    int status = romiBackendSim.readReg(handle, addr, buf, len, delayUs);
+
+    if (UT_Replay)
+    {
+        memcpy(buf, UT_ReplayBlock, len);
+    }
+    return status;
+}
+
+static int UT_ReplayWrite(int handle, const uint8_t *buf, uint8_t len)
+{
+    return romiBackendSim.write(handle, buf, len);
+}
+
+static const RomiBackend UT_ReplayBackend = {"replay", NULL, NULL, UT_ReplayReadReg, UT_ReplayWrite};
+
+void Test_ROMIMOT_StaleSample(void)
+{
+    /*
+     * Test Case For:
+     * Stale snapshot handling in void ROMIMOT_IoCycle( void )
+     */
+    ROMIMOT_StateBatchPayload_t *Batch = &ROMIMOT_Data.Device[0].StateTlm.Payload;
+    ROMIMOT_SensorState_t *      Sensor = &ROMIMOT_Data.Device[0].IoSensor;
+    int32                        LeftOdo;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+
+    romiSetBackend(&romiBackendSim);
+    romiSimUseWallClock(0);
+    ROMIMOT_Data.Device[0].i2cfd    = romiOpen(1, ROMI_I2C_ADDRESS);
+    ROMIMOT_Data.Device[0].i2c_open = true;
+    UtAssert_INT32_EQ(romiMotorWrite(ROMIMOT_Data.Device[0].i2cfd, 300, 300), 0);
+    romiSimAdvance(0.1);
+
+    /* every cycle publishes the firmware sequence it read */
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(Batch->Samples[0].RomiSequence, Sensor->Romi.sequence);
+
+    /* a block the firmware already gave us is dropped and counted */
+    romiSetBackend(&UT_ReplayBackend);
+    romiSimAdvance(0.1);
+    UtAssert_INT32_EQ(romiRead(ROMIMOT_Data.Device[0].i2cfd, ROMI_REG_TLM, sizeof(UT_ReplayBlock), UT_ReplayBlock), 0);
+    UT_Replay = true;
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(Sensor->Stats.StaleSamples, 0);
+    UtAssert_True(Batch->Samples[0].LeftEncoderDelta > 0, "left delta %d", (int)Batch->Samples[0].LeftEncoderDelta);
+    LeftOdo = Sensor->Ctl.LeftOdo;
+    romiSimAdvance(0.1);
+    ROMIMOT_IoCycle();
+    UtAssert_INT32_EQ(Sensor->Status, 0);
+    UtAssert_UINT32_EQ(Sensor->Stats.StaleSamples, 1);
+    UtAssert_INT32_EQ(Sensor->Ctl.LeftOdo, LeftOdo);
+
+    /* and publishes no motion, the next fresh one carries it */
+    UtAssert_INT32_EQ(Batch->Samples[0].LeftEncoderDelta, 0);
+    UtAssert_INT32_EQ(Batch->Samples[0].RightEncoderDelta, 0);
+    UtAssert_UINT32_EQ(Batch->Samples[0].RomiSequence, UT_ReplayBlock[0] | (UT_ReplayBlock[1] << 8));
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].I2CErrCounter, 0);
+
+    /* the next fresh one brings the odometry up to date */
+    UT_Replay = false;
+    ROMIMOT_IoCycle();
+    UtAssert_True(Sensor->Ctl.LeftOdo > LeftOdo, "odometer %d moved on", (int)Sensor->Ctl.LeftOdo);
+    UtAssert_INT32_EQ(Batch->Samples[0].LeftEncoderDelta, Sensor->Ctl.LeftOdo - LeftOdo);
+    UtAssert_UINT32_EQ(Sensor->Stats.StaleSamples, 1);
+
+    UtAssert_INT32_EQ(ROMIMOT_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_INT32_EQ(ROMIMOT_ReportHousekeeping(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.StaleSamples, 1);
+
+    romiSetBackend(&romiBackendSim);
+    romiClose(ROMIMOT_Data.Device[0].i2cfd);
+    romiSimUseWallClock(1);
+    romiSetBackend(&romiBackendI2C);
+}
+
+void Test_ROMIMOT_BusStats(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_BusStatsRecord( ROMIMOT_BusStats_t *Stats, int Op, uint32 ElapsedUs, int Status )
+     * void ROMIMOT_BusStatsReport( const ROMIMOT_BusStats_t *Stats, ROMIMOT_DiagTlm_Payload_t *Payload )
+     * int32 ROMIMOT_SendDiag( const ROMIMOT_SendDiagCmd_t *Msg )
+     */
+    ROMIMOT_BusStats_t            Stats;
+    ROMIMOT_DiagTlm_Payload_t     Payload;
+    ROMIMOT_BusOpStats_Payload_t *Read = &Payload.Ops[ROMIMOT_BUS_OP_READ];
+    ROMIMOT_SendDiagCmd_t         TestMsg;
+
+    /* buckets double from ROMIMOT_BUS_HIST_BASE_US, the last one is open ended */
+    ROMIMOT_BusStatsReset(&Stats);
+    ROMIMOT_BusStatsRecord(&Stats, ROMIMOT_BUS_OP_READ, 10, 0);
+    ROMIMOT_BusStatsRecord(&Stats, ROMIMOT_BUS_OP_READ, 16, 0);
+    ROMIMOT_BusStatsRecord(&Stats, ROMIMOT_BUS_OP_READ, 100, ROMIMOT_I2C_DAT_R_ERR_EID);
+    ROMIMOT_BusStatsRecord(&Stats, ROMIMOT_BUS_OP_READ, 10000000, 0);
+    ROMIMOT_BusStatsRecord(&Stats, ROMIMOT_BUS_OP_COUNT, 10, 0);
+    ROMIMOT_BusStatsReport(&Stats, &Payload);
+
+    UtAssert_UINT32_EQ(Read->Count, 4);
+    UtAssert_UINT32_EQ(Read->Errors, 1);
+    UtAssert_UINT32_EQ(Read->MinUs, 10);
+    UtAssert_UINT32_EQ(Read->MaxUs, 10000000);
+    UtAssert_UINT32_EQ(Read->MeanUs, 2500031);
+    UtAssert_UINT32_EQ(Read->Buckets[0], 1);
+    UtAssert_UINT32_EQ(Read->Buckets[1], 1);
+    UtAssert_UINT32_EQ(Read->Buckets[3], 1);
+    UtAssert_UINT32_EQ(Read->Buckets[ROMIMOT_BUS_HIST_BUCKETS - 1], 1);
+    UtAssert_UINT32_EQ(Payload.Ops[ROMIMOT_BUS_OP_MOTOR_WRITE].Count, 0);
+    UtAssert_UINT32_EQ(Payload.Ops[ROMIMOT_BUS_OP_MOTOR_WRITE].MeanUs, 0);
+
+    /* the I/O task times its own bus traffic and answers the request */
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+    UtAssert_INT32_EQ(ROMIMOT_StartIoTask(), CFE_SUCCESS);
+
+    romiSetBackend(&romiBackendSim);
+    ROMIMOT_Data.Device[0].i2cfd    = romiOpen(1, ROMI_I2C_ADDRESS);
+    ROMIMOT_Data.Device[0].i2c_open = true;
+
+    ROMIMOT_IoCycle();
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].BusStats.Ops[ROMIMOT_BUS_OP_SNAPSHOT_READ].Count, 2);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].BusStats.Ops[ROMIMOT_BUS_OP_MOTOR_WRITE].Count, 2);
+
+    UT_ResetState(UT_KEY(CFE_SB_TransmitMsg));
+    UtAssert_INT32_EQ(ROMIMOT_SendDiag(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.CmdCounter, 1);
+    ROMIMOT_IoCycle();
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].DiagTlm.Payload.Ops[ROMIMOT_BUS_OP_SNAPSHOT_READ].Count, 3);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].DiagTlm.Payload.Ops[ROMIMOT_BUS_OP_READ].Count, 0);
+
+    /* a counter reset starts the statistics and the I2C error count over */
+    ROMIMOT_Data.Device[0].BusStatsResetReq = true;
+    ROMIMOT_Data.Device[0].I2CErrCounter    = 3;
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].BusStats.Ops[ROMIMOT_BUS_OP_SNAPSHOT_READ].Count, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].I2CErrCounter, 0);
+
+    romiSetTimingHook(NULL);
+    romiClose(ROMIMOT_Data.Device[0].i2cfd);
+    romiSetBackend(&romiBackendI2C);
+}
+
+static void UT_RecordReadCal(ROMIMOT_ReadCal_t *Cal, int Passes, int Fails)
+{
+    while (Passes-- > 0)
+    {
+        ROMIMOT_ReadCalRecord(Cal, 0);
+    }
+    while (Fails-- > 0)
+    {
+        ROMIMOT_ReadCalRecord(Cal, ROMIMOT_I2C_DAT_R_ERR_EID);
+    }
+}
+
+void Test_ROMIMOT_ReadCal(void)
+{
+    /*
+     * Test Case For:
+     * bool ROMIMOT_ReadCalRecord( ROMIMOT_ReadCal_t *Cal, int Status )
+     * bool ROMIMOT_ReadBackoffCheck( ROMIMOT_ReadBackoff_t *Backoff, int Status )
+     * int32 ROMIMOT_CalibrateRead( const ROMIMOT_CalibrateReadCmd_t *Msg )
+     * void ROMIMOT_StoreReadCal( void )
+     */
+    ROMIMOT_ReadCal_t          Cal;
+    ROMIMOT_ReadBackoff_t      Backoff;
+    ROMIMOT_CalibrateReadCmd_t TestMsg;
+    ROMIMOT_Table_t            TestTblData;
+    void *                     TblPtr = &TestTblData;
+    int                        Range;
+    int                        i;
+
+    /* one failure in a candidate's trials moves on to the next delay */
+    ROMIMOT_ReadCalStart(&Cal, 20);
+    UT_RecordReadCal(&Cal, ROMIMOT_READ_CAL_TRIALS - 1, 1);
+    UtAssert_UINT32_EQ(Cal.DelayUs, ROMIMOT_READ_CAL_STEP_US);
+    UtAssert_UINT32_EQ(Cal.RejectFailures[0], 1);
+    UT_RecordReadCal(&Cal, ROMIMOT_READ_CAL_TRIALS, 0);
+    UtAssert_UINT32_EQ(Cal.ResultUs[0], ROMIMOT_READ_CAL_STEP_US + 20);
+    UtAssert_UINT32_EQ(Cal.Range, 1);
+    UtAssert_BOOL_TRUE(Cal.Active);
+
+    /* a range that never reads cleanly is left at the maximum */
+    Cal.DelayUs = ROMIMOT_READ_DELAY_MAX_US;
+    UT_RecordReadCal(&Cal, 0, ROMIMOT_READ_CAL_TRIALS);
+    UtAssert_UINT32_EQ(Cal.ResultUs[1], ROMIMOT_READ_DELAY_MAX_US);
+    UtAssert_BOOL_TRUE(Cal.Failed);
+    UT_RecordReadCal(&Cal, ROMIMOT_READ_CAL_TRIALS, 0);
+    UtAssert_UINT32_EQ(Cal.ResultUs[2], 20);
+    UtAssert_BOOL_FALSE(Cal.Active);
+
+    /* errors only back off when they cluster within a window */
+    memset(&Backoff, 0, sizeof(Backoff));
+    UtAssert_BOOL_FALSE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_R_ERR_EID));
+    UtAssert_BOOL_FALSE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_R_ERR_EID));
+    for (i = 0; i < ROMIMOT_READ_BACKOFF_WINDOW; i++)
+    {
+        UtAssert_BOOL_FALSE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_W_ERR_EID));
+    }
+    UtAssert_BOOL_FALSE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_R_ERR_EID));
+    UtAssert_BOOL_FALSE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_R_ERR_EID));
+    UtAssert_BOOL_TRUE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_R_ERR_EID));
+
+    /* data that went through but did not validate counts the same */
+    UtAssert_BOOL_FALSE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_BAD_ERR_EID));
+    UtAssert_BOOL_FALSE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_BAD_ERR_EID));
+    UtAssert_BOOL_TRUE(ROMIMOT_ReadBackoffCheck(&Backoff, ROMIMOT_I2C_DAT_BAD_ERR_EID));
+
+    /* a Romi that needs 35 us is calibrated on the I/O task */
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    UtAssert_INT32_EQ(ROMIMOT_StartIoTask(), CFE_SUCCESS);
+
+    romiSetBackend(&romiBackendSim);
+    romiSimSetMinReadDelay(35);
+    ROMIMOT_Data.Device[0].i2cfd             = romiOpen(1, ROMI_I2C_ADDRESS);
+    ROMIMOT_Data.Device[0].i2c_open          = true;
+    ROMIMOT_Data.ReadDelayMarginUs = 20;
+
+    /* a trial read too early still goes through, its data gives it away */
+    for (Range = 0; Range < ROMIMOT_READ_RANGES; Range++)
+    {
+        romiSetReadDelay(Range, 30);
+        UtAssert_INT32_EQ(romiRangeRead(ROMIMOT_Data.Device[0].i2cfd, Range, ROMIMOT_READ_DELAY_MAX_US),
+                          ROMIMOT_I2C_DAT_BAD_ERR_EID);
+        romiSetReadDelay(Range, 40);
+        UtAssert_INT32_EQ(romiRangeRead(ROMIMOT_Data.Device[0].i2cfd, Range, ROMIMOT_READ_DELAY_MAX_US), 0);
+        romiSetReadDelay(Range, 100);
+    }
+    UtAssert_INT32_EQ(romiRangeRead(ROMIMOT_Data.Device[0].i2cfd, ROMI_READ_RANGE_COUNT, ROMIMOT_READ_DELAY_MAX_US),
+                      ROMIMOT_I2C_DAT_R_ERR_EID);
+
+    /* not while the wheels are driven */
+    ROMIMOT_Data.Device[0].MotorsEnabled = 1;
+    UtAssert_INT32_EQ(ROMIMOT_CalibrateRead(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 1);
+    ROMIMOT_Data.Device[0].MotorsEnabled = 0;
+    UtAssert_INT32_EQ(ROMIMOT_CalibrateRead(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.CmdCounter, 1);
+    UtAssert_INT32_EQ(ROMIMOT_CalibrateRead(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 2);
+
+    ROMIMOT_IoCycle();
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].IoSensor.ReadCalActive);
+    for (i = 0; i < 1000 && ROMIMOT_Data.Device[0].ReadCal.Active; i++)
+    {
+        ROMIMOT_IoCycle();
+    }
+    UtAssert_BOOL_FALSE(ROMIMOT_Data.Device[0].ReadCal.Active);
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].ReadCalDone);
+    for (Range = 0; Range < ROMIMOT_READ_RANGES; Range++)
+    {
+        UtAssert_INT32_EQ(romiGetReadDelay(Range), 60);
+        UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].ReadCal.RejectFailures[Range], ROMIMOT_READ_CAL_TRIALS);
+    }
+    UtAssert_BOOL_FALSE(ROMIMOT_Data.Device[0].ReadCal.Failed);
+
+    /* the main task stores the result in the table once, for this Romi only */
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    ROMIMOT_StoreReadCal(&ROMIMOT_Data.Device[0]);
+    ROMIMOT_StoreReadCal(&ROMIMOT_Data.Device[0]);
+    UtAssert_UINT32_EQ(TestTblData.Devices[0].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT], 60);
+    UtAssert_UINT32_EQ(TestTblData.Devices[1].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT], 0);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT], 60);
+    UtAssert_STUB_COUNT(CFE_TBL_Modified, 1);
+    UtAssert_BOOL_FALSE(ROMIMOT_Data.Device[0].ReadCalPending);
+
+    /* snapshots read too early come back stale, and lengthen the delay once
+       they cluster.  The first is still newer than the loop's last sample. */
+    ROMIMOT_Data.Device[0].BusReadDelayUs[ROMI_READ_RANGE_SNAPSHOT] = 0;
+    for (i = 0; i <= ROMIMOT_READ_BACKOFF_ERRORS; i++)
+    {
+        ROMIMOT_IoCycle();
+    }
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Stats.StaleSamples, ROMIMOT_READ_BACKOFF_ERRORS);
+    UtAssert_INT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Status, 0);
+    UtAssert_INT32_EQ(romiGetReadDelay(ROMI_READ_RANGE_SNAPSHOT), ROMIMOT_READ_BACKOFF_STEP_US);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.SnapshotDelayUs, ROMIMOT_READ_BACKOFF_STEP_US);
+
+    /* and a new table value replaces the back-off */
+    ROMIMOT_Data.Device[0].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT] = 80;
+    ROMIMOT_PublishControl(&ROMIMOT_Data.Device[0]);
+    ROMIMOT_IoCycle();
+    UtAssert_INT32_EQ(romiGetReadDelay(ROMI_READ_RANGE_SNAPSHOT), 80);
+
+    romiSimSetMinReadDelay(0);
+    romiSetReadDelay(ROMI_READ_RANGE_STATUS, 100);
+    romiSetReadDelay(ROMI_READ_RANGE_ENCODERS, 100);
+    romiSetReadDelay(ROMI_READ_RANGE_SNAPSHOT, 100);
+    romiSetTimingHook(NULL);
+    romiClose(ROMIMOT_Data.Device[0].i2cfd);
+    romiSetBackend(&romiBackendI2C);
+}
+
+void Test_ROMIMOT_BusRecovery(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_BusRecoveryCycle( ROMIMOT_BusRecovery_t *Recovery, int Status, int64 NowUs )
+     * void ROMIMOT_BusRecoveryOpenFailed( ROMIMOT_BusRecovery_t *Recovery, int64 NowUs )
+     * I2C fault recovery in void ROMIMOT_IoCycle( void )
+     */
+    ROMIMOT_BusRecovery_t Recovery;
+    ROMIMOT_Table_t       TestTblData;
+    void *                TblPtrs[16];
+    uint32                Writes;
+    int                   i;
+
+    /* an isolated error is ridden out, a repeated one holds the motors */
+    ROMIMOT_BusRecoveryReset(&Recovery);
+    ROMIMOT_BusRecoveryOpened(&Recovery);
+    UtAssert_UINT32_EQ(Recovery.State, ROMIMOT_BUS_STATE_OK);
+    ROMIMOT_BusRecoveryCycle(&Recovery, ROMIMOT_I2C_DAT_R_ERR_EID, 1000);
+    UtAssert_BOOL_FALSE(ROMIMOT_BusRecoveryHolding(&Recovery));
+    ROMIMOT_BusRecoveryCycle(&Recovery, ROMIMOT_I2C_DAT_R_ERR_EID, 1000);
+    UtAssert_UINT32_EQ(Recovery.State, ROMIMOT_BUS_STATE_RETRY);
+    UtAssert_BOOL_TRUE(ROMIMOT_BusRecoveryHolding(&Recovery));
+
+    /* a bus that keeps failing is reopened after a wait */
+    for (i = ROMIMOT_BUS_RETRY_FAILURES; i < ROMIMOT_BUS_REOPEN_FAILURES; i++)
+    {
+        ROMIMOT_BusRecoveryCycle(&Recovery, ROMIMOT_I2C_DAT_R_ERR_EID, 1000);
+    }
+    UtAssert_UINT32_EQ(Recovery.State, ROMIMOT_BUS_STATE_REOPEN);
+    UtAssert_BOOL_FALSE(ROMIMOT_BusRecoveryDue(&Recovery, 1000));
+    UtAssert_BOOL_TRUE(ROMIMOT_BusRecoveryDue(&Recovery, 1000 + ROMIMOT_BUS_REOPEN_MIN_US));
+
+    /* the wait doubles up to a cap, then the recovery gives up */
+    ROMIMOT_BusRecoveryOpened(&Recovery);
+    UtAssert_UINT32_EQ(Recovery.State, ROMIMOT_BUS_STATE_RETRY);
+    for (i = 1; i < ROMIMOT_BUS_REOPEN_ATTEMPTS; i++)
+    {
+        ROMIMOT_BusRecoveryOpenFailed(&Recovery, 0);
+    }
+    UtAssert_UINT32_EQ(Recovery.BackoffUs, ROMIMOT_BUS_REOPEN_MAX_US);
+    ROMIMOT_BusRecoveryOpenFailed(&Recovery, 0);
+    UtAssert_UINT32_EQ(Recovery.State, ROMIMOT_BUS_STATE_CLOSED);
+    UtAssert_BOOL_FALSE(ROMIMOT_BusRecoveryHolding(&Recovery));
+
+    /* the I/O task recovers a simulated Romi that stops answering */
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.HwBackend            = ROMIMOT_HW_BACKEND_SIM;
+    TestTblData.Devices[0].BusNumber = 1;
+    TestTblData.Devices[0].Address   = ROMI_I2C_ADDRESS;
+    for (i = 0; i < 16; i++)
+    {
+        TblPtrs[i] = &TestTblData;
+    }
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), TblPtrs, sizeof(TblPtrs), false);
+    UtAssert_INT32_EQ(ROMIMOT_StartIoTask(), CFE_SUCCESS);
+
+    ROMIMOT_Data.WakeTimeUs = 1000000;
+    ROMIMOT_RequestI2C(&ROMIMOT_Data.Device[0]);
+    ROMIMOT_IoCycle();
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].i2c_open);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusState, ROMIMOT_BUS_STATE_OK);
+
+    ROMIMOT_Data.Device[0].MotorsEnabled     = 1;
+    ROMIMOT_Data.Device[0].LeftOdoTrgt       = 10000;
+    ROMIMOT_Data.Device[0].TargetDeltaLeft   = 10;
+    ROMIMOT_Data.Gains.Kp          = ROMIMOT_Q16(1.0);
+    ROMIMOT_Data.Gains.DAlpha      = ROMIMOT_Q16(1.0);
+    ROMIMOT_Data.Gains.OutputLimit = 300;
+    ROMIMOT_PublishControl(&ROMIMOT_Data.Device[0]);
+
+    romiSimSetOffline(1);
+    ROMIMOT_IoCycle();
+    UtAssert_True(ROMIMOT_Data.Device[0].IoSensor.Ctl.LeftMotSpeed != 0, "first failure keeps driving");
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusState, ROMIMOT_BUS_STATE_RETRY);
+    Writes = ROMIMOT_Data.Device[0].BusStats.Ops[ROMIMOT_BUS_OP_MOTOR_WRITE].Count;
+    ROMIMOT_IoCycle();
+    UtAssert_INT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Ctl.LeftMotSpeed, 0);
+
+    /* held, a failed read is the only transfer of the cycle */
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].BusStats.Ops[ROMIMOT_BUS_OP_MOTOR_WRITE].Count, Writes);
+    for (i = ROMIMOT_BUS_RETRY_FAILURES + 1; i < ROMIMOT_BUS_REOPEN_FAILURES; i++)
+    {
+        ROMIMOT_IoCycle();
+    }
+    UtAssert_BOOL_FALSE(ROMIMOT_Data.Device[0].i2c_open);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusState, ROMIMOT_BUS_STATE_REOPEN);
+
+    /* commands do not cut the wait short */
+    ROMIMOT_RequestI2C(&ROMIMOT_Data.Device[0]);
+    ROMIMOT_IoCycle();
+    UtAssert_BOOL_FALSE(ROMIMOT_Data.Device[0].i2c_open);
+
+    /* the reopened bus is trusted again after a clean cycle */
+    romiSimSetOffline(0);
+    ROMIMOT_Data.WakeTimeUs += ROMIMOT_BUS_REOPEN_MIN_US;
+    ROMIMOT_IoCycle();
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].i2c_open);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusState, ROMIMOT_BUS_STATE_OK);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusReopens, 1);
+    UtAssert_STUB_COUNT(CFE_EVS_ResetFilter, 1);
+
+    /* a Romi that never comes back is given up on */
+    romiSimSetOffline(1);
+    for (i = 0; i < 1000 && ROMIMOT_Data.Device[0].IoSensor.BusState != ROMIMOT_BUS_STATE_CLOSED; i++)
+    {
+        ROMIMOT_Data.WakeTimeUs += ROMIMOT_BUS_REOPEN_MAX_US;
+        ROMIMOT_IoCycle();
+    }
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusState, ROMIMOT_BUS_STATE_CLOSED);
+    UtAssert_BOOL_FALSE(ROMIMOT_Data.Device[0].i2c_open);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusReopens, 1 + ROMIMOT_BUS_REOPEN_ATTEMPTS);
+
+    /* until the next command opens it again */
+    romiSimSetOffline(0);
+    ROMIMOT_RequestI2C(&ROMIMOT_Data.Device[0]);
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusState, ROMIMOT_BUS_STATE_OK);
+
+    /* a counter reset clears the reopen count */
+    ROMIMOT_Data.Device[0].BusStatsResetReq = true;
+    ROMIMOT_IoCycle();
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.BusReopens, 0);
+
+    romiSetTimingHook(NULL);
+    romiClose(ROMIMOT_Data.Device[0].i2cfd);
+    romiSetBackend(&romiBackendI2C);
+}
+
+/*
+ * Trace dump file contents captured from the OS_write() stub
+ */
+void Test_ROMIMOT_DriveMode(void)
+{
+    /*
+     * Test Case For:
+     * int32 ROMIMOT_SetDriveMode( const ROMIMOT_DriveModeCmd_t *Msg )
+     * ROMIMOT_DRIVE_MODE_SPEED in void ROMIMOT_ControlStep( ... )
+     * the firmware speed loop in romi_speed.h, run by the simulated Romi
+     */
+    ROMIMOT_DriveModeCmd_t TestMsg;
+    ROMIMOT_ControlCmd_t   Cmd;
+    ROMIMOT_ControlState_t Ctl;
+    ROMIMOT_Profile_t      Profile;
+    ROMIMOT_Table_t        TestTblData;
+    void *                 TblPtr = &TestTblData;
+    RomiSnapshot           Before;
+    RomiSnapshot           After;
+    UT_CheckEvent_t        EventTest;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestMsg, 0, sizeof(TestMsg));
+
+    /* the motor registers change meaning, so the mode only changes while stopped */
+    ROMIMOT_Data.Device[0].MotorsEnabled = 1;
+    TestMsg.DriveMode          = ROMIMOT_DRIVE_MODE_SPEED;
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_DRIVE_MODE_ERR_EID, NULL);
+    UtAssert_INT32_EQ(ROMIMOT_SetDriveMode(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].DriveMode, ROMIMOT_DRIVE_MODE_POWER);
+
+    ROMIMOT_Data.Device[0].MotorsEnabled = 0;
+    TestMsg.DriveMode          = ROMIMOT_DRIVE_MODE_SPEED + 1;
+    UtAssert_INT32_EQ(ROMIMOT_SetDriveMode(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 2);
+
+    TestMsg.DriveMode = ROMIMOT_DRIVE_MODE_SPEED;
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_DRIVE_MODE_INF_EID, NULL);
+    UtAssert_INT32_EQ(ROMIMOT_SetDriveMode(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.CmdCounter, 1);
+    UtAssert_BOOL_TRUE(ROMIMOT_DblBuf_Read(&ROMIMOT_Data.Device[0].ControlBuf, ROMIMOT_Data.Device[0].ControlSlots,
+                                           sizeof(Cmd), &Cmd, &ROMIMOT_Data.Device[0].ControlCount));
+    UtAssert_UINT32_EQ(Cmd.DriveMode, ROMIMOT_DRIVE_MODE_SPEED);
+
+    /* the loop writes the reference speed plus a share of the lag, in counts/s */
+    memset(&Ctl, 0, sizeof(Ctl));
+    memset(&Cmd, 0, sizeof(Cmd));
+    memset(&Profile, 0, sizeof(Profile));
+    Cmd.MotorsEnabled    = 1;
+    Cmd.DriveMode        = ROMIMOT_DRIVE_MODE_SPEED;
+    Cmd.LeftOdoTrgt      = 1000;
+    Cmd.RightOdoTrgt     = -1000;
+    Cmd.TargetDeltaLeft  = 10;
+    Cmd.TargetDeltaRight = 10;
+
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 0);
+
+    Ctl.PeriodUs = 10000;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 20);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 1250);
+    UtAssert_INT32_EQ(Ctl.RightMotSpeed, -1250);
+
+    Ctl.LeftOdo  = 20;
+    Ctl.RightOdo = -20;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 1125);
+    UtAssert_INT32_EQ(Ctl.RightMotSpeed, -1125);
+
+    /* a large lag is capped at the firmware limit */
+    Ctl.LeftOdo = -10000;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, ROMI_SPEED_MAX);
+
+    /* the simulated firmware holds the commanded wheel speeds */
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.HwBackend            = ROMIMOT_HW_BACKEND_SIM;
+    TestTblData.Devices[0].BusNumber = 1;
+    TestTblData.Devices[0].Address   = ROMI_I2C_ADDRESS;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UtAssert_INT32_EQ(ROMIMOT_ConnectI2C(&ROMIMOT_Data.Device[0]), CFE_SUCCESS);
+    romiSimUseWallClock(0);
+
+    UtAssert_INT32_EQ(romiDriveWrite(ROMIMOT_Data.Device[0].i2cfd, ROMI_DRIVE_SPEED, 1000, -500), 0);
+    romiSimAdvance(1.0);
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &Before), 0);
+    romiSimAdvance(1.0);
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &After), 0);
+    UtAssert_True(After.encoders.left - Before.encoders.left > 990 && After.encoders.left - Before.encoders.left < 1010,
+                  "left wheel at %d counts/s", After.encoders.left - Before.encoders.left);
+    UtAssert_True(After.encoders.right - Before.encoders.right < -490 &&
+                      After.encoders.right - Before.encoders.right > -510,
+                  "right wheel at %d counts/s", After.encoders.right - Before.encoders.right);
+
+    /* speeds beyond the limit are ignored, back in power mode 300 is full power */
+    UtAssert_INT32_EQ(romiDriveWrite(ROMIMOT_Data.Device[0].i2cfd, ROMI_DRIVE_SPEED, ROMI_SPEED_MAX + 1, 0), 0);
+    romiSimAdvance(1.0);
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &Before), 0);
+    UtAssert_True(Before.encoders.left - After.encoders.left > 990, "left wheel kept %d counts/s",
+                  Before.encoders.left - After.encoders.left);
+
+    UtAssert_INT32_EQ(romiMotorWrite(ROMIMOT_Data.Device[0].i2cfd, 300, 0), 0);
+    romiSimAdvance(1.0);
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &After), 0);
+    UtAssert_True(After.encoders.left - Before.encoders.left > 2500, "left wheel at full power, %d counts/s",
+                  After.encoders.left - Before.encoders.left);
+
+    romiSimUseWallClock(1);
+}
+
+void Test_ROMIMOT_Velocity(void)
+{
+    /*
+     * Test Case For:
+     * the firmware velocity estimate in romi_velocity.h, and its use in
+     * void ROMIMOT_UpdateOdometry( ROMIMOT_ControlState_t *Ctl, const RomiSnapshot *Romi )
+     * void ROMIMOT_ControlStep( ... )
+     */
+    RomiVelocity           Velocity;
+    ROMIMOT_ControlState_t Ctl;
+    ROMIMOT_ControlCmd_t   Cmd;
+    ROMIMOT_Profile_t      Profile;
+    ROMIMOT_Table_t        TestTblData;
+    void *                 TblPtr = &TestTblData;
+    RomiSnapshot           Romi;
+
+    /* counts and micros() both wrap between samples */
+    romiVelocityReset(&Velocity);
+    romiVelocitySample(&Velocity, 32760, -5, 4294967000u);
+    UtAssert_INT32_EQ(Velocity.leftVelocity, 0);
+    romiVelocitySample(&Velocity, -32766, -15, 4294967000u + ROMI_SPEED_PERIOD_US);
+    UtAssert_INT32_EQ(Velocity.leftVelocity, 2500);
+    UtAssert_INT32_EQ(Velocity.rightVelocity, -2500);
+    UtAssert_UINT32_EQ(romiVelocityTime(&Velocity), 4294967000u + ROMI_SPEED_PERIOD_US);
+
+    /* the control loop takes the error rate from the measured velocity */
+    memset(&Ctl, 0, sizeof(Ctl));
+    memset(&Cmd, 0, sizeof(Cmd));
+    memset(&Profile, 0, sizeof(Profile));
+    memset(&Romi, 0, sizeof(Romi));
+    Romi.velocity.left  = 600;
+    Romi.velocity.right = -1000;
+    ROMIMOT_UpdateOdometry(&Ctl, &Romi);
+    UtAssert_INT32_EQ(Ctl.LeftVelocity, 600);
+    UtAssert_INT32_EQ(Ctl.RightVelocity, -1000);
+
+    Cmd.MotorsEnabled     = 1;
+    Cmd.LeftOdoTrgt       = 1000;
+    Cmd.RightOdoTrgt      = -1000;
+    Cmd.TargetDeltaLeft   = 10;
+    Cmd.TargetDeltaRight  = 10;
+    Cmd.Gains.Kd          = ROMIMOT_Q16(1.0);
+    Cmd.Gains.DAlpha      = ROMIMOT_Q16(1.0);
+    Cmd.Gains.OutputLimit = 300;
+    Ctl.PeriodUs          = 10000;
+    ROMIMOT_ControlStep(&Ctl, &Cmd, &Profile);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 4);
+    UtAssert_INT32_EQ(Ctl.RightMotSpeed, 0);
+
+    /* the simulated firmware reports the wheel speeds it holds, to a count over the window */
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.HwBackend            = ROMIMOT_HW_BACKEND_SIM;
+    TestTblData.Devices[0].BusNumber = 1;
+    TestTblData.Devices[0].Address   = ROMI_I2C_ADDRESS;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UtAssert_INT32_EQ(ROMIMOT_ConnectI2C(&ROMIMOT_Data.Device[0]), CFE_SUCCESS);
+    romiSimUseWallClock(0);
+
+    UtAssert_INT32_EQ(romiDriveWrite(ROMIMOT_Data.Device[0].i2cfd, ROMI_DRIVE_SPEED, 1000, -500), 0);
+    romiSimAdvance(1.0);
+    UtAssert_INT32_EQ(romiSnapshotRead(ROMIMOT_Data.Device[0].i2cfd, &Romi), 0);
+    UtAssert_INT32_GTEQ(Romi.velocity.left, 1000 - 1000000 / ROMI_VELOCITY_WINDOW_US);
+    UtAssert_INT32_LTEQ(Romi.velocity.left, 1000 + 1000000 / ROMI_VELOCITY_WINDOW_US);
+    UtAssert_INT32_GTEQ(Romi.velocity.right, -500 - 1000000 / ROMI_VELOCITY_WINDOW_US);
+    UtAssert_INT32_LTEQ(Romi.velocity.right, -500 + 1000000 / ROMI_VELOCITY_WINDOW_US);
+    UtAssert_INT32_LT(Romi.velocityAgeUs, ROMI_SPEED_PERIOD_US);
+
+    romiSimUseWallClock(1);
+}
+
+static struct
+{
+    ROMIMOT_TraceFileHdr_t Hdr;
+    ROMIMOT_TraceSample_t  Samples[ROMIMOT_TRACE_DEPTH];
+} UT_TraceFile;
+
+static void UT_RecordTrace(ROMIMOT_Trace_t *Trace, uint32 Count, int32 Status)
+{
+    ROMIMOT_TraceSample_t Sample;
+
+    memset(&Sample, 0, sizeof(Sample));
+    while (Count-- > 0)
+    {
+        Sample.Cycle  = Trace->Head;
+        Sample.Status = Status;
+        ROMIMOT_TraceRecord(Trace, &Sample);
+    }
+}
+
+void Test_ROMIMOT_Trace(void)
+{
+    /*
+     * Test Case For:
+     * void ROMIMOT_TraceRecord( ROMIMOT_Trace_t *Trace, const ROMIMOT_TraceSample_t *Sample )
+     * int32 ROMIMOT_TraceDrain( ROMIMOT_Trace_t *Trace, const char *FileName, ROMIMOT_TraceFileHdr_t *Info )
+     * int32 ROMIMOT_DumpTrace( const ROMIMOT_DumpTraceCmd_t *Msg )
+     */
+    ROMIMOT_Trace_t *      Trace = &ROMIMOT_Data.Device[0].Trace;
+    ROMIMOT_TraceFileHdr_t Info;
+    ROMIMOT_DumpTraceCmd_t TestMsg;
+    UT_CheckEvent_t        EventTest;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    UT_SetDefaultReturnValue(UT_KEY(CFE_FS_WriteHeader), sizeof(CFE_FS_Header_t));
+
+    /* samples are written oldest first after the file header */
+    ROMIMOT_TraceInit(Trace);
+    UT_RecordTrace(Trace, 10, 0);
+    memset(&UT_TraceFile, 0, sizeof(UT_TraceFile));
+    UT_SetDataBuffer(UT_KEY(OS_write), &UT_TraceFile, sizeof(UT_TraceFile), false);
+    UtAssert_INT32_EQ(ROMIMOT_TraceDrain(Trace, "/ram/ut.bin", &Info), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Info.SampleCount, 10);
+    UtAssert_UINT32_EQ(UT_TraceFile.Hdr.SampleCount, 10);
+    UtAssert_UINT32_EQ(UT_TraceFile.Hdr.SampleSize, sizeof(ROMIMOT_TraceSample_t));
+    UtAssert_UINT32_EQ(UT_TraceFile.Samples[0].Cycle, 0);
+    UtAssert_UINT32_EQ(UT_TraceFile.Samples[9].Cycle, 9);
+
+    /* a drained sample is not written twice */
+    UT_ResetState(UT_KEY(OS_write));
+    UT_SetDataBuffer(UT_KEY(OS_write), &UT_TraceFile, sizeof(UT_TraceFile), false);
+    UtAssert_INT32_EQ(ROMIMOT_TraceDrain(Trace, "/ram/ut.bin", &Info), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Info.SampleCount, 0);
+    UtAssert_UINT32_EQ(Info.FirstIndex, 10);
+
+    /* after wrapping the oldest slot is skipped, it may be mid-write */
+    UT_RecordTrace(Trace, ROMIMOT_TRACE_DEPTH + 5, 0);
+    memset(&UT_TraceFile, 0, sizeof(UT_TraceFile));
+    UT_ResetState(UT_KEY(OS_write));
+    UT_SetDataBuffer(UT_KEY(OS_write), &UT_TraceFile, sizeof(UT_TraceFile), false);
+    UtAssert_INT32_EQ(ROMIMOT_TraceDrain(Trace, "/ram/ut.bin", &Info), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Info.SampleCount, ROMIMOT_TRACE_DEPTH - 1);
+    UtAssert_UINT32_EQ(UT_TraceFile.Samples[0].Cycle, 16);
+    UtAssert_UINT32_EQ(UT_TraceFile.Samples[ROMIMOT_TRACE_DEPTH - 2].Cycle, ROMIMOT_TRACE_DEPTH + 14);
+    UT_ResetState(UT_KEY(OS_write));
+
+    /* an I2C error freezes the ring a fixed number of samples later */
+    ROMIMOT_TraceInit(Trace);
+    UT_RecordTrace(Trace, 5, 0);
+    UT_RecordTrace(Trace, 1, ROMIMOT_I2C_DAT_R_ERR_EID);
+    UT_RecordTrace(Trace, ROMIMOT_TRACE_POST_FAULT + 10, ROMIMOT_I2C_DAT_R_ERR_EID);
+    UtAssert_BOOL_TRUE(Trace->Frozen);
+    UtAssert_UINT32_EQ(Trace->Head, 6 + ROMIMOT_TRACE_POST_FAULT);
+
+    /* a failed dump keeps the frozen samples */
+    UT_SetDeferredRetcode(UT_KEY(OS_OpenCreate), 1, OS_ERROR);
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_TRACE_ERR_EID, NULL);
+    ROMIMOT_Data.ErrCounter = 0;
+    UtAssert_INT32_EQ(ROMIMOT_DumpTrace(&TestMsg), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 1);
+    UtAssert_BOOL_TRUE(Trace->Frozen);
+
+    UT_SetDeferredRetcode(UT_KEY(CFE_FS_WriteHeader), 1, -1);
+    UtAssert_INT32_EQ(ROMIMOT_TraceDrain(Trace, "/ram/ut.bin", &Info), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_BOOL_TRUE(Trace->Frozen);
+
+    UT_SetDeferredRetcode(UT_KEY(OS_write), 1, -1);
+    UtAssert_INT32_EQ(ROMIMOT_TraceDrain(Trace, "/ram/ut.bin", &Info), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_BOOL_TRUE(Trace->Frozen);
+
+    /* a good dump to the default file rearms it */
+    memset(&UT_TraceFile, 0, sizeof(UT_TraceFile));
+    UT_SetDataBuffer(UT_KEY(OS_write), &UT_TraceFile, sizeof(UT_TraceFile), false);
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_TRACE_INF_EID, NULL);
+    UtAssert_INT32_EQ(ROMIMOT_DumpTrace(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(UT_TraceFile.Hdr.SampleCount, 6 + ROMIMOT_TRACE_POST_FAULT);
+    UtAssert_UINT32_EQ(UT_TraceFile.Hdr.Faulted, 1);
+    UtAssert_INT32_EQ(UT_TraceFile.Samples[5].Status, ROMIMOT_I2C_DAT_R_ERR_EID);
+    UtAssert_BOOL_FALSE(Trace->Frozen);
+    UtAssert_BOOL_FALSE(Trace->Faulted);
+    UT_ResetState(UT_KEY(OS_write));
+
+    /* a named file */
+    UT_SetDataBuffer(UT_KEY(OS_write), &UT_TraceFile, sizeof(UT_TraceFile), false);
+    strncpy(TestMsg.FileName, "/ram/trace2.bin", sizeof(TestMsg.FileName) - 1);
+    UtAssert_INT32_EQ(ROMIMOT_DumpTrace(&TestMsg), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OS_OpenCreate, 8);
+}
+
+void Test_ROMIMOT_MultiDevice(void)
+{
+    /*
+     * Test Case For:
+     * several Romi bases served in turn by void ROMIMOT_IoCycle( void )
+     * ROMIMOT_Device_t *ROMIMOT_CmdDevice( uint8 Device )
+     */
+    ROMIMOT_Table_t             TestTblData;
+    void *                      TblPtrs[32];
+    ROMIMOT_SetTargetDeltaCmd_t TargetMsg;
+    ROMIMOT_SetEnableCmd_t      EnableMsg;
+    ROMIMOT_DriveModeCmd_t      ModeMsg;
+    UT_CheckEvent_t             EventTest;
+    int                         i;
+
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.HwBackend = ROMIMOT_HW_BACKEND_SIM;
+    for (i = 0; i < 3; i++)
+    {
+        TestTblData.Devices[i].Enabled   = 1;
+        TestTblData.Devices[i].BusNumber = 1;
+        TestTblData.Devices[i].Address   = ROMI_I2C_ADDRESS + i;
+        ROMIMOT_Data.Device[i].Instance  = i;
+        ROMIMOT_Data.Device[i].Enabled   = true;
+    }
+    for (i = 0; i < 32; i++)
+    {
+        TblPtrs[i] = &TestTblData;
+    }
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), TblPtrs, sizeof(TblPtrs), false);
+    UtAssert_INT32_EQ(ROMIMOT_StartIoTask(), CFE_SUCCESS);
+    romiSimUseWallClock(0);
+
+    ROMIMOT_Data.Gains.Kp          = ROMIMOT_Q16(1.0);
+    ROMIMOT_Data.Gains.DAlpha      = ROMIMOT_Q16(1.0);
+    ROMIMOT_Data.Gains.OutputLimit = 300;
+
+    /* each Romi gets its own bus handle and its own commands */
+    memset(&EnableMsg, 0, sizeof(EnableMsg));
+    memset(&TargetMsg, 0, sizeof(TargetMsg));
+    for (i = 0; i < 3; i++)
+    {
+        EnableMsg.Device = i;
+        UtAssert_INT32_EQ(ROMIMOT_SetMotEnable(&EnableMsg, i != 2), CFE_SUCCESS);
+        TargetMsg.Device     = i;
+        TargetMsg.cmdMotLeft = 10 * (i + 1);
+        UtAssert_INT32_EQ(ROMIMOT_SetTargetDelta(&TargetMsg), CFE_SUCCESS);
+    }
+    for (i = 0; i < 3; i++)
+    {
+        ROMIMOT_Data.Device[i].LeftOdoTrgt = 100000;
+        ROMIMOT_PublishControl(&ROMIMOT_Data.Device[i]);
+    }
+
+    for (i = 0; i < 5; i++)
+    {
+        ROMIMOT_Data.WakeTimeUs += 5000;
+        ROMIMOT_IoCycle();
+        romiSimAdvance(0.005);
+    }
+    for (i = 0; i < 3; i++)
+    {
+        UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[i].i2c_open);
+        UtAssert_UINT32_EQ(ROMIMOT_Data.Device[i].IoSensor.Stats.Cycles, 5);
+        UtAssert_UINT32_EQ(ROMIMOT_Data.Device[i].I2CErrCounter, 0);
+        UtAssert_UINT32_EQ(ROMIMOT_Data.Device[i].StateTlm.Payload.Instance, i);
+    }
+    UtAssert_True(ROMIMOT_Data.Device[0].i2cfd != ROMIMOT_Data.Device[1].i2cfd, "separate handles");
+    UtAssert_INT32_GT(ROMIMOT_Data.Device[0].IoSensor.Ctl.LeftOdoStep, 0);
+    UtAssert_INT32_GT(ROMIMOT_Data.Device[1].IoSensor.Ctl.LeftOdoStep, ROMIMOT_Data.Device[0].IoSensor.Ctl.LeftOdoStep);
+    UtAssert_INT32_EQ(ROMIMOT_Data.Device[2].IoSensor.Ctl.LeftMotSpeed, 0);
+    UtAssert_INT32_EQ(ROMIMOT_Data.Device[2].IoSensor.Ctl.LeftOdo, 0);
+
+    /* commands to a device that is missing or not enabled are rejected */
+    memset(&ModeMsg, 0, sizeof(ModeMsg));
+    ModeMsg.Device = ROMIMOT_MAX_DEVICES;
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_DEVICE_ERR_EID, NULL);
+    UtAssert_INT32_EQ(ROMIMOT_SetDriveMode(&ModeMsg), CFE_SUCCESS);
+    ModeMsg.Device = 3;
+    UtAssert_INT32_EQ(ROMIMOT_SetDriveMode(&ModeMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 2);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 2);
+
+    /* one housekeeping packet per enabled device */
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+    UtAssert_INT32_EQ(ROMIMOT_ReportHousekeeping(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 3);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[2].HkTlm.Payload.Instance, 2);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[2].HkTlm.Payload.MotorsEnabled, 0);
+
+    /* a device the table disables is stopped and closed, the others carry on */
+    ROMIMOT_Data.Device[1].Enabled = false;
+    ROMIMOT_IoCycle();
+    UtAssert_BOOL_FALSE(ROMIMOT_Data.Device[1].i2c_open);
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].i2c_open);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].IoSensor.Sequence, 6);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[1].IoSensor.Sequence, 5);
+
+    romiSimUseWallClock(1);
+    romiSetTimingHook(NULL);
+    for (i = 0; i < 3; i++)
+    {
+        romiClose(ROMIMOT_Data.Device[i].i2cfd);
+    }
+    romiSetBackend(&romiBackendI2C);
+}
+
+void Test_ROMIMOT_Path(void)
+{
+    /*
+     * Test Case For:
+     * the path queue in romimot_path.c
+     * const ROMIMOT_Profile_t *ROMIMOT_ControlPath( ... )
+     * void ROMIMOT_ControlPathStop( ... )
+     * int32 ROMIMOT_QueuePath( const ROMIMOT_QueuePathCmd_t *Msg )
+     * int32 ROMIMOT_ClearPath( const ROMIMOT_ClearPathCmd_t *Msg )
+     * table paths in void ROMIMOT_ApplyTableConfig( void )
+     */
+    ROMIMOT_Path_t           Path;
+    ROMIMOT_Segment_t        Segments[ROMIMOT_PATH_DEPTH];
+    ROMIMOT_Segment_t        Segment;
+    ROMIMOT_ControlState_t   Ctl;
+    ROMIMOT_ControlCmd_t     Published;
+    ROMIMOT_ControlCmd_t     Cmd;
+    ROMIMOT_Profile_t        Profile;
+    ROMIMOT_Profile_t        PathProfile;
+    const ROMIMOT_Profile_t *Used;
+    ROMIMOT_QueuePathCmd_t   QueueMsg;
+    ROMIMOT_ClearPathCmd_t   ClearMsg;
+    ROMIMOT_Table_t          TestTblData;
+    void *                   TblPtr = &TestTblData;
+    UT_CheckEvent_t          EventTest;
+    int                      i;
+
+    /* appends are all or nothing, and segments come out in order */
+    memset(Segments, 0, sizeof(Segments));
+    for (i = 0; i < ROMIMOT_PATH_DEPTH; i++)
+    {
+        Segments[i].Left = i + 1;
+    }
+    ROMIMOT_PathInit(&Path);
+    UtAssert_BOOL_FALSE(ROMIMOT_PathTake(&Path, &Segment));
+    UtAssert_BOOL_TRUE(ROMIMOT_PathAppend(&Path, Segments, ROMIMOT_PATH_DEPTH - 1));
+    UtAssert_BOOL_FALSE(ROMIMOT_PathAppend(&Path, Segments, 2));
+    UtAssert_UINT32_EQ(ROMIMOT_PathQueued(&Path), ROMIMOT_PATH_DEPTH - 1);
+    UtAssert_BOOL_TRUE(ROMIMOT_PathTake(&Path, &Segment));
+    UtAssert_INT32_EQ(Segment.Left, 1);
+    UtAssert_BOOL_TRUE(ROMIMOT_PathAppend(&Path, Segments, 2));
+    ROMIMOT_PathFlush(&Path);
+    UtAssert_UINT32_EQ(ROMIMOT_PathQueued(&Path), 0);
+
+    /* each leg starts on the cycle the previous target is reached */
+    memset(&Ctl, 0, sizeof(Ctl));
+    memset(&Published, 0, sizeof(Published));
+    memset(&Profile, 0, sizeof(Profile));
+    memset(&PathProfile, 0, sizeof(PathProfile));
+    Published.MotorsEnabled     = 1;
+    Published.TargetDeltaLeft   = 10;
+    Published.TargetDeltaRight  = 10;
+    Published.Gains.DAlpha      = ROMIMOT_Q16(1.0);
+    Published.Gains.OutputLimit = 300;
+
+    memset(Segments, 0, sizeof(Segments));
+    Segments[0].Left       = 20;
+    Segments[0].Right      = 20;
+    Segments[1].Left       = 30;
+    Segments[1].Right      = -30;
+    Segments[1].SpeedLeft  = 15;
+    Segments[1].SpeedRight = 15;
+    UtAssert_BOOL_TRUE(ROMIMOT_PathAppend(&Path, Segments, 2));
+
+    /* nothing starts while the motors are off */
+    Published.MotorsEnabled = 0;
+    Cmd                     = Published;
+    UtAssert_ADDRESS_EQ(ROMIMOT_ControlPath(&Ctl, &Cmd, &Profile, &Path, &PathProfile), &Profile);
+    UtAssert_UINT32_EQ(ROMIMOT_PathQueued(&Path), 2);
+    Published.MotorsEnabled = 1;
+
+    for (i = 0; i < 3; i++)
+    {
+        Cmd  = Published;
+        Used = ROMIMOT_ControlPath(&Ctl, &Cmd, &Profile, &Path, &PathProfile);
+        ROMIMOT_ControlStep(&Ctl, &Cmd, Used);
+    }
+    UtAssert_ADDRESS_EQ(Used, &PathProfile);
+    UtAssert_UINT32_EQ(Ctl.PathSegments, 2);
+    UtAssert_UINT32_EQ(PathProfile.Seq, ROMIMOT_PATH_SEQ_BIT | 2);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 35);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, 5);
+    UtAssert_INT32_EQ(Cmd.TargetDeltaLeft, 15);
+
+    Cmd  = Published;
+    Used = ROMIMOT_ControlPath(&Ctl, &Cmd, &Profile, &Path, &PathProfile);
+    ROMIMOT_ControlStep(&Ctl, &Cmd, Used);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 50);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, -10);
+
+    /* at the end the commanded targets take over, moved along by the path */
+    Cmd  = Published;
+    Used = ROMIMOT_ControlPath(&Ctl, &Cmd, &Profile, &Path, &PathProfile);
+    UtAssert_ADDRESS_EQ(Used, &Profile);
+    UtAssert_BOOL_FALSE(Ctl.PathActive);
+    UtAssert_INT32_EQ(Cmd.LeftOdoTrgt, 50);
+    UtAssert_INT32_EQ(Cmd.RightOdoTrgt, -10);
+
+    /* stopping a leg holds the intermediate targets */
+    UtAssert_BOOL_TRUE(ROMIMOT_PathAppend(&Path, Segments, 1));
+    Cmd  = Published;
+    Used = ROMIMOT_ControlPath(&Ctl, &Cmd, &Profile, &Path, &PathProfile);
+    ROMIMOT_ControlStep(&Ctl, &Cmd, Used);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 60);
+    ROMIMOT_ControlPathStop(&Ctl, &Published);
+    ROMIMOT_ControlPathStop(&Ctl, &Published);
+    Cmd  = Published;
+    Used = ROMIMOT_ControlPath(&Ctl, &Cmd, &Profile, &Path, &PathProfile);
+    ROMIMOT_ControlStep(&Ctl, &Cmd, Used);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 60);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, 0);
+
+    /* commands name an enabled device and carry 1 to ROMIMOT_PATH_CMD_MAX valid segments */
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&QueueMsg, 0, sizeof(QueueMsg));
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_PATH_ERR_EID, NULL);
+    UtAssert_INT32_EQ(ROMIMOT_QueuePath(&QueueMsg), CFE_SUCCESS);
+    QueueMsg.Count = ROMIMOT_PATH_CMD_MAX + 1;
+    UtAssert_INT32_EQ(ROMIMOT_QueuePath(&QueueMsg), CFE_SUCCESS);
+    QueueMsg.Count                  = ROMIMOT_PATH_CMD_MAX;
+    QueueMsg.Segments[3].SpeedRight = -1;
+    UtAssert_INT32_EQ(ROMIMOT_QueuePath(&QueueMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 3);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 3);
+
+    QueueMsg.Segments[3].SpeedRight = 0;
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_PATH_INF_EID, NULL);
+    for (i = 0; i < ROMIMOT_PATH_DEPTH / ROMIMOT_PATH_CMD_MAX; i++)
+    {
+        UtAssert_INT32_EQ(ROMIMOT_QueuePath(&QueueMsg), CFE_SUCCESS);
+    }
+    UtAssert_UINT32_EQ(EventTest.MatchCount, ROMIMOT_PATH_DEPTH / ROMIMOT_PATH_CMD_MAX);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.CmdCounter, ROMIMOT_PATH_DEPTH / ROMIMOT_PATH_CMD_MAX);
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].I2CConnectReq);
+
+    /* a full queue turns the next batch away */
+    UtAssert_INT32_EQ(ROMIMOT_QueuePath(&QueueMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 4);
+
+    UtAssert_INT32_EQ(ROMIMOT_ReportHousekeeping(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.PathQueued, ROMIMOT_PATH_DEPTH);
+
+    /* clearing is left to the I/O task */
+    memset(&ClearMsg, 0, sizeof(ClearMsg));
+    UtAssert_INT32_EQ(ROMIMOT_ClearPath(&ClearMsg), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].PathClearReq);
+    ClearMsg.Device = 1;
+    UtAssert_INT32_EQ(ROMIMOT_ClearPath(&ClearMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 5);
+
+    /* a table load queues the paths of the devices it enables */
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    memset(&TestTblData, 0, sizeof(TestTblData));
+    TestTblData.Devices[0].Enabled   = 1;
+    TestTblData.Devices[0].PathCount = 3;
+    TestTblData.Devices[1].PathCount = 3;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_INFO_UPDATED);
+    ROMIMOT_ApplyTableConfig();
+    UtAssert_UINT32_EQ(ROMIMOT_PathQueued(&ROMIMOT_Data.Device[0].Path), 3);
+    UtAssert_UINT32_EQ(ROMIMOT_PathQueued(&ROMIMOT_Data.Device[1].Path), 0);
+
+    /* but not again until the next load; read delays apply to their own device */
+    TestTblData.Devices[1].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT] = 70;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_SUCCESS);
+    ROMIMOT_ApplyTableConfig();
+    UtAssert_UINT32_EQ(ROMIMOT_PathQueued(&ROMIMOT_Data.Device[0].Path), 3);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT], 0);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[1].ReadDelayUs[ROMI_READ_RANGE_SNAPSHOT], 70);
+
+    /* segments past the table's room are refused */
+    TestTblData.Devices[1].PathCount = ROMIMOT_PATH_TABLE_MAX + 1;
+    TestTblData.ControlRateHz        = ROMIMOT_CONTROL_RATE_MIN_HZ;
+    TestTblData.OutputLimit          = ROMIMOT_PID_OUTPUT_MAX;
+    TestTblData.DAlpha               = ROMIMOT_Q16(1.0);
+    TestTblData.StateBatchSize       = 1;
+    TestTblData.Devices[0].Address   = ROMI_I2C_ADDRESS;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), ROMIMOT_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.Devices[1].PathCount = ROMIMOT_PATH_TABLE_MAX;
+    UtAssert_INT32_EQ(ROMIMOT_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+}
+
+void Test_ROMIMOT_Stream(void)
+{
+    /*
+     * Test Case For:
+     * int32 ROMIMOT_SetVelocity( const ROMIMOT_SetVelocityCmd_t *Msg )
+     * bool ROMIMOT_ControlStream( ... )
+     */
+    ROMIMOT_SetVelocityCmd_t TestMsg;
+    ROMIMOT_ControlState_t   Ctl;
+    ROMIMOT_ControlCmd_t     Published;
+    ROMIMOT_ControlCmd_t     Cmd;
+    ROMIMOT_Profile_t        Profile;
+    ROMIMOT_Path_t           Path;
+    ROMIMOT_Profile_t        PathProfile;
+    const ROMIMOT_Profile_t *Used;
+    UT_CheckEvent_t          EventTest;
+    int                      i;
+
+    /* setpoints name an enabled device with its motors on, and stay in range */
+    memset(&ROMIMOT_Data, 0, sizeof(ROMIMOT_Data));
+    ROMIMOT_Data.Device[0].Enabled = true;
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    TestMsg.SpeedLeft  = 150;
+    TestMsg.SpeedRight = -50;
+    TestMsg.TimeoutMs  = 100;
+
+    UT_CHECKEVENT_SETUP(&EventTest, ROMIMOT_STREAM_ERR_EID, NULL);
+    UtAssert_INT32_EQ(ROMIMOT_SetVelocity(&TestMsg), CFE_SUCCESS);
+    ROMIMOT_Data.Device[0].MotorsEnabled = 1;
+    TestMsg.SpeedRight                   = -ROMIMOT_STREAM_SPEED_MAX - 1;
+    UtAssert_INT32_EQ(ROMIMOT_SetVelocity(&TestMsg), CFE_SUCCESS);
+    TestMsg.SpeedRight = -50;
+    TestMsg.TimeoutMs  = 0;
+    UtAssert_INT32_EQ(ROMIMOT_SetVelocity(&TestMsg), CFE_SUCCESS);
+    TestMsg.TimeoutMs = ROMIMOT_STREAM_TIMEOUT_MAX_MS + 1;
+    UtAssert_INT32_EQ(ROMIMOT_SetVelocity(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 4);
+    TestMsg.TimeoutMs = 100;
+    TestMsg.Device    = 1;
+    UtAssert_INT32_EQ(ROMIMOT_SetVelocity(&TestMsg), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.ErrCounter, 5);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].StreamSeq, 0);
+
+    /* a good one is published with a new sequence number, and raises no event */
+    TestMsg.Device = 0;
+    UtAssert_INT32_EQ(ROMIMOT_SetVelocity(&TestMsg), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(CFE_EVS_SendEvent, 5);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.CmdCounter, 1);
+    UtAssert_BOOL_TRUE(ROMIMOT_Data.Device[0].I2CConnectReq);
+    UtAssert_BOOL_TRUE(ROMIMOT_DblBuf_Read(&ROMIMOT_Data.Device[0].ControlBuf, ROMIMOT_Data.Device[0].ControlSlots,
+                                           sizeof(Cmd), &Cmd, &ROMIMOT_Data.Device[0].ControlCount));
+    UtAssert_UINT32_EQ(Cmd.StreamSeq, 1);
+    UtAssert_INT32_EQ(Cmd.StreamLeft, 150);
+    UtAssert_INT32_EQ(Cmd.StreamRight, -50);
+    UtAssert_UINT32_EQ(Cmd.StreamTimeoutMs, 100);
+
+    /* no setpoint yet, the commanded targets have the wheels */
+    memset(&Ctl, 0, sizeof(Ctl));
+    memset(&Published, 0, sizeof(Published));
+    memset(&Profile, 0, sizeof(Profile));
+    memset(&PathProfile, 0, sizeof(PathProfile));
+    ROMIMOT_PathInit(&Path);
+    Published.MotorsEnabled     = 1;
+    Published.LeftOdoTrgt       = 100;
+    Published.TargetDeltaLeft   = 10;
+    Published.TargetDeltaRight  = 10;
+    Published.Gains.Kp          = ROMIMOT_Q16(1.0);
+    Published.Gains.DAlpha      = ROMIMOT_Q16(1.0);
+    Published.Gains.OutputLimit = 300;
+    Ctl.PeriodUs                = 10000;
+    UtAssert_BOOL_FALSE(ROMIMOT_ControlStream(&Ctl, &Published));
+
+    /* the stream takes over a move part way through, at 1.5 and -0.5 counts a cycle */
+    Ctl.LeftOdoStep           = 40;
+    Ctl.LeftProfile.Active    = true;
+    Published.StreamSeq       = 1;
+    Published.StreamLeft      = 150;
+    Published.StreamRight     = -50;
+    Published.StreamTimeoutMs = 100;
+    UtAssert_BOOL_TRUE(ROMIMOT_ControlStream(&Ctl, &Published));
+    UtAssert_BOOL_TRUE(Ctl.Streaming);
+    UtAssert_BOOL_FALSE(Ctl.LeftProfile.Active);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 41);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, 0);
+    UtAssert_INT32_EQ(Ctl.PathLeft, -59);
+    UtAssert_INT32_EQ(Ctl.LeftMotSpeed, 41);
+
+    UtAssert_BOOL_TRUE(ROMIMOT_ControlStream(&Ctl, &Published));
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 43);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, -1);
+
+    /* the watchdog stops the wheels once the setpoints are 100 ms old */
+    for (i = 2; i < 11; i++)
+    {
+        UtAssert_BOOL_TRUE(ROMIMOT_ControlStream(&Ctl, &Published));
+    }
+    UtAssert_BOOL_FALSE(ROMIMOT_ControlStream(&Ctl, &Published));
+    UtAssert_BOOL_FALSE(Ctl.Streaming);
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 56);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, -5);
+
+    /* the targets then hold where the stream left them */
+    for (i = 0; i < 3; i++)
+    {
+        Cmd  = Published;
+        Used = ROMIMOT_ControlPath(&Ctl, &Cmd, &Profile, &Path, &PathProfile);
+        ROMIMOT_ControlStep(&Ctl, &Cmd, Used);
+    }
+    UtAssert_INT32_EQ(Ctl.LeftOdoStep, 56);
+    UtAssert_INT32_EQ(Ctl.RightOdoStep, -5);
+
+    /* a zero setpoint is no stream */
+    Published.StreamSeq   = 2;
+    Published.StreamLeft  = 0;
+    Published.StreamRight = 0;
+    UtAssert_BOOL_FALSE(ROMIMOT_ControlStream(&Ctl, &Published));
+
+    /* a setpoint sent with the motors off is dropped, not kept for later */
+    Published.StreamSeq     = 3;
+    Published.StreamLeft    = 100;
+    Published.MotorsEnabled = 0;
+    UtAssert_BOOL_FALSE(ROMIMOT_ControlStream(&Ctl, &Published));
+    Published.MotorsEnabled = 1;
+    UtAssert_BOOL_FALSE(ROMIMOT_ControlStream(&Ctl, &Published));
+
+    /* and so is one held off by the bus recovery */
+    Published.StreamSeq = 4;
+    UtAssert_BOOL_TRUE(ROMIMOT_ControlStream(&Ctl, &Published));
+    ROMIMOT_ControlHold(&Ctl);
+    UtAssert_BOOL_FALSE(ROMIMOT_ControlStream(&Ctl, &Published));
+
+    /* housekeeping says whether a stream is driving */
+    ROMIMOT_Data.Device[0].Sensor.Ctl.Streaming = true;
+    UtAssert_INT32_EQ(ROMIMOT_ReportHousekeeping(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(ROMIMOT_Data.Device[0].HkTlm.Payload.Streaming, 1);
+}
+
+/*
+ * Table image handed out by CFE_TBL_GetAddress() when a test case did not
+ * supply its own with UT_SetDataBuffer()
+ */
+static ROMIMOT_Table_t UT_DefaultTbl = {.HwBackend         = ROMIMOT_HW_BACKEND_DEFAULT,
+                                       .ControlMode       = ROMIMOT_CONTROL_MODE_WAKEUP,
+                                       .ControlRateHz     = 200,
+                                       .OutputLimit       = 200,
+                                       .Kp                = ROMIMOT_Q16(0.05),
+                                       .DAlpha            = ROMIMOT_Q16(1.0),
+                                       .StateBatchSize    = 5,
+                                       .ReadDelayMarginUs = 20,
+                                       .Devices           = {{1, 1, ROMI_I2C_ADDRESS, {100, 100, 100}}}};
+
+static void UT_Handler_CFE_TBL_GetAddress(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    void **TblPtr = UT_Hook_GetArgValueByName(Context, "TblPtr", void **);
+    int32  status;
+    void * ptr;
+
+    UT_Stub_GetInt32StatusCode(Context, &status);
+    if (status >= 0)
+    {
+        if (UT_Stub_CopyToLocal(FuncKey, &ptr, sizeof(ptr)) < sizeof(ptr))
+        {
+            ptr = &UT_DefaultTbl;
+        }
+        *TblPtr = ptr;
+    }
+}
+
 /*
  * Setup function prior to every test
  */
 void romimot_UT_Setup(void)
 {
     UT_ResetState(0);
+    UT_SetHandlerFunction(UT_KEY(CFE_TBL_GetAddress), UT_Handler_CFE_TBL_GetAddress, NULL);
 }
 
 /*
@@ -589,13 +2869,36 @@ void UtTest_Setup(void)
 {
     ADD_TEST(ROMIMOT_Main);
     ADD_TEST(ROMIMOT_Init);
+    ADD_TEST(ROMIMOT_RtProfile);
     ADD_TEST(ROMIMOT_ProcessCommandPacket);
-    ADD_TEST(ROMIMOT_ProcessGroundCommand);
+    ADD_TEST(ROMIMOT_DispatchTable);
     ADD_TEST(ROMIMOT_ReportHousekeeping);
     ADD_TEST(ROMIMOT_NoopCmd);
     ADD_TEST(ROMIMOT_ResetCounters);
+    ADD_TEST(ROMIMOT_SendCmdStats);
     ADD_TEST(ROMIMOT_ProcessCC);
-    ADD_TEST(ROMIMOT_VerifyCmdLength);
     ADD_TEST(ROMIMOT_TblValidationFunc);
     ADD_TEST(ROMIMOT_GetCrc);
+    ADD_TEST(ROMIMOT_DblBuf);
+    ADD_TEST(ROMIMOT_IoCycle);
+    ADD_TEST(ROMIMOT_SimBackend);
+    ADD_TEST(ROMIMOT_BusLog);
+    ADD_TEST(romiSnapshotRead);
+    ADD_TEST(ROMIMOT_ControlStep);
+    ADD_TEST(ROMIMOT_Pid);
+    ADD_TEST(ROMIMOT_Profile);
+    ADD_TEST(ROMIMOT_PlanProfile);
+    ADD_TEST(ROMIMOT_Trace);
+    ADD_TEST(ROMIMOT_ControlTimer);
+    ADD_TEST(ROMIMOT_LoopStats);
+    ADD_TEST(ROMIMOT_StateBatch);
+    ADD_TEST(ROMIMOT_StaleSample);
+    ADD_TEST(ROMIMOT_BusStats);
+    ADD_TEST(ROMIMOT_ReadCal);
+    ADD_TEST(ROMIMOT_BusRecovery);
+    ADD_TEST(ROMIMOT_DriveMode);
+    ADD_TEST(ROMIMOT_Velocity);
+    ADD_TEST(ROMIMOT_MultiDevice);
+    ADD_TEST(ROMIMOT_Path);
+    ADD_TEST(ROMIMOT_Stream);
 }
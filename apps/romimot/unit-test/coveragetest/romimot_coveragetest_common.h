@@ -19,6 +19,7 @@
 #include "romimot_events.h"
 #include "romimot.h"
 #include "romimot_table.h"
+#include "romi_velocity.h"
 
 /*
  * Macro to add a test case to the list of tests to execute
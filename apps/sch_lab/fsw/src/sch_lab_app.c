@@ -32,6 +32,9 @@
 #include "cfe_es.h"
 #include "cfe_error.h"
 
+#include "mrlib.h"
+
+#include "sch_lab_events.h"
 #include "sch_lab_perfids.h"
 #include "sch_lab_version.h"
 
@@ -57,6 +60,7 @@ typedef struct
     osal_id_t            TimingSem;
     CFE_TBL_Handle_t     TblHandle;
     CFE_SB_PipeId_t      CmdPipe;
+    uint32               OneHzPktsRcvd;
 } SCH_LAB_GlobalData_t;
 
 /*
@@ -68,6 +72,30 @@ SCH_LAB_GlobalData_t SCH_LAB_Global;
 ** Local Function Prototypes
 */
 int32 SCH_LAB_AppInit(void);
+int32 SCH_LAB_OneHz(const CFE_MSG_CommandHeader_t *Msg);
+
+/*
+** Table entries, each handing the packet to its handler as its command type
+*/
+MRLIB_HANDLER_ADAPTER(SCH_LAB_OneHz, CFE_MSG_CommandHeader_t)
+
+/*
+** Command dispatch table, the 1Hz tick is the only message on the pipe
+*/
+static const MRLIB_Cmd_t SCH_LAB_OneHzCmds[] = {
+    {SCH_LAB_OneHz_Handler, sizeof(CFE_MSG_CommandHeader_t)},
+};
+
+/*
+** SCH_LAB has no ground command to send dispatch statistics, so it keeps none
+*/
+static const MRLIB_Route_t SCH_LAB_Routes[] = {
+    {CFE_TIME_1HZ_CMD_MID, 0, SCH_LAB_OneHzCmds, NULL},
+};
+
+static const MRLIB_Dispatch_t SCH_LAB_Dispatch = {
+    SCH_LAB_Routes, MRLIB_COUNT(SCH_LAB_Routes), SCH_LAB_MSGID_ERR_EID, SCH_LAB_FNCODE_ERR_EID, SCH_LAB_LEN_ERR_EID,
+};
 
 /*
 ** AppMain
@@ -75,7 +103,6 @@ int32 SCH_LAB_AppInit(void);
 void SCH_Lab_AppMain(void)
 {
     int                   i;
-    uint32                SCH_OneHzPktsRcvd = 0;
     int32                 OsStatus;
     CFE_Status_t          Status;
     uint32                RunStatus = CFE_ES_RunStatus_APP_RUN;
@@ -112,10 +139,10 @@ void SCH_Lab_AppMain(void)
 
         if (Status == CFE_SUCCESS)
         {
-            SCH_OneHzPktsRcvd++;
+            MRLIB_Dispatch(&SCH_LAB_Dispatch, SBBufPtr);
         }
 
-        if (OsStatus == OS_SUCCESS && SCH_OneHzPktsRcvd > 0)
+        if (OsStatus == OS_SUCCESS && SCH_LAB_Global.OneHzPktsRcvd > 0)
         {
             /*
             ** Process table every tick, sending packets that are ready
@@ -141,6 +168,16 @@ void SCH_Lab_AppMain(void)
     CFE_ES_ExitApp(Status);
 }
 
+/*
+** 1Hz tick from TIME, once one has arrived the schedule table runs
+*/
+int32 SCH_LAB_OneHz(const CFE_MSG_CommandHeader_t *Msg)
+{
+    SCH_LAB_Global.OneHzPktsRcvd++;
+
+    return CFE_SUCCESS;
+}
+
 void SCH_LAB_LocalTimerCallback(osal_id_t object_id, void *arg)
 {
     OS_CountSemGive(SCH_LAB_Global.TimingSem);
@@ -165,6 +202,14 @@ int32 SCH_LAB_AppInit(void)
 
     memset(&SCH_LAB_Global, 0, sizeof(SCH_LAB_Global));
 
+    /* Only for the dispatch errors, everything else still goes to syslog */
+    Status = CFE_EVS_Register(NULL, 0, CFE_EVS_EventFilter_BINARY);
+    if (Status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("%s: CFE_EVS_Register failed:RC=0x%08lX\n", __func__, (unsigned long)Status);
+        return Status;
+    }
+
     OsStatus = OS_CountSemCreate(&SCH_LAB_Global.TimingSem, "SCH_LAB", 0, 0);
     if (OsStatus != OS_SUCCESS)
     {
@@ -0,0 +1,13 @@
+/**
+ * @file
+ *  Define SCH Lab Events IDs
+ */
+#ifndef SCH_LAB_EVENTS_H
+#define SCH_LAB_EVENTS_H
+
+#define SCH_LAB_RESERVED_EID   0
+#define SCH_LAB_MSGID_ERR_EID  1
+#define SCH_LAB_FNCODE_ERR_EID 2
+#define SCH_LAB_LEN_ERR_EID    3
+
+#endif
@@ -26,7 +26,8 @@
 #define TO_LAB_CMD_MID     0x1880
 #define TO_LAB_SEND_HK_MID 0x1881
 
-#define TO_LAB_HK_TLM_MID     0x0880
-#define TO_LAB_DATA_TYPES_MID 0x0881
+#define TO_LAB_HK_TLM_MID        0x0880
+#define TO_LAB_DATA_TYPES_MID    0x0881
+#define TO_LAB_CMD_STATS_TLM_MID 0x0882
 
 #endif
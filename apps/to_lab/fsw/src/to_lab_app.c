@@ -43,6 +43,7 @@ typedef struct
 
     TO_LAB_HkTlm_t        HkTlm;
     TO_LAB_DataTypesTlm_t DataTypesTlm;
+    MRLIB_CmdStatsTlm_t   CmdStatsTlm;
 } TO_LAB_GlobalData_t;
 
 TO_LAB_GlobalData_t TO_LAB_Global;
@@ -55,7 +56,6 @@ CFE_TBL_Handle_t TO_SubTblHandle;
 */
 void  TO_LAB_openTLM(void);
 int32 TO_LAB_init(void);
-void  TO_LAB_exec_local_command(CFE_SB_Buffer_t *SBBufPtr);
 void  TO_LAB_process_commands(void);
 void  TO_LAB_forward_telemetry(void);
 
@@ -69,8 +69,52 @@ int32 TO_LAB_RemoveAll(const TO_LAB_RemoveAllCmd_t *data);
 int32 TO_LAB_RemovePacket(const TO_LAB_RemovePacketCmd_t *data);
 int32 TO_LAB_ResetCounters(const TO_LAB_ResetCountersCmd_t *data);
 int32 TO_LAB_SendDataTypes(const TO_LAB_SendDataTypesCmd_t *data);
+int32 TO_LAB_SendCmdStats(const TO_LAB_SendCmdStatsCmd_t *data);
 int32 TO_LAB_SendHousekeeping(const CFE_MSG_CommandHeader_t *data);
 
+/*
+ * Table entries, each handing the packet to its handler as its command type
+ */
+MRLIB_HANDLER_ADAPTER(TO_LAB_Noop, TO_LAB_NoopCmd_t)
+MRLIB_HANDLER_ADAPTER(TO_LAB_ResetCounters, TO_LAB_ResetCountersCmd_t)
+MRLIB_HANDLER_ADAPTER(TO_LAB_AddPacket, TO_LAB_AddPacketCmd_t)
+MRLIB_HANDLER_ADAPTER(TO_LAB_SendDataTypes, TO_LAB_SendDataTypesCmd_t)
+MRLIB_HANDLER_ADAPTER(TO_LAB_RemovePacket, TO_LAB_RemovePacketCmd_t)
+MRLIB_HANDLER_ADAPTER(TO_LAB_RemoveAll, TO_LAB_RemoveAllCmd_t)
+MRLIB_HANDLER_ADAPTER(TO_LAB_EnableOutput, TO_LAB_EnableOutputCmd_t)
+MRLIB_HANDLER_ADAPTER(TO_LAB_SendCmdStats, TO_LAB_SendCmdStatsCmd_t)
+MRLIB_HANDLER_ADAPTER(TO_LAB_SendHousekeeping, CFE_MSG_CommandHeader_t)
+
+/*
+ * Command dispatch tables, indexed by function code
+ */
+static const MRLIB_Cmd_t TO_LAB_GroundCmds[] = {
+    [TO_LAB_NOOP_CC]            = {TO_LAB_Noop_Handler, sizeof(TO_LAB_NoopCmd_t)},
+    [TO_LAB_RESET_STATUS_CC]    = {TO_LAB_ResetCounters_Handler, sizeof(TO_LAB_ResetCountersCmd_t)},
+    [TO_LAB_ADD_PKT_CC]         = {TO_LAB_AddPacket_Handler, sizeof(TO_LAB_AddPacketCmd_t)},
+    [TO_LAB_SEND_DATA_TYPES_CC] = {TO_LAB_SendDataTypes_Handler, sizeof(TO_LAB_SendDataTypesCmd_t)},
+    [TO_LAB_REMOVE_PKT_CC]      = {TO_LAB_RemovePacket_Handler, sizeof(TO_LAB_RemovePacketCmd_t)},
+    [TO_LAB_REMOVE_ALL_PKT_CC]  = {TO_LAB_RemoveAll_Handler, sizeof(TO_LAB_RemoveAllCmd_t)},
+    [TO_LAB_OUTPUT_ENABLE_CC]   = {TO_LAB_EnableOutput_Handler, sizeof(TO_LAB_EnableOutputCmd_t)},
+    [TO_LAB_SEND_CMD_STATS_CC]  = {TO_LAB_SendCmdStats_Handler, sizeof(TO_LAB_SendCmdStatsCmd_t)},
+};
+
+static const MRLIB_Cmd_t TO_LAB_SendHkCmds[] = {
+    {TO_LAB_SendHousekeeping_Handler, sizeof(CFE_MSG_CommandHeader_t)},
+};
+
+static MRLIB_CmdStats_t TO_LAB_GroundStats[MRLIB_COUNT(TO_LAB_GroundCmds)];
+static MRLIB_CmdStats_t TO_LAB_SendHkStats[MRLIB_COUNT(TO_LAB_SendHkCmds)];
+
+static const MRLIB_Route_t TO_LAB_Routes[] = {
+    {TO_LAB_CMD_MID, MRLIB_COUNT(TO_LAB_GroundCmds), TO_LAB_GroundCmds, TO_LAB_GroundStats},
+    {TO_LAB_SEND_HK_MID, 0, TO_LAB_SendHkCmds, TO_LAB_SendHkStats},
+};
+
+static const MRLIB_Dispatch_t TO_LAB_Dispatch = {
+    TO_LAB_Routes, MRLIB_COUNT(TO_LAB_Routes), TO_LAB_MSGID_ERR_EID, TO_LAB_FNCODE_ERR_EID, TO_LAB_LEN_ERR_EID,
+};
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 /*                                                                   */
 /* TO_LAB_AppMain() -- Application entry point and main process loop */
@@ -148,10 +192,12 @@ int32 TO_LAB_init(void)
     */
     CFE_EVS_Register(NULL, 0, CFE_EVS_EventFilter_BINARY);
     /*
-    ** Initialize housekeeping packet (clear user data area)...
+    ** Initialize housekeeping and dispatch statistics packets (clear user data area)...
     */
     CFE_MSG_Init(CFE_MSG_PTR(TO_LAB_Global.HkTlm.TelemetryHeader), CFE_SB_ValueToMsgId(TO_LAB_HK_TLM_MID),
                  sizeof(TO_LAB_Global.HkTlm));
+    CFE_MSG_Init(CFE_MSG_PTR(TO_LAB_Global.CmdStatsTlm.TelemetryHeader), CFE_SB_ValueToMsgId(TO_LAB_CMD_STATS_TLM_MID),
+                 sizeof(TO_LAB_Global.CmdStatsTlm));
 
     status = CFE_TBL_Register(&TO_SubTblHandle, "TO_LAB_Subs", sizeof(*TO_LAB_Subs), CFE_TBL_OPT_DEFAULT, NULL);
 
@@ -263,7 +309,6 @@ int32 TO_LAB_EnableOutput(const TO_LAB_EnableOutputCmd_t *data)
 void TO_LAB_process_commands(void)
 {
     CFE_SB_Buffer_t *SBBufPtr;
-    CFE_SB_MsgId_t   MsgId = CFE_SB_INVALID_MSG_ID;
 
     while (1)
     {
@@ -271,24 +316,10 @@ void TO_LAB_process_commands(void)
         {
             case CFE_SUCCESS:
 
-                CFE_MSG_GetMsgId(&SBBufPtr->Msg, &MsgId);
-
                 /* For SB return statuses that imply a message: process it. */
-                switch (CFE_SB_MsgIdToValue(MsgId))
+                if (MRLIB_Dispatch(&TO_LAB_Dispatch, SBBufPtr) != CFE_SUCCESS)
                 {
-                    case TO_LAB_CMD_MID:
-                        TO_LAB_exec_local_command(SBBufPtr);
-                        break;
-
-                    case TO_LAB_SEND_HK_MID:
-                        TO_LAB_SendHousekeeping((const CFE_MSG_CommandHeader_t *)SBBufPtr);
-                        break;
-
-                    default:
-                        CFE_EVS_SendEvent(TO_LAB_MSGID_ERR_EID, CFE_EVS_EventType_ERROR,
-                                          "L%d TO: Invalid Msg ID Rcvd 0x%x", __LINE__,
-                                          (unsigned int)CFE_SB_MsgIdToValue(MsgId));
-                        break;
+                    ++TO_LAB_Global.HkTlm.Payload.CommandErrorCounter;
                 }
                 break;
             default:
@@ -298,55 +329,6 @@ void TO_LAB_process_commands(void)
     }
 }
 
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
-/*                                                                 */
-/*  TO_LAB_exec_local_command() -- Process local message           */
-/*                                                                 */
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
-void TO_LAB_exec_local_command(CFE_SB_Buffer_t *SBBufPtr)
-{
-    CFE_MSG_FcnCode_t CommandCode = 0;
-
-    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &CommandCode);
-
-    switch (CommandCode)
-    {
-        case TO_LAB_NOOP_CC:
-            TO_LAB_Noop((const TO_LAB_NoopCmd_t *)SBBufPtr);
-            break;
-
-        case TO_LAB_RESET_STATUS_CC:
-            TO_LAB_ResetCounters((const TO_LAB_ResetCountersCmd_t *)SBBufPtr);
-            break;
-
-        case TO_LAB_SEND_DATA_TYPES_CC:
-            TO_LAB_SendDataTypes((const TO_LAB_SendDataTypesCmd_t *)SBBufPtr);
-            break;
-
-        case TO_LAB_ADD_PKT_CC:
-            TO_LAB_AddPacket((const TO_LAB_AddPacketCmd_t *)SBBufPtr);
-            break;
-
-        case TO_LAB_REMOVE_PKT_CC:
-            TO_LAB_RemovePacket((const TO_LAB_RemovePacketCmd_t *)SBBufPtr);
-            break;
-
-        case TO_LAB_REMOVE_ALL_PKT_CC:
-            TO_LAB_RemoveAll((const TO_LAB_RemoveAllCmd_t *)SBBufPtr);
-            break;
-
-        case TO_LAB_OUTPUT_ENABLE_CC:
-            TO_LAB_EnableOutput((const TO_LAB_EnableOutputCmd_t *)SBBufPtr);
-            break;
-
-        default:
-            CFE_EVS_SendEvent(TO_LAB_FNCODE_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "L%d TO: Invalid Function Code Rcvd In Ground Command 0x%x", __LINE__,
-                              (unsigned int)CommandCode);
-            ++TO_LAB_Global.HkTlm.Payload.CommandErrorCounter;
-    }
-}
-
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 /*                                                                 */
 /* TO_LAB_Noop() -- Noop Handler                                   */
@@ -368,6 +350,19 @@ int32 TO_LAB_ResetCounters(const TO_LAB_ResetCountersCmd_t *data)
 {
     TO_LAB_Global.HkTlm.Payload.CommandErrorCounter = 0;
     TO_LAB_Global.HkTlm.Payload.CommandCounter      = 0;
+    MRLIB_ResetCmdStats(&TO_LAB_Dispatch);
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* TO_LAB_SendCmdStats() -- Output command dispatch statistics     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+int32 TO_LAB_SendCmdStats(const TO_LAB_SendCmdStatsCmd_t *data)
+{
+    ++TO_LAB_Global.HkTlm.Payload.CommandCounter;
+    MRLIB_SendCmdStats(&TO_LAB_Dispatch, &TO_LAB_Global.CmdStatsTlm);
     return CFE_SUCCESS;
 }
 
@@ -33,6 +33,8 @@
 #include "common_types.h"
 #include "osapi.h"
 
+#include "mrlib.h"
+
 /*****************************************************************************/
 
 #define TO_LAB_TASK_MSEC 500 /* run at 2 Hz */
@@ -30,6 +30,7 @@
 #define TO_LAB_REMOVE_PKT_CC      4 /*  remove packet     */
 #define TO_LAB_REMOVE_ALL_PKT_CC  5 /*  remove all packet */
 #define TO_LAB_OUTPUT_ENABLE_CC   6 /*  output enable     */
+#define TO_LAB_SEND_CMD_STATS_CC  7 /*  send cmd stats    */
 
 /******************************************************************************/
 
@@ -94,6 +95,7 @@ typedef TO_LAB_NoArgsCmd_t TO_LAB_NoopCmd_t;
 typedef TO_LAB_NoArgsCmd_t TO_LAB_ResetCountersCmd_t;
 typedef TO_LAB_NoArgsCmd_t TO_LAB_RemoveAllCmd_t;
 typedef TO_LAB_NoArgsCmd_t TO_LAB_SendDataTypesCmd_t;
+typedef TO_LAB_NoArgsCmd_t TO_LAB_SendCmdStatsCmd_t;
 
 typedef struct
 {
@@ -69,6 +69,7 @@
 TO_LAB_Subs_t TO_LAB_Subs = {.Subs = {/* CFS App Subscriptions */
                                       {CFE_SB_MSGID_WRAP_VALUE(TO_LAB_HK_TLM_MID), {0, 0}, 4},
                                       {CFE_SB_MSGID_WRAP_VALUE(TO_LAB_DATA_TYPES_MID), {0, 0}, 4},
+                                      {CFE_SB_MSGID_WRAP_VALUE(TO_LAB_CMD_STATS_TLM_MID), {0, 0}, 4},
 
                                       /* cFE Core subscriptions */
                                       {CFE_SB_MSGID_WRAP_VALUE(CFE_ES_HK_TLM_MID), {0, 0}, 4},
@@ -86,6 +87,7 @@ TO_LAB_Subs_t TO_LAB_Subs = {.Subs = {/* CFS App Subscriptions */
 
 #ifdef HAVE_CI_LAB
                                       {CFE_SB_MSGID_WRAP_VALUE(CI_LAB_HK_TLM_MID), {0, 0}, 4},
+                                      {CFE_SB_MSGID_WRAP_VALUE(CI_LAB_CMD_STATS_TLM_MID), {0, 0}, 4},
 #endif
 #ifdef HAVE_SAMPLE_APP
                                       {CFE_SB_MSGID_WRAP_VALUE(SAMPLE_APP_HK_TLM_MID), {0, 0}, 4},
@@ -107,9 +109,14 @@ TO_LAB_Subs_t TO_LAB_Subs = {.Subs = {/* CFS App Subscriptions */
 #endif
 #ifdef HAVE_ROMIMOT
                                       {CFE_SB_MSGID_WRAP_VALUE(ROMIMOT_HK_TLM_MID), {0, 0}, 4},
+                                      {CFE_SB_MSGID_WRAP_VALUE(ROMIMOT_STATE_TLM_MID), {0, 0}, 4},
+                                      {CFE_SB_MSGID_WRAP_VALUE(ROMIMOT_DIAG_TLM_MID), {0, 0}, 4},
+                                      {CFE_SB_MSGID_WRAP_VALUE(ROMIMOT_CMD_STATS_TLM_MID), {0, 0}, 4},
 #endif
 #ifdef HAVE_DDFK
                                       {CFE_SB_MSGID_WRAP_VALUE(DDFK_APP_HK_TLM_MID), {0, 0}, 4},
+                                      {CFE_SB_MSGID_WRAP_VALUE(DDFK_APP_POSE_TLM_MID), {0, 0}, 4},
+                                      {CFE_SB_MSGID_WRAP_VALUE(DDFK_APP_CMD_STATS_TLM_MID), {0, 0}, 4},
 #endif
                                       /* CFE_SB_MSGID_RESERVED entry to mark the end of valid MsgIds */
                                       {CFE_SB_MSGID_RESERVED, {0, 0}, 0}}};
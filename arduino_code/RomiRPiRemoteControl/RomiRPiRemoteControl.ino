@@ -2,6 +2,11 @@
 #include <Romi32U4.h>
 #include <PololuRPiSlave.h>
 
+#include "romi_encoder.h"
+#include "romi_regmap.h"
+#include "romi_speed.h"
+#include "romi_velocity.h"
+
 /* This example program shows how to make the Romi 32U4 Control Board
  * into a Raspberry Pi I2C slave.  The RPi and Romi 32U4 Control Board can
  * exchange data bidirectionally, allowing each device to do what it
@@ -19,31 +24,11 @@
  * for your Raspberry Pi robot.
  */
 
-// Custom data structure that we will use for interpreting the buffer.
-// We recommend keeping this under 64 bytes total.  If you change the
-// data format, make sure to update the corresponding code in
-// a_star.py on the Raspberry Pi.
+// The buffer layout lives in romi_regmap.h, shared with romimot on the
+// Raspberry Pi.  Keep it under 64 bytes total, and bump
+// ROMI_REGMAP_VERSION if you change it.
 
-struct Data
-{
-    // addr 0
-    bool yellow, green, red;
-    // addr 3
-    bool buttonA, buttonB, buttonC;
-    // addr 6
-    int16_t leftMotor, rightMotor;
-    // addr 10
-    uint16_t batteryMillivolts;
-    // addr 12
-    uint16_t analog[6];
-    // addr 24
-    bool playNotes;
-    char notes[14];
-    // addr
-    int16_t leftEncoder, rightEncoder;
-};
-
-PololuRPiSlave<struct Data, 5> slave;
+PololuRPiSlave<RomiRegisters, 5> slave;
 PololuBuzzer                   buzzer;
 Romi32U4Motors                 motors;
 Romi32U4ButtonA                buttonA;
@@ -51,10 +36,27 @@ Romi32U4ButtonB                buttonB;
 Romi32U4ButtonC                buttonC;
 Romi32U4Encoders               encoders;
 
+// 32 bit encoder counts, so the Pi can poll slowly without losing any.
+RomiEncoderCount leftCount, rightCount;
+
+// Encoder sampling on a fixed grid, for the velocity estimate and the
+// wheel speed loop used while the Pi selects ROMI_DRIVE_SPEED.
+uint32_t      sampleUs;
+RomiVelocity  velocity;
+uint8_t       driveMode = ROMI_DRIVE_POWER;
+RomiSpeedLoop leftSpeed, rightSpeed;
+int16_t       leftTarget, rightTarget;
+
 void setup()
 {
-    // Set up the slave at I2C address 20.
-    slave.init(20);
+    // Set up the slave at I2C address 20.  Give each Romi on a shared
+    // bus its own address, and list it in the ROMIMOT table.
+    slave.init(ROMI_I2C_ADDRESS);
+
+    // Tell the Pi which register layout this firmware speaks.
+    slave.updateBuffer();
+    slave.buffer.version = ROMI_REGMAP_VERSION;
+    slave.finalizeWrites();
 
     // Play startup sound.
     buzzer.play("v10>>g16>>>c16");
@@ -87,13 +89,61 @@ void loop()
     int set_left  = slave.buffer.leftMotor;
     int set_right = slave.buffer.rightMotor;
 
-    // If the commanded motor values are inside the allowed range,
-    // set the speet.  We expect values between -300 and 300.
-    if (set_left >= -300 && set_left <= 300 && set_right >= -300 && set_right <= 300)
+    // A new drive mode starts from rest, the motor registers change
+    // meaning with it.
+    if (slave.buffer.driveMode != driveMode)
+    {
+        driveMode   = slave.buffer.driveMode;
+        leftTarget  = 0;
+        rightTarget = 0;
+        romiSpeedReset(&leftSpeed, encoders.getCountsLeft());
+        romiSpeedReset(&rightSpeed, encoders.getCountsRight());
+        motors.setSpeeds(0, 0);
+    }
+
+    if (driveMode == ROMI_DRIVE_SPEED)
+    {
+        // The motor registers hold wheel speeds in counts/s.
+        if (set_left >= -ROMI_SPEED_MAX && set_left <= ROMI_SPEED_MAX && set_right >= -ROMI_SPEED_MAX &&
+            set_right <= ROMI_SPEED_MAX)
+        {
+            leftTarget  = set_left;
+            rightTarget = set_right;
+        }
+    }
+    else if (set_left >= -ROMI_POWER_MAX && set_left <= ROMI_POWER_MAX && set_right >= -ROMI_POWER_MAX &&
+             set_right <= ROMI_POWER_MAX)
     {
+        // If the commanded motor values are inside the allowed range,
+        // set the speed.  We expect values between -300 and 300.
         motors.setSpeeds(set_left, set_right);
     }
 
+    // Sample the encoders on a fixed grid, so neither the velocity nor
+    // the speed loop depends on how long the rest of loop() takes.
+    uint32_t now = micros();
+    if ((uint32_t)(now - sampleUs) >= ROMI_SPEED_PERIOD_US)
+    {
+        sampleUs += ROMI_SPEED_PERIOD_US;
+
+        // After a long stall restart the grid rather than catch up.
+        if ((uint32_t)(now - sampleUs) >= ROMI_SPEED_PERIOD_US)
+        {
+            sampleUs = now;
+        }
+
+        int16_t left  = encoders.getCountsLeft();
+        int16_t right = encoders.getCountsRight();
+
+        romiVelocitySample(&velocity, left, right, now);
+
+        if (driveMode == ROMI_DRIVE_SPEED)
+        {
+            motors.setSpeeds(romiSpeedStep(&leftSpeed, leftTarget, left),
+                             romiSpeedStep(&rightSpeed, rightTarget, right));
+        }
+    }
+
     // Playing music involves both reading and writing, since we only
     // want to do it once.
     static bool startedPlaying = false;
@@ -109,8 +159,21 @@ void loop()
         startedPlaying         = false;
     }
 
-    slave.buffer.leftEncoder  = encoders.getCountsLeft();
-    slave.buffer.rightEncoder = encoders.getCountsRight();
+    slave.buffer.leftEncoder  = romiEncoderUpdate(&leftCount, encoders.getCountsLeft());
+    slave.buffer.rightEncoder = romiEncoderUpdate(&rightCount, encoders.getCountsRight());
+
+    // Stamp the sample so the Pi can tell fresh data from a repeat and
+    // time each one exactly.
+    slave.buffer.micros = micros();
+    slave.buffer.sequence++;
+
+    // The velocity comes from the last grid sample, its age dates it.
+    slave.buffer.leftVelocity  = velocity.leftVelocity;
+    slave.buffer.rightVelocity = velocity.rightVelocity;
+    slave.buffer.velocityAge   = slave.buffer.micros - romiVelocityTime(&velocity);
+
+    // Last, so the check covers everything published above.
+    slave.buffer.check = romiTlmCheck((const uint8_t *)&slave.buffer + ROMI_REG_TLM);
 
     // When you are done WRITING, call finalizeWrites() to make modified
     // data available to I2C master.
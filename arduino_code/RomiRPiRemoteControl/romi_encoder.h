@@ -0,0 +1,42 @@
+/*  Encoder count arithmetic shared by the firmware
+    (RomiRPiRemoteControl.ino), the simulated Romi and ROMIMOT on the Pi.
+
+    The Romi32U4Encoders library keeps 16 bit counters, which wrap after
+    about 23 wheel turns.  The firmware extends them to 32 bits on every
+    loop(), far more often than they can wrap, so the Pi may poll as
+    slowly as it likes and still see every count.  Differences are taken
+    in unsigned arithmetic: on the 32U4 an int is 16 bits, and a signed
+    subtraction there could overflow. */
+
+#ifndef ROMI_ENCODER_H
+#define ROMI_ENCODER_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    int16_t last;  /* Library counter at the previous update, 0 at reset like the library's */
+    int32_t count; /* Accumulated count, wraps at 32 bits */
+} RomiEncoderCount;
+
+/* Counts from before to now on a wrapping 16 bit counter */
+static inline int16_t romiCountDelta16(int16_t now, int16_t before)
+{
+    return (int16_t)(uint16_t)((uint16_t)now - (uint16_t)before);
+}
+
+/* Counts from before to now on a wrapping 32 bit counter */
+static inline int32_t romiCountDelta32(int32_t now, int32_t before)
+{
+    return (int32_t)((uint32_t)now - (uint32_t)before);
+}
+
+/* Fold a new library counter value in, returns the 32 bit count */
+static inline int32_t romiEncoderUpdate(RomiEncoderCount *e, int16_t raw)
+{
+    e->count = (int32_t)((uint32_t)e->count + (uint32_t)(int32_t)romiCountDelta16(raw, e->last));
+    e->last  = raw;
+    return e->count;
+}
+
+#endif /* ROMI_ENCODER_H */
@@ -0,0 +1,129 @@
+/*  Register map of the Romi 32U4 I2C slave.
+
+    Shared by the firmware (RomiRPiRemoteControl.ino) and the Pi side
+    (apps/romimot/fsw/src/romimot_hw.h) so the two cannot drift apart.
+    Both sides are little-endian and the struct is packed, so a register
+    address is simply the byte offset of its field.
+
+    Registers the Pi writes come first.  Everything the Pi reads each
+    control cycle follows in one contiguous block, ROMI_REG_TLM up to
+    ROMI_REG_TLM_END, so a single burst read of ROMI_TLM_LEN bytes gets a
+    consistent sample.  The firmware bumps sequence and stamps micros each
+    time it publishes the block, and closes it with a check byte so the Pi
+    can reject a read the slave answered before it was ready.
+
+    Bump ROMI_REGMAP_VERSION whenever the layout changes; the Pi refuses to
+    drive a board that reports a different version. */
+
+#ifndef ROMI_REGMAP_H
+#define ROMI_REGMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ROMI_REGMAP_VERSION 6
+
+/*
+** Default 7 bit slave address.  Romis sharing a bus each need their own,
+** set in the firmware and in the ROMIMOT table.
+*/
+#define ROMI_I2C_ADDRESS 20
+
+/*
+** Register addresses
+*/
+#define ROMI_REG_VERSION    0  /* Written by the firmware at startup */
+#define ROMI_REG_LEDS       1  /* yellow, green, red */
+#define ROMI_REG_DRIVE      4  /* driveMode, written together with the motors */
+#define ROMI_REG_MOTORS     5  /* leftMotor, rightMotor */
+#define ROMI_REG_PLAY_NOTES 9
+#define ROMI_REG_NOTES      10
+#define ROMI_REG_TLM        25 /* First register of the per-cycle burst read */
+#define ROMI_REG_SEQUENCE   25
+#define ROMI_REG_MICROS     27
+#define ROMI_REG_ENCODERS   31 /* leftEncoder, rightEncoder */
+#define ROMI_REG_VELOCITY   39 /* leftVelocity, rightVelocity */
+#define ROMI_REG_VEL_AGE    43
+#define ROMI_REG_BATTERY    45
+#define ROMI_REG_ANALOG     47
+#define ROMI_REG_BUTTONS    59 /* buttonA, buttonB, buttonC */
+#define ROMI_REG_CHECK      62 /* romiTlmCheck() of the block before it */
+#define ROMI_REG_TLM_END    63
+
+#define ROMI_NOTES_LEN    15
+#define ROMI_ANALOG_LEN   6
+#define ROMI_ENCODERS_LEN (ROMI_REG_VELOCITY - ROMI_REG_ENCODERS)
+#define ROMI_TLM_LEN      (ROMI_REG_TLM_END - ROMI_REG_TLM)
+
+#define ROMI_TLM_CHECK_SEED 0xA5 /* so an all zero block does not pass */
+
+/*
+** Values for driveMode, which set how leftMotor and rightMotor are read
+*/
+#define ROMI_DRIVE_POWER 0 /* Motor power, +/- ROMI_POWER_MAX */
+#define ROMI_DRIVE_SPEED 1 /* Wheel speed in encoder counts/s, +/- ROMI_SPEED_MAX, see romi_speed.h */
+
+#define ROMI_POWER_MAX 300
+#define ROMI_SPEED_MAX 4000
+
+typedef struct __attribute__((__packed__))
+{
+    uint8_t version;
+    uint8_t yellow, green, red;
+    uint8_t driveMode;
+    int16_t leftMotor, rightMotor;
+    uint8_t playNotes;
+    char    notes[ROMI_NOTES_LEN];
+
+    /* per-cycle telemetry block */
+    uint16_t sequence; /* Bumped on every publish, wraps */
+    uint32_t micros;   /* micros() when the sample was taken */
+    int32_t  leftEncoder, rightEncoder;   /* Accumulated counts, see romi_encoder.h */
+    int16_t  leftVelocity, rightVelocity; /* counts/s, see romi_velocity.h */
+    uint16_t velocityAge;                 /* micros minus the time of the velocity sample */
+    uint16_t batteryMillivolts;
+    uint16_t analog[ROMI_ANALOG_LEN];
+    uint8_t  buttonA, buttonB, buttonC;
+    uint8_t  check; /* romiTlmCheck(), set last */
+} RomiRegisters;
+
+/*
+** Check byte over the telemetry block from ROMI_REG_TLM up to
+** ROMI_REG_CHECK.  The rotate makes it depend on byte order as well as
+** value, so a block shifted by the slave answering for another register
+** fails too.
+*/
+static inline uint8_t romiTlmCheck(const uint8_t *block)
+{
+    uint8_t check = ROMI_TLM_CHECK_SEED;
+    uint8_t i;
+
+    for (i = 0; i < ROMI_REG_CHECK - ROMI_REG_TLM; i++)
+    {
+        check = (uint8_t)(((check << 1) | (check >> 7)) + block[i]);
+    }
+    return check;
+}
+
+/*
+** Compile time layout checks, an array of negative size fails the build
+*/
+#define ROMI_REGMAP_CHECK(name, cond) typedef char RomiRegmapCheck_##name[(cond) ? 1 : -1]
+
+ROMI_REGMAP_CHECK(leds, offsetof(RomiRegisters, yellow) == ROMI_REG_LEDS);
+ROMI_REGMAP_CHECK(drive, offsetof(RomiRegisters, driveMode) == ROMI_REG_DRIVE);
+ROMI_REGMAP_CHECK(motors, offsetof(RomiRegisters, leftMotor) == ROMI_REG_MOTORS);
+ROMI_REGMAP_CHECK(playNotes, offsetof(RomiRegisters, playNotes) == ROMI_REG_PLAY_NOTES);
+ROMI_REGMAP_CHECK(notes, offsetof(RomiRegisters, notes) == ROMI_REG_NOTES);
+ROMI_REGMAP_CHECK(sequence, offsetof(RomiRegisters, sequence) == ROMI_REG_SEQUENCE);
+ROMI_REGMAP_CHECK(micros, offsetof(RomiRegisters, micros) == ROMI_REG_MICROS);
+ROMI_REGMAP_CHECK(encoders, offsetof(RomiRegisters, leftEncoder) == ROMI_REG_ENCODERS);
+ROMI_REGMAP_CHECK(velocity, offsetof(RomiRegisters, leftVelocity) == ROMI_REG_VELOCITY);
+ROMI_REGMAP_CHECK(velocityAge, offsetof(RomiRegisters, velocityAge) == ROMI_REG_VEL_AGE);
+ROMI_REGMAP_CHECK(battery, offsetof(RomiRegisters, batteryMillivolts) == ROMI_REG_BATTERY);
+ROMI_REGMAP_CHECK(analog, offsetof(RomiRegisters, analog) == ROMI_REG_ANALOG);
+ROMI_REGMAP_CHECK(buttons, offsetof(RomiRegisters, buttonA) == ROMI_REG_BUTTONS);
+ROMI_REGMAP_CHECK(check, offsetof(RomiRegisters, check) == ROMI_REG_CHECK);
+ROMI_REGMAP_CHECK(size, sizeof(RomiRegisters) == ROMI_REG_TLM_END);
+
+#endif /* ROMI_REGMAP_H */
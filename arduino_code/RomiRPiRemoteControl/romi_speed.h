@@ -0,0 +1,80 @@
+/*  Wheel speed loop run by the Romi 32U4 in ROMI_DRIVE_SPEED mode.
+
+    Shared by the firmware (RomiRPiRemoteControl.ino) and the simulated
+    Romi on the Pi (apps/romimot/fsw/src/romimot_hw_sim.c), so the simulator
+    runs exactly the control law the board does.
+
+    The loop runs every ROMI_SPEED_PERIOD_US next to the encoders.  The
+    motor power is a feedforward from the target speed plus a proportional
+    term on the speed error and an integral one.  The integral is kept as
+    the distance the wheel lags the target by, so encoder quantisation over
+    a short period does not build up.  Integer only, the 32U4 has no FPU. */
+
+#ifndef ROMI_SPEED_H
+#define ROMI_SPEED_H
+
+#include <stdint.h>
+
+#include "romi_encoder.h"
+#include "romi_regmap.h"
+
+#define ROMI_SPEED_PERIOD_US 4000 /* 250 Hz */
+#define ROMI_SPEED_HZ        (1000000L / ROMI_SPEED_PERIOD_US)
+
+/*
+** Gains, in power / 1024 per unit
+*/
+#define ROMI_SPEED_KFF 85   /* per count/s of target speed, 300 power gives about 3600 counts/s */
+#define ROMI_SPEED_KP  40   /* per count/s of speed error */
+#define ROMI_SPEED_KI  1024 /* per count of lag behind the target */
+
+#define ROMI_SPEED_LAG_MAX (150L * ROMI_SPEED_HZ) /* Bound on the lag, counts * ROMI_SPEED_HZ */
+
+typedef struct
+{
+    int16_t lastCount; /* Encoder count at the previous step */
+    int32_t lag;       /* Target distance minus distance travelled, counts * ROMI_SPEED_HZ */
+} RomiSpeedLoop;
+
+static inline void romiSpeedReset(RomiSpeedLoop *loop, int16_t count)
+{
+    loop->lastCount = count;
+    loop->lag       = 0;
+}
+
+/* One loop period: returns the motor power for a target speed in counts/s */
+static inline int16_t romiSpeedStep(RomiSpeedLoop *loop, int16_t target, int16_t count)
+{
+    int16_t delta = romiCountDelta16(count, loop->lastCount);
+    int32_t speed = (int32_t)delta * ROMI_SPEED_HZ;
+    int32_t power;
+
+    loop->lastCount = count;
+
+    loop->lag += target - speed;
+    if (loop->lag > ROMI_SPEED_LAG_MAX)
+    {
+        loop->lag = ROMI_SPEED_LAG_MAX;
+    }
+    else if (loop->lag < -ROMI_SPEED_LAG_MAX)
+    {
+        loop->lag = -ROMI_SPEED_LAG_MAX;
+    }
+
+    power = ((int32_t)ROMI_SPEED_KFF * target + (int32_t)ROMI_SPEED_KP * (target - speed) +
+             (int32_t)ROMI_SPEED_KI * loop->lag / ROMI_SPEED_HZ) /
+            1024;
+
+    if (power > ROMI_POWER_MAX)
+    {
+        power = ROMI_POWER_MAX;
+    }
+    else if (power < -ROMI_POWER_MAX)
+    {
+        power = -ROMI_POWER_MAX;
+    }
+
+    return (int16_t)power;
+}
+
+#endif /* ROMI_SPEED_H */
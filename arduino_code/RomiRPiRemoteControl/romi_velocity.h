@@ -0,0 +1,93 @@
+/*  Wheel velocity estimate made by the Romi 32U4.
+
+    Shared by the firmware (RomiRPiRemoteControl.ino) and the simulated
+    Romi on the Pi (apps/romimot/fsw/src/romimot_hw_sim.c).
+
+    The encoders are sampled with their micros() time on the fixed
+    ROMI_SPEED_PERIOD_US grid of the speed loop, whatever the drive mode.
+    The velocity is the count difference across the last
+    ROMI_VELOCITY_SAMPLES samples divided by their measured time span, so it
+    is an average over about ROMI_VELOCITY_WINDOW_US ending at the newest
+    sample and does not depend on when the Pi happens to poll. */
+
+#ifndef ROMI_VELOCITY_H
+#define ROMI_VELOCITY_H
+
+#include <stdint.h>
+
+#include "romi_encoder.h"
+#include "romi_speed.h"
+
+#define ROMI_VELOCITY_SAMPLES   6 /* Samples in the window, the span is one fewer periods */
+#define ROMI_VELOCITY_WINDOW_US ((ROMI_VELOCITY_SAMPLES - 1) * ROMI_SPEED_PERIOD_US)
+
+typedef struct
+{
+    int16_t  left[ROMI_VELOCITY_SAMPLES];
+    int16_t  right[ROMI_VELOCITY_SAMPLES];
+    uint32_t us[ROMI_VELOCITY_SAMPLES];
+    uint8_t  head;  /* Newest sample */
+    uint8_t  count; /* Samples held, up to ROMI_VELOCITY_SAMPLES */
+
+    int16_t leftVelocity; /* counts/s over the window */
+    int16_t rightVelocity;
+} RomiVelocity;
+
+static inline void romiVelocityReset(RomiVelocity *v)
+{
+    v->head          = 0;
+    v->count         = 0;
+    v->leftVelocity  = 0;
+    v->rightVelocity = 0;
+}
+
+static inline int16_t romiVelocityRate(int16_t counts, int32_t spanUs)
+{
+    int32_t rate = (int32_t)counts * 1000000L / spanUs;
+
+    if (rate > 32767)
+    {
+        return 32767;
+    }
+    if (rate < -32767)
+    {
+        return -32767;
+    }
+    return (int16_t)rate;
+}
+
+/* Add a sample taken at time us and update the velocities */
+static inline void romiVelocitySample(RomiVelocity *v, int16_t left, int16_t right, uint32_t us)
+{
+    uint8_t oldest;
+    int32_t spanUs;
+
+    v->head           = (uint8_t)((v->head + 1) % ROMI_VELOCITY_SAMPLES);
+    v->left[v->head]  = left;
+    v->right[v->head] = right;
+    v->us[v->head]    = us;
+    if (v->count < ROMI_VELOCITY_SAMPLES)
+    {
+        v->count++;
+    }
+
+    oldest = (uint8_t)((v->head + ROMI_VELOCITY_SAMPLES - (v->count - 1)) % ROMI_VELOCITY_SAMPLES);
+    spanUs = (int32_t)(us - v->us[oldest]); /* micros() wraps */
+    if (spanUs <= 0)
+    {
+        v->leftVelocity  = 0;
+        v->rightVelocity = 0;
+        return;
+    }
+
+    v->leftVelocity  = romiVelocityRate(romiCountDelta16(left, v->left[oldest]), spanUs);
+    v->rightVelocity = romiVelocityRate(romiCountDelta16(right, v->right[oldest]), spanUs);
+}
+
+/* Time of the newest sample */
+static inline uint32_t romiVelocityTime(const RomiVelocity *v)
+{
+    return v->us[v->head];
+}
+
+#endif /* ROMI_VELOCITY_H */
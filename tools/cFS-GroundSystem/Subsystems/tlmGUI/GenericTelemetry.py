@@ -67,7 +67,7 @@ class SubsystemTelemetry(QDialog, UiGenerictelemetrydialog):
                 pass
             tlm_field2 = datagram[item_start:item_start +
                                  int(tlm_item_size[tlm_index])]
-            if tlm_field2:
+            if len(tlm_field2) == int(tlm_item_size[tlm_index]):
                 tlm_field = unpack(tlm_field1, tlm_field2)
                 if tlm_item_display_type[tlm_index] == 'Dec':
                     value_field.setText(str(tlm_field[0]))
@@ -78,8 +78,12 @@ class SubsystemTelemetry(QDialog, UiGenerictelemetrydialog):
                 elif tlm_item_display_type[tlm_index] == 'Str':
                     value_field.setText(tlm_field[0].decode('utf-8', 'ignore'))
                 label_field.setText(tlm_item_desc[tlm_index])
-            else:
+            elif item_start < len(datagram):
                 print("ERROR: Can't unpack buffer of length", len(tlm_field2))
+            else:
+                # Past the end of a variable length packet
+                value_field.setText('')
+                label_field.setText(tlm_item_desc[tlm_index])
 
     # Start the telemetry receiver (see GTTlmReceiver class)
     def init_gt_tlm_receiver(self, subscr):
@@ -0,0 +1,525 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+ * DDFK log reprocessing. This program integrates a recorded session of
+ * Romi encoder counts into poses with the DDFK forward kinematics, for a
+ * wheel geometry given on the command line, so a calibration can be tuned
+ * against a long session without replaying it through the flight software.
+ * It can also time the batch kernel against the scalar step.
+ */
+
+/* System define for getopt_long */
+#define _DEFAULT_SOURCE
+
+/*
+ * System includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#include "ddfk_app_batch.h"
+
+/*
+ * Defines
+ */
+
+/* Geometry defaults, the Pololu Romi as in the DDFK table */
+#define DEFAULT_WHEEL_RADIUS   0.035   /* m */
+#define DEFAULT_TRACK_WIDTH    0.141   /* m */
+#define DEFAULT_COUNTS_PER_REV 1437.09 /* Encoder counts per wheel revolution */
+
+#define MAX_LINE_SIZE    256  /* Longest input line */
+#define INITIAL_CAPACITY 4096 /* Samples allocated before the first grow */
+
+/*
+ * Option datatype structure
+ */
+typedef struct
+{
+    double      WheelRadius;  /* m */
+    double      TrackWidth;   /* m */
+    double      CountsPerRev; /* Encoder counts per wheel revolution */
+    bool        Totals;       /* Input columns are odometer totals, not per-sample counts */
+    bool        Scalar;       /* Integrate with DDFK_APP_FkArc() rather than the batch kernel */
+    unsigned    BenchRuns;    /* Passes of each path to time, 0 for none */
+    uint32_t    Synthesize;   /* Samples of random drive to make instead of reading input */
+    const char *InputFile;    /* NULL for stdin */
+    const char *OutputFile;   /* CSV of every pose, NULL for none */
+} Options_t;
+
+/*
+ * Encoder counts, structure of arrays as the batch kernel takes them
+ */
+typedef struct
+{
+    int32   *Left;
+    int32   *Right;
+    uint32_t Count;
+    uint32_t Capacity;
+} Samples_t;
+
+/*
+ * getopts parameter passing options string
+ */
+static const char *optString = "r:w:c:to:sb:n:?";
+
+/*
+ * getopts_long long form argument table
+ */
+static struct option longOpts[] = {{"radius", required_argument, NULL, 'r'},
+                                   {"track", required_argument, NULL, 'w'},
+                                   {"counts", required_argument, NULL, 'c'},
+                                   {"totals", no_argument, NULL, 't'},
+                                   {"output", required_argument, NULL, 'o'},
+                                   {"scalar", no_argument, NULL, 's'},
+                                   {"bench", required_argument, NULL, 'b'},
+                                   {"synthesize", required_argument, NULL, 'n'},
+                                   {"help", no_argument, NULL, '?'},
+                                   {0, 0, 0, 0}};
+
+/*******************************************************************************
+ * Display program usage, and exit.
+ */
+void DisplayUsage(const char *Name)
+{
+    printf("%s -- DDFK log reprocessing.\n", Name);
+    printf("  usage: %s [options] [input]\n", Name);
+    printf("  Input has one sample per line, the left and right encoder counts rolled in\n");
+    printf("  that sample separated by white space or a comma. Lines starting with # are\n");
+    printf("  skipped. Without an input file the samples are read from stdin.\n");
+    printf("  - Geometry options:\n");
+    printf("    -r, --radius: Wheel radius in m (default = %g)\n", DEFAULT_WHEEL_RADIUS);
+    printf("    -w, --track: Track width in m (default = %g)\n", DEFAULT_TRACK_WIDTH);
+    printf("    -c, --counts: Encoder counts per wheel revolution (default = %g)\n", DEFAULT_COUNTS_PER_REV);
+    printf("  - Processing options:\n");
+    printf("    -t, --totals: Input columns are odometer totals, as in the ROMIMOT state packets\n");
+    printf("    -o, --output: Write the pose after every sample to this CSV file\n");
+    printf("    -s, --scalar: Integrate sample by sample instead of with the batch kernel\n");
+    printf("    -b, --bench: Time this many passes of the scalar and batch paths and compare them\n");
+    printf("    -n, --synthesize: Integrate this many samples of a random drive instead of an input\n");
+    printf("    -?, --help: print options and exit\n");
+    exit(EXIT_SUCCESS);
+}
+
+/*******************************************************************************
+ * Parse a positive number option, or exit.
+ */
+double ParsePositive(const char *Name, const char *In)
+{
+    char  *End;
+    double Value;
+
+    errno = 0;
+    Value = strtod(In, &End);
+    if (errno != 0 || End == In || *End != '\0' || !(Value > 0 && Value < INFINITY))
+    {
+        fprintf(stderr, "ERROR: %s must be a positive number, not '%s'\n", Name, In);
+        exit(EXIT_FAILURE);
+    }
+
+    return Value;
+}
+
+/*******************************************************************************
+ * Parse a positive whole number option no larger than Max, or exit.
+ */
+uint32_t ParseCount(const char *Name, const char *In, uint32_t Max)
+{
+    double Value = ParsePositive(Name, In);
+
+    if (Value != floor(Value) || Value > Max)
+    {
+        fprintf(stderr, "ERROR: %s must be a whole number from 1 to %lu, not '%s'\n", Name, (unsigned long)Max, In);
+        exit(EXIT_FAILURE);
+    }
+
+    return (uint32_t)Value;
+}
+
+/*******************************************************************************
+ * Append one sample, growing the arrays as needed, or exit.
+ */
+void AddSample(Samples_t *Samples, int32 Left, int32 Right)
+{
+    int32 *Grown;
+
+    if (Samples->Count == Samples->Capacity)
+    {
+        if (Samples->Capacity > UINT32_MAX / 2)
+        {
+            fprintf(stderr, "ERROR: Too many samples\n");
+            exit(EXIT_FAILURE);
+        }
+        Samples->Capacity = Samples->Capacity == 0 ? INITIAL_CAPACITY : Samples->Capacity * 2;
+
+        Grown = realloc(Samples->Left, Samples->Capacity * sizeof(*Grown));
+        if (Grown == NULL)
+        {
+            fprintf(stderr, "ERROR: Out of memory for %lu samples\n", (unsigned long)Samples->Capacity);
+            exit(EXIT_FAILURE);
+        }
+        Samples->Left = Grown;
+
+        Grown = realloc(Samples->Right, Samples->Capacity * sizeof(*Grown));
+        if (Grown == NULL)
+        {
+            fprintf(stderr, "ERROR: Out of memory for %lu samples\n", (unsigned long)Samples->Capacity);
+            exit(EXIT_FAILURE);
+        }
+        Samples->Right = Grown;
+    }
+
+    Samples->Left[Samples->Count]  = Left;
+    Samples->Right[Samples->Count] = Right;
+    Samples->Count++;
+}
+
+/*******************************************************************************
+ * Read the samples, turning odometer totals into counts if asked, or exit.
+ */
+void ReadSamples(const Options_t *Opts, Samples_t *Samples)
+{
+    FILE         *File = stdin;
+    char          Line[MAX_LINE_SIZE];
+    long          Left;
+    long          Right;
+    uint32_t      LastLeft  = 0;
+    uint32_t      LastRight = 0;
+    bool          First     = true;
+    unsigned long LineNum   = 0;
+
+    if (Opts->InputFile != NULL)
+    {
+        File = fopen(Opts->InputFile, "r");
+        if (File == NULL)
+        {
+            fprintf(stderr, "ERROR: Cannot open %s: %s\n", Opts->InputFile, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    while (fgets(Line, sizeof(Line), File) != NULL)
+    {
+        LineNum++;
+        if (Line[0] == '#' || strspn(Line, " \t\r\n") == strlen(Line))
+        {
+            continue;
+        }
+
+        if (sscanf(Line, "%ld%*[ \t,]%ld", &Left, &Right) != 2 || Left < INT32_MIN || Left > INT32_MAX ||
+            Right < INT32_MIN || Right > INT32_MAX)
+        {
+            fprintf(stderr, "ERROR: Line %lu is not two 32 bit counts\n", LineNum);
+            exit(EXIT_FAILURE);
+        }
+
+        if (!Opts->Totals)
+        {
+            AddSample(Samples, (int32)Left, (int32)Right);
+            continue;
+        }
+
+        /* The same unsigned differences DDFK takes, right across an odometer wrap */
+        if (!First)
+        {
+            AddSample(Samples, (int32)((uint32_t)Left - LastLeft), (int32)((uint32_t)Right - LastRight));
+        }
+        LastLeft  = (uint32_t)Left;
+        LastRight = (uint32_t)Right;
+        First     = false;
+    }
+
+    if (File != stdin)
+    {
+        fclose(File);
+    }
+}
+
+/*******************************************************************************
+ * Make a random drive at about 0.3 m/s, wandering left and right.
+ */
+void SynthesizeSamples(uint32_t Count, Samples_t *Samples)
+{
+    uint32_t Seed = 1;
+    int32    Turn = 0;
+    uint32_t i;
+
+    for (i = 0; i < Count; i++)
+    {
+        Seed = Seed * 1664525u + 1013904223u;
+        if (Seed >> 28 == 0)
+        {
+            Turn = (int32)(Seed >> 20 & 0x1F) - 16;
+        }
+        AddSample(Samples, 20 - Turn + (int32)(Seed >> 8 & 3), 20 + Turn + (int32)(Seed >> 12 & 3));
+    }
+}
+
+/*******************************************************************************
+ * Integrate every sample with the scalar step, into the same arrays the
+ * batch kernel fills.
+ */
+void IntegrateScalar(DDFK_APP_Pose_t *Pose, const DDFK_APP_Batch_t *Batch, double MetersPerCount, double TrackWidth)
+{
+    uint32_t i;
+
+    for (i = 0; i < Batch->Count; i++)
+    {
+        DDFK_APP_FkArc(Pose, Batch->LeftCounts[i] * MetersPerCount, Batch->RightCounts[i] * MetersPerCount,
+                       TrackWidth);
+        Batch->X[i]       = Pose->X;
+        Batch->Y[i]       = Pose->Y;
+        Batch->Heading[i] = Pose->Heading;
+    }
+}
+
+/*******************************************************************************
+ * Seconds on a monotonic clock.
+ */
+double Now(void)
+{
+    struct timespec Time;
+
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return Time.tv_sec + Time.tv_nsec * 1e-9;
+}
+
+/*******************************************************************************
+ * Time each path over the same samples and report how far apart they end up.
+ */
+void Benchmark(const Options_t *Opts, DDFK_APP_Batch_t *Batch, double MetersPerCount)
+{
+    DDFK_APP_Batch_t Scalar = *Batch;
+    DDFK_APP_Pose_t  Pose;
+    double           ScalarTime = INFINITY;
+    double           BatchTime  = INFINITY;
+    double           Start;
+    double           Elapsed;
+    double           Position = 0;
+    double           Heading  = 0;
+    unsigned         Run;
+    uint32_t         i;
+
+    Scalar.X       = malloc(Batch->Count * sizeof(double));
+    Scalar.Y       = malloc(Batch->Count * sizeof(double));
+    Scalar.Heading = malloc(Batch->Count * sizeof(double));
+    if (Scalar.X == NULL || Scalar.Y == NULL || Scalar.Heading == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory for the benchmark\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The best of the runs, after a first untimed one to fault the arrays in */
+    for (Run = 0; Run <= Opts->BenchRuns; Run++)
+    {
+        memset(&Pose, 0, sizeof(Pose));
+        Start = Now();
+        IntegrateScalar(&Pose, &Scalar, MetersPerCount, Opts->TrackWidth);
+        Elapsed = Now() - Start;
+        if (Run > 0 && Elapsed < ScalarTime)
+        {
+            ScalarTime = Elapsed;
+        }
+
+        memset(&Pose, 0, sizeof(Pose));
+        Start = Now();
+        DDFK_APP_FkBatch(&Pose, Batch, MetersPerCount, Opts->TrackWidth);
+        Elapsed = Now() - Start;
+        if (Run > 0 && Elapsed < BatchTime)
+        {
+            BatchTime = Elapsed;
+        }
+    }
+
+    for (i = 0; i < Batch->Count; i++)
+    {
+        Position = fmax(Position, hypot(Batch->X[i] - Scalar.X[i], Batch->Y[i] - Scalar.Y[i]));
+        Heading  = fmax(Heading, fabs(DDFK_APP_FkWrap(Batch->Heading[i] - Scalar.Heading[i])));
+    }
+
+    printf("scalar %.2f ns/sample, batch %.2f ns/sample, %.2fx\n", ScalarTime / Batch->Count * 1e9,
+           BatchTime / Batch->Count * 1e9, ScalarTime / BatchTime);
+    printf("largest difference %.3g m, %.3g rad\n", Position, Heading);
+
+    free(Scalar.X);
+    free(Scalar.Y);
+    free(Scalar.Heading);
+}
+
+/*******************************************************************************
+ * Write the pose after every sample.
+ */
+void WritePoses(const char *Name, const DDFK_APP_Batch_t *Batch)
+{
+    FILE    *File;
+    uint32_t i;
+
+    File = fopen(Name, "w");
+    if (File == NULL)
+    {
+        fprintf(stderr, "ERROR: Cannot create %s: %s\n", Name, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    fprintf(File, "sample,x_m,y_m,heading_rad\n");
+    for (i = 0; i < Batch->Count; i++)
+    {
+        fprintf(File, "%lu,%.9f,%.9f,%.9f\n", (unsigned long)i, Batch->X[i], Batch->Y[i], Batch->Heading[i]);
+    }
+
+    if (fclose(File) != 0)
+    {
+        fprintf(stderr, "ERROR: Cannot write %s\n", Name);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*******************************************************************************
+ * Main
+ */
+int main(int argc, char *argv[])
+{
+    Options_t        Opts;
+    Samples_t        Samples;
+    DDFK_APP_Batch_t Batch;
+    DDFK_APP_Pose_t  Pose;
+    double           MetersPerCount;
+    int              opt;
+
+    memset(&Opts, 0, sizeof(Opts));
+    memset(&Samples, 0, sizeof(Samples));
+    Opts.WheelRadius  = DEFAULT_WHEEL_RADIUS;
+    Opts.TrackWidth   = DEFAULT_TRACK_WIDTH;
+    Opts.CountsPerRev = DEFAULT_COUNTS_PER_REV;
+
+    while ((opt = getopt_long(argc, argv, optString, longOpts, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 'r':
+                Opts.WheelRadius = ParsePositive("Wheel radius", optarg);
+                break;
+            case 'w':
+                Opts.TrackWidth = ParsePositive("Track width", optarg);
+                break;
+            case 'c':
+                Opts.CountsPerRev = ParsePositive("Counts per revolution", optarg);
+                break;
+            case 't':
+                Opts.Totals = true;
+                break;
+            case 'o':
+                Opts.OutputFile = optarg;
+                break;
+            case 's':
+                Opts.Scalar = true;
+                break;
+            case 'b':
+                /* one below the largest, the runs are counted from 0 to BenchRuns */
+                Opts.BenchRuns = ParseCount("Benchmark runs", optarg, UINT_MAX - 1);
+                break;
+            case 'n':
+                Opts.Synthesize = ParseCount("Synthesized samples", optarg, UINT32_MAX);
+                break;
+            default:
+                DisplayUsage(argv[0]);
+                break;
+        }
+    }
+
+    if (optind < argc)
+    {
+        Opts.InputFile = argv[optind];
+    }
+
+    if (Opts.Synthesize > 0 && Opts.InputFile != NULL)
+    {
+        fprintf(stderr, "ERROR: An input file cannot be given with --synthesize\n");
+        return EXIT_FAILURE;
+    }
+
+    if (Opts.Synthesize > 0)
+    {
+        SynthesizeSamples(Opts.Synthesize, &Samples);
+    }
+    else
+    {
+        ReadSamples(&Opts, &Samples);
+    }
+
+    if (Samples.Count == 0)
+    {
+        fprintf(stderr, "ERROR: No samples\n");
+        return EXIT_FAILURE;
+    }
+
+    Batch.LeftCounts  = Samples.Left;
+    Batch.RightCounts = Samples.Right;
+    Batch.X           = malloc(Samples.Count * sizeof(double));
+    Batch.Y           = malloc(Samples.Count * sizeof(double));
+    Batch.Heading     = malloc(Samples.Count * sizeof(double));
+    Batch.Count       = Samples.Count;
+    if (Batch.X == NULL || Batch.Y == NULL || Batch.Heading == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory for %lu poses\n", (unsigned long)Samples.Count);
+        return EXIT_FAILURE;
+    }
+
+    /* The same geometry DDFK takes from its table */
+    MetersPerCount = 2.0 * DDFK_APP_PI * Opts.WheelRadius / Opts.CountsPerRev;
+
+    if (Opts.BenchRuns > 0)
+    {
+        Benchmark(&Opts, &Batch, MetersPerCount);
+    }
+
+    memset(&Pose, 0, sizeof(Pose));
+    if (Opts.Scalar)
+    {
+        IntegrateScalar(&Pose, &Batch, MetersPerCount, Opts.TrackWidth);
+    }
+    else
+    {
+        DDFK_APP_FkBatch(&Pose, &Batch, MetersPerCount, Opts.TrackWidth);
+    }
+
+    printf("%lu samples, x %.6f m, y %.6f m, heading %.6f rad\n", (unsigned long)Samples.Count, Pose.X, Pose.Y,
+           Pose.Heading);
+
+    if (Opts.OutputFile != NULL)
+    {
+        WritePoses(Opts.OutputFile, &Batch);
+    }
+
+    free(Batch.X);
+    free(Batch.Y);
+    free(Batch.Heading);
+    free(Samples.Left);
+    free(Samples.Right);
+
+    return EXIT_SUCCESS;
+}